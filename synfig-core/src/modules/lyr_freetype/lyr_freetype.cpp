@@ -43,6 +43,10 @@
 #include "lyr_freetype.h"
 
 #include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
 #include <glibmm.h>
 
 #include FT_IMAGE_H
@@ -267,6 +271,97 @@ public:
 	}
 };
 
+/// Glyph outline in font units (glyphs are loaded with FT_LOAD_NO_SCALE)
+struct GlyphInfo {
+	Vector advance;
+	FT_BBox bbox;
+	rendering::Contour::ChunkList outline;
+};
+
+/// Cache glyph outlines, so text re-layout doesn't decompose the same glyphs again.
+/// Faces live in FaceCache until exit, so FT_Face is a valid key.
+class GlyphCache {
+public:
+	typedef std::shared_ptr<const GlyphInfo> Handle;
+
+private:
+	typedef std::tuple<FT_Face, uint32_t, bool> Key;
+	//! Cache is dropped as whole when grows above this count of glyphs,
+	//! glyphs in use are kept alive by their handles
+	enum { MAX_GLYPHS = 8192 };
+
+	std::map<Key, Handle> cache;
+	mutable std::mutex cache_mutex;
+	GlyphCache() = default;
+
+public:
+	//! Returns null handle if glyph can't be loaded
+	Handle get(FT_Face face, uint32_t glyph_index, bool grid_fit) {
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		const Key key(face, glyph_index, grid_fit);
+		auto iter = cache.find(key);
+		if (iter != cache.end())
+			return iter->second;
+
+		Handle glyph = load(face, glyph_index, grid_fit);
+		if (cache.size() >= MAX_GLYPHS)
+			cache.clear();
+		cache[key] = glyph;
+		return glyph;
+	}
+
+	static GlyphCache& instance() {
+		static GlyphCache obj;
+		return obj;
+	}
+
+	GlyphCache(const GlyphCache&) = delete;
+	void operator=(const GlyphCache&) = delete;
+
+private:
+	static Handle load(FT_Face face, uint32_t glyph_index, bool grid_fit);
+};
+
+#if HAVE_HARFBUZZ
+/// Cache shaping results of text spans.
+/// Animated text usually repeats the same spans (i.e. digits of a counter) in every frame.
+class ShapeCache {
+public:
+	typedef std::shared_ptr<const std::vector<uint32_t>> Handle;
+
+private:
+	typedef std::tuple<FT_Face, hb_script_t, std::vector<uint32_t>> Key;
+	//! Cache is dropped as whole when grows above this count of spans
+	enum { MAX_SPANS = 4096 };
+
+	std::map<Key, Handle> cache;
+	mutable std::mutex cache_mutex;
+	ShapeCache() = default;
+
+public:
+	Handle get(FT_Face face, hb_script_t script, const std::vector<uint32_t> &codepoints) const {
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		auto iter = cache.find(Key(face, script, codepoints));
+		return iter == cache.end() ? Handle() : iter->second;
+	}
+
+	void put(FT_Face face, hb_script_t script, const std::vector<uint32_t> &codepoints, const Handle &glyph_indices) {
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		if (cache.size() >= MAX_SPANS)
+			cache.clear();
+		cache[Key(face, script, codepoints)] = glyph_indices;
+	}
+
+	static ShapeCache& instance() {
+		static ShapeCache obj;
+		return obj;
+	}
+
+	ShapeCache(const ShapeCache&) = delete;
+	void operator=(const ShapeCache&) = delete;
+};
+#endif
+
 /* === P R O C E D U R E S ================================================= */
 
 static bool
@@ -515,7 +610,7 @@ Layer_Freetype::new_font_(const synfig::String &font_fam_, int style, int weight
 		if (!font_path_from_canvas)
 			meta.canvas_path.clear();
 		FaceInfo face_info(face);
-		face_cache.put(meta, FaceInfo(face));
+		face_cache.put(meta, face_info);
 #if HAVE_HARFBUZZ
 		font = face_info.font;
 #endif
@@ -946,8 +1041,9 @@ Layer_Freetype::sync_vfunc()
 	}
 
 #if HAVE_HARFBUZZ
-	hb_buffer_t *span_buffer = hb_buffer_create();
-	std::unique_ptr<hb_buffer_t, decltype(&hb_buffer_destroy)> safe_buf(span_buffer, hb_buffer_destroy); // auto delete
+	hb_buffer_t *span_buffer = nullptr;
+	std::unique_ptr<hb_buffer_t, decltype(&hb_buffer_destroy)> safe_buf(nullptr, hb_buffer_destroy); // auto delete
+	ShapeCache &shape_cache = ShapeCache::instance();
 #endif
 
 	// Lines of glyph indices
@@ -960,32 +1056,37 @@ Layer_Freetype::sync_vfunc()
 
 		for (const TextSpan& span : line) {
 #if HAVE_HARFBUZZ
-			hb_buffer_clear_contents(span_buffer);
+			ShapeCache::Handle shaped = shape_cache.get(face, span.script, span.codepoints);
+			if (!shaped) {
+				if (!span_buffer) {
+					span_buffer = hb_buffer_create();
+					safe_buf.reset(span_buffer);
+				}
+				hb_buffer_clear_contents(span_buffer);
 
-			hb_direction_t direction = HB_DIRECTION_LTR; // character order already fixed by FriBiDi
-			hb_buffer_set_direction(span_buffer, direction);
-			hb_buffer_set_script(span_buffer, span.script);
-//			hb_buffer_set_language(span_buffer, hb_language_from_string(language.c_str(), -1));
+				hb_direction_t direction = HB_DIRECTION_LTR; // character order already fixed by FriBiDi
+				hb_buffer_set_direction(span_buffer, direction);
+				hb_buffer_set_script(span_buffer, span.script);
+//				hb_buffer_set_language(span_buffer, hb_language_from_string(language.c_str(), -1));
 
-			hb_buffer_add_utf32(span_buffer, span.codepoints.data(), span.codepoints.size(), 0, -1);
+				hb_buffer_add_utf32(span_buffer, span.codepoints.data(), span.codepoints.size(), 0, -1);
 
-			hb_shape(font, span_buffer, nullptr, 0);
+				hb_shape(font, span_buffer, nullptr, 0);
 
-			unsigned int glyph_count;
-			hb_glyph_info_t *glyph_info = hb_buffer_get_glyph_infos(span_buffer, &glyph_count);
-#else
-			size_t glyph_count = span.codepoints.size();
-#endif
+				unsigned int glyph_count;
+				hb_glyph_info_t *glyph_info = hb_buffer_get_glyph_infos(span_buffer, &glyph_count);
 
-			for (size_t i = 0; i < glyph_count; i++) {
-				uint32_t glyph_index;
-#if HAVE_HARFBUZZ
-				glyph_index = glyph_info[i].codepoint;
+				std::vector<uint32_t> *span_indices = new std::vector<uint32_t>(glyph_count);
+				for (size_t i = 0; i < glyph_count; i++)
+					(*span_indices)[i] = glyph_info[i].codepoint;
+				shaped.reset(span_indices);
+				shape_cache.put(face, span.script, span.codepoints, shaped);
+			}
+			glyph_index_line.insert(glyph_index_line.end(), shaped->begin(), shaped->end());
 #else
-				glyph_index = FT_Get_Char_Index(face, span.codepoints[i]);
+			for (size_t i = 0; i < span.codepoints.size(); i++)
+				glyph_index_line.push_back(FT_Get_Char_Index(face, span.codepoints[i]));
 #endif
-				glyph_index_line.push_back(glyph_index);
-			}
 		}
 
 		glyph_indices.push_back(glyph_index_line);
@@ -993,46 +1094,16 @@ Layer_Freetype::sync_vfunc()
 
 	// get visual info
 	// Depends on: glyph indices, font and grid_fit
-	struct Glyph {
-		Vector advance;
-		FT_BBox bbox;
-		rendering::Contour::ChunkList outline;
-	};
-
-	std::map<uint32_t, Glyph> glyph_map;
+	GlyphCache &glyph_cache = GlyphCache::instance();
+	std::map<uint32_t, GlyphCache::Handle> glyph_map;
 
 	for (const std::vector<uint32_t>& glyph_line : glyph_indices)
 	{
 		for (const uint32_t glyph_index : glyph_line) {
 			if (glyph_map.count(glyph_index))
 				continue;
-
-			// load glyph image into the slot. DO NOT RENDER IT !!
-			FT_Error error;
-			if(grid_fit)
-				error = FT_Load_Glyph( face, glyph_index, FT_LOAD_NO_SCALE);
-			else
-				error = FT_Load_Glyph( face, glyph_index, FT_LOAD_NO_SCALE|FT_LOAD_NO_HINTING );
-			if (error) continue;  // ignore errors, jump to next glyph
-
-			// extract glyph image and store it in our table
-			FT_Glyph ftglyph;
-			error = FT_Get_Glyph( face->glyph, &ftglyph );
-			if (error) continue;  // ignore errors, jump to next glyph
-
-			Glyph glyph;
-			glyph.advance = Vector(ftglyph->advance.x >> 10, ftglyph->advance.y >> 10);
-			FT_Glyph_Get_CBox(ftglyph, ft_glyph_bbox_subpixels, &glyph.bbox);
-
-			FT_OutlineGlyph outline_glyph = nullptr;
-			if (ftglyph->format == FT_GLYPH_FORMAT_OUTLINE) {
-				outline_glyph = FT_OutlineGlyph(ftglyph);
-				convert_outline_to_contours(outline_glyph, glyph.outline);
-			}
-
-			glyph_map[glyph_index] = glyph;
-
-			FT_Done_Glyph(ftglyph);
+			if (GlyphCache::Handle glyph = glyph_cache.get(face, glyph_index, grid_fit))
+				glyph_map[glyph_index] = glyph;
 		}
 	}
 
@@ -1066,7 +1137,7 @@ Layer_Freetype::sync_vfunc()
 
 			// 'render' the glyph
 			try {
-				const Glyph &glyph = glyph_map.at(glyph_index);
+				const GlyphInfo &glyph = *glyph_map.at(glyph_index);
 
 				rendering::Contour::ChunkList chunks = glyph.outline;
 				shift_contour_chunks(chunks, offset);
@@ -1106,6 +1177,33 @@ Layer_Freetype::sync_vfunc()
 	}
 }
 
+GlyphCache::Handle
+GlyphCache::load(FT_Face face, uint32_t glyph_index, bool grid_fit)
+{
+	// load glyph image into the slot. DO NOT RENDER IT !!
+	FT_Error error;
+	if(grid_fit)
+		error = FT_Load_Glyph( face, glyph_index, FT_LOAD_NO_SCALE);
+	else
+		error = FT_Load_Glyph( face, glyph_index, FT_LOAD_NO_SCALE|FT_LOAD_NO_HINTING );
+	if (error) return Handle();
+
+	// extract glyph image and store it in our table
+	FT_Glyph ftglyph;
+	error = FT_Get_Glyph( face->glyph, &ftglyph );
+	if (error) return Handle();
+
+	GlyphInfo *glyph = new GlyphInfo();
+	glyph->advance = Vector(ftglyph->advance.x >> 10, ftglyph->advance.y >> 10);
+	FT_Glyph_Get_CBox(ftglyph, ft_glyph_bbox_subpixels, &glyph->bbox);
+
+	if (ftglyph->format == FT_GLYPH_FORMAT_OUTLINE)
+		Layer_Freetype::convert_outline_to_contours(FT_OutlineGlyph(ftglyph), glyph->outline);
+
+	FT_Done_Glyph(ftglyph);
+	return Handle(glyph);
+}
+
 bool
 Layer_Freetype::is_inside_contour(const Point& p, bool ignore_feather) const
 {
@@ -51,6 +51,7 @@
 class Layer_Freetype : public synfig::Layer_Shape
 {
 	SYNFIG_LAYER_MODULE_EXT
+	friend class GlyphCache;
 private:
 	//!Parameter: (synfig::String) text of the layer;
 	synfig::ValueBase param_text;
@@ -57,6 +57,6 @@ MODULE_INVENTORY_BEGIN(mod_bmp)
 		TARGET(bmp)
 	END_TARGETS
 	BEGIN_IMPORTERS
-		IMPORTER(bmp_mptr)
+		IMPORTER_PARALLEL(bmp_mptr)
 	END_IMPORTERS
 MODULE_INVENTORY_END
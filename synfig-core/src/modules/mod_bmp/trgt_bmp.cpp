@@ -200,7 +200,7 @@ bmp::set_rend_desc(RendDesc *given_desc)
     return true;
 }
 
-void
+bool
 bmp::end_frame()
 {
 	if(file)
@@ -209,6 +209,7 @@ bmp::end_frame()
 	color_buffer=0;
 	file = nullptr;
 	imagecount++;
+	return true;
 }
 
 bool
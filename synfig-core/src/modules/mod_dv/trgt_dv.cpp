@@ -240,12 +240,13 @@ dv_trgt::init(synfig::ProgressCallback * /* cb */)
 	return true;
 }
 
-void
+bool
 dv_trgt::end_frame()
 {
 	fprintf(file, " ");
 	fflush(file);
 	imagecount++;
+	return true;
 }
 
 bool
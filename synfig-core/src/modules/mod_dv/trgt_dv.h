@@ -67,7 +67,7 @@ public:
 	bool init(synfig::ProgressCallback* cb) override;
 
 	bool start_frame(synfig::ProgressCallback* cb) override;
-	void end_frame() override;
+	bool end_frame() override;
 
 	synfig::Color* start_scanline(int scanline) override;
 	bool end_scanline() override;
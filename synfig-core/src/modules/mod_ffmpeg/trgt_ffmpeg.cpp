@@ -380,12 +380,13 @@ ffmpeg_trgt::init(ProgressCallback* cb = nullptr)
 	return true;
 }
 
-void
+bool
 ffmpeg_trgt::end_frame()
 {
 	//fprintf(file, " ");
 	fflush(file);
 	imagecount++;
+	return true;
 }
 
 bool
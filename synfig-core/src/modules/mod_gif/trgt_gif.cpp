@@ -38,6 +38,7 @@
 #include <synfig/localization.h>
 #include <synfig/general.h>
 #include <synfig/color.h>
+#include <synfig/threadpool.h>
 
 #include <glib/gstdio.h>
 #include "trgt_gif.h"
@@ -51,6 +52,19 @@ using namespace etl;
 
 #define MAX_FRAME_RATE	(20.0)
 
+// rows per task for parallel quantization
+#define QUANTIZE_ROWS	(32)
+
+static const int bayer_matrix[8][8] = {
+	{  0, 32,  8, 40,  2, 34, 10, 42 },
+	{ 48, 16, 56, 24, 50, 18, 58, 26 },
+	{ 12, 44,  4, 36, 14, 46,  6, 38 },
+	{ 60, 28, 52, 20, 62, 30, 54, 22 },
+	{  3, 35, 11, 43,  1, 33,  9, 41 },
+	{ 51, 19, 59, 27, 49, 17, 57, 25 },
+	{ 15, 47,  7, 39, 13, 45,  5, 37 },
+	{ 63, 31, 55, 23, 61, 29, 53, 21 } };
+
 /* === G L O B A L S ======================================================= */
 
 SYNFIG_TARGET_INIT(gif);
@@ -60,7 +74,7 @@ SYNFIG_TARGET_SET_VERSION(gif,"0.1");
 
 /* === M E T H O D S ======================================================= */
 
-gif::gif(const char *filename_, const synfig::TargetParam & /* params */):
+gif::gif(const char *filename_, const synfig::TargetParam &params):
 	bs(),
 	filename(filename_),
 	file( (filename=="-")?stdout:g_fopen(filename_,POPEN_BINARY_WRITE_TYPE) ),
@@ -75,6 +89,7 @@ gif::gif(const char *filename_, const synfig::TargetParam & /* params */):
 	lossy(true),
 	multi_image(false),
 	dithering(true),
+	ordered_dithering(params.ordered_dithering),
 	color_bits(8),
 	iframe_density(30),
 	loop_count(0x7fff),
@@ -206,6 +221,55 @@ gif::start_frame(synfig::ProgressCallback *callback)
 }
 
 void
+gif::quantize_rows(const PaletteLookup *lookup, int begin, int end)
+{
+	const int w = desc.get_w();
+	const ColorReal spread = ordered_dithering && dithering
+		? 1/std::cbrt(ColorReal(std::max((int)curr_palette.size(), 2))) : 0;
+
+	for(int y = begin; y < end; ++y) {
+		const Color *src = curr_surface[y];
+		unsigned char *dst = curr_frame[y];
+		for(int x = 0; x < w; ++x) {
+			Color color = src[x].clamped();
+			if (spread) {
+				ColorReal offset = spread*((bayer_matrix[y%8][x%8] + ColorReal(0.5))/64 - ColorReal(0.5));
+				color.set_r(color.get_r() + offset);
+				color.set_g(color.get_g() + offset);
+				color.set_b(color.get_b() + offset);
+			}
+			dst[x] = (unsigned char)lookup->find_closest(color);
+		}
+	}
+}
+
+void
+gif::quantize_error_diffusion(const PaletteLookup &lookup)
+{
+	const int w = desc.get_w(), h = desc.get_h();
+	for(int y = 0; y < h; ++y) {
+		for(int x = 0; x < w; ++x) {
+			Color color(curr_surface[y][x].clamped());
+			int index = lookup.find_closest(color);
+			curr_frame[y][x] = (unsigned char)index;
+
+			// Floyd-Steinberg
+			Color error(color-curr_palette[index].color);
+			if(h>y+1)
+			{
+				if(x>0)
+					curr_surface[y+1][x-1]  += error * ((float)3/(float)16);
+				curr_surface[y+1][x]    += error * ((float)5/(float)16);
+				if(w>x+1)
+					curr_surface[y+1][x+1]  += error * ((float)1/(float)16);
+			}
+			if(w>x+1)
+				curr_surface[y][x+1]    += error * ((float)7/(float)16);
+		}
+	}
+}
+
+bool
 gif::end_frame()
 {
 	int w = desc.get_w(), h = desc.get_h();
@@ -237,7 +301,7 @@ gif::end_frame()
 
 	if(local_palette)
 	{
-		curr_palette = Palette(curr_surface, 256/(1<<(8-rootsize)) - build_off_previous - 1, Gamma());
+		curr_palette = Palette(curr_surface, std::max(1, 256/(1<<(8-rootsize)) - build_off_previous - 1), Gamma());
 		synfig::info("curr_palette.size()=%d",curr_palette.size());
 	}
 
@@ -315,32 +379,26 @@ gif::end_frame()
 	// Push a table reset into the bitstream
 	bs.push_value(1<<rootsize,codesize);
 
-	for(int cur_scanline=0;cur_scanline<desc.get_h();cur_scanline++)
+	// Map the frame to palette indices
 	{
-		//color_to_pixelformat(curr_frame[cur_scanline], curr_surface[cur_scanline], PF_GRAY, &gamma(), desc.get_w());
+		palette_lookup.reset(curr_palette, Gamma());
+		if(dithering && !ordered_dithering)
+			quantize_error_diffusion(palette_lookup);
+		else
+		{
+			ThreadPool::Group group;
+			for(int y=0;y<h;y+=QUANTIZE_ROWS)
+				group.enqueue(sigc::bind(sigc::mem_fun(this, &gif::quantize_rows), &palette_lookup, y, std::min(h, y+QUANTIZE_ROWS)));
+			group.run();
+		}
+	}
 
+	for(int cur_scanline=0;cur_scanline<desc.get_h();cur_scanline++)
+	{
 		// Now we compress it!
 		for(int i=0; i < w; ++i)
 		{
-			Color color(curr_surface[cur_scanline][i].clamped());
-			Palette::iterator iter(curr_palette.find_closest(color, Gamma()));
-
-			if(dithering)
-			{
-				Color error(color-iter->color);
-				//error*=0.25;
-				if(curr_surface.get_h()>cur_scanline+1)
-				{
-					curr_surface[cur_scanline+1][i-1]  += error * ((float)3/(float)16);
-					curr_surface[cur_scanline+1][i]    += error * ((float)5/(float)16);
-					if(curr_surface.get_w()>i+1)
-						curr_surface[cur_scanline+1][i+1]  += error * ((float)1/(float)16);
-				}
-				if(curr_surface.get_w()>i+1)
-					curr_surface[cur_scanline][i+1]    += error * ((float)7/(float)16);
-			}
-
-			curr_frame[cur_scanline][i]=iter-curr_palette.begin();
+			const Palette::iterator iter(curr_palette.begin() + curr_frame[cur_scanline][i]);
 
 			value=curr_frame[cur_scanline][i];
 			if(build_off_previous)
@@ -434,6 +492,7 @@ gif::end_frame()
 
 	fflush(file.get());
 	imagecount++;
+	return true;
 }
 
 synfig::Color*
@@ -185,15 +185,21 @@ private:
 	bool lossy;
 	bool multi_image;
 	bool dithering;
+	bool ordered_dithering;	// Bayer dithering, row-independent and stable between frames
 	int color_bits;
 	int iframe_density;
 	int loop_count;
 	bool local_palette;
 
 	synfig::Palette curr_palette;
+	synfig::PaletteLookup palette_lookup;	// allocated once, reset for each frame
 
 	void output_curr_palette();
 
+	// Fills curr_frame with palette indices
+	void quantize_rows(const synfig::PaletteLookup *lookup, int begin, int end);
+	void quantize_error_diffusion(const synfig::PaletteLookup &lookup);
+
 public:
 	gif(const char *filename, const synfig::TargetParam& /* params */);
 
@@ -203,7 +209,7 @@ public:
 	bool init(synfig::ProgressCallback* cb) override;
 
 	bool start_frame(synfig::ProgressCallback* cb) override;
-	void end_frame() override;
+	bool end_frame() override;
 
 	synfig::Color* start_scanline(int scanline) override;
 	bool end_scanline() override;
@@ -130,7 +130,7 @@ imagemagick_trgt::init(synfig::ProgressCallback * /* cb */)
 	return true;
 }
 
-void
+bool
 imagemagick_trgt::end_frame()
 {
 	if(file)
@@ -147,6 +147,7 @@ imagemagick_trgt::end_frame()
 	}
 	file=nullptr;
 	imagecount++;
+	return true;
 }
 
 bool
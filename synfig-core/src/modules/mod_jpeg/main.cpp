@@ -58,7 +58,7 @@ MODULE_INVENTORY_BEGIN(mod_jpeg)
 		TARGET_EXT(jpeg_trgt,"jpg")
 	END_TARGETS
 	BEGIN_IMPORTERS
-		IMPORTER_EXT(jpeg_mptr,"jpg")
-		IMPORTER_EXT(jpeg_mptr,"jpeg")
+		IMPORTER_EXT_PARALLEL(jpeg_mptr,"jpg")
+		IMPORTER_EXT_PARALLEL(jpeg_mptr,"jpeg")
 	END_IMPORTERS
 MODULE_INVENTORY_END
@@ -162,7 +162,7 @@ jpeg_trgt::start_frame(synfig::ProgressCallback *callback)
 	return true;
 }
 
-void
+bool
 jpeg_trgt::end_frame()
 {
 	if(ready)
@@ -176,6 +176,7 @@ jpeg_trgt::end_frame()
 		fclose(file);
 	file=nullptr;
 	imagecount++;
+	return true;
 }
 
 Color *
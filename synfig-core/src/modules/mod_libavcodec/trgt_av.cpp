@@ -476,9 +476,9 @@ Target_LibAVCodec::set_rend_desc(RendDesc *given_desc)
 	return true;
 }
 
-void
+bool
 Target_LibAVCodec::end_frame()
-	{ internal->encode_frame(surface, curr_frame_ > desc.get_frame_end()); }
+	{ return internal->encode_frame(surface, curr_frame_ > desc.get_frame_end()); }
 
 bool
 Target_LibAVCodec::start_frame(synfig::ProgressCallback */*callback*/)
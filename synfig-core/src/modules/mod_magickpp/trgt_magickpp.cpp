@@ -243,13 +243,14 @@ magickpp_trgt::init(synfig::ProgressCallback*)
 	return true;
 }
 
-void
+bool
 magickpp_trgt::end_frame()
 {
 	Magick::Image image(width, height, "RGBA", Magick::CharPixel, start_pointer);
 	if (transparent && images.begin() != images.end())
 		(images.end()-1)->gifDisposeMethod(Magick::BackgroundDispose);
 	images.push_back(image);
+	return true;
 }
 
 bool
@@ -245,7 +245,7 @@ cleanup_on_error:
 	return false;
 }
 
-void
+bool
 mng_trgt::end_frame()
 {
 	// synfig::info("%s:%d mng_trgt::end_frame()", __FILE__, __LINE__);
@@ -253,12 +253,12 @@ mng_trgt::end_frame()
 	if (deflate(&zstream,Z_FINISH) != Z_STREAM_END)
 	{
 		synfig::error("%s:%d deflate()", __FILE__, __LINE__);
-		return;
+		return false;
 	}
 	if (deflateEnd(&zstream) != Z_OK)
 	{
 		synfig::error("%s:%d deflateEnd()", __FILE__, __LINE__);
-		return;
+		return false;
 	}
 	if (mng != MNG_NULL)
 	{
@@ -267,6 +267,7 @@ mng_trgt::end_frame()
 	}
 	imagecount++;
 	ready=false;
+	return true;
 }
 
 bool
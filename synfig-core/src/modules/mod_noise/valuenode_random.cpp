@@ -39,6 +39,7 @@
 #include <synfig/valuenode_registry.h>
 #include <synfig/general.h>
 #include <synfig/localization.h>
+#include <synfig/settimesession.h>
 #include "synfig/color.h"
 #include <synfig/vector.h>
 
@@ -118,6 +119,14 @@ ValueNode_Random::~ValueNode_Random()
 
 ValueBase
 ValueNode_Random::operator()(Time t)const
+{
+	// generator is reseeded while calculation, so threads of set_time() must not share it
+	return SetTimeSession::evaluate_stateful(*this, t,
+		sigc::mem_fun(*this, &ValueNode_Random::calculate) );
+}
+
+ValueBase
+ValueNode_Random::calculate(Time t)const
 {
 	typedef const RandomNoise::SmoothType Smooth;
 
@@ -55,6 +55,9 @@ class ValueNode_Random : public LinkableValueNode
 
 	ValueNode_Random(const ValueBase &value);
 
+	//! Reseeds the generator, see operator()()
+	ValueBase calculate(Time t)const;
+
 public:
 	typedef etl::handle<ValueNode_Random> Handle;
 	typedef etl::handle<const ValueNode_Random> ConstHandle;
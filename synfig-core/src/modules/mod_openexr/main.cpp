@@ -36,11 +36,26 @@
 #warning HAVE_CONFIG_H not defined!
 #endif
 
+#include <thread>
+
 #include <synfig/module.h>
 #include "trgt_openexr.h"
 #include "mptr_openexr.h"
+
+#include <OpenEXR/ImfThreading.h>
 #endif
 
+/* === P R O C E D U R E S ================================================= */
+
+bool openexr_constructor(synfig::ProgressCallback * /* cb */)
+{
+	// let OpenEXR compress and decompress blocks on its own worker threads,
+	// the thread count is process-wide, so it is set once here
+	if (Imf::globalThreadCount() == 0)
+		Imf::setGlobalThreadCount((int)std::thread::hardware_concurrency());
+	return true;
+}
+
 /* === E N T R Y P O I N T ================================================= */
 
 MODULE_DESC_BEGIN(mod_openexr)
@@ -49,6 +64,8 @@ MODULE_DESC_BEGIN(mod_openexr)
 	MODULE_AUTHOR("Industrial Light & Magic")
 	MODULE_VERSION("1.0.4")
 	MODULE_COPYRIGHT("OpenEXR Library is Copyright (c) 2003 Lucas Digital Ltd. LLC.")
+
+	MODULE_CONSTRUCTOR(openexr_constructor)
 MODULE_DESC_END
 
 MODULE_INVENTORY_BEGIN(mod_openexr)
@@ -34,9 +34,20 @@
 #endif
 
 #include "trgt_openexr.h"
+#include <algorithm>
 #include <cstdio>
 #include <ETL/stringf>
 
+#include <synfig/general.h>
+#include <synfig/localization.h>
+
+#include <OpenEXR/ImfChannelList.h>
+#include <OpenEXR/ImfFrameBuffer.h>
+#include <OpenEXR/ImfHeader.h>
+#include <OpenEXR/ImfOutputFile.h>
+#include <OpenEXR/ImfTileDescription.h>
+#include <OpenEXR/ImfTiledOutputFile.h>
+
 #endif
 
 /* === M A C R O S ========================================================= */
@@ -56,7 +67,27 @@ SYNFIG_TARGET_SET_VERSION(exr_trgt,"1.0.4");
 bool
 exr_trgt::ready()
 {
-	return (bool)exr_file;
+	return !frame_name.empty();
+}
+
+bool
+exr_trgt::parse_compression(const String &name, Imf::Compression &compression)
+{
+	static const struct { const char *name; Imf::Compression compression; } list[] = {
+		{ "none",  Imf::NO_COMPRESSION    },
+		{ "rle",   Imf::RLE_COMPRESSION   },
+		{ "zips",  Imf::ZIPS_COMPRESSION  },
+		{ "zip",   Imf::ZIP_COMPRESSION   },
+		{ "piz",   Imf::PIZ_COMPRESSION   },
+		{ "pxr24", Imf::PXR24_COMPRESSION },
+		{ "b44",   Imf::B44_COMPRESSION   },
+		{ "b44a",  Imf::B44A_COMPRESSION  },
+		{ "dwaa",  Imf::DWAA_COMPRESSION  },
+		{ "dwab",  Imf::DWAB_COMPRESSION  } };
+	for(size_t i = 0; i < sizeof(list)/sizeof(list[0]); ++i)
+		if (name == list[i].name)
+			{ compression = list[i].compression; return true; }
+	return false;
 }
 
 exr_trgt::exr_trgt(const char *Filename, const synfig::TargetParam &params):
@@ -64,20 +95,19 @@ exr_trgt::exr_trgt(const char *Filename, const synfig::TargetParam &params):
 	imagecount(0),
 	scanline(),
 	filename(Filename),
-	exr_file(nullptr),
-	buffer(nullptr),
-	buffer_color(nullptr)
+	compression(Imf::ZIP_COMPRESSION),
+	pixel_type(params.float_channels ? Imf::FLOAT : Imf::HALF),
+	tile_size(std::max(0, params.tile_size))
 {
 	// OpenEXR uses linear gamma
 	sequence_separator = params.sequence_separator;
+
+	if (!params.compression.empty() && !parse_compression(params.compression, compression))
+		synfig::warning(_("OpenEXR: unknown compression \"%s\", using zip"), params.compression.c_str());
 }
 
 exr_trgt::~exr_trgt()
-{
-	if(exr_file) delete exr_file;
-	if(buffer) delete [] buffer;
-	if(buffer_color) delete [] buffer_color;
-}
+	{ }
 
 bool
 exr_trgt::set_rend_desc(RendDesc *given_desc)
@@ -97,10 +127,6 @@ exr_trgt::start_frame(synfig::ProgressCallback *cb)
 {
 	int w=desc.get_w(),h=desc.get_h();
 
-	String frame_name;
-
-	if(exr_file)
-		delete exr_file;
 	if(multi_image)
 	{
 		frame_name = (filename_sans_extension(filename) +
@@ -114,59 +140,75 @@ exr_trgt::start_frame(synfig::ProgressCallback *cb)
 		frame_name=filename;
 		if(cb)cb->task(filename);
 	}
-	exr_file=new Imf::RgbaOutputFile(frame_name.c_str(),w,h,Imf::WRITE_RGBA,desc.get_pixel_aspect());
-	if(buffer_color) delete [] buffer_color;
-	buffer_color=new Color[w];
-	//if(buffer) delete [] buffer;
-	//buffer=new Imf::Rgba[w];
-	out_surface.set_wh(w,h);
+	surface.set_wh(w,h);
 
 	return true;
 }
 
-void
+bool
 exr_trgt::end_frame()
 {
-	if(exr_file)
+	bool success = ready();
+	if(success)
 	{
-		exr_file->setFrameBuffer(out_surface[0],1,desc.get_w());
-		exr_file->writePixels(desc.get_h());
-
-		delete exr_file;
+		const int w = desc.get_w(), h = desc.get_h();
+
+		Imf::Header header(w, h, desc.get_pixel_aspect());
+		header.compression() = compression;
+		header.channels().insert("R", Imf::Channel(pixel_type));
+		header.channels().insert("G", Imf::Channel(pixel_type));
+		header.channels().insert("B", Imf::Channel(pixel_type));
+		header.channels().insert("A", Imf::Channel(pixel_type));
+
+		// slice the channels directly out of the frame,
+		// OpenEXR converts them to half on write when the file channels are half
+		char *base = reinterpret_cast<char*>(surface[0]);
+		const size_t xstride = sizeof(Color);
+		const size_t ystride = sizeof(Color)*w;
+		Imf::FrameBuffer frame_buffer;
+		frame_buffer.insert("R", Imf::Slice(Imf::FLOAT, base + 0*sizeof(ColorReal), xstride, ystride));
+		frame_buffer.insert("G", Imf::Slice(Imf::FLOAT, base + 1*sizeof(ColorReal), xstride, ystride));
+		frame_buffer.insert("B", Imf::Slice(Imf::FLOAT, base + 2*sizeof(ColorReal), xstride, ystride));
+		frame_buffer.insert("A", Imf::Slice(Imf::FLOAT, base + 3*sizeof(ColorReal), xstride, ystride));
+
+		try
+		{
+			if (tile_size > 0)
+			{
+				header.setTileDescription(Imf::TileDescription(tile_size, tile_size, Imf::ONE_LEVEL));
+				Imf::TiledOutputFile file(frame_name.c_str(), header);
+				file.setFrameBuffer(frame_buffer);
+				file.writeTiles(0, file.numXTiles() - 1, 0, file.numYTiles() - 1);
+			}
+			else
+			{
+				Imf::OutputFile file(frame_name.c_str(), header);
+				file.setFrameBuffer(frame_buffer);
+				file.writePixels(h);
+			}
+		}
+		catch(const std::exception &e)
+		{
+			synfig::error("OpenEXR: unable to write \"%s\": %s", frame_name.c_str(), e.what());
+			success = false;
+		}
 	}
 
-	exr_file=0;
+	frame_name.clear();
 
 	imagecount++;
+	return success;
 }
 
 Color *
 exr_trgt::start_scanline(int i)
 {
 	scanline=i;
-	return reinterpret_cast<Color *>(buffer_color);
+	return surface[scanline];
 }
 
 bool
 exr_trgt::end_scanline()
 {
-	if(!ready())
-		return false;
-
-	int i;
-	for(i=0;i<desc.get_w();i++)
-	{
-//		Imf::Rgba &rgba=buffer[i];
-		Imf::Rgba &rgba=out_surface[scanline][i];
-		Color &color=buffer_color[i];
-		rgba.r=color.get_r();
-		rgba.g=color.get_g();
-		rgba.b=color.get_b();
-		rgba.a=color.get_a();
-	}
-
-    //exr_file->setFrameBuffer(buffer,1,desc.get_w());
-	//exr_file->writePixels(1);
-
-	return true;
+	return ready();
 }
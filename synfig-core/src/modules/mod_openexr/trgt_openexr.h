@@ -33,8 +33,8 @@
 #include <synfig/target_scanline.h>
 #include <synfig/string.h>
 #include <synfig/surface.h>
-#include <OpenEXR/ImfArray.h>
-#include <OpenEXR/ImfRgbaFile.h>
+#include <OpenEXR/ImfCompression.h>
+#include <OpenEXR/ImfPixelType.h>
 
 /* === M A C R O S ========================================================= */
 
@@ -52,14 +52,20 @@ private:
 	bool multi_image;
 	int imagecount,scanline;
 	synfig::String filename;
-	Imf::RgbaOutputFile *exr_file;
-	Imf::Rgba *buffer;
-	etl::surface<Imf::Rgba> out_surface;
-	synfig::Color *buffer_color;
+	synfig::String frame_name;
+	//! Rendered frame, channels are sliced straight out of synfig::Color
+	synfig::Surface surface;
+
+	Imf::Compression compression;
+	Imf::PixelType pixel_type;
+	//! Tile width and height, zero for scanline files
+	int tile_size;
 
 	bool ready();
 	synfig::String sequence_separator;
 
+	static bool parse_compression(const synfig::String &name, Imf::Compression &compression);
+
 public:
 
 	exr_trgt(const char *filename, const synfig::TargetParam& /* params */);
@@ -68,7 +74,7 @@ public:
 	bool set_rend_desc(synfig::RendDesc* desc) override;
 
 	bool start_frame(synfig::ProgressCallback* cb) override;
-	void end_frame() override;
+	bool end_frame() override;
 
 	synfig::Color* start_scanline(int scanline) override;
 	bool end_scanline() override;
@@ -59,7 +59,7 @@ MODULE_INVENTORY_BEGIN(mod_png)
 		TARGET_EXT(png_trgt, "png")
 	END_TARGETS
 	BEGIN_IMPORTERS
-		IMPORTER(png_mptr)
+		IMPORTER_PARALLEL(png_mptr)
 		IMPORTER_EXT(png_mptr, "kra")
 		IMPORTER_EXT(png_mptr, "ora")
 	END_IMPORTERS
@@ -113,7 +113,7 @@ png_trgt::set_rend_desc(RendDesc *given_desc)
 	return true;
 }
 
-void
+bool
 png_trgt::end_frame()
 {
 	if(ready && file)
@@ -127,6 +127,7 @@ png_trgt::end_frame()
 	file=nullptr;
 	imagecount++;
 	ready=false;
+	return true;
 }
 
 bool
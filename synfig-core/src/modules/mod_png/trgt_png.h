@@ -68,7 +68,7 @@ public:
 	bool set_rend_desc(synfig::RendDesc* desc) override;
 
 	bool start_frame(synfig::ProgressCallback* cb) override;
-	void end_frame() override;
+	bool end_frame() override;
 
 	synfig::Color* start_scanline(int scanline) override;
 	bool end_scanline() override;};
@@ -206,7 +206,7 @@ png_trgt_spritesheet::set_rend_desc(RendDesc *given_desc)
     return true;
 }
 
-void
+bool
 png_trgt_spritesheet::end_frame()
 {
 	std::cout << "end_frame()" << std::endl;
@@ -233,6 +233,7 @@ png_trgt_spritesheet::end_frame()
 			cur_row = 0;
 		}
 	}
+	return true;
 }
 
 bool
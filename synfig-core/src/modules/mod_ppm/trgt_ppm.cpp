@@ -83,10 +83,11 @@ ppm::set_rend_desc(RendDesc *given_desc)
 	return true;
 }
 
-void
+bool
 ppm::end_frame()
 {
 	imagecount++;
+	return true;
 }
 
 bool
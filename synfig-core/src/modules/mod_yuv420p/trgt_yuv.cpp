@@ -123,7 +123,7 @@ yuv::end_scanline()
 	return static_cast<bool>(file);
 }
 
-void
+bool
 yuv::end_frame()
 {
 	const int w=desc.get_w(),h=desc.get_h();
@@ -229,4 +229,5 @@ yuv::end_frame()
 
 	// Flush out the frame
 	fflush(file.get());
+	return true;
 }
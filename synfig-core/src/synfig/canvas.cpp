@@ -50,6 +50,7 @@
 #include "importer.h"
 #include "layer.h"
 #include "loadcanvas.h"
+#include "settimesession.h"
 #include "valuenode_registry.h"
 
 #include "debug/measure.h"
@@ -92,6 +93,7 @@ int _CanvasCounter::counter(0);
 Canvas::Canvas(const String &id):
 	id_			(id),
 	version_	(CURRENT_CANVAS_VERSION),
+	children_index_valid_(true),
 	cur_time_	(0),
 	is_inline_	(false),
 	is_dirty_	(true),
@@ -425,6 +427,8 @@ Canvas::set_id(const String &x)
 	if(!valid_id(x))
 		throw std::runtime_error("Invalid ID");
 	id_=x;
+	if(parent_)
+		parent_->children_index_valid_=false;
 	signal_id_changed_();
 }
 
@@ -490,7 +494,25 @@ Canvas::set_time(Time t)const
 		const_cast<Canvas&>(*this).cur_time_=t;
 
 		is_dirty_=false;
-		get_independent_context().set_time(t);
+		if (SetTimeSession::current())
+		{
+			get_independent_context().set_time(t);
+		}
+		else
+		if (SetTimeSession::get_parallel())
+		{
+			// root of the time evaluation, sub-canvases share the session
+			SetTimeSession session;
+			SetTimeSession::Scope scope(&session);
+			SetTimeSession::Timer timer(this, get_file_name());
+			get_independent_context().set_time(t);
+		}
+		else
+		{
+			// serial evaluation, nothing to share between threads
+			SetTimeSession::Timer timer(is_root() ? this : nullptr, get_file_name());
+			get_independent_context().set_time(t);
+		}
 	}
 	is_dirty_=false;
 }
@@ -783,13 +805,10 @@ Canvas::surefind_canvas(const String &id, String &warnings)
 	// request is for this immediate canvas
 	if(id.find_first_of(':')==std::string::npos)
 	{
-		Children::iterator iter;
-
 		// Search for the image in the image list,
 		// and return it if it is found
-		for(iter=children().begin();iter!=children().end();iter++)
-			if(id==(*iter)->get_id())
-				return *iter;
+		if(Handle child_canvas=find_child_canvas(id))
+			return child_canvas;
 
 		// Create a new canvas and return it
 		//synfig::warning("Implicitly creating canvas named "+id);
@@ -869,13 +888,10 @@ Canvas::find_canvas(const String &id, String &warnings)const
 	// request is for this immediate canvas
 	if(id.find_first_of(':')==std::string::npos)
 	{
-		Children::const_iterator iter;
-
 		// Search for the image in the image list,
 		// and return it if it is found
-		for(iter=children().begin();iter!=children().end();iter++)
-			if(id==(*iter)->get_id())
-				return *iter;
+		if(Handle child_canvas=find_child_canvas(id))
+			return child_canvas;
 
 		throw Exception::IDNotFound("Child Canvas in Parent Canvas: (child)"+id);
 	}
@@ -1079,8 +1095,8 @@ Canvas::new_child_canvas()
 		return parent_->new_child_canvas();
 
 	// Create a new canvas
-	children().push_back(create());
-	Canvas::Handle canvas(children().back());
+	children_.push_back(create());
+	Canvas::Handle canvas(children_.back());
 
 	canvas->rend_desc()=rend_desc();
 	canvas->set_parent(this);
@@ -1095,12 +1111,13 @@ Canvas::new_child_canvas(const String &id)
 		return parent_->new_child_canvas(id);
 
 	// Create a new canvas
-	children().push_back(create());
-	Canvas::Handle canvas(children().back());
+	children_.push_back(create());
+	Canvas::Handle canvas(children_.back());
 
 	canvas->set_id(id);
 	canvas->rend_desc()=rend_desc();
 	canvas->set_parent(this);
+	index_last_child_canvas();
 
 	return canvas;
 }
@@ -1128,8 +1145,9 @@ Canvas::add_child_canvas(Canvas::Handle child_canvas, const synfig::String& id)
 		if(child_canvas->is_inline())
 			child_canvas->is_inline_=false;
 		child_canvas->id_=id;
-		children().push_back(child_canvas);
+		children_.push_back(child_canvas);
 		child_canvas->set_parent(this);
+		index_last_child_canvas();
 	}
 
 	return child_canvas;
@@ -1144,13 +1162,41 @@ Canvas::remove_child_canvas(Canvas::Handle child_canvas)
 	if(child_canvas->parent_!=this)
 		throw std::runtime_error("Given child does not belong to me");
 
-	if(find(children().begin(),children().end(),child_canvas)==children().end())
+	if(find(children_.begin(),children_.end(),child_canvas)==children_.end())
 		throw Exception::IDNotFound(child_canvas->get_id());
 
-	children().remove(child_canvas);
+	children_.remove(child_canvas);
+	children_index_valid_=false;
 	child_canvas->set_parent(nullptr);
 }
 
+Canvas::Handle
+Canvas::find_child_canvas(const String &id)const
+{
+	std::lock_guard<std::mutex> lock(children_index_mutex_);
+
+	Children &children = const_cast<Children&>(children_);
+	if(!children_index_valid_)
+	{
+		// keep the first canvas for duplicated ids, like the linear search did
+		children_index_.clear();
+		for(Children::iterator iter=children.begin();iter!=children.end();++iter)
+			children_index_.insert(std::make_pair((*iter)->get_id(), iter));
+		children_index_valid_=true;
+	}
+
+	std::unordered_map<String, Children::iterator>::const_iterator i=children_index_.find(id);
+	return i==children_index_.end() ? Handle() : *i->second;
+}
+
+void
+Canvas::index_last_child_canvas()
+{
+	std::lock_guard<std::mutex> lock(children_index_mutex_);
+	if(children_index_valid_)
+		children_index_.insert(std::make_pair(children_.back()->get_id(), --children_.end()));
+}
+
 void
 Canvas::set_parent(const Canvas::LooseHandle &parent)
 {
@@ -1165,7 +1211,7 @@ Canvas::on_parent_set()
 {
 	// parent canvas is important field,
 	// so assume that canvas replaced for layers
-	for(std::list<Handle>::iterator i = children().begin(); i != children().end(); ++i)
+	for(std::list<Handle>::iterator i = children_.begin(); i != children_.end(); ++i)
 		(*i)->on_parent_set();
 	for(iterator i = begin(); *i; ++i)
 		(*i)->on_canvas_set();
@@ -31,8 +31,11 @@
 
 /* === H E A D E R S ======================================================= */
 
+#include <atomic>
 #include <map>
 #include <list>
+#include <mutex>
+#include <unordered_map>
 #include <ETL/handle>
 #include <sigc++/signal.h>
 #include <sigc++/connection.h>
@@ -234,6 +237,13 @@ private:
 	/*!	\see children() */
 	Children children_;
 
+	//! Hash index of children_ by id, used by find_canvas() and surefind_canvas().
+	//! It is rebuilt on demand after children() was accessed for modification
+	//! or a child was renamed.
+	mutable std::unordered_map<String, Children::iterator> children_index_;
+	mutable std::atomic<bool> children_index_valid_;
+	mutable std::mutex children_index_mutex_;
+
 	//! Render Description for Canvas
 	/*!	\see rend_desc() */
 	RendDesc desc_;
@@ -461,7 +471,7 @@ public:
 	LooseHandle get_non_inline_ancestor()const;
 
 	//! Returns a list of all child canvases in this canvas
-	std::list<Handle> &children() { return children_; }
+	std::list<Handle> &children() { children_index_valid_ = false; return children_; }
 
 	//! Returns a list of all child canvases in this canvas
 	const std::list<Handle> &children()const { return children_; }
@@ -697,6 +707,11 @@ public:
 private:
 	//! Sets parent and raises on_parent_set event
 	void set_parent(const Canvas::LooseHandle &parent);
+	//! Finds a direct child Canvas by its \a id through children_index_
+	//! \return found canvas or an empty handle
+	Handle find_child_canvas(const String &id)const;
+	//! Adds the last item of children_ to children_index_
+	void index_last_child_canvas();
 	//! Adds a \layer to a group given by its \group string to the group
 	//! database
 	void add_group_pair(String group, etl::handle<Layer> layer);
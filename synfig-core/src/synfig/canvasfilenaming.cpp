@@ -42,6 +42,7 @@
 #include "filesystemgroup.h"
 #include "filesystemtemporary.h"
 #include "importer.h"
+#include "module.h"
 
 #endif
 
@@ -82,6 +83,7 @@ CanvasFileNaming::append_directory_separator(const String &path)
 String
 CanvasFileNaming::content_folder_by_extension(const String &ext)
 {
+	Module::require(Module::BOOK_IMPORTER, ext);
 	if (Importer::book().count(ext))
 		return "images";
 	if (ext == "pgo" || ext == "tsv" || ext == "xml")
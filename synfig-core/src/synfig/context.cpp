@@ -417,7 +417,10 @@ Context::build_rendering_task() const
 	if (!*context)
 		return rendering::Task::Handle();
 	else {
-		if (context.get_params().force_set_time)
+		const ContextParams &params = context.get_params();
+		if ( params.force_set_time
+		  && ( !params.force_set_time_layers
+			|| params.force_set_time_layers->count((*context).get()) ))
 			context.set_time((*context)->get_time_mark(), true);
 		return (*context)->build_rendering_task(context.get_next());
 	}
@@ -31,6 +31,9 @@
 
 /* === H E A D E R S ======================================================= */
 
+#include <memory>
+#include <set>
+
 #include "canvas.h"
 #include "rect.h"
 #include "renddesc.h"
@@ -101,6 +104,8 @@ public:
 	Real z_range_blur;
 	//! Force set_time (to current time mark) at every rendering
 	bool force_set_time;
+	//! When not null, force_set_time applies to these layers only
+	std::shared_ptr< const std::set<const Layer*> > force_set_time_layers;
 
 	explicit ContextParams(bool render_excluded_contexts = false):
 	render_excluded_contexts(render_excluded_contexts),
@@ -36,6 +36,13 @@
 #include <stdint.h>
 #include <cstddef>
 
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
 #include <libxml++/libxml++.h>
 #include <glib/gstdio.h>
 
@@ -218,6 +225,82 @@ namespace synfig
 
 using namespace synfig::FileContainerZip_InternalStructs;
 
+//! Read-only view of the whole storage file,
+//! it lives while container or any of mapped streams uses it
+struct FileContainerZip::StorageMap
+{
+	const char *data;
+	size_t size;
+#ifdef _WIN32
+	HANDLE mapping;
+#endif
+
+	StorageMap(const StorageMap&) = delete;
+	StorageMap& operator=(const StorageMap&) = delete;
+
+	StorageMap():
+		data(nullptr),
+		size(0)
+#ifdef _WIN32
+		, mapping(nullptr)
+#endif
+	{ }
+
+	~StorageMap()
+	{
+#ifdef _WIN32
+		if (data) UnmapViewOfFile(data);
+		if (mapping) CloseHandle(mapping);
+#else
+		if (data) munmap(const_cast<char*>(data), size);
+#endif
+	}
+
+	static std::shared_ptr<StorageMap> create(FILE *f, file_size_t size)
+	{
+		if (!f || size <= 0 || (unsigned long long)size > (unsigned long long)(size_t)-1)
+			return std::shared_ptr<StorageMap>();
+
+		std::shared_ptr<StorageMap> map(new StorageMap());
+		map->size = (size_t)size;
+#ifdef _WIN32
+		HANDLE file = (HANDLE)_get_osfhandle(_fileno(f));
+		if (file == INVALID_HANDLE_VALUE)
+			return std::shared_ptr<StorageMap>();
+		map->mapping = CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!map->mapping)
+			return std::shared_ptr<StorageMap>();
+		map->data = (const char*)MapViewOfFile(map->mapping, FILE_MAP_READ, 0, 0, map->size);
+#else
+		void *data = mmap(nullptr, map->size, PROT_READ, MAP_SHARED, fileno(f), 0);
+		map->data = data == MAP_FAILED ? nullptr : (const char*)data;
+#endif
+		if (!map->data)
+			return std::shared_ptr<StorageMap>();
+		return map;
+	}
+};
+
+FileContainerZip::MappedReadStream::MappedReadStream(
+	FileSystem::Handle file_system,
+	const std::shared_ptr<StorageMap> &storage_map,
+	const char *begin,
+	size_t size
+):
+	FileSystem::ReadStream(file_system),
+	storage_map_(storage_map)
+{
+	// whole entry is the get area of stream buffer,
+	// so it is read without intermediate copies and calls of internal_read
+	char *b = const_cast<char*>(begin);
+	setg(b, b, b + size);
+}
+
+FileContainerZip::MappedReadStream::~MappedReadStream() { }
+
+size_t FileContainerZip::MappedReadStream::internal_read(void * /* buffer */, size_t /* size */)
+	{ return 0; }
+
 void FileContainerZip::FileInfo::split_name()
 {
 	size_t pos = name.rfind('/');
@@ -235,6 +318,7 @@ void FileContainerZip::FileInfo::split_name()
 
 FileContainerZip::FileContainerZip():
 storage_file_(nullptr),
+memory_mapping_(true),
 prev_storage_size_(0),
 file_reading_whole_container_(false),
 file_reading_(false),
@@ -501,6 +585,8 @@ bool FileContainerZip::open_from_history(const String &container_filename, file_
 
 	// loaded
 	fseek(f, 0, SEEK_END);
+	if (memory_mapping_)
+		storage_map_ = StorageMap::create(f, actual_filesize);
 	storage_file_ = f;
 	files_.swap( files );
 	prev_storage_size_ = actual_filesize;
@@ -610,7 +696,9 @@ void FileContainerZip::close()
 
 	save();
 
-	// close storage file and clead variables
+	// close storage file and clead variables,
+	// mapped streams keep the mapping until they are destroyed
+	storage_map_.reset();
 	fclose(storage_file_);
 	storage_file_ = nullptr;
 	files_.clear();
@@ -840,8 +928,43 @@ size_t FileContainerZip::file_write(const void *buffer, size_t size)
 	return s;
 }
 
+FileSystem::ReadStream::Handle FileContainerZip::get_mapped_read_stream(const FileInfo &info)
+{
+	if (!storage_map_ || info.is_directory)
+		return FileSystem::ReadStream::Handle();
+
+	// entries written after opening are placed out of the mapped area
+	const StorageMap &map = *storage_map_;
+	if (info.header_offset < 0 || info.size < 0
+	 || info.header_offset + (file_size_t)sizeof(LocalFileHeader) > (file_size_t)map.size)
+		return FileSystem::ReadStream::Handle();
+
+	LocalFileHeader lfh;
+	memcpy(&lfh, map.data + info.header_offset, sizeof(lfh));
+	if (lfh.signature != LocalFileHeader::valid_signature__)
+		return FileSystem::ReadStream::Handle();
+
+	file_size_t offset = info.header_offset + sizeof(lfh) + lfh.filename_length + lfh.extrafield_length;
+	if (offset + info.size > (file_size_t)map.size)
+		return FileSystem::ReadStream::Handle();
+
+	FileSystem::ReadStream::Handle stream(
+		new MappedReadStream(this, storage_map_, map.data + offset, (size_t)info.size) );
+	if (info.compression > 0)
+		return new ZReadStream(stream, zstreambuf::compression::deflate);
+	return stream;
+}
+
 FileSystem::ReadStream::Handle FileContainerZip::get_read_stream(const String &filename)
 {
+	if (storage_map_)
+	{
+		FileMap::const_iterator i = files_.find(fix_slashes(filename));
+		if (i != files_.end())
+			if (FileSystem::ReadStream::Handle stream = get_mapped_read_stream(i->second))
+				return stream;
+	}
+
 	FileSystem::ReadStream::Handle stream = FileContainer::get_read_stream(filename);
 	if (stream
 	 && file_is_opened_for_read()
@@ -31,6 +31,7 @@
 /* === H E A D E R S ======================================================= */
 
 #include <map>
+#include <memory>
 #include <ctime>
 #include "filecontainer.h"
 
@@ -45,6 +46,9 @@ namespace synfig
 
 	class FileContainerZip: public FileContainer
 	{
+	private:
+		struct StorageMap;
+
 	public:
 		typedef etl::handle<FileContainerZip> Handle;
 
@@ -60,6 +64,23 @@ namespace synfig
 			virtual size_t read(void *buffer, size_t size);
 		};
 
+		//! Reads the entry directly from the memory-mapped container.
+		//! Stream doesn't occupy the container, so several entries
+		//! may be read at the same time, also from the different threads.
+		class MappedReadStream : public FileSystem::ReadStream
+		{
+		public:
+			typedef etl::handle<MappedReadStream> Handle;
+		private:
+			std::shared_ptr<StorageMap> storage_map_;
+		protected:
+			friend class FileContainerZip;
+			MappedReadStream(FileSystem::Handle file_system, const std::shared_ptr<StorageMap> &storage_map, const char *begin, size_t size);
+			virtual size_t internal_read(void *buffer, size_t size);
+		public:
+			virtual ~MappedReadStream();
+		};
+
 		typedef long long int file_size_t;
 
 		struct HistoryRecord {
@@ -94,6 +115,8 @@ namespace synfig
 		typedef std::map< String, FileInfo > FileMap;
 
 		FILE *storage_file_;
+		std::shared_ptr<StorageMap> storage_map_;
+		bool memory_mapping_;
 		FileMap files_;
 		file_size_t prev_storage_size_;
 		bool file_reading_whole_container_;
@@ -108,6 +131,8 @@ namespace synfig
 		static HistoryRecord decode_history(const String &comment);
 		static void read_history(std::list<HistoryRecord> &list, FILE *f, file_size_t size);
 
+		FileSystem::ReadStream::Handle get_mapped_read_stream(const FileInfo &info);
+
 	public:
 		FileContainerZip();
 		virtual ~FileContainerZip();
@@ -119,6 +144,12 @@ namespace synfig
 		virtual bool is_opened();
 		bool save();
 
+		//! Map the storage file into memory when container will be opened,
+		//! entries of the mapped file are read without copying and locking (enabled by default)
+		void set_memory_mapping(bool enable) { memory_mapping_ = enable; }
+		bool get_memory_mapping() const { return memory_mapping_; }
+		bool is_memory_mapped() const { return (bool)storage_map_; }
+
 		static std::list<HistoryRecord> read_history(const String &container_filename);
 
 		virtual bool is_file(const String &filename);
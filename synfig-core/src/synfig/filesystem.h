@@ -69,7 +69,7 @@ namespace synfig
 
 		class ReadStream :
 			public Stream,
-			private std::streambuf,
+			protected std::streambuf,
 			public std::istream
 		{
 		public:
@@ -39,6 +39,7 @@
 #include <algorithm>
 #include <functional>
 #include <map>
+#include <mutex>
 
 #include <glibmm.h>
 
@@ -49,6 +50,7 @@
 
 #include "canvas.h"
 #include "importer.h"
+#include "module.h"
 #include "string.h"
 #include "surface.h"
 
@@ -67,6 +69,8 @@ using namespace synfig;
 Importer::Book* synfig::Importer::book_;
 
 static std::map<FileSystem::Identifier,Importer::LooseHandle> *__open_importers;
+//! guards __open_importers, importers may be preloaded in other threads
+static std::recursive_mutex __open_importers_mutex;
 
 /* === P R O C E D U R E S ================================================= */
 
@@ -107,10 +111,13 @@ Importer::open(const FileSystem::Identifier &identifier, bool force)
 
 	// If we already have an importer open under that filename,
 	// then use it instead.
-	if(__open_importers->count(identifier))
 	{
-		//synfig::info("Found importer already open, using it...");
-		return (*__open_importers)[identifier];
+		std::lock_guard<std::recursive_mutex> lock(__open_importers_mutex);
+		if(__open_importers->count(identifier))
+		{
+			//synfig::info("Found importer already open, using it...");
+			return (*__open_importers)[identifier];
+		}
 	}
 
 	if(filename_extension(identifier.filename) == "")
@@ -124,6 +131,7 @@ Importer::open(const FileSystem::Identifier &identifier, bool force)
 	std::transform(ext.begin(),ext.end(),ext.begin(),&::tolower);
 
 
+	Module::require(Module::BOOK_IMPORTER, ext);
 	if(!Importer::book().count(ext))
 	{
 		synfig::error(_("Importer::open(): Unknown file type -- ")+ext);
@@ -133,6 +141,7 @@ Importer::open(const FileSystem::Identifier &identifier, bool force)
 	try {
 		Importer::Handle importer;
 		importer=Importer::book()[ext].factory(identifier);
+		std::lock_guard<std::recursive_mutex> lock(__open_importers_mutex);
 		(*__open_importers)[identifier]=importer;
 		return importer;
 	}
@@ -143,8 +152,50 @@ Importer::open(const FileSystem::Identifier &identifier, bool force)
 	return nullptr;
 }
 
+Importer::Handle
+Importer::preload(const FileSystem::Identifier &identifier, const FileSystem::Identifier &source)
+{
+	String ext(filename_extension(identifier.filename));
+	if (ext.size()) ext = ext.substr(1); // skip initial '.'
+	std::transform(ext.begin(),ext.end(),ext.begin(),&::tolower);
+
+	Book::const_iterator entry = book().find(ext);
+	if (entry == book().end() || !entry->second.supports_parallel_loading)
+		return nullptr;
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(__open_importers_mutex);
+		std::map<FileSystem::Identifier,Importer::LooseHandle>::const_iterator i = __open_importers->find(identifier);
+		if (i != __open_importers->end())
+			return i->second;
+	}
+
+	// errors will be reported by open() called later in usual way
+	Importer::Handle importer;
+	try
+	{
+		importer = entry->second.factory(source);
+		if (!importer || importer->is_animated())
+			return nullptr;
+		if (!importer->get_frame(RendDesc(), Time(0))->is_exists())
+			return nullptr;
+	}
+	catch (...)
+	{
+		return nullptr;
+	}
+
+	std::lock_guard<std::recursive_mutex> lock(__open_importers_mutex);
+	Importer::LooseHandle &open_importer = (*__open_importers)[identifier];
+	if (open_importer)
+		return open_importer;
+	open_importer = importer;
+	return importer;
+}
+
 void Importer::forget(const FileSystem::Identifier &identifier)
 {
+	std::lock_guard<std::recursive_mutex> lock(__open_importers_mutex);
 	__open_importers->erase(identifier);
 }
 
@@ -157,6 +208,7 @@ Importer::Importer(const FileSystem::Identifier &identifier):
 Importer::~Importer()
 {
 	// Remove ourselves from the open importer list
+	std::lock_guard<std::recursive_mutex> lock(__open_importers_mutex);
 	std::map<FileSystem::Identifier,Importer::LooseHandle>::iterator iter;
 	for(iter=__open_importers->begin();iter!=__open_importers->end();)
 		if(iter->second==this)
@@ -120,10 +120,13 @@ public:
 	{
 		Factory factory;
 		bool supports_file_system_wrapper;
+		//! importer doesn't use shared state, so it may be created and decode
+		//! the frame simultaneously with other importers, see preload()
+		bool supports_parallel_loading;
 
-		BookEntry(): factory(nullptr), supports_file_system_wrapper(false) { }
-		BookEntry(Factory factory, bool supports_file_system_wrapper):
-		factory(factory), supports_file_system_wrapper(supports_file_system_wrapper)
+		BookEntry(): factory(nullptr), supports_file_system_wrapper(false), supports_parallel_loading(false) { }
+		BookEntry(Factory factory, bool supports_file_system_wrapper, bool supports_parallel_loading = false):
+		factory(factory), supports_file_system_wrapper(supports_file_system_wrapper), supports_parallel_loading(supports_parallel_loading)
 		{ }
 	};
 
@@ -172,6 +175,14 @@ public:
 
 	//! Attempts to open \a filename, and returns a handle to the associated Importer
 	static Handle open(const FileSystem::Identifier &identifier, bool force=false);
+
+	//! Opens the importer of the static image and decodes its frame, so the following
+	//! open() will return ready importer. Unlike open() it may be called from any thread,
+	//! but it doesn't load modules and skips importers which don't support parallel loading.
+	//! \param identifier the file which will be passed to open()
+	//! \param source the same file in the file system which is safe for simultaneous reading
+	//! \return importer, it should be kept until the file will be opened by open()
+	static Handle preload(const FileSystem::Identifier &identifier, const FileSystem::Identifier &source);
 	static void forget(const FileSystem::Identifier &identifier);
 };
 
@@ -48,6 +48,7 @@
 #include "context.h"
 #include "surface.h"
 #include "paramdesc.h"
+#include "settimesession.h"
 #include "transform.h"
 
 #include "layers/layer_composite.h"
@@ -69,6 +70,7 @@
 #include "rendering/common/task/tasklayer.h"
 
 #include "importer.h"
+#include "module.h"
 #include <atomic>
 #include <giomm.h>
 
@@ -166,6 +168,7 @@ Layer::Layer():
 	active_(true),
 	optimized_(false),
 	exclude_from_rendering_(false),
+	dynamic_param_slots_valid_(false),
 	param_z_depth(Real(0.0f)),
 	time_mark(Time::end()),
 	outline_grow_mark(0.0)
@@ -178,6 +181,7 @@ Layer::Layer():
 Layer::LooseHandle
 synfig::Layer::create(const String &name)
 {
+	Module::require(Module::BOOK_LAYER, name);
 	if(!book().count(name))
 	{
 		return Layer::LooseHandle(new Layer_Mime(name));
@@ -324,6 +328,7 @@ Layer::connect_dynamic_param(const String& param, etl::loose_handle<ValueNode> v
 		return true;
 
 	dynamic_param_list_[param]=ValueNode::Handle(value_node);
+	dynamic_param_slots_valid_ = false;
 
 	if (previous)
 	{
@@ -357,6 +362,7 @@ Layer::disconnect_dynamic_param(const String& param)
 
 	ValueNode::Handle previous(i->second);
 	dynamic_param_list_.erase(i);
+	dynamic_param_slots_valid_ = false;
 
 	if(previous)
 	{
@@ -608,13 +614,32 @@ Layer::reset_version()
 void
 Layer::set_time(IndependentContext context, Time time)const
 {
-	Layer::ParamList params;
-	Layer::DynamicParamList::const_iterator iter;
-	// For each parameter of the layer sets the time by the operator()(time)
-	for(iter=dynamic_param_list().begin();iter!=dynamic_param_list().end();iter++)
-		params[iter->first]=(*iter->second)(time);
-	// Sets the modified parameter list to the current context layer
-	const_cast<Layer*>(this)->set_param_list(params);
+	if (!dynamic_param_slots_valid_)
+	{
+		dynamic_param_slots_.clear();
+		dynamic_param_slots_.resize(dynamic_param_list().size());
+		std::vector<DynamicParamSlot>::iterator slot = dynamic_param_slots_.begin();
+		for(DynamicParamList::const_iterator i = dynamic_param_list().begin(); i != dynamic_param_list().end(); ++i, ++slot)
+		{
+			slot->param = i->first;
+			slot->value_node = i->second.get();
+		}
+		dynamic_param_slots_valid_ = true;
+	}
+
+	// For each parameter of the layer calculates the value by the operator()(time),
+	// all values are calculated before setting any of them
+	for(std::vector<DynamicParamSlot>::iterator i = dynamic_param_slots_.begin(); i != dynamic_param_slots_.end(); ++i)
+		i->value = SetTimeSession::evaluate(*i->value_node, time);
+	// Sets the calculated values to the current context layer,
+	// if set_param() reconnects some parameter, slots will be rebuilt by the next call.
+	// Layer keeps its own copy, so the value is released from the slot immediately
+	Layer *layer = const_cast<Layer*>(this);
+	for(std::vector<DynamicParamSlot>::iterator i = dynamic_param_slots_.begin(); i != dynamic_param_slots_.end(); ++i)
+	{
+		layer->set_param(i->param, i->value);
+		i->value.clear();
+	}
 
 	set_time_mark(time);
 
@@ -32,7 +32,9 @@
 
 /* === H E A D E R S ======================================================= */
 
+#include <cstring>
 #include <map>
+#include <vector>
 
 #include <ETL/handle>
 
@@ -97,7 +99,7 @@
 
 //! Imports a parameter if it is of the same type as param
 #define IMPORT_VALUE(x) \
-	if (#x=="param_"+param && x.get_type()==value.get_type()) \
+	if (synfig::Layer::is_param_member(#x, param) && x.get_type()==value.get_type()) \
 	{ \
 		x=value; \
         static_param_changed(param); \
@@ -107,7 +109,7 @@
 //! Imports a parameter 'x' and perform an action usually based on
 //! some condition 'y'
 #define IMPORT_VALUE_PLUS_BEGIN(x) \
-	if (#x=="param_"+param && x.get_type()==value.get_type()) \
+	if (synfig::Layer::is_param_member(#x, param) && x.get_type()==value.get_type()) \
 	{ \
 		x=value; \
 		{
@@ -123,7 +125,7 @@
 
 //! Exports a parameter if it is the same type as value
 #define EXPORT_VALUE(x) \
-	if (#x=="param_"+param) \
+	if (synfig::Layer::is_param_member(#x, param)) \
 	{ \
 		synfig::ValueBase ret; \
 		ret.copy(x); \
@@ -296,6 +298,22 @@ private:
 	//! Map of parameter with animated value nodes
 	DynamicParamList dynamic_param_list_;
 
+	//! Animated parameter prepared for set_time()
+	struct DynamicParamSlot
+	{
+		String param;
+		ValueNode *value_node;
+		ValueBase value;        //!< calculated value, empty outside of set_time()
+
+		DynamicParamSlot(): value_node() { }
+	};
+
+	//! Flat copy of dynamic_param_list_ in the same order,
+	//! rebuilt by set_time() after connecting or disconnecting of parameters,
+	//! so set_time() doesn't walk the map and doesn't build the ParamList each frame
+	mutable std::vector<DynamicParamSlot> dynamic_param_slots_;
+	mutable bool dynamic_param_slots_valid_;
+
 	//! A description of what this layer does
 	String description_;
 
@@ -543,6 +561,12 @@ public:
 	//!	Sets a list of parameters
 	virtual bool set_param_list(const ParamList &);
 
+	//! Checks that \a member is the name of field which keeps the parameter \a param,
+	//! i.e. "param_" + param. Used by IMPORT_VALUE() and EXPORT_VALUE() macros
+	//! to avoid building of the temporary string for each compared field.
+	static bool is_param_member(const char *member, const String &param)
+		{ return std::strncmp(member, "param_", 6) == 0 && param.compare(member + 6) == 0; }
+
 	//! Get the value of the specified parameter.
 	/*!	\return The requested parameter value, or (upon failure) a NIL ValueBase.
 	**	\sa set_param()
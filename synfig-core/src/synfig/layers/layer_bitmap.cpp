@@ -81,7 +81,9 @@ synfig::Layer_Bitmap::Layer_Bitmap():
 	left                    (0),
 	top                     (0),
 	width                   (0),
-	height                  (0)
+	height                  (0),
+	opaque_checked_modification_id (GUID::zero()),
+	opaque                  (false)
 {
 	SET_INTERPOLATION_DEFAULTS();
 	SET_STATIC_DEFAULTS();
@@ -355,6 +357,35 @@ Layer_Bitmap::get_bounding_rect()const
 }
 
 
+bool
+Layer_Bitmap::is_surface_opaque() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if ( opaque_checked_surface == rendering_surface
+	  && opaque_checked_modification_id == get_surface_modification_id() )
+		return opaque;
+
+	opaque_checked_surface = rendering_surface;
+	opaque_checked_modification_id = get_surface_modification_id();
+	opaque = false;
+	if (!rendering_surface || !rendering_surface->is_exists())
+		return opaque;
+
+	// don't convert surface just for this check
+	rendering::SurfaceResource::LockReadBase lsurf(rendering_surface);
+	if (!lsurf.convert<rendering::SurfaceSW>(false))
+		return opaque;
+	const synfig::Surface &surface = lsurf.cast<rendering::SurfaceSW>()->get_surface();
+	if (!surface.is_valid())
+		return opaque;
+
+	for(int y = 0; y < surface.get_h(); ++y)
+		for(const Color *c = surface[y], *end = c + surface.get_w(); c != end; ++c)
+			if (c->get_a() < 1.0)
+				return opaque;
+	return opaque = true;
+}
+
 rendering::Task::Handle
 Layer_Bitmap::build_composite_task_vfunc(ContextParams /* context_params */) const
 {
@@ -375,6 +406,7 @@ Layer_Bitmap::build_composite_task_vfunc(ContextParams /* context_params */) con
 	task_surface->target_surface = rendering_surface;
 	task_surface->target_rect = RectInt(VectorInt(), rendering_surface->get_size());
 	task_surface->source_rect = Rect(0.0, 0.0, 1.0, 1.0);
+	task_surface->opaque = is_surface_opaque();
 	task = task_surface;
 
 	rendering::TaskTransformationAffine::Handle task_transform = new rendering::TaskTransformationAffine();
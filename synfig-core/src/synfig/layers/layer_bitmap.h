@@ -68,6 +68,11 @@ public:
 	mutable bool trimmed;
 	mutable unsigned int left, top, width, height;
 
+	// cached result of is_surface_opaque()
+	mutable rendering::SurfaceResource::Handle opaque_checked_surface;
+	mutable GUID opaque_checked_modification_id;
+	mutable bool opaque;
+
 
 	Layer_Bitmap();
 
@@ -80,6 +85,10 @@ public:
 	void reset_surface_modification_id()
 		{ surface_modification_id = GUID::zero(); }
 
+	//! true when all pixels of the surface are fully opaque,
+	//! surface is scanned once per modification
+	bool is_surface_opaque() const;
+
 	virtual bool set_param(const String & param, const ValueBase & value);
 
 	virtual ValueBase get_param(const String & param)const;
@@ -50,6 +50,9 @@
 
 #include <synfig/rendering/common/task/taskblend.h>
 
+#include <set>
+#include <vector>
+
 #endif
 
 /* === U S I N G =========================================================== */
@@ -65,6 +68,50 @@ SYNFIG_LAYER_SET_LOCAL_NAME(Layer_Duplicate,N_("Duplicate"));
 SYNFIG_LAYER_SET_CATEGORY(Layer_Duplicate,N_("Other"));
 SYNFIG_LAYER_SET_VERSION(Layer_Duplicate,"0.1");
 
+/* === P R O C E D U R E S ================================================= */
+
+//! Collects layers whose parameters depend on \a node,
+//! and also the layers which paste canvases containing such layers
+static void
+collect_dependent_layers(const Node *node, std::set<const Layer*> &layers)
+{
+	std::set<const Node*> visited;
+	std::vector<const Node*> queue(1, node);
+	while(!queue.empty())
+	{
+		const Node *n = queue.back();
+		queue.pop_back();
+		if (!visited.insert(n).second)
+			continue;
+
+		if (const Layer *layer = dynamic_cast<const Layer*>(n))
+		{
+			layers.insert(layer);
+			if (Canvas::LooseHandle canvas = layer->get_canvas())
+				queue.push_back(canvas.get());
+		}
+		n->foreach_parent([&queue](const Node *parent) -> bool {
+			queue.push_back(parent);
+			return false;
+		});
+	}
+}
+
+static rendering::Task::Handle
+create_blend(
+	const rendering::Task::Handle &a,
+	const rendering::Task::Handle &b,
+	ColorReal amount,
+	Color::BlendMethod blend_method )
+{
+	rendering::TaskBlend::Handle task_blend(new rendering::TaskBlend());
+	task_blend->amount = amount;
+	task_blend->blend_method = blend_method;
+	task_blend->sub_task_a() = a;
+	task_blend->sub_task_b() = b;
+	return task_blend;
+}
+
 /* === M E M B E R S ======================================================= */
 
 Layer_Duplicate::Layer_Duplicate():
@@ -171,23 +218,68 @@ Layer_Duplicate::build_rendering_task_vfunc(Context context) const
 	ColorReal amount = get_amount() * Context::z_depth_visibility(context.get_params(), *this);
 	Color::BlendMethod blend_method = get_blend_method();
 
-	rendering::Task::Handle task;
-
 	std::lock_guard<std::mutex> lock(mutex);
-	duplicate_param->reset_index(time_cur);
-	ContextParams dup_context_params(context.get_params());
+
+	// Only layers which depend on the index should be re-evaluated for each copy.
+	// Keep the layers forced by an outer duplicate, or keep forcing all of them.
+	const ContextParams &params = context.get_params();
+	std::set<const Layer*> index_layers;
+	collect_dependent_layers(duplicate_param.get(), index_layers);
+
+	ContextParams dup_context_params(params);
 	dup_context_params.force_set_time = true;
+	if (!params.force_set_time || params.force_set_time_layers)
+	{
+		std::set<const Layer*> *force_layers = new std::set<const Layer*>(index_layers);
+		if (params.force_set_time_layers)
+			force_layers->insert(params.force_set_time_layers->begin(), params.force_set_time_layers->end());
+		dup_context_params.force_set_time_layers.reset(force_layers);
+	}
 	Context dup_context(context, dup_context_params);
-	do
+
+	bool depends_on_index = false;
+	for(Context i = context; *i; ++i)
+		if (index_layers.count((*i).get()))
+			{ depends_on_index = true; break; }
+
+	std::vector<rendering::Task::Handle> tasks;
+	duplicate_param->reset_index(time_cur);
+	if (depends_on_index)
+	{
+		do
+			tasks.push_back(dup_context.build_rendering_task());
+		while (duplicate_param->step(time_cur));
+	}
+	else
+	{
+		// all copies are the same, so build the sub-context once
+		rendering::Task::Handle sub_task = dup_context.build_rendering_task();
+		tasks.push_back(sub_task);
+		while (duplicate_param->step(time_cur))
+			tasks.push_back(sub_task ? sub_task->clone_recursive() : sub_task);
+	}
+
+	// the first copy is blended onto the transparent background
+	tasks.front() = create_blend(rendering::Task::Handle(), tasks.front(), amount, blend_method);
+
+	if (((1 << blend_method) & Color::BLEND_METHODS_ASSOCIATIVE) && approximate_equal_lp(amount, ColorReal(1.0)))
+	{
+		// associative blending allows the balanced tree, so copies may be blended in parallel
+		while(tasks.size() > 1)
+		{
+			std::vector<rendering::Task::Handle> next;
+			for(size_t i = 0; i < tasks.size(); i += 2)
+				next.push_back( i + 1 < tasks.size()
+							  ? create_blend(tasks[i], tasks[i + 1], amount, blend_method)
+							  : tasks[i] );
+			tasks.swap(next);
+		}
+	}
+	else
 	{
-		rendering::TaskBlend::Handle task_blend(new rendering::TaskBlend());
-		task_blend->amount = amount;
-		task_blend->blend_method = blend_method;
-		task_blend->sub_task_a() = task;
-		task_blend->sub_task_b() = dup_context.build_rendering_task();
-		task = task_blend;
+		for(size_t i = 1; i < tasks.size(); ++i)
+			tasks.front() = create_blend(tasks.front(), tasks[i], amount, blend_method);
 	}
-	while (duplicate_param->step(time_cur));
 
-	return task;
+	return tasks.front();
 }
@@ -88,6 +88,7 @@ namespace {
 
 Layer_MeshTransform::Layer_MeshTransform(Real amount, Color::BlendMethod blend_method):
 	Layer_CompositeFork(amount, blend_method),
+	param_interpolation(int(Color::INTERPOLATION_CUBIC)),
 	mesh(new rendering::Mesh())
 {
 	SET_INTERPOLATION_DEFAULTS();
@@ -97,6 +98,39 @@ Layer_MeshTransform::Layer_MeshTransform(Real amount, Color::BlendMethod blend_m
 Layer_MeshTransform::~Layer_MeshTransform()
 	{ }
 
+bool
+Layer_MeshTransform::set_param(const String &param, const ValueBase &value)
+{
+	IMPORT_VALUE(param_interpolation);
+	return Layer_CompositeFork::set_param(param, value);
+}
+
+ValueBase
+Layer_MeshTransform::get_param(const String &param)const
+{
+	EXPORT_VALUE(param_interpolation);
+	return Layer_CompositeFork::get_param(param);
+}
+
+Layer::Vocab
+Layer_MeshTransform::get_param_vocab()const
+{
+	Layer::Vocab ret(Layer_CompositeFork::get_param_vocab());
+
+	ret.push_back(ParamDesc("interpolation")
+		.set_local_name(_("Interpolation"))
+		.set_description(_("What type of interpolation to use for the deformed image"))
+		.set_hint("enum")
+		.add_enum_value(Color::INTERPOLATION_NEAREST, "nearest", _("Nearest Neighbor"))
+		.add_enum_value(Color::INTERPOLATION_LINEAR, "linear", _("Linear"))
+		.add_enum_value(Color::INTERPOLATION_COSINE, "cosine", _("Cosine"))
+		.add_enum_value(Color::INTERPOLATION_CUBIC, "cubic", _("Cubic"))
+		.set_static(true)
+	);
+
+	return ret;
+}
+
 Layer::Handle
 Layer_MeshTransform::hit_check(synfig::Context context, const synfig::Point &point)const
 {
@@ -148,6 +182,7 @@ Layer_MeshTransform::build_composite_fork_task_vfunc(ContextParams /* context_pa
 	rendering::TaskMesh::Handle task_mesh(new rendering::TaskMesh());
 	task_mesh->mesh = new rendering::Mesh();
 	task_mesh->mesh->assign(*mesh);
+	task_mesh->interpolation = (Color::Interpolation)param_interpolation.get(int());
 	task_mesh->sub_task() = task_blend;
 	return task_mesh;
 }
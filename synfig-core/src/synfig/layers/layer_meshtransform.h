@@ -44,6 +44,11 @@
 namespace synfig {
 class Layer_MeshTransform : public Layer_CompositeFork
 {
+private:
+	//! Parameter: (int) texture interpolation, see Color::Interpolation,
+	//! saved since version 0.3 of skeleton_deformation, older files get cubic
+	ValueBase param_interpolation;
+
 protected:
 	rendering::Mesh::Handle mesh;
 	rendering::Contour::Handle mask;
@@ -54,6 +59,10 @@ public:
 	//! Destructor
 	virtual ~Layer_MeshTransform();
 
+	virtual bool set_param(const String &param, const ValueBase &value);
+	virtual ValueBase get_param(const String &param)const;
+	virtual Vocab get_param_vocab()const;
+
 	synfig::Layer::Handle hit_check(synfig::Context context, const synfig::Point &point)const;
 	virtual Color get_color(Context context, const Point &pos)const;
 	virtual Rect get_bounding_rect()const;
@@ -199,7 +199,10 @@ Layer_MotionBlur::build_rendering_task_vfunc(Context context) const
 	}
 
 	Real k = 1.0/sum;
-	rendering::Task::Handle task;
+	std::vector<rendering::Task::Handle> subsamples;
+	std::vector<Real> weights;
+	subsamples.reserve(samples);
+	weights.reserve(samples);
 	for(int i = 0; i < samples; i++)
 	{
 		if (fabs(scales[i]*k) < 1e-8)
@@ -209,13 +212,52 @@ Layer_MotionBlur::build_rendering_task_vfunc(Context context) const
 		Real ipos = 1.0 - pos;
 		context.set_time(get_time_mark() - aperture*ipos);
 
+		subsamples.push_back(context.build_rendering_task());
+		weights.push_back(scales[i]*k);
+	}
+
+	return build_subsamples_sum(subsamples, weights);
+}
+
+rendering::Task::Handle
+Layer_MotionBlur::build_subsamples_sum(
+	const std::vector<rendering::Task::Handle> &subsamples,
+	const std::vector<Real> &weights )
+{
+	// each subsample is scaled by its weight, then weighted subsamples are summed
+	// by a balanced tree, so renderer can process independent sums in parallel
+	std::vector<rendering::Task::Handle> tasks;
+	tasks.reserve(subsamples.size());
+	for(size_t i = 0; i < subsamples.size() && i < weights.size(); i++)
+	{
+		if (fabs(weights[i]) < 1e-8)
+			continue;
 		rendering::TaskBlend::Handle task_blend(new rendering::TaskBlend());
-		task_blend->amount = scales[i]*k;
+		task_blend->amount = weights[i];
 		task_blend->blend_method = Color::BLEND_ADD_COMPOSITE;
-		task_blend->sub_task_a() = task;
-		task_blend->sub_task_b() = context.build_rendering_task();
-		task = task_blend;
+		task_blend->sub_task_b() = subsamples[i];
+		tasks.push_back(task_blend);
+	}
+
+	// weights are normalized, so alpha of any partial sum does not exceed 1
+	// and BLEND_ADD_COMPOSITE with amount 1 is plain summation here
+	while(tasks.size() > 1)
+	{
+		std::vector<rendering::Task::Handle> next;
+		next.reserve((tasks.size() + 1)/2);
+		for(size_t i = 0; i < tasks.size(); i += 2)
+		{
+			if (i + 1 == tasks.size())
+				{ next.push_back(tasks[i]); break; }
+			rendering::TaskBlend::Handle task_blend(new rendering::TaskBlend());
+			task_blend->amount = 1.0;
+			task_blend->blend_method = Color::BLEND_ADD_COMPOSITE;
+			task_blend->sub_task_a() = tasks[i];
+			task_blend->sub_task_b() = tasks[i + 1];
+			next.push_back(task_blend);
+		}
+		tasks.swap(next);
 	}
 
-	return task;
+	return tasks.empty() ? rendering::Task::Handle() : tasks.front();
 }
@@ -33,6 +33,7 @@
 
 #include "layer_composite_fork.h"
 #include <synfig/time.h>
+#include <vector>
 
 /* === S T R U C T S & C L A S S E S ======================================= */
 
@@ -66,6 +67,12 @@ public:
 	virtual Vocab get_param_vocab()const;
 	virtual bool reads_context()const { return true; }
 
+	//! Sums subsamples with the given weights by a balanced tree of blend tasks,
+	//! weights should be normalized, subsamples with zero weight are skipped
+	static rendering::Task::Handle build_subsamples_sum(
+		const std::vector<rendering::Task::Handle> &subsamples,
+		const std::vector<Real> &weights );
+
 protected:
 	virtual rendering::Task::Handle build_rendering_task_vfunc(Context context) const;
 }; // END of class Layer_MotionBlur
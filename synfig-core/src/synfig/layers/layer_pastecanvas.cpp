@@ -43,6 +43,7 @@
 #include <synfig/context.h>
 #include <synfig/paramdesc.h>
 #include <synfig/renddesc.h>
+#include <synfig/settimesession.h>
 #include <synfig/time.h>
 #include <synfig/string.h>
 #include <synfig/value.h>
@@ -72,6 +73,11 @@ using namespace synfig;
 
 /* === C L A S S E S ======================================================= */
 
+namespace {
+	void set_context_time(IndependentContext context, Time time)
+		{ context.set_time(time); }
+}
+
 class depth_counter	// Makes our recursive depth counter exception-safe
 {
 	int *depth;
@@ -305,17 +311,37 @@ Layer_PasteCanvas::get_param(const String& param)const
 void
 Layer_PasteCanvas::set_time_vfunc(IndependentContext context, Time time)const
 {
-	context.set_time(time);
-
-	if (!sub_canvas)
-		return;
-	if (depth == MAX_DEPTH)
-		return;
+	if (!sub_canvas || depth == MAX_DEPTH)
+		{ context.set_time(time); return; }
 	depth_counter counter(depth);
 
 	Real time_dilation = param_time_dilation.get(Real());
 	Time time_offset = param_time_offset.get(Time());
-	sub_canvas->set_time(time*time_dilation + time_offset);
+	Time sub_time = time*time_dilation + time_offset;
+
+	if (sub_canvas->is_inline())
+	{
+		// inline canvas is used by this layer only,
+		// so it may be processed simultaneously with the rest of context
+		SetTimeSession::run(
+			sigc::bind(sigc::ptr_fun(&set_context_time), context, time),
+			sigc::bind(sigc::mem_fun(*this, &Layer_PasteCanvas::set_sub_canvas_time), sub_time) );
+	}
+	else
+	{
+		context.set_time(time);
+		SetTimeSession::SharedCanvasLock lock;
+		set_sub_canvas_time(sub_time);
+	}
+}
+
+void
+Layer_PasteCanvas::set_sub_canvas_time(Time time)const
+{
+	if (!SetTimeSession::get_timing())
+		{ sub_canvas->set_time(time); return; }
+	SetTimeSession::Timer timer(sub_canvas.get(), get_non_empty_description());
+	sub_canvas->set_time(time);
 }
 
 void
@@ -112,6 +112,9 @@ private:
 
 	void childs_changed();
 
+	//! Sets time of the sub_canvas and collects SetTimeSession timing
+	void set_sub_canvas_time(Time time)const;
+
 	/*
  -- ** -- S I G N A L S -------------------------------------------------------
 	*/
@@ -38,6 +38,7 @@
 
 #include <synfig/context.h>
 #include <synfig/paramdesc.h>
+#include <synfig/skinning.h>
 #include <synfig/string.h>
 #include <synfig/time.h>
 #include <synfig/value.h>
@@ -58,13 +59,28 @@ using namespace synfig;
 
 /* === C L A S S E S ======================================================= */
 
+namespace {
+	typedef std::pair<Real, rendering::Mesh::Triangle> DepthTriangle;
+
+	bool compare_triangles(const DepthTriangle &a, const DepthTriangle &b)
+	{
+		return a.first < b.first ? false
+			 : b.first < a.first ? true
+			 : a.second.vertices[0] < b.second.vertices[0] ? true
+			 : b.second.vertices[0] < a.second.vertices[0] ? false
+			 : a.second.vertices[1] < b.second.vertices[1] ? true
+			 : b.second.vertices[1] < a.second.vertices[1] ? false
+			 : a.second.vertices[2] < b.second.vertices[2];
+	}
+}
+
 /* === G L O B A L S ======================================================= */
 
 SYNFIG_LAYER_INIT(Layer_SkeletonDeformation);
 SYNFIG_LAYER_SET_NAME(Layer_SkeletonDeformation,"skeleton_deformation");
 SYNFIG_LAYER_SET_LOCAL_NAME(Layer_SkeletonDeformation,N_("Skeleton Deformation"));
 SYNFIG_LAYER_SET_CATEGORY(Layer_SkeletonDeformation,N_("Distortions"));
-SYNFIG_LAYER_SET_VERSION(Layer_SkeletonDeformation,"0.2");
+SYNFIG_LAYER_SET_VERSION(Layer_SkeletonDeformation,"0.3");
 
 /* === M E T H O D S ======================================================= */
 
@@ -175,58 +191,9 @@ Layer_SkeletonDeformation::prepare_mask()
 	this->mask = mask;
 }
 
-struct Layer_SkeletonDeformation::GridPoint {
-	Vector initial_position;
-	Vector summary_position;
-	Real summary_depth;
-	Real summary_weight;
-	Real average_depth;
-	bool used;
-
-	inline GridPoint():
-		summary_depth(0.0), summary_weight(0.0), average_depth(0.0), used(false) { }
-	inline explicit GridPoint(const Vector &initial_position):
-		initial_position(initial_position), summary_depth(0.0), summary_weight(0.0), average_depth(0.0), used(false) { }
-	static bool compare_triagles(
-		const std::pair<Real, rendering::Mesh::Triangle> &a,
-		const std::pair<Real, rendering::Mesh::Triangle> &b )
-	{
-		return a.first < b.first ? false
-			 : b.first < a.first ? true
-			 : a.second.vertices[0] < b.second.vertices[0] ? true
-			 : b.second.vertices[0] < a.second.vertices[0] ? false
-			 : a.second.vertices[1] < b.second.vertices[1] ? true
-			 : b.second.vertices[1] < a.second.vertices[1] ? false
-			 : a.second.vertices[2] < b.second.vertices[2];
-	}
-};
-
-Real Layer_SkeletonDeformation::distance_to_line(const Vector &p0, const Vector &p1, const Vector &x)
-{
-	const Real epsilon = 1e-10;
-
-	Real distance_to_p0 = (x - p0).mag();
-	Real distance_to_p1 = (x - p1).mag();
-	Real distance_to_line = INFINITY;
-
-	Vector line = p1 - p0;
-	Real line_length = line.mag();
-	if (line_length > epsilon)
-	{
-		Real dist = fabs((x - p0) * line.perp() / line_length);
-		Real pos = (x - p0) * line / line_length;
-		if (pos > 0.0 && pos < line_length)
-			distance_to_line = dist;
-	}
-
-	return std::min(distance_to_line, std::min(distance_to_p0, distance_to_p1) );
-}
-
 void
 Layer_SkeletonDeformation::prepare_mesh()
 {
-	static const Real precision = 1e-10;
-
 	rendering::Mesh::Handle mesh(new rendering::Mesh());
 
 	// TODO: build grid with dynamic size
@@ -236,20 +203,8 @@ Layer_SkeletonDeformation::prepare_mesh()
 	const int grid_side_count_x = std::max(1, param_x_subdivisions.get(int())) + 1;
 	const int grid_side_count_y = std::max(1, param_y_subdivisions.get(int())) + 1;
 
-	const Real grid_step_x = (grid_p1[0] - grid_p0[0]) / (Real)(grid_side_count_x - 1);
-	const Real grid_step_y = (grid_p1[1] - grid_p0[1]) / (Real)(grid_side_count_y - 1);
-	const Real grid_step_diagonal = sqrt(grid_step_x*grid_step_x + grid_step_y*grid_step_y);
-
-	// build grid
-	std::vector<GridPoint> grid;
-	grid.reserve(grid_side_count_x * grid_side_count_y);
-	for(int j = 0; j < grid_side_count_y; ++j)
-		for(int i = 0; i < grid_side_count_x; ++i)
-			grid.push_back(GridPoint(Vector(
-				grid_p0[0] + i*grid_step_x,
-				grid_p0[1] + j*grid_step_y )));
-
 	// apply deformation
+	SkinningGrid grid(grid_p0, grid_p1, grid_side_count_x, grid_side_count_y);
 	if (param_bones.can_get(ValueBase::List()))
 	{
 		const ValueBase::List &bones = param_bones.get_list();
@@ -258,59 +213,26 @@ Layer_SkeletonDeformation::prepare_mesh()
 			if (i->can_get(BonePair()))
 			{
 				const BonePair &bone_pair = i->get(BonePair());
-				Bone::Shape shape0 = bone_pair.first.get_shape();
-				Bone::Shape shape1 = bone_pair.second.get_shape();
-				Bone::Shape expandedShape0 = shape0;
-				expandedShape0.r0 += 2.0*grid_step_diagonal;
-				expandedShape0.r1 += 2.0*grid_step_diagonal;
-				Real depth = bone_pair.second.get_depth();
-
-				Matrix into_bone(
-					shape0.p1[0] - shape0.p0[0], shape0.p1[1] - shape0.p0[1], 0.0,
-					shape0.p0[1] - shape0.p1[1], shape0.p1[0] - shape0.p0[0], 0.0,
-					shape0.p0[0], shape0.p0[1], 1.0
-				);
-				into_bone.invert();
-				Matrix from_bone(
-					shape1.p1[0] - shape1.p0[0], shape1.p1[1] - shape1.p0[1], 0.0,
-					shape1.p0[1] - shape1.p1[1], shape1.p1[0] - shape1.p0[0], 0.0,
-					shape1.p0[0], shape1.p0[1], 1.0
-				);
-				Matrix matrix = from_bone * into_bone;
-
-				for(std::vector<GridPoint>::iterator j = grid.begin(); j != grid.end(); ++j)
-				{
-					Real percent = Bone::distance_to_shape_center_percent(expandedShape0, j->initial_position);
-					if (percent > precision) {
-						Real distance = distance_to_line(shape0.p0, shape0.p1, j->initial_position);
-						if (distance < precision) distance = precision;
-						Real weight =
-							percent/(distance*distance);
-							// 1.0/distance;
-							// 1.0/(distance*distance);
-							// 1.0/(distance*distance*distance);
-							// exp(-4.0*distance);
-						j->summary_position += matrix.get_transformed(j->initial_position) * weight;
-						j->summary_depth += depth * weight;
-						j->summary_weight += weight;
-						j->used = true;
-					}
-				}
+				grid.add_bone(
+					bone_pair.first.get_shape(),
+					bone_pair.second.get_shape(),
+					bone_pair.second.get_depth() );
 			}
 		}
 	}
+	grid.process();
 
 	// build vertices
-	mesh->vertices.reserve(grid.size());
-	for(std::vector<GridPoint>::iterator i = grid.begin(); i != grid.end(); ++i) {
-		Vector average_position = i->summary_weight > precision ? i->summary_position/i->summary_weight : i->initial_position;
-		i->average_depth = i->summary_weight > precision ? i->summary_depth/i->summary_weight : 0.0;
+	std::vector<Real> depths(grid.get_count());
+	mesh->vertices.reserve(grid.get_count());
+	for(int i = 0; i < grid.get_count(); ++i) {
+		depths[i] = grid.get_depth(i);
 		mesh->vertices.push_back( rendering::Mesh::Vertex(
-			average_position, i->initial_position ));
+			grid.get_position(i), grid.get_initial_position(i) ));
 	}
 
 	// build triangles
-	std::vector< std::pair<Real, rendering::Mesh::Triangle> > triangles;
+	std::vector<DepthTriangle> triangles;
 	triangles.reserve(2*(grid_side_count_x-1)*(grid_side_count_y-1));
 	for(int j = 1; j < grid_side_count_y; ++j)
 	{
@@ -322,12 +244,9 @@ Layer_SkeletonDeformation::prepare_mesh()
 				 j   *grid_side_count_x +  i,
 				 j   *grid_side_count_x + (i-1),
 			};
-			if (grid[v[0]].used && grid[v[1]].used && grid[v[2]].used && grid[v[3]].used)
+			if (grid.is_used(v[0]) && grid.is_used(v[1]) && grid.is_used(v[2]) && grid.is_used(v[3]))
 			{
-				Real depth = 0.25*(grid[v[0]].average_depth
-						         + grid[v[1]].average_depth
-								 + grid[v[2]].average_depth
-								 + grid[v[3]].average_depth);
+				Real depth = 0.25*(depths[v[0]] + depths[v[1]] + depths[v[2]] + depths[v[3]]);
 				triangles.push_back(std::make_pair(depth, rendering::Mesh::Triangle(v[0], v[1], v[3])));
 				triangles.push_back(std::make_pair(depth, rendering::Mesh::Triangle(v[1], v[2], v[3])));
 			}
@@ -335,9 +254,9 @@ Layer_SkeletonDeformation::prepare_mesh()
 	}
 
 	// sort triangles
-	std::sort(triangles.begin(), triangles.end(), GridPoint::compare_triagles);
+	std::sort(triangles.begin(), triangles.end(), compare_triangles);
 	mesh->triangles.reserve(triangles.size());
-	for(std::vector< std::pair<Real, rendering::Mesh::Triangle> >::iterator i = triangles.begin(); i != triangles.end(); ++i)
+	for(std::vector<DepthTriangle>::iterator i = triangles.begin(); i != triangles.end(); ++i)
 		mesh->triangles.push_back(i->second);
 
 	prepare_mask();
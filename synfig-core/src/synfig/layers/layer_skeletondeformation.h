@@ -60,9 +60,6 @@ private:
 	//! Parameter: (Integer)
 	synfig::ValueBase param_y_subdivisions;
 
-	struct GridPoint;
-	static Real distance_to_line(const Vector &p0, const Vector &p1, const Vector &x);
-
 public:
 	typedef etl::handle<Layer_SkeletonDeformation> Handle;
 	typedef etl::handle<const Layer_SkeletonDeformation> ConstHandle;
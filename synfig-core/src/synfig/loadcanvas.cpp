@@ -41,13 +41,19 @@
 #include <cstdlib>
 #include <cstring>
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <vector>
 #include <stdexcept>
 
+#include <glibmm/convert.h>
+#include <libxml/parser.h>
 #include <libxml++/libxml++.h>
 #include <sigc++/bind.h>
+#include <sigc++/functors/ptr_fun.h>
 
 #include "loadcanvas.h"
 
@@ -61,9 +67,12 @@
 #include "dashitem.h"
 #include "exception.h"
 #include "importer.h"
+#include "module.h"
 #include "gradient.h"
 #include "layer.h"
 #include "string.h"
+#include "canvasfilenaming.h"
+#include "threadpool.h"
 #include "valuenode.h"
 #include "valuenode_registry.h"
 #include "valueoperations.h"
@@ -113,8 +122,324 @@ inline bool is_false(const std::string& s) { return s=="0" || s=="false" || s=="
 
 std::set<FileSystem::Identifier> CanvasParser::loading_;
 
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+Real seconds_since(const Clock::time_point &timepoint)
+	{ return std::chrono::duration<Real>(Clock::now() - timepoint).count(); }
+
+//! External file read in advance by other thread
+struct PrefetchedDocument
+{
+	FileSystem::Identifier identifier;
+	FileSystem::Identifier source;
+	std::shared_ptr<xmlpp::DomParser> parser;
+	Real seconds;
+
+	PrefetchedDocument(const FileSystem::Identifier &identifier, const FileSystem::Identifier &source):
+		identifier(identifier), source(source), seconds() { }
+};
+
+//! Imported image decoded in advance by other thread
+struct PrefetchedImage
+{
+	FileSystem::Identifier identifier;
+	FileSystem::Identifier source;
+	Importer::Handle importer;
+	Real seconds;
+
+	PrefetchedImage(const FileSystem::Identifier &identifier, const FileSystem::Identifier &source):
+		identifier(identifier), source(source), seconds() { }
+};
+
+//! depth of nested calls of CanvasParser::parse_from_file_as()
+int load_depth = 0;
+//! documents which are read but not parsed yet
+std::map<FileSystem::Identifier, std::shared_ptr<xmlpp::DomParser> > prefetched_documents;
+//! keep preloaded importers till the layers will take them
+std::vector<Importer::Handle> prefetched_importers;
+//! all files which were already read or decoded during the current load
+std::set<FileSystem::Identifier> prefetched_files;
+
+std::vector<CanvasLoadTime> load_times;
+std::map<String, int> load_time_indices;
+//! time of nested loads for each level of load_depth
+std::vector<Real> nested_load_seconds;
+
+CanvasLoadTime& get_load_time(const String &filename)
+{
+	std::map<String, int>::const_iterator i = load_time_indices.find(filename);
+	if (i != load_time_indices.end())
+		return load_times[i->second];
+	load_time_indices[filename] = (int)load_times.size();
+	load_times.push_back(CanvasLoadTime());
+	load_times.back().filename = filename;
+	return load_times.back();
+}
+
+//! Opens document \a identifier, reading it from \a source
+FileSystem::ReadStream::Handle open_document_stream(const FileSystem::Identifier &identifier, const FileSystem::Identifier &source)
+{
+	FileSystem::ReadStream::Handle stream = source.get_read_stream();
+	if (stream && filename_extension(identifier.filename) == ".sifz")
+		stream = FileSystem::ReadStream::Handle(new ZReadStream(stream, zstreambuf::compression::gzip));
+	return stream;
+}
+
+//! The same file in the native file system, it is safe for reading from other threads,
+//! unlike containers and temporary file systems
+bool get_native_identifier(const FileSystem::Identifier &identifier, FileSystem::Identifier &out_identifier)
+{
+	try
+	{
+		String uri = identifier.file_system->get_real_uri(identifier.filename);
+		if (uri.empty())
+			return false;
+		out_identifier = FileSystemNative::instance()->get_identifier(Glib::filename_from_uri(uri));
+	}
+	catch (...)
+	{
+		return false;
+	}
+	return true;
+}
+
+void read_document(PrefetchedDocument *document)
+{
+	Clock::time_point start = Clock::now();
+	try
+	{
+		// errors will be reported when the file will be read again by parser
+		if (FileSystem::ReadStream::Handle stream = open_document_stream(document->identifier, document->source))
+		{
+			std::shared_ptr<xmlpp::DomParser> parser(new xmlpp::DomParser());
+			parser->parse_stream(*stream);
+			if (*parser)
+				document->parser = parser;
+		}
+	}
+	catch (...) { }
+	document->seconds = seconds_since(start);
+}
+
+void decode_image(PrefetchedImage *image)
+{
+	Clock::time_point start = Clock::now();
+	image->importer = Importer::preload(image->identifier, image->source);
+	image->seconds = seconds_since(start);
+}
+
+//! Text of the first child element with given name
+String get_child_text(xmlpp::Element *element, const String &child_name)
+{
+	xmlpp::Element::NodeList children = element->get_children(child_name);
+	for(xmlpp::Element::NodeList::iterator i = children.begin(); i != children.end(); ++i)
+	{
+		String text;
+		xmlpp::Element::NodeList list = (*i)->get_children();
+		for(xmlpp::Element::NodeList::iterator j = list.begin(); j != list.end(); ++j)
+			if(dynamic_cast<xmlpp::TextNode*>(*j))text+=dynamic_cast<xmlpp::TextNode*>(*j)->get_content();
+		return text;
+	}
+	return String();
+}
+
+//! Collects external canvases (use="file.sif#id") and imported images
+//! referenced by the document, file names are resolved the same way
+//! as Canvas::surefind_canvas() and Layer Import do it
+void find_dependencies(
+	xmlpp::Element *element,
+	const String &filename,
+	std::vector<String> &documents,
+	std::vector<String> &images )
+{
+	if (element->get_attribute("use"))
+	{
+		const String id = element->get_attribute("use")->get_value();
+		String::size_type pos = id.find('#');
+		if (pos != String::npos && pos > 0)
+		{
+			String file_name = FileSystem::fix_slashes(String(id, 0, pos));
+			if (!is_absolute_path(file_name))
+				file_name = dirname(filename) + ETL_DIRECTORY_SEPARATOR + file_name;
+			if (file_name != filename)
+				documents.push_back(file_name);
+		}
+	}
+
+	if (element->get_name() == "layer"
+	 && element->get_attribute("type")
+	 && element->get_attribute("type")->get_value() == "import")
+	{
+		xmlpp::Element::NodeList params = element->get_children("param");
+		for(xmlpp::Element::NodeList::iterator i = params.begin(); i != params.end(); ++i)
+		{
+			xmlpp::Element *param = dynamic_cast<xmlpp::Element*>(*i);
+			if (!param || !param->get_attribute("name") || param->get_attribute("name")->get_value() != "filename")
+				continue;
+			String image = FileSystem::fix_slashes(get_child_text(param, "string"));
+			for(String::size_type n; (n = image.find("%20")) != String::npos;)
+				image.replace(n, 3, " ");
+			image = CanvasFileNaming::make_full_filename(filename, image);
+			if (!image.empty())
+				images.push_back(image);
+		}
+	}
+
+	xmlpp::Element::NodeList children = element->get_children();
+	for(xmlpp::Element::NodeList::iterator i = children.begin(); i != children.end(); ++i)
+		if (xmlpp::Element *child = dynamic_cast<xmlpp::Element*>(*i))
+			find_dependencies(child, filename, documents, images);
+}
+
+//! Reads external documents and decodes imported images referenced by the document
+//! simultaneously. Documents are read level by level, because references of each
+//! document are known only after reading of it. Then parser links everything
+//! in the usual order in the current thread, taking ready documents and importers.
+void prefetch_dependencies(xmlpp::Element *root, const FileSystem::Identifier &identifier, const String &filename)
+{
+	// libxml2 should be initialized in the main thread
+	xmlInitParser();
+
+	std::vector< std::pair<xmlpp::Element*, String> > sources;
+	sources.push_back(std::make_pair(root, filename));
+	prefetched_files.insert(identifier);
+
+	while(!sources.empty())
+	{
+		std::vector<String> document_names, image_names;
+		for(std::vector< std::pair<xmlpp::Element*, String> >::const_iterator i = sources.begin(); i != sources.end(); ++i)
+			find_dependencies(i->first, i->second, document_names, image_names);
+
+		std::list<PrefetchedDocument> documents;
+		for(std::vector<String>::const_iterator i = document_names.begin(); i != document_names.end(); ++i)
+		{
+			FileSystem::Identifier document_identifier = identifier.file_system->get_identifier(*i);
+			if (!prefetched_files.insert(document_identifier).second)
+				continue;
+			bool opened = false;
+			const String absolute_filename = etl::absolute_path(*i);
+			for (const auto& it : get_open_canvas_map())
+				if (it.second == absolute_filename)
+					{ opened = true; break; }
+			FileSystem::Identifier source;
+			if (!opened && get_native_identifier(document_identifier, source))
+				documents.push_back(PrefetchedDocument(document_identifier, source));
+		}
+
+		std::list<PrefetchedImage> images;
+		for(std::vector<String>::const_iterator i = image_names.begin(); i != image_names.end(); ++i)
+		{
+			FileSystem::Identifier image_identifier = identifier.file_system->get_identifier(*i);
+			FileSystem::Identifier source;
+			if (!prefetched_files.insert(image_identifier).second || !get_native_identifier(image_identifier, source))
+				continue;
+			// modules should be loaded before the parallel part
+			String ext = filename_extension(*i);
+			if (ext.size()) ext = ext.substr(1);
+			std::transform(ext.begin(), ext.end(), ext.begin(), &::tolower);
+			Module::require(Module::BOOK_IMPORTER, ext);
+			images.push_back(PrefetchedImage(image_identifier, source));
+		}
+
+		if (documents.empty() && images.empty())
+			break;
+
+		ThreadPool::Group group;
+		for(std::list<PrefetchedDocument>::iterator i = documents.begin(); i != documents.end(); ++i)
+			group.enqueue(sigc::bind(sigc::ptr_fun(&read_document), &*i));
+		for(std::list<PrefetchedImage>::iterator i = images.begin(); i != images.end(); ++i)
+			group.enqueue(sigc::bind(sigc::ptr_fun(&decode_image), &*i));
+		group.run();
+
+		sources.clear();
+		for(std::list<PrefetchedImage>::const_iterator i = images.begin(); i != images.end(); ++i)
+		{
+			if (!i->importer)
+				continue;
+			prefetched_importers.push_back(i->importer);
+			get_load_time(i->identifier.filename).import += i->seconds;
+		}
+		for(std::list<PrefetchedDocument>::const_iterator i = documents.begin(); i != documents.end(); ++i)
+		{
+			if (!i->parser)
+				continue;
+			prefetched_documents[i->identifier] = i->parser;
+			get_load_time(i->identifier.filename).read += i->seconds;
+			sources.push_back(std::make_pair(i->parser->get_document()->get_root_node(), i->identifier.filename));
+		}
+	}
+}
+
+//! Tracks nested loads of files, measures the time spent on each file
+//! and releases the prefetched data at the end of the top-level load
+class LoadScope
+{
+private:
+	String filename;
+	Clock::time_point start;
+	Real read_seconds;
+
+public:
+	explicit LoadScope(const String &filename):
+		filename(filename), start(Clock::now()), read_seconds()
+	{
+		if (load_depth++ == 0)
+		{
+			load_times.clear();
+			load_time_indices.clear();
+			nested_load_seconds.clear();
+		}
+		nested_load_seconds.push_back(0.0);
+	}
+
+	~LoadScope()
+	{
+		Real seconds = seconds_since(start);
+		Real nested_seconds = nested_load_seconds.back();
+		nested_load_seconds.pop_back();
+		if (!nested_load_seconds.empty())
+			nested_load_seconds.back() += seconds;
+
+		CanvasLoadTime &time = get_load_time(filename);
+		time.read += read_seconds;
+		time.build += std::max(0.0, seconds - nested_seconds - read_seconds);
+
+		if (--load_depth == 0)
+		{
+			prefetched_documents.clear();
+			prefetched_importers.clear();
+			prefetched_files.clear();
+		}
+	}
+
+	bool is_top_level() const { return load_depth == 1; }
+
+	void set_read_time(Real seconds) { read_seconds = seconds; }
+};
+
+//! Takes the document read in advance, if any
+std::shared_ptr<xmlpp::DomParser> take_prefetched_document(const FileSystem::Identifier &identifier)
+{
+	std::shared_ptr<xmlpp::DomParser> parser;
+	std::map<FileSystem::Identifier, std::shared_ptr<xmlpp::DomParser> >::iterator i = prefetched_documents.find(identifier);
+	if (i != prefetched_documents.end())
+	{
+		parser = i->second;
+		prefetched_documents.erase(i);
+	}
+	return parser;
+}
+
+} // END of anonymous namespace
+
 /* === P R O C E D U R E S ================================================= */
 
+std::list<CanvasLoadTime>
+synfig::get_canvas_load_times()
+	{ return std::list<CanvasLoadTime>(load_times.begin(), load_times.end()); }
+
 OpenCanvasMap& synfig::get_open_canvas_map()
 {
 	static OpenCanvasMap open_canvas_map_;
@@ -2582,6 +2907,9 @@ CanvasParser::parse_value_node(xmlpp::Element *element,Canvas::Handle canvas)
 		}
 	}
 
+	// value node may be provided by a module which is not loaded yet
+	Module::require(Module::BOOK_VALUENODE, element->get_name());
+
 	// If ValueBase::ident_type() recognizes the name, then we know it's a ValueBase
 	if (getenv("SYNFIG_DEBUG_LOAD_CANVAS")) printf("%s:%d element name = '%s'\n", __FILE__, __LINE__, element->get_name().c_str());
 	if(element->get_name()!="canvas" && ValueBase::ident_type(element->get_name()) != type_nil)
@@ -3496,39 +3824,46 @@ CanvasParser::parse_from_file_as(const FileSystem::Identifier &identifier,const
 		total_warnings_=0;
 		
 		synfig::info(String("Loading file: ") + filename);
-		FileSystem::ReadStream::Handle stream = identifier.get_read_stream();
-		if (stream)
+		LoadScope load_scope(identifier.filename);
+
+		std::shared_ptr<xmlpp::DomParser> parser = take_prefetched_document(identifier);
+		if (!parser)
 		{
-			if (filename_extension(identifier.filename) == ".sifz")
-				stream = FileSystem::ReadStream::Handle(new ZReadStream(stream, zstreambuf::compression::gzip));
+			Clock::time_point read_start = Clock::now();
+			FileSystem::ReadStream::Handle stream = open_document_stream(identifier, identifier);
+			if (!stream)
+				throw std::runtime_error(String("  * ") + _("Can't find linked file") + " \"" + identifier.filename + "\"");
 
-			xmlpp::DomParser parser;
-			parser.parse_stream(*stream);
+			parser.reset(new xmlpp::DomParser());
+			parser->parse_stream(*stream);
 			stream.reset();
-			if(parser)
-			{
-				Canvas::Handle canvas(parse_canvas(parser.get_document()->get_root_node(),0,false,identifier,as));
-				if (!canvas) return canvas;
-				register_canvas_in_map(canvas, as);
+			load_scope.set_read_time(seconds_since(read_start));
+		}
+
+		if(*parser)
+		{
+			if (load_scope.is_top_level())
+				prefetch_dependencies(parser->get_document()->get_root_node(), identifier, as);
+
+			Canvas::Handle canvas(parse_canvas(parser->get_document()->get_root_node(),0,false,identifier,as));
+			if (!canvas) return canvas;
+			register_canvas_in_map(canvas, as);
 
-				const ValueNodeList& value_node_list(canvas->value_node_list());
+			const ValueNodeList& value_node_list(canvas->value_node_list());
 
-				again:
-				ValueNodeList::const_iterator iter;
-				for(iter=value_node_list.begin();iter!=value_node_list.end();++iter)
+			again:
+			ValueNodeList::const_iterator iter;
+			for(iter=value_node_list.begin();iter!=value_node_list.end();++iter)
+			{
+				ValueNode::Handle value_node(*iter);
+				if(value_node->is_exported() && value_node->get_id().find("Unnamed")==0)
 				{
-					ValueNode::Handle value_node(*iter);
-					if(value_node->is_exported() && value_node->get_id().find("Unnamed")==0)
-					{
-						canvas->remove_value_node(value_node, true);
-						goto again;
-					}
+					canvas->remove_value_node(value_node, true);
+					goto again;
 				}
-
-				return canvas;
 			}
-		} else {
-			throw std::runtime_error(String("  * ") + _("Can't find linked file") + " \"" + identifier.filename + "\"");
+
+			return canvas;
 		}
 	}
 	catch(Exception::BadLinkName&) { synfig::error("BadLinkName Thrown"); }
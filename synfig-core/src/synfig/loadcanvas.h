@@ -249,6 +249,21 @@ extern Canvas::Handle open_canvas(xmlpp::Element* node,String &errors,String &wa
 /*!	\return	The Canvas's handle on success, an empty handle on failure */
 extern Canvas::Handle open_canvas_as(const FileSystem::Identifier &identifier,const String &as,String &errors,String &warnings);
 
+//! Time spent on loading of one file, see get_canvas_load_times()
+struct CanvasLoadTime
+{
+	String filename;
+	Real read;   //!< reading and parsing of XML, may run in parallel with other files
+	Real build;  //!< creation of layers and value nodes, without nested files
+	Real import; //!< decoding of imported image in parallel with other files
+
+	CanvasLoadTime(): read(), build(), import() { }
+};
+
+//! Returns times of the files loaded by the last open_canvas_as() call
+//! (not nested into loading of other file) in order of their first use
+std::list<CanvasLoadTime> get_canvas_load_times();
+
 //! Returns the Open Canvases Map.
 //! \see open_canvas_map_
 using OpenCanvasMap = std::map<Canvas::LooseHandle, std::string>;
@@ -34,6 +34,7 @@
 #	include <config.h>
 #endif
 
+#include <chrono>
 #include <cstring>
 #include <ctime>
 
@@ -257,10 +258,17 @@ synfig::Main::Main(const synfig::String& rootpath,ProgressCallback *cb):
 	// Init the subsystems
 	if(cb)cb->amount_complete(0, 100);
 
+	std::chrono::steady_clock::time_point stage_timepoint = std::chrono::steady_clock::now();
+	#define STARTUP_STAGE(name) \
+		add_startup_time(name, std::chrono::duration<double>(std::chrono::steady_clock::now() - stage_timepoint).count()); \
+		stage_timepoint = std::chrono::steady_clock::now();
+
 	if(cb)cb->task(_("Starting Subsystem \"Sound\""));
 	if(!SoundProcessor::subsys_init())
 		throw std::runtime_error(_("Unable to initialize subsystem \"Sound\""));
 
+	STARTUP_STAGE("sound");
+
 	if(cb)cb->task(_("Starting Subsystem \"Types\""));
 	if(!Type::subsys_init())
 	{
@@ -268,6 +276,8 @@ synfig::Main::Main(const synfig::String& rootpath,ProgressCallback *cb):
 		throw std::runtime_error(_("Unable to initialize subsystem \"Types\""));
 	}
 
+	STARTUP_STAGE("types");
+
 	if(cb)cb->task(_("Starting Subsystem \"Rendering\""));
 	if(!rendering::Renderer::subsys_init())
 	{
@@ -276,6 +286,8 @@ synfig::Main::Main(const synfig::String& rootpath,ProgressCallback *cb):
 		throw std::runtime_error(_("Unable to initialize subsystem \"Rendering\""));
 	}
 
+	STARTUP_STAGE("rendering");
+
 	if(cb)cb->task(_("Starting Subsystem \"Modules\""));
 	if(!Module::subsys_init(root_path))
 	{
@@ -285,6 +297,8 @@ synfig::Main::Main(const synfig::String& rootpath,ProgressCallback *cb):
 		throw std::runtime_error(_("Unable to initialize subsystem \"Modules\""));
 	}
 
+	STARTUP_STAGE("module search paths");
+
 	if(cb)cb->task(_("Starting Subsystem \"Layers\""));
 	if(!Layer::subsys_init())
 	{
@@ -295,6 +309,8 @@ synfig::Main::Main(const synfig::String& rootpath,ProgressCallback *cb):
 		throw std::runtime_error(_("Unable to initialize subsystem \"Layers\""));
 	}
 
+	STARTUP_STAGE("layers");
+
 	if(cb)cb->task(_("Starting Subsystem \"Targets\""));
 	if(!Target::subsys_init())
 	{
@@ -306,6 +322,8 @@ synfig::Main::Main(const synfig::String& rootpath,ProgressCallback *cb):
 		throw std::runtime_error(_("Unable to initialize subsystem \"Targets\""));
 	}
 
+	STARTUP_STAGE("targets");
+
 	if(cb)cb->task(_("Starting Subsystem \"Importers\""));
 	if(!Importer::subsys_init())
 	{
@@ -318,10 +336,14 @@ synfig::Main::Main(const synfig::String& rootpath,ProgressCallback *cb):
 		throw std::runtime_error(_("Unable to initialize subsystem \"Importers\""));
 	}
 
+	STARTUP_STAGE("importers");
+
 	if(cb)cb->task(_("Starting Subsystem \"Thread Pool\""));
 	if(!ThreadPool::subsys_init())
 		throw std::runtime_error(_("Unable to initialize subsystem \"Thread Pool\""));
 
+	STARTUP_STAGE("thread pool");
+
 	// Rebuild tokens data
 	Token::rebuild();
 
@@ -377,22 +399,21 @@ synfig::Main::Main(const synfig::String& rootpath,ProgressCallback *cb):
 		Module::register_default_modules(cb);
 	}
 
-	std::list<String>::iterator iter;
-
-	for(i=0,iter=modules_to_load.begin();iter!=modules_to_load.end();++iter,i++)
-	{
-		synfig::info("Loading %s..", iter->c_str());
-		Module::Register(*iter,cb);
-		if(cb)cb->amount_complete((i+1)*100, modules_to_load.size()*100u);
-	}
+	Module::register_modules(modules_to_load, cb);
 
 	// Rebuild tokens data again to include new tokens from modules
 	Token::rebuild();
+	STARTUP_STAGE("modules");
+	#undef STARTUP_STAGE
 
 	if(cb)cb->amount_complete(100, 100);
 	if(cb)cb->task(_("DONE"));
 }
 
+void
+synfig::Main::add_startup_time(const String &stage, double seconds)
+	{ startup_times_.push_back(std::make_pair(stage, seconds)); }
+
 synfig::Main::~Main()
 {
 	ref_count_.detach();
@@ -31,6 +31,8 @@
 /* === H E A D E R S ======================================================= */
 
 #include <cassert>
+#include <list>
+#include <utility>
 
 #include <ETL/ref_count>
 
@@ -55,6 +57,9 @@ class Main
 private:
 	static Main *instance;
 	etl::reference_counter ref_count_;
+	std::list< std::pair<String, double> > startup_times_;
+
+	void add_startup_time(const String &stage, double seconds);
 
 public:
 	synfig::String root_path;
@@ -68,6 +73,9 @@ public:
 	~Main();
 
 	const etl::reference_counter& ref_count()const { return ref_count_; }
+	//! Time in seconds spent on each stage of initialization,
+	//! see also Module::get_load_times()
+	const std::list< std::pair<String, double> >& get_startup_times()const { return startup_times_; }
 	static const Main& get_instance() { assert(instance); return *instance; }
 }; // END of class Main
 
@@ -33,12 +33,27 @@
 #endif
 
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <vector>
+
 #include "module.h"
 
 #include "general.h"
 #include <synfig/localization.h>
+#include "importer.h"
+#include "target.h"
+#include "token.h"
 #include "type.h"
+#include "valuenode_registry.h"
 #include <glibmm.h>
+#include <glib/gstdio.h>
 
 #ifndef USE_CF_BUNDLES
 #include <ltdl.h>
@@ -55,6 +70,260 @@ using namespace synfig;
 
 Module::Book *synfig::Module::book_;
 
+namespace {
+
+//! first line of manifest file, increase the number when format changes
+const char manifest_header[] = "synfig-module-manifest 1";
+
+//! (Module::BookType, name of entry in book)
+typedef std::pair<int, String> Entry;
+//! values of entries, used to find entries replaced by module
+typedef std::map<Entry, String> EntryValues;
+
+struct ManifestModule
+{
+	String name;
+	String path;
+	long long mtime;
+	long long size;
+	std::vector<Entry> entries; //!< added or replaced by module
+	std::vector<int> related;   //!< modules which touch the same entries
+	bool loaded;
+
+	ManifestModule(): mtime(), size(), loaded() { }
+};
+
+std::recursive_mutex lazy_mutex;
+bool lazy_loading = false;
+std::vector<ManifestModule> lazy_modules;
+//! the last module in list which touches the entry, it defines value of entry
+std::map<Entry, int> lazy_owners;
+//! count of modules which are not loaded yet,
+//! it is read without lock, so lookups don't wait for each other when all modules are loaded
+std::atomic<int> lazy_pending(0);
+
+std::list< std::pair<String, Real> > load_times;
+//! files of loaded modules
+std::map<String, String> module_files;
+
+const char* book_type_name(int type)
+{
+	switch(type) {
+	case Module::BOOK_LAYER:      return "layer";
+	case Module::BOOK_TARGET:     return "target";
+	case Module::BOOK_TARGET_EXT: return "target-ext";
+	case Module::BOOK_IMPORTER:   return "importer";
+	case Module::BOOK_VALUENODE:  return "valuenode";
+	default: break;
+	}
+	return nullptr;
+}
+
+int book_type_by_name(const String &name)
+{
+	for(int type = Module::BOOK_LAYER; type <= Module::BOOK_VALUENODE; ++type)
+		if (name == book_type_name(type))
+			return type;
+	return -1;
+}
+
+template<typename T>
+String factory_id(T factory)
+	{ return std::to_string(reinterpret_cast<std::uintptr_t>(factory)); }
+
+template<typename T>
+void collect_factories(EntryValues &values, int type, const T &book)
+{
+	for(typename T::const_iterator i = book.begin(); i != book.end(); ++i)
+		values[Entry(type, i->first)] = factory_id(i->second.factory);
+}
+
+EntryValues collect_entries()
+{
+	EntryValues values;
+	collect_factories(values, Module::BOOK_LAYER, Layer::book());
+	collect_factories(values, Module::BOOK_TARGET, Target::book());
+	collect_factories(values, Module::BOOK_IMPORTER, Importer::book());
+	collect_factories(values, Module::BOOK_VALUENODE, ValueNodeRegistry::book());
+	for(Target::ExtBook::const_iterator i = Target::ext_book().begin(); i != Target::ext_book().end(); ++i)
+		values[Entry(Module::BOOK_TARGET_EXT, i->first)] = i->second;
+	return values;
+}
+
+String get_manifest_filename()
+{
+	if (const char *filename = getenv("SYNFIG_MODULE_MANIFEST"))
+		return filename;
+	return Glib::build_filename(Glib::get_user_cache_dir(), "synfig", "synfig_modules.manifest");
+}
+
+bool get_file_info(const String &path, long long &mtime, long long &size)
+{
+	GStatBuf info;
+	if (path.empty() || g_stat(path.c_str(), &info) != 0)
+		return false;
+	mtime = (long long)info.st_mtime;
+	size = (long long)info.st_size;
+	return true;
+}
+
+//! Reads manifest, it is valid only for the same list of modules with unchanged files
+bool read_manifest(const String &filename, const std::list<String> &module_names, std::vector<ManifestModule> &modules)
+{
+	std::ifstream file(filename.c_str());
+	if (!file)
+		return false;
+
+	String line;
+	if (!std::getline(file, line) || line != manifest_header)
+		return false;
+	if (!std::getline(file, line) || line != String("version ") + SYNFIG_VERSION)
+		return false;
+
+	modules.clear();
+	while(std::getline(file, line))
+	{
+		std::istringstream stream(line);
+		String word;
+		stream >> word;
+		if (word == "module")
+		{
+			modules.push_back(ManifestModule());
+			ManifestModule &module = modules.back();
+			stream >> module.name >> module.mtime >> module.size;
+			std::getline(stream >> std::ws, module.path);
+			if (!stream && !stream.eof())
+				return false;
+		}
+		else
+		if (word == "end")
+		{
+			break;
+		}
+		else
+		{
+			int type = book_type_by_name(word);
+			String name;
+			std::getline(stream >> std::ws, name);
+			if (type < 0 || name.empty() || modules.empty())
+				return false;
+			modules.back().entries.push_back(Entry(type, name));
+		}
+	}
+	if (line != "end")
+		return false;
+
+	if (modules.size() != module_names.size())
+		return false;
+	std::list<String>::const_iterator name = module_names.begin();
+	for(std::vector<ManifestModule>::const_iterator i = modules.begin(); i != modules.end(); ++i, ++name)
+	{
+		if (i->name != *name)
+			return false;
+		// modules which were not found have no file
+		if (i->path.empty())
+			continue;
+		long long mtime, size;
+		if (!get_file_info(i->path, mtime, size) || mtime != i->mtime || size != i->size)
+			return false;
+	}
+	return true;
+}
+
+bool write_manifest(const String &filename, const std::vector<ManifestModule> &modules)
+{
+	g_mkdir_with_parents(Glib::path_get_dirname(filename).c_str(), 0755);
+
+	// write into temporary file first, so simultaneously started processes
+	// will not read incomplete manifest
+	String tmp_filename = filename + "." + std::to_string(g_get_real_time()) + ".tmp";
+	{
+		std::ofstream file(tmp_filename.c_str());
+		if (!file)
+			return false;
+		file << manifest_header << std::endl;
+		file << "version " << SYNFIG_VERSION << std::endl;
+		for(std::vector<ManifestModule>::const_iterator i = modules.begin(); i != modules.end(); ++i)
+		{
+			file << "module " << i->name << " " << i->mtime << " " << i->size << " " << i->path << std::endl;
+			for(std::vector<Entry>::const_iterator j = i->entries.begin(); j != i->entries.end(); ++j)
+				file << book_type_name(j->first) << " " << j->second << std::endl;
+		}
+		file << "end" << std::endl;
+		if (!file)
+		{
+			g_remove(tmp_filename.c_str());
+			return false;
+		}
+	}
+	if (g_rename(tmp_filename.c_str(), filename.c_str()) != 0)
+	{
+		g_remove(tmp_filename.c_str());
+		return false;
+	}
+	return true;
+}
+
+//! Fills owners of entries and relations between modules which touch the same entries
+void link_manifest(std::vector<ManifestModule> &modules, std::map<Entry, int> &owners)
+{
+	std::map<Entry, std::vector<int> > touched;
+	for(int i = 0; i < (int)modules.size(); ++i)
+		for(std::vector<Entry>::const_iterator j = modules[i].entries.begin(); j != modules[i].entries.end(); ++j)
+			touched[*j].push_back(i);
+
+	owners.clear();
+	for(std::map<Entry, std::vector<int> >::const_iterator i = touched.begin(); i != touched.end(); ++i)
+	{
+		owners[i->first] = i->second.back();
+		for(std::vector<int>::const_iterator j = i->second.begin(); j != i->second.end(); ++j)
+			for(std::vector<int>::const_iterator k = i->second.begin(); k != i->second.end(); ++k)
+				if (*j != *k)
+					modules[*j].related.push_back(*k);
+	}
+	for(std::vector<ManifestModule>::iterator i = modules.begin(); i != modules.end(); ++i)
+	{
+		std::sort(i->related.begin(), i->related.end());
+		i->related.erase(std::unique(i->related.begin(), i->related.end()), i->related.end());
+	}
+}
+
+//! Loads module with all related modules in order of the list,
+//! so replaced entries get the same values as with loading of all modules.
+//! lazy_mutex must be locked
+void load_lazy_module(int index, ProgressCallback *cb)
+{
+	std::set<int> group;
+	std::vector<int> stack(1, index);
+	while(!stack.empty())
+	{
+		int i = stack.back();
+		stack.pop_back();
+		if (lazy_modules[i].loaded || !group.insert(i).second)
+			continue;
+		stack.insert(stack.end(), lazy_modules[i].related.begin(), lazy_modules[i].related.end());
+	}
+	if (group.empty())
+		return;
+
+	for(std::set<int>::const_iterator i = group.begin(); i != group.end(); ++i)
+	{
+		ManifestModule &module = lazy_modules[*i];
+		synfig::info("Loading %s on demand..", module.name.c_str());
+		module.loaded = true;
+		Module::Register(module.name, cb);
+	}
+
+	// include new tokens from modules
+	Token::rebuild();
+
+	// decrease only when entries are registered,
+	// because require() returns without lock when there is nothing to load
+	lazy_pending -= (int)group.size();
+}
+
+} // END of anonymous namespace
+
 /* === P R O C E D U R E S ================================================= */
 
 bool
@@ -148,6 +417,9 @@ synfig::Module::Register(const String &module_name, ProgressCallback *callback)
 
 	if(callback)callback->task(strprintf(_("Attempting to register \"%s\""),module_name.c_str()));
 
+	std::chrono::steady_clock::time_point start_timepoint =
+		std::chrono::steady_clock::now();
+
 	module=lt_dlopenext((std::string("lib")+module_name).c_str());
 	if(!module)module=lt_dlopenext(module_name.c_str());
 	Type::initialize_all();
@@ -160,6 +432,10 @@ synfig::Module::Register(const String &module_name, ProgressCallback *callback)
 
 	if(callback)callback->task(strprintf(_("Found module \"%s\""),module_name.c_str()));
 
+	if (const lt_dlinfo *info = lt_dlgetinfo(module))
+		if (info->filename)
+			module_files[module_name] = info->filename;
+
 	Module::constructor_type constructor=nullptr;
 	Handle mod;
 
@@ -193,10 +469,106 @@ synfig::Module::Register(const String &module_name, ProgressCallback *callback)
 
 	if(callback)callback->task(strprintf(_("Success for \"%s\""),module_name.c_str()));
 
+	std::chrono::duration<Real> duration = std::chrono::steady_clock::now() - start_timepoint;
+	load_times.push_back(std::make_pair(module_name, duration.count()));
+
 #endif
 	return true;
 }
 
+void
+Module::set_lazy_loading(bool x)
+	{ lazy_loading = x; }
+
+bool
+Module::get_lazy_loading()
+	{ return lazy_loading; }
+
+void
+Module::register_modules(const std::list<String> &module_names, ProgressCallback *callback)
+{
+	std::lock_guard<std::recursive_mutex> lock(lazy_mutex);
+
+#ifndef USE_CF_BUNDLES
+	const String manifest_filename = lazy_loading ? get_manifest_filename() : String();
+	if (lazy_loading && read_manifest(manifest_filename, module_names, lazy_modules))
+	{
+		synfig::info(_("Modules will be loaded on demand, see %s"), manifest_filename.c_str());
+		link_manifest(lazy_modules, lazy_owners);
+		lazy_pending = (int)lazy_modules.size();
+		return;
+	}
+#endif
+
+	std::vector<ManifestModule> modules;
+	EntryValues values;
+	if (lazy_loading)
+		values = collect_entries();
+
+	int i = 0;
+	for(std::list<String>::const_iterator iter = module_names.begin(); iter != module_names.end(); ++iter, ++i)
+	{
+		synfig::info("Loading %s..", iter->c_str());
+		bool success = Register(*iter, callback);
+		if(callback)callback->amount_complete((i+1)*100, module_names.size()*100u);
+		if (!lazy_loading)
+			continue;
+
+		// remember the entries added or replaced by module
+		modules.push_back(ManifestModule());
+		ManifestModule &module = modules.back();
+		module.name = *iter;
+		module.loaded = true;
+		EntryValues new_values = collect_entries();
+		for(EntryValues::const_iterator j = new_values.begin(); j != new_values.end(); ++j)
+		{
+			EntryValues::const_iterator prev = values.find(j->first);
+			if (prev == values.end() || prev->second != j->second)
+				module.entries.push_back(j->first);
+		}
+		values.swap(new_values);
+
+		std::map<String, String>::const_iterator file = module_files.find(*iter);
+		if (success && file != module_files.end() && get_file_info(file->second, module.mtime, module.size))
+			module.path = file->second;
+	}
+
+#ifndef USE_CF_BUNDLES
+	if (lazy_loading && !write_manifest(manifest_filename, modules))
+		synfig::warning(_("Unable to write manifest of modules %s"), manifest_filename.c_str());
+#endif
+}
+
+void
+Module::require(BookType type, const String &name)
+{
+	if (!lazy_pending)
+		return;
+	std::lock_guard<std::recursive_mutex> lock(lazy_mutex);
+	if (!lazy_pending)
+		return;
+	std::map<Entry, int>::const_iterator i = lazy_owners.find(Entry(type, name));
+	if (i != lazy_owners.end())
+		load_lazy_module(i->second, nullptr);
+}
+
+void
+Module::require_all(ProgressCallback *callback)
+{
+	if (!lazy_pending)
+		return;
+	std::lock_guard<std::recursive_mutex> lock(lazy_mutex);
+	for(int i = 0; lazy_pending && i < (int)lazy_modules.size(); ++i)
+		load_lazy_module(i, callback);
+}
+
+std::list< std::pair<String, Real> >
+Module::get_load_times()
+{
+	std::lock_guard<std::recursive_mutex> lock(lazy_mutex);
+	return load_times;
+}
+
 synfig::Module::~Module()
 {
 	destructor_();
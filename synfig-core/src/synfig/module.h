@@ -32,6 +32,7 @@
 /* === H E A D E R S ======================================================= */
 
 #include <ETL/handle>
+#include <list>
 #include <map>
 #include "string.h"
 #include "releases.h"
@@ -146,6 +147,15 @@
 //! Register an Importer class in the book of importers by the default extension
 #define IMPORTER(x) IMPORTER_EXT(x,x::ext__)
 
+//! Register an Importer class which may be loaded simultaneously with other importers
+//! (see Importer::preload()) in the book of importers by one file extension string
+#define IMPORTER_EXT_PARALLEL(x,y) \
+		synfig::Importer::book()[synfig::String(y)]=synfig::Importer::BookEntry(x::create, x::supports_file_system_wrapper__, true);
+
+//! Register an Importer class which may be loaded simultaneously with other importers
+//! in the book of importers by the default extension
+#define IMPORTER_PARALLEL(x) IMPORTER_EXT_PARALLEL(x,x::ext__)
+
 //! Marks the end of the importers in the module's inventory
 #define END_IMPORTERS }
 
@@ -214,6 +224,15 @@ class ProgressCallback;
 * Modules are not auto-registered. Instead, Synfig register those listed in a
 * plain-text file called "synfig_modules.cfg" or that defined by envvar SYNFIG_MODULE_LIST.
 * See synfig::Main for further details.
+*
+* In lazy loading mode (see set_lazy_loading()) the listed modules are not loaded
+* at startup. Instead, the names of layers, targets, importers and valuenodes
+* provided by each module are read from a manifest file, and the module is loaded
+* by require() on the first request of one of its entries. The manifest is
+* written automatically after all listed modules were loaded, and it is rebuilt
+* when the list of modules, the version of Synfig or some module file changes.
+* Manifest is stored in the user cache directory or in the file defined by envvar
+* SYNFIG_MODULE_MANIFEST.
 */
 class Module : public etl::shared_object
 {
@@ -232,6 +251,15 @@ public:
 	typedef Module* (*constructor_type)(ProgressCallback *);
 	//! Type of registered modules: maps Module name to Module handle
 	typedef std::map<String, Handle> Book;
+
+	//! Kinds of the entries which modules add to the books
+	enum BookType {
+		BOOK_LAYER,      //!< Layer::book()
+		BOOK_TARGET,     //!< Target::book()
+		BOOK_TARGET_EXT, //!< Target::ext_book()
+		BOOK_IMPORTER,   //!< Importer::book()
+		BOOK_VALUENODE   //!< ValueNodeRegistry::book()
+	};
 private:
 	//! Registered modules
 	static Book* book_;
@@ -253,6 +281,21 @@ public:
 	//!Register Module by instance pointer
 	static inline void Register(Module *mod) { Register(Handle(mod)); }
 
+	//! Enables or disables loading of modules on demand, should be called before synfig::Main
+	static void set_lazy_loading(bool x);
+	static bool get_lazy_loading();
+	//! Registers modules by names. In lazy loading mode with a valid manifest
+	//! modules are not loaded here, only their entries are remembered
+	static void register_modules(const std::list<String> &module_names, ProgressCallback *cb=nullptr);
+	//! Loads the module which provides the entry, if it isn't loaded yet.
+	//! Call it before searching for a name in the corresponding book
+	static void require(BookType type, const String &name);
+	//! Loads all modules which are not loaded yet.
+	//! Call it before enumerating the entries of books
+	static void require_all(ProgressCallback *cb=nullptr);
+	//! Time in seconds spent on loading of each module (by file name) in order of loading
+	static std::list< std::pair<String, Real> > get_load_times();
+
 	// Virtual Modules properties wrappers.
 	// They MUST be defined in the module implementation classes.
 	// They SHOULD be defined via MODULE_* macros inside MODULE_DESC_BEGIN/END block.
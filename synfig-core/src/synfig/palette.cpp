@@ -42,6 +42,8 @@
 #include "general.h"
 #include "filesystemnative.h"
 #include <synfig/localization.h>
+#include <algorithm>
+#include <climits>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -77,6 +79,59 @@ bool luma_less_than(const PaletteItem& lhs,const float& rhs)
 	return lhs.color.get_y()<rhs;
 }
 
+namespace {
+
+struct HistogramCell
+{
+	int key[3];
+	Color sum;
+	int count;
+
+	HistogramCell(): key(), count() { }
+};
+
+struct HistogramBox
+{
+	std::vector<HistogramCell>::iterator begin;
+	std::vector<HistogramCell>::iterator end;
+	int min[3];
+	int max[3];
+	int count;
+
+	HistogramBox(
+		std::vector<HistogramCell>::iterator begin,
+		std::vector<HistogramCell>::iterator end
+	):
+		begin(begin), end(end), min(), max(), count() { }
+
+	void update()
+	{
+		for(int c = 0; c < 3; ++c)
+			{ min[c] = INT_MAX; max[c] = INT_MIN; }
+		count = 0;
+		for(std::vector<HistogramCell>::const_iterator i = begin; i != end; ++i) {
+			for(int c = 0; c < 3; ++c) {
+				min[c] = std::min(min[c], i->key[c]);
+				max[c] = std::max(max[c], i->key[c]);
+			}
+			count += i->count;
+		}
+	}
+
+	int longest_axis() const
+	{
+		int axis = 0;
+		for(int c = 1; c < 3; ++c)
+			if (max[c] - min[c] > max[axis] - min[axis]) axis = c;
+		return axis;
+	}
+
+	int extent() const
+		{ return max[longest_axis()] - min[longest_axis()] + 1; }
+};
+
+}
+
 /* === P R O C E D U R E S ================================================= */
 
 /* === M E T H O D S ======================================================= */
@@ -101,98 +156,91 @@ PaletteItem::add(const Color& x,int xweight)
 Palette::Palette(const Surface& surface, int max_colors, const Gamma &gamma):
 	name_(_("Surface Palette"))
 {
-	max_colors-=2;
-	for(int i=0;(signed)size()<(max_colors-1) && i<max_colors*16;++i) {
-        int x=rand()%surface.get_w();
-        int y=rand()%surface.get_h();
-
-			float dist;
-			Color color(surface[y][x]);
-
-			if(empty())
-			{
-				push_back(color);
-				continue;
-			}
-
-			if(color.get_a()==0)
-			{
-				if(front().color.get_a()!=0)
-					insert(begin(),Color(1,0,1,0));
-				front().weight+=400;
-				continue;
-			}
-
-			iterator iter(find_closest(color, gamma, &dist));
-			if(sqrt(dist)<0.005)
-			{
-				iter->add(color);
-				continue;
-			}
-
-			/*if(size()>=max_colors)
-			{
-				iterator iterlight(find_light());
-				PaletteItem light(*iterlight);
-				erase(iterlight);
-				find_closest(light.color, gamma)->add(light.color,light.weight);
-			}
-			*/
-
-			push_back(color);
-			continue;
-    }
-
-/*
-
-	max_colors-=2;
-	for(int y=0;y<surface.get_h();y++)
-		for(int x=0;x<surface.get_w();x++)
-		{
-			float dist;
-			Color color(surface[y][x]);
-
-			if(empty())
-			{
-				push_back(color);
-				continue;
-			}
-
-			if(color.get_a()==0)
-			{
-				if(front().color.get_a()!=0)
-					insert(begin(),Color(1,0,1,0));
-				front().weight+=400;
-				continue;
-			}
-
-			iterator iter(find_closest(color, gamma, &dist));
-			if(sqrt(dist)<0.005)
-			{
-				iter->add(color);
-				continue;
+	// histogram with 5 bits per channel, colors are accumulated in gamma space
+	const int bits = 5;
+	const int levels = 1 << bits;
+	std::vector<HistogramCell> histogram(levels*levels*levels);
+
+	int transparent = 0;
+	for(int y = 0; y < surface.get_h(); ++y) {
+		const Color *row = surface[y];
+		for(int x = 0; x < surface.get_w(); ++x) {
+			if (row[x].get_a() <= 0) { ++transparent; continue; }
+			Color color = gamma.apply(row[x].clamped());
+			int r = std::min(levels - 1, (int)(color.get_r()*levels));
+			int g = std::min(levels - 1, (int)(color.get_g()*levels));
+			int b = std::min(levels - 1, (int)(color.get_b()*levels));
+			HistogramCell &cell = histogram[(r*levels + g)*levels + b];
+			if (!cell.count) {
+				cell.key[0] = r;
+				cell.key[1] = g;
+				cell.key[2] = b;
 			}
+			cell.sum += color;
+			++cell.count;
+		}
+	}
 
+	std::vector<HistogramCell> cells;
+	for(std::vector<HistogramCell>::const_iterator i = histogram.begin(); i != histogram.end(); ++i)
+		if (i->count) cells.push_back(*i);
+
+	// one entry is reserved for transparency, and two for black and white
+	// when the palette is large enough, the total never exceeds max_colors
+	max_colors = std::max(1, max_colors);
+	const bool has_transparent = transparent && (max_colors > 1 || cells.empty());
+	const int colors_count = max_colors - (has_transparent ? 1 : 0);
+	const bool has_extremes = colors_count >= 8;
+	const int boxes_count = colors_count - (has_extremes ? 2 : 0);
+
+	std::vector<HistogramBox> boxes;
+	if (!cells.empty() && boxes_count > 0) {
+		boxes.push_back(HistogramBox(cells.begin(), cells.end()));
+		boxes.back().update();
+	}
 
-			push_back(color);
-			continue;
+	// median cut: split the box with largest weighted extent at the median of its longest axis
+	while((int)boxes.size() < boxes_count) {
+		std::vector<HistogramBox>::iterator best = boxes.end();
+		long long best_score = 0;
+		for(std::vector<HistogramBox>::iterator i = boxes.begin(); i != boxes.end(); ++i) {
+			long long score = (long long)i->extent()*i->count;
+			if (i->end - i->begin > 1 && score > best_score)
+				{ best = i; best_score = score; }
 		}
-	sort(rbegin(),rend());
+		if (best == boxes.end()) break;
+
+		const int axis = best->longest_axis();
+		std::sort(best->begin, best->end, [axis](const HistogramCell &a, const HistogramCell &b)
+			{ return a.key[axis] < b.key[axis]; });
+
+		int half = 0;
+		std::vector<HistogramCell>::iterator middle = best->begin;
+		while(middle + 2 < best->end && (half += middle->count)*2 < best->count) ++middle;
+		++middle;
+
+		HistogramBox second(middle, best->end);
+		best->end = middle;
+		best->update();
+		second.update();
+		boxes.push_back(second);
+	}
 
-	iterator iter;
+	if (has_transparent)
+		push_back(PaletteItem(Color(1,0,1,0), transparent));
 
-	iterator best_match(begin());
-	while((signed)size()>max_colors)
-	{
-		PaletteItem item(back());
-		pop_back();
-		find_closest(item.color, gamma)->add(item.color,item.weight);
+	const Gamma inverse = gamma.get_inverted();
+	for(std::vector<HistogramBox>::const_iterator i = boxes.begin(); i != boxes.end(); ++i) {
+		Color sum;
+		for(std::vector<HistogramCell>::const_iterator j = i->begin; j != i->end; ++j)
+			sum += j->sum;
+		push_back(PaletteItem(inverse.apply(sum/(ColorReal)i->count), i->count));
 	}
-*/
-	push_back(Color::black());
-	push_back(Color::white());
 
-//	sort(begin(),end(),&luma_less_than);
+	if (has_extremes) {
+		push_back(Color::black());
+		push_back(Color::white());
+	}
 }
 
 Palette::const_iterator
@@ -253,6 +301,80 @@ Palette::find_closest(const Color& color, const Gamma &gamma, float* dist)
 }
 
 
+PaletteLookup::PaletteLookup():
+	palette(),
+	cells(new std::atomic<short>[CELLS_COUNT])
+{
+	reset();
+}
+
+PaletteLookup::PaletteLookup(const Palette &palette, const Gamma &gamma):
+	palette(),
+	cells(new std::atomic<short>[CELLS_COUNT])
+{
+	reset(palette, gamma);
+}
+
+void
+PaletteLookup::reset()
+{
+	for(int i = 0; i < CELLS_COUNT; ++i)
+		cells[i].store(-1, std::memory_order_relaxed);
+}
+
+void
+PaletteLookup::reset(const Palette &palette, const Gamma &gamma)
+{
+	this->palette = &palette;
+	this->gamma = gamma;
+	reset();
+}
+
+Color
+PaletteLookup::get_cell_color(const Color &color)
+	{ return cell_color(cell_index(color)); }
+
+int
+PaletteLookup::cell_index(const Color &color)
+{
+	const int levels = 1 << BITS;
+	int r = synfig::clamp((int)(color.get_r()*levels), 0, levels - 1);
+	int g = synfig::clamp((int)(color.get_g()*levels), 0, levels - 1);
+	int b = synfig::clamp((int)(color.get_b()*levels), 0, levels - 1);
+	int a = color.get_a() <= 0.00001 ? 0
+		  : color.get_a() < 0.5      ? 1
+		  : color.get_a() < 0.99999  ? 2
+		  : 3;
+	return ((a*levels + r)*levels + g)*levels + b;
+}
+
+Color
+PaletteLookup::cell_color(int index)
+{
+	static const ColorReal alpha[] = { 0, 0.25, 0.75, 1 };
+	const int levels = 1 << BITS;
+	const ColorReal k = 1/ColorReal(levels);
+	int b = index % levels; index /= levels;
+	int g = index % levels; index /= levels;
+	int r = index % levels; index /= levels;
+	return Color((r + 0.5)*k, (g + 0.5)*k, (b + 0.5)*k, alpha[index]);
+}
+
+int
+PaletteLookup::find_closest(const Color &color) const
+{
+	// results for a cell are deterministic, so concurrent fills are harmless
+	if (!palette || palette->empty())
+		return 0;
+	const int index = cell_index(color);
+	int entry = cells[index].load(std::memory_order_relaxed);
+	if (entry < 0) {
+		entry = palette->find_closest(cell_color(index), gamma) - palette->begin();
+		cells[index].store((short)entry, std::memory_order_relaxed);
+	}
+	return entry;
+}
+
 Palette::iterator
 Palette::find_heavy()
 {
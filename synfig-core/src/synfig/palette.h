@@ -32,6 +32,8 @@
 
 #include "color.h"
 #include "string.h"
+#include <atomic>
+#include <memory>
 #include <vector>
 
 /* === M A C R O S ========================================================= */
@@ -72,7 +74,7 @@ public:
 	Palette(const String& name_);
 
 	/*! Generates a palette for the given
-	**	surface
+	**	surface by median cut over a color histogram
 	*/
 	Palette(const Surface& surface, int size, const Gamma &gamma);
 
@@ -90,6 +92,48 @@ public:
 	static Palette load_from_file(const synfig::String& filename);
 }; // END of class Palette
 
+/*!	\class PaletteLookup
+**	\brief Cached nearest color search for a fixed palette
+**
+**	Colors are quantized to 6 bits per channel and 2 bits of alpha,
+**	the closest palette entry is resolved once per cell and then reused.
+**	The cache is filled lazily and may be queried from several threads.
+**	The table is large, so reuse the same lookup for sequential frames, see reset().
+*/
+class PaletteLookup
+{
+public:
+	enum {
+		BITS = 6,
+		ALPHA_BITS = 2,
+		CELLS_COUNT = 1 << (3*BITS + ALPHA_BITS)
+	};
+
+private:
+	const Palette *palette;
+	Gamma gamma;
+	std::unique_ptr< std::atomic<short>[] > cells;
+
+	static int cell_index(const Color &color);
+	static Color cell_color(int index);
+
+	void reset();
+
+public:
+	PaletteLookup();
+	PaletteLookup(const Palette &palette, const Gamma &gamma);
+
+	//! Switches to another palette and clears the cache,
+	//!  palette must stay alive while lookup is used
+	void reset(const Palette &palette, const Gamma &gamma);
+
+	//! Color by which the closest entry is searched for  color
+	static Color get_cell_color(const Color &color);
+
+	//! Index of the palette entry closest to \a color
+	int find_closest(const Color &color) const;
+}; // END of class PaletteLookup
+
 }; // END of namespace synfig
 
 /* === E N D =============================================================== */
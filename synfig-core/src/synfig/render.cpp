@@ -183,7 +183,12 @@ synfig::render(
 	}
 
 	// Finish up the target's frame
-	target->end_frame();
+	if(!target->end_frame())
+	{
+		if(callback)callback->error(_("Target panic"));
+		else throw(std::string(_("Target panic")));
+		return false;
+	}
 
 	// Give the callback one more last call,
 	// this time with the full height as the
@@ -0,0 +1,190 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file synfig/rendering/common/optimizer/optimizerocclusion.cpp
+**	\brief OptimizerOcclusion
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#ifdef USING_PCH
+#	include "pch.h"
+#else
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include <cmath>
+
+#include <synfig/general.h>
+#include <synfig/localization.h>
+#include <synfig/debug/log.h>
+
+#include "optimizerocclusion.h"
+
+#include "../task/taskblend.h"
+#include "../../renderer.h"
+
+#endif
+
+using namespace synfig;
+using namespace rendering;
+
+/* === M A C R O S ========================================================= */
+
+/* === G L O B A L S ======================================================= */
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+	long long calc_area(const RectInt &rect)
+		{ return rect.is_valid() ? (long long)(rect.maxx - rect.minx)*(rect.maxy - rect.miny) : 0; }
+
+	bool is_same_grid(const Vector &ppu_a, const Vector &ppu_b)
+		{ return approximate_equal_lp(ppu_a[0], ppu_b[0]) && approximate_equal_lp(ppu_a[1], ppu_b[1]); }
+
+	//! shrinks rect to the whole pixels of the task
+	Rect snap_inside(const Task &task, const Rect &rect)
+	{
+		const Real precision = 1e-6;
+		Vector ppu = task.get_pixels_per_unit();
+		const Rect &sr = task.source_rect;
+		Rect r(
+			sr.minx + std::ceil ((rect.minx - sr.minx)*ppu[0] - precision)/ppu[0],
+			sr.miny + std::ceil ((rect.miny - sr.miny)*ppu[1] - precision)/ppu[1],
+			sr.minx + std::floor((rect.maxx - sr.minx)*ppu[0] + precision)/ppu[0],
+			sr.miny + std::floor((rect.maxy - sr.miny)*ppu[1] + precision)/ppu[1] );
+		return r.minx < r.maxx && r.miny < r.maxy ? r : Rect::zero();
+	}
+
+	//! part of 'rect' which is not covered by 'cover',
+	//! returns 'rect' when uncovered part is not a rectangle
+	Rect calc_uncovered(const Rect &rect, const Rect &cover)
+	{
+		Rect best = rect;
+		Real best_area = rect.area();
+		Rect candidates[4] = { rect, rect, rect, rect };
+		if (cover.miny <= rect.miny && cover.maxy >= rect.maxy) {
+			if (cover.minx <= rect.minx) candidates[0].minx = std::max(rect.minx, cover.maxx);
+			if (cover.maxx >= rect.maxx) candidates[1].maxx = std::min(rect.maxx, cover.minx);
+		}
+		if (cover.minx <= rect.minx && cover.maxx >= rect.maxx) {
+			if (cover.miny <= rect.miny) candidates[2].miny = std::max(rect.miny, cover.maxy);
+			if (cover.maxy >= rect.maxy) candidates[3].maxy = std::min(rect.maxy, cover.miny);
+		}
+		for(int i = 0; i < 4; ++i) {
+			const Rect &r = candidates[i];
+			Real area = r.minx < r.maxx && r.miny < r.maxy ? r.area() : 0.0;
+			if (area < best_area)
+				{ best = r; best_area = area; }
+		}
+		return best;
+	}
+}
+
+/* === M E T H O D S ======================================================= */
+
+OptimizerOcclusion::OptimizerOcclusion():
+	culled_tasks(0),
+	culled_pixels(0)
+{
+	category_id = CATEGORY_ID_SPECIALIZED;
+	depends_from = CATEGORY_COORDS;
+	for_task = true;
+}
+
+void
+OptimizerOcclusion::run(const RunParams& params) const
+{
+	//
+	// blend(COMPOSITE)
+	// - taskA  - hidden by opaque part of taskB, will be removed or truncated
+	// - taskB
+	//
+
+	TaskBlend::Handle blend = TaskBlend::Handle::cast_dynamic(params.ref_task);
+	if ( !blend
+	  || blend->blend_method != Color::BLEND_COMPOSITE
+	  || !approximate_equal_lp(blend->amount, ColorReal(1.0))
+	  || !blend->is_valid_coords() )
+		return;
+
+	const Task::Handle &a = blend->sub_task_a();
+	const Task::Handle &b = blend->sub_task_b();
+	if ( !a || !a->is_valid_coords() || a->target_surface == blend->target_surface
+	  || !b || !b->is_valid_coords() )
+		return;
+
+	// tasks should be placed on the same pixel grid
+	Vector ppu = blend->get_pixels_per_unit();
+	if ( !is_same_grid(a->get_pixels_per_unit(), ppu)
+	  || !is_same_grid(b->get_pixels_per_unit(), ppu) )
+		return;
+
+	Rect opaque = b->calc_opaque_bounds() & b->source_rect & blend->source_rect;
+	if (!opaque.is_valid())
+		return;
+	opaque = snap_inside(*blend, opaque);
+	if (!opaque.is_valid())
+		return;
+
+	if (opaque.contains(a->source_rect))
+	{
+		TaskBlend::Handle new_blend = TaskBlend::Handle::cast_dynamic(blend->clone());
+		new_blend->sub_task_a() = Task::Handle();
+
+		long long tasks = ++culled_tasks;
+		long long pixels = culled_pixels += calc_area(a->target_rect);
+		const String &logfile = Renderer::get_debug_options().optimizer_log;
+		if (!logfile.empty())
+			debug::Log::info(logfile, "occlusion: removed %s %dx%d, culled %lld tasks, %lld pixels",
+				a->get_token()->name.c_str(),
+				a->target_rect.get_width(), a->target_rect.get_height(),
+				tasks, pixels );
+
+		apply(params, new_blend);
+		return;
+	}
+
+	Rect rect = calc_uncovered(a->source_rect, opaque);
+	if (rect == a->source_rect)
+		return;
+
+	Task::Handle new_a = a->clone_recursive();
+	new_a->set_coords(rect, new_a->target_rect.get_size());
+	long long pixels = calc_area(a->target_rect) - calc_area(new_a->target_rect);
+	if (pixels <= 0)
+		return;
+
+	TaskBlend::Handle new_blend = TaskBlend::Handle::cast_dynamic(blend->clone());
+	new_blend->sub_task_a() = new_a;
+
+	long long total_pixels = culled_pixels += pixels;
+	const String &logfile = Renderer::get_debug_options().optimizer_log;
+	if (!logfile.empty())
+		debug::Log::info(logfile, "occlusion: truncated %s %dx%d to %dx%d, culled %lld tasks, %lld pixels",
+			a->get_token()->name.c_str(),
+			a->target_rect.get_width(), a->target_rect.get_height(),
+			new_a->target_rect.get_width(), new_a->target_rect.get_height(),
+			(long long)culled_tasks, total_pixels );
+
+	apply(params, new_blend);
+}
+
+/* === E N T R Y P O I N T ================================================= */
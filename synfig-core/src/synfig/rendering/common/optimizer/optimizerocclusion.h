@@ -0,0 +1,73 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file synfig/rendering/common/optimizer/optimizerocclusion.h
+**	\brief OptimizerOcclusion Header
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === S T A R T =========================================================== */
+
+#ifndef __SYNFIG_RENDERING_OPTIMIZEROCCLUSION_H
+#define __SYNFIG_RENDERING_OPTIMIZEROCCLUSION_H
+
+/* === H E A D E R S ======================================================= */
+
+#include <atomic>
+
+#include "../../optimizer.h"
+
+/* === M A C R O S ========================================================= */
+
+/* === T Y P E D E F S ===================================================== */
+
+/* === C L A S S E S & S T R U C T S ======================================= */
+
+namespace synfig
+{
+namespace rendering
+{
+
+//! Removes (or truncates) destination of BLEND_COMPOSITE
+//! when it is hidden by opaque region of the source,
+//! see Task::calc_opaque_bounds().
+//! Culled tasks and pixels are counted and written to the optimizer log
+//! (see Renderer::DebugOptions::optimizer_log)
+class OptimizerOcclusion: public Optimizer
+{
+private:
+	mutable std::atomic<long long> culled_tasks;
+	mutable std::atomic<long long> culled_pixels;
+
+public:
+	OptimizerOcclusion();
+	virtual void run(const RunParams &params) const;
+
+	//! count of removed sub-tasks
+	long long get_culled_tasks() const { return culled_tasks; }
+	//! count of pixels which are not rendered anymore (by the top level of removed or truncated sub-tasks)
+	long long get_culled_pixels() const { return culled_pixels; }
+	void reset_counters() const { culled_tasks = 0; culled_pixels = 0; }
+};
+
+} /* end namespace rendering */
+} /* end namespace synfig */
+
+/* -- E N D ----------------------------------------------------------------- */
+
+#endif
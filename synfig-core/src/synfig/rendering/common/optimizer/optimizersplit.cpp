@@ -34,9 +34,12 @@
 
 #include <synfig/general.h>
 #include <synfig/localization.h>
+#include <synfig/debug/log.h>
 
 #include "optimizersplit.h"
 
+#include "../../renderer.h"
+
 #endif
 
 using namespace synfig;
@@ -46,47 +49,148 @@ using namespace rendering;
 
 /* === G L O B A L S ======================================================= */
 
+namespace {
+	//! don't split tasks cheaper than this
+	const Real min_cost = 128.0*128.0;
+	//! parts should not be smaller than this (in pixels)
+	const int min_part_size = 32;
+	//! split only when expected time is less than this part of time without split
+	const Real min_gain = 0.8;
+	//! max count of parts per thread
+	const int max_parts_per_thread = 4;
+}
+
 /* === P R O C E D U R E S ================================================= */
 
 /* === M E T H O D S ======================================================= */
 
-OptimizerSplit::OptimizerSplit()
+OptimizerSplit::OptimizerSplit(int threads):
+	threads(threads)
 {
 	category_id = CATEGORY_ID_LIST;
 	depends_from = CATEGORY_SPECIALIZED;
 	for_list = true;
 }
 
+bool
+OptimizerSplit::choose_grid(
+	const TaskInterfaceSplit &split,
+	const VectorInt &size,
+	int threads,
+	VectorInt &out_grid )
+{
+	out_grid = VectorInt(1, 1);
+	if (threads < 2 || size[0] <= 0 || size[1] <= 0)
+		return false;
+
+	const Real cost = split.get_split_cost(size);
+	if (cost < min_cost)
+		return false;
+
+	// Search the grid with the minimal expected time of rendering,
+	// assume that parts will rendered by all threads simultaneously.
+	// Parts are shrinked equally, so time is a count of rounds
+	// multiplied by cost of one part. Cost of part grows with
+	// overhead (margins, geometry), so too many parts will be rejected.
+	const int max_parts = threads*max_parts_per_thread;
+	const int max_nx = std::max(1, std::min(max_parts, size[0]/min_part_size));
+	const int max_ny = std::max(1, std::min(max_parts, size[1]/min_part_size));
+
+	Real best_time = cost*min_gain;
+	int best_parts = 1;
+	Real best_ratio = 0.0;
+	for(int nx = 1; nx <= max_nx; ++nx)
+	for(int ny = 1; ny <= max_ny && nx*ny <= max_parts; ++ny)
+	{
+		int parts = nx*ny;
+		if (parts < 2) continue;
+		VectorInt part_size(
+			(size[0] + nx - 1)/nx,
+			(size[1] + ny - 1)/ny );
+		int rounds = (parts + threads - 1)/threads;
+		Real time = rounds*split.get_split_cost(part_size);
+
+		// prefer square parts
+		Real ratio = part_size[0] < part_size[1]
+		           ? part_size[0]/(Real)part_size[1]
+		           : part_size[1]/(Real)part_size[0];
+
+		if ( time < best_time
+		  || ( time == best_time
+		    && ( parts < best_parts
+		      || (parts == best_parts && ratio > best_ratio) )))
+		{
+			best_time = time;
+			best_parts = parts;
+			best_ratio = ratio;
+			out_grid = VectorInt(nx, ny);
+		}
+	}
+
+	return best_parts > 1;
+}
+
 void
 OptimizerSplit::run(const RunParams &params) const
 {
 	if (!params.list) return;
-	const int min_area = 256*256;
+	const int threads = this->threads > 0 ? this->threads : Renderer::get_max_simultaneous_threads();
+	if (threads < 2) return;
+	const String &logfile = Renderer::get_debug_options().optimizer_log;
+
 	for(Task::List::iterator i = params.list->begin(); i != params.list->end(); ++i)
 	{
-		if (TaskInterfaceSplit *split = i->type_pointer<TaskInterfaceSplit>())
-		if (split->is_splittable())
+		if (!*i || !(*i)->is_valid())
+			continue;
+		TaskInterfaceSplit *split = i->type_pointer<TaskInterfaceSplit>();
+		if (!split || !split->is_splittable())
+			continue;
+
+		const RectInt r = (*i)->target_rect;
+		const VectorInt size = r.get_size();
+		VectorInt grid;
+		if (!choose_grid(*split, size, threads, grid))
+			continue;
+
+		const Real cost = split->get_split_cost(size);
+		Real parts_cost = 0.0;
+		Real max_part_cost = 0.0;
+
+		// tasks writes to the different areas of the same surface,
+		// so they may be processed simultaneously (see Task::allow_run_before)
+		Task::Handle task = *i;
+		const int count = grid[0]*grid[1];
+		for(int j = 0; j < count; ++j)
 		{
-			RectInt r = (*i)->target_rect;
-			int w = r.maxx - r.minx;
-			int h = r.maxy - r.miny;
-			int t = std::min(h/10, w*h/min_area);
-			if (t >= 2)
-			{
-				int hh = h/t;
-				int y = r.miny;
-				for(int j = 1; j < t; ++j, y += hh)
-				{
-					Task::Handle task = (*i)->clone();
-					task->trunc_target_rect( RectInt(r.minx, y, r.maxx, y + hh) );
-					i = params.list->insert(i, task);
-					++i;
-				}
-				*i = (*i)->clone();
-				(*i)->trunc_target_rect( RectInt(r.minx, y, r.maxx, r.maxy) );
-				apply(params);
-			}
+			int x = j % grid[0];
+			int y = j / grid[0];
+			RectInt part(
+				r.minx + size[0]*x/grid[0],
+				r.miny + size[1]*y/grid[1],
+				r.minx + size[0]*(x + 1)/grid[0],
+				r.miny + size[1]*(y + 1)/grid[1] );
+
+			Real part_cost = split->get_split_cost(part.get_size());
+			parts_cost += part_cost;
+			max_part_cost = std::max(max_part_cost, part_cost);
+
+			Task::Handle sub_task = task->clone();
+			sub_task->trunc_target_rect(part);
+			sub_task.type_pointer<TaskInterfaceSplit>()->on_split();
+			if (j + 1 < count)
+				{ i = params.list->insert(i, sub_task); ++i; }
+			else
+				*i = sub_task;
 		}
+
+		if (!logfile.empty())
+			debug::Log::info(logfile, "split %s %dx%d into %dx%d parts, cost %.0f, parts cost %.0f (%.2f%% overhead), max part %.0f, balance %.2f%%",
+				task->get_token()->name.c_str(),
+				size[0], size[1], grid[0], grid[1],
+				cost, parts_cost, 100.0*(parts_cost - cost)/cost,
+				max_part_cost, 100.0*parts_cost/(count*max_part_cost) );
+
+		apply(params);
 	}
 }
 
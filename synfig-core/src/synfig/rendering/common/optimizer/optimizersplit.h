@@ -43,10 +43,25 @@ namespace synfig
 namespace rendering
 {
 
+//! Splits heavy tasks into the tiles to render them simultaneously.
+//! Count of tiles depends on the estimated cost of the task
+//! (see TaskInterfaceSplit::get_split_cost) and on the count of rendering threads.
 class OptimizerSplit: public Optimizer
 {
+private:
+	int threads;
+
 public:
-	OptimizerSplit();
+	//! Chooses count of columns and rows of tiles, returns false if task should not be split
+	static bool choose_grid(
+		const TaskInterfaceSplit &split,
+		const VectorInt &size,
+		int threads,
+		VectorInt &out_grid );
+
+	//! \param threads count of threads to balance parts for,
+	//! zero means count of rendering threads (see Renderer::get_max_simultaneous_threads)
+	explicit OptimizerSplit(int threads = 0);
 	virtual void run(const RunParams &params) const;
 };
 
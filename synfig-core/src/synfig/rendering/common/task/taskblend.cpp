@@ -84,4 +84,26 @@ TaskBlend::calc_bounds() const
 	return bounds;
 }
 
+Rect
+TaskBlend::calc_opaque_bounds() const
+{
+	// composite keeps opaque pixels of destination,
+	// and source gives opaque pixels only with full amount
+	if ( blend_method != Color::BLEND_COMPOSITE
+	  && blend_method != Color::BLEND_BEHIND )
+		return Rect::zero();
+
+	Rect ra = sub_task_a() ? sub_task_a()->calc_opaque_bounds() & sub_task_a()->source_rect : Rect::zero();
+	if (!approximate_equal_lp(amount, ColorReal(1.0)))
+		return ra;
+	Rect rb = sub_task_b() ? sub_task_b()->calc_opaque_bounds() & sub_task_b()->source_rect : Rect::zero();
+
+	// union of rects is not a rect, so choose the biggest one
+	if (!ra.is_valid()) return rb;
+	if (!rb.is_valid()) return ra;
+	if (ra.contains(rb)) return ra;
+	if (rb.contains(ra)) return rb;
+	return ra.area() < rb.area() ? rb : ra;
+}
+
 /* === E N T R Y P O I N T ================================================= */
@@ -32,6 +32,8 @@
 #	include <config.h>
 #endif
 
+#include <cmath>
+
 #include "taskcontour.h"
 
 #endif
@@ -60,4 +62,63 @@ TaskContour::calc_bounds() const
          :                   contour->calc_bounds(transformation->matrix);
 }
 
+Rect
+TaskContour::calc_opaque_bounds() const
+{
+	if ( !contour
+	  || contour->invert
+	  || !approximate_greater_or_equal_lp(contour->color.get_a(), ColorReal(1.0)) )
+		return Rect::zero();
+
+	const Matrix &matrix = transformation->matrix;
+	if ( !approximate_zero(matrix.m01)
+	  || !approximate_zero(matrix.m10)
+	  || !approximate_zero(matrix.m02)
+	  || !approximate_zero(matrix.m12)
+	  || !approximate_equal(matrix.m22, Real(1.0)) )
+		return Rect::zero();
+
+	// expected single closed polyline: MOVE, LINE, ..., LINE [, CLOSE]
+	const Contour::ChunkList &chunks = contour->get_chunks();
+	if (chunks.size() < 4 || chunks.front().type != Contour::MOVE)
+		return Rect::zero();
+	for(Contour::ChunkList::const_iterator i = chunks.begin() + 1; i != chunks.end(); ++i)
+		if ( i->type != Contour::LINE
+		  && !(i->type == Contour::CLOSE && i + 1 == chunks.end()) )
+			return Rect::zero();
+
+	Rect bounds(chunks.front().p1);
+	for(Contour::ChunkList::const_iterator i = chunks.begin() + 1; i != chunks.end(); ++i)
+		if (i->type == Contour::LINE)
+			bounds.expand(i->p1);
+	if (!bounds.is_valid())
+		return Rect::zero();
+
+	// all segments should be placed on the sides of bounds,
+	// and the polyline should cover bounds once (non-self-intersecting rectangle)
+	Real area = 0.0;
+	Vector prev = chunks.front().p1;
+	for(Contour::ChunkList::const_iterator i = chunks.begin() + 1; i <= chunks.end(); ++i)
+	{
+		const Vector &p = i == chunks.end() || i->type == Contour::CLOSE
+		                ? chunks.front().p1 : i->p1;
+		bool on_x = approximate_equal(p[0], bounds.minx) || approximate_equal(p[0], bounds.maxx);
+		bool on_y = approximate_equal(p[1], bounds.miny) || approximate_equal(p[1], bounds.maxy);
+		if (!on_x || !on_y)
+			return Rect::zero();
+		if (!approximate_equal(p[0], prev[0]) && !approximate_equal(p[1], prev[1]))
+			return Rect::zero();
+		area += prev[0]*p[1] - p[0]*prev[1];
+		prev = p;
+		if (i == chunks.end() || i->type == Contour::CLOSE)
+			break;
+	}
+	if (!approximate_equal(std::fabs(0.5*area), bounds.area()))
+		return Rect::zero();
+
+	return Rect(
+		matrix.get_transformed(Vector(bounds.minx, bounds.miny)),
+		matrix.get_transformed(Vector(bounds.maxx, bounds.maxy)) );
+}
+
 /* === E N T R Y P O I N T ================================================= */
@@ -62,6 +62,9 @@ public:
 
 	virtual Rect calc_bounds() const;
 
+	//! Only solid axis-aligned rectangles are detected
+	virtual Rect calc_opaque_bounds() const;
+
 	virtual Transformation::Handle get_transformation() const
 		{ return transformation.handle(); }
 };
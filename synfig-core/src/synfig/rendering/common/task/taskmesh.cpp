@@ -52,6 +52,10 @@ Task::Token TaskMesh::token(
 	DescAbstract<TaskMesh>("Mesh") );
 
 
+TaskMesh::TaskMesh():
+	interpolation(Color::INTERPOLATION_CUBIC) { }
+
+
 Rect
 TaskMesh::calc_bounds() const
 	{ return mesh && sub_task() ? mesh->calc_target_rectangle(transformation->matrix) : Rect(); }
@@ -54,6 +54,9 @@ public:
 
 	Mesh::Handle mesh;
 	Holder<TransformationAffine> transformation;
+	Color::Interpolation interpolation;
+
+	TaskMesh();
 
 	virtual int get_pass_subtask_index() const
 		{ return sub_task() ? PASSTO_THIS_TASK : PASSTO_NO_TASK; }
@@ -65,6 +65,24 @@ TaskPixelProcessor::calc_bounds() const
 	     : Rect::zero();
 }
 
+Rect
+TaskPixelColorMatrix::calc_opaque_bounds() const
+{
+	// alpha = r*m03 + g*m13 + b*m23 + a*m33 + m43
+	if ( !approximate_zero_lp(matrix.m03)
+	  || !approximate_zero_lp(matrix.m13)
+	  || !approximate_zero_lp(matrix.m23) )
+		return Rect::zero();
+	if (approximate_zero_lp(matrix.m33))
+		return approximate_greater_or_equal_lp(matrix.m43, ColorReal(1.0))
+		     ? Rect::infinite() : Rect::zero();
+	if ( approximate_equal_lp(matrix.m33, ColorReal(1.0))
+	  && approximate_zero_lp(matrix.m43)
+	  && sub_task() )
+		return sub_task()->calc_opaque_bounds() & sub_task()->source_rect;
+	return Rect::zero();
+}
+
 VectorInt
 TaskPixelProcessor::get_offset() const
 {
@@ -106,6 +106,10 @@ public:
 			&& approximate_equal_lp(gamma.get_g(), ColorReal(1.0))
 			&& approximate_equal_lp(gamma.get_b(), ColorReal(1.0));
 	}
+
+	//! gamma doesn't change alpha
+	virtual Rect calc_opaque_bounds() const
+		{ return sub_task() ? sub_task()->calc_opaque_bounds() & sub_task()->source_rect : Rect::zero(); }
 };
 
 
@@ -126,6 +130,8 @@ public:
 		{ return matrix.is_constant(); }
 	virtual bool is_affects_transparent() const
 		{ return matrix.is_affects_transparent(); }
+
+	virtual Rect calc_opaque_bounds() const;
 };
 
 
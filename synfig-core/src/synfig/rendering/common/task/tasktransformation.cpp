@@ -32,6 +32,8 @@
 #	include <config.h>
 #endif
 
+#include <cmath>
+
 #include "tasktransformation.h"
 
 #endif
@@ -137,4 +139,37 @@ TaskTransformationAffine::get_pass_subtask_index() const
 	return TaskTransformation::get_pass_subtask_index();
 }
 
+Rect
+TaskTransformationAffine::calc_opaque_bounds() const
+{
+	// rotated and skewed opaque rects are not tracked
+	const Matrix &matrix = transformation->matrix;
+	if ( !sub_task()
+	  || !is_valid_coords()
+	  || !approximate_zero(matrix.m01)
+	  || !approximate_zero(matrix.m10)
+	  || !approximate_zero(matrix.m02)
+	  || !approximate_zero(matrix.m12)
+	  || !approximate_equal(matrix.m22, Real(1.0)) )
+		return Rect::zero();
+
+	Rect rect = sub_task()->calc_opaque_bounds() & sub_task()->source_rect;
+	if (rect.is_full_infinite())
+		return rect;
+	if (!rect.is_valid() || rect.is_nan_or_inf())
+		return Rect::zero();
+
+	Rect r(
+		matrix.get_transformed(Vector(rect.minx, rect.miny)),
+		matrix.get_transformed(Vector(rect.maxx, rect.maxy)) );
+
+	// resampling blends pixels on the edges with the outside
+	Vector border = get_units_per_pixel()*2.0;
+	r.minx += std::fabs(border[0]);
+	r.maxx -= std::fabs(border[0]);
+	r.miny += std::fabs(border[1]);
+	r.maxy -= std::fabs(border[1]);
+	return r.is_valid() ? r : Rect::zero();
+}
+
 /* === E N T R Y P O I N T ================================================= */
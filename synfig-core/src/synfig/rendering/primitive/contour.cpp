@@ -35,6 +35,7 @@
 #include <algorithm>
 
 #include "intersector.h"
+#include "contouredges.h"
 
 #include "contour.h"
 
@@ -297,6 +298,7 @@ Contour::touch_chunks()
 	autocurve_end = false;
 	bounds_calculated = false;
 	intersector.reset();
+	edges.reset();
 }
 
 void
@@ -462,6 +464,10 @@ Contour::assign(const Contour &other)
 		std::lock_guard<std::mutex> lock(other.intersector_read_mutex);
 		intersector = other.intersector;
 	}
+	{
+		std::lock_guard<std::mutex> lock(other.edges_read_mutex);
+		edges = other.edges;
+	}
 }
 
 void
@@ -634,6 +640,15 @@ Contour::get_intersector() const
 	return *intersector;
 }
 
+etl::handle<ContourEdges>
+Contour::get_edges(const Matrix &transform_matrix, Real detail, const RectInt &window) const
+{
+	std::lock_guard<std::mutex> lock(edges_read_mutex);
+	if (!edges || !edges->is_compatible(transform_matrix, detail, window))
+		edges = new ContourEdges(chunks, transform_matrix, detail, window);
+	return edges;
+}
+
 void
 Contour::split(
 	Contour &out_contour,
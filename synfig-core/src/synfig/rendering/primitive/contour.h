@@ -52,6 +52,7 @@ namespace rendering
 {
 
 class Intersector;
+class ContourEdges;
 
 class Contour: public etl::shared_object
 {
@@ -112,6 +113,9 @@ private:
 	mutable std::mutex intersector_read_mutex;
 	mutable etl::handle<Intersector> intersector;
 
+	mutable std::mutex edges_read_mutex;
+	mutable etl::handle<ContourEdges> edges;
+
 	//! call this when 'chunks' or 'first' was changed
 	void touch_chunks();
 
@@ -182,6 +186,10 @@ public:
 	//! method is thread-safe for constant contours - you must not modify a contour while this call
 	const Intersector& get_intersector() const;
 
+	//! actualize internal copy of flattened edges for given transformation (if needed) and return it
+	//! method is thread-safe for constant contours - you must not modify a contour while this call
+	etl::handle<ContourEdges> get_edges(const Matrix &transform_matrix, Real detail, const RectInt &window) const;
+
 	void split(
 		Contour &out_contour,
 		Rect &ref_bounds,
@@ -0,0 +1,295 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file synfig/rendering/primitive/contouredges.cpp
+**	\brief ContourEdges
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#ifdef USING_PCH
+#	include "pch.h"
+#else
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+#include <synfig/real.h>
+
+#include "contouredges.h"
+
+#endif
+
+using namespace synfig;
+using namespace rendering;
+
+/* === M A C R O S ========================================================= */
+
+/* === G L O B A L S ======================================================= */
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+	Vector clamp_point(const Vector &p) {
+		const Real limit = 1e9;
+		return Vector(
+			std::max(-limit, std::min(limit, p[0])),
+			std::max(-limit, std::min(limit, p[1])) );
+	}
+
+	int calc_subdivisions(Real max_second_difference, Real factor, Real tolerance) {
+		// Wang's formula
+		Real n = std::ceil(std::sqrt(factor*max_second_difference/tolerance));
+		return n < 1 ? 1
+		     : n > ContourEdges::MAX_SUBDIVISIONS ? (int)ContourEdges::MAX_SUBDIVISIONS
+		     : (int)n;
+	}
+
+	//! curve which control points are all outside of the same side of window
+	//! may be replaced by the line between its ends: to the left of window
+	//! both give the same winding for visible pixels, and at other sides
+	//! neither of them affects visible pixels
+	bool is_outside(const Vector *points, int count, const RectInt &window) {
+		bool left = true, right = true, top = true, bottom = true;
+		for(int i = 0; i < count; ++i) {
+			if (points[i][0] >= window.minx) left   = false;
+			if (points[i][0] <= window.maxx) right  = false;
+			if (points[i][1] >= window.miny) top    = false;
+			if (points[i][1] <= window.maxy) bottom = false;
+		}
+		return left || right || top || bottom;
+	}
+}
+
+/* === M E T H O D S ======================================================= */
+
+ContourEdges::Edge::Edge(Real x0, Real y0, Real x1, Real y1):
+	x0(x0), y0(y0), x1(x1), y1(y1), dxdy(), dir(1)
+{
+	if (this->y0 > this->y1) {
+		std::swap(this->x0, this->x1);
+		std::swap(this->y0, this->y1);
+		dir = -1;
+	}
+	dxdy = (this->x1 - this->x0)/(this->y1 - this->y0);
+}
+
+ContourEdges::ContourEdges(
+	const Contour::ChunkList &chunks,
+	const Matrix &matrix,
+	Real detail,
+	const RectInt &window
+):
+	matrix(matrix),
+	detail(detail),
+	window(window),
+	bin_miny(),
+	bin_height(MIN_BIN_HEIGHT)
+{
+	// max distance between curve and its flattened edges, in pixels,
+	// keeps the antialiasing close to Polyspan which subdivides curves much deeper
+	const Real tolerance = std::max(0.001, detail*0.01);
+
+	// same as Polyspan: contour without MOVE starts from pixel (0, 0)
+	Vector first, last, p1;
+	for(Contour::ChunkList::const_iterator i = chunks.begin(); i != chunks.end(); ++i)
+	{
+		switch(i->type)
+		{
+			case Contour::CLOSE:
+				add_edge(last, first);
+				last = first;
+				break;
+			case Contour::MOVE:
+				add_edge(last, first);
+				first = last = clamp_point(matrix.get_transformed(i->p1));
+				break;
+			case Contour::LINE:
+				p1 = clamp_point(matrix.get_transformed(i->p1));
+				add_edge(last, p1);
+				last = p1;
+				break;
+			case Contour::CONIC:
+				p1 = clamp_point(matrix.get_transformed(i->p1));
+				add_conic(
+					last, p1,
+					clamp_point(matrix.get_transformed(i->pp0)),
+					tolerance );
+				last = p1;
+				break;
+			case Contour::CUBIC:
+				p1 = clamp_point(matrix.get_transformed(i->p1));
+				add_cubic(
+					last, p1,
+					clamp_point(matrix.get_transformed(i->pp0)),
+					clamp_point(matrix.get_transformed(i->pp1)),
+					tolerance );
+				last = p1;
+				break;
+			default:
+				break;
+		}
+	}
+	add_edge(last, first);
+
+	build_bins();
+}
+
+void
+ContourEdges::add_edge(const Vector &p0, const Vector &p1)
+{
+	// horizontal edges gives no cover
+	if (p0[1] == p1[1])
+		return;
+	// edge affects only pixels at the right side of itself
+	if ( std::max(p0[1], p1[1]) <= window.miny
+	  || std::min(p0[1], p1[1]) >= window.maxy
+	  || std::min(p0[0], p1[0]) >= window.maxx )
+		return;
+	edges.push_back(Edge(p0[0], p0[1], p1[0], p1[1]));
+}
+
+void
+ContourEdges::add_conic(const Vector &p0, const Vector &p1, const Vector &pp0, Real tolerance)
+{
+	const Vector points[] = { p0, pp0, p1 };
+	if (is_outside(points, 3, window))
+		{ add_edge(p0, p1); return; }
+
+	int n = calc_subdivisions((p0 - pp0*2.0 + p1).mag(), 0.25, tolerance);
+	Vector prev = p0;
+	for(int i = 1; i < n; ++i) {
+		Real t = i/(Real)n;
+		Real tt = 1.0 - t;
+		Vector p = p0*(tt*tt) + pp0*(2.0*tt*t) + p1*(t*t);
+		add_edge(prev, p);
+		prev = p;
+	}
+	add_edge(prev, p1);
+}
+
+void
+ContourEdges::add_cubic(const Vector &p0, const Vector &p1, const Vector &pp0, const Vector &pp1, Real tolerance)
+{
+	const Vector points[] = { p0, pp0, pp1, p1 };
+	if (is_outside(points, 4, window))
+		{ add_edge(p0, p1); return; }
+
+	Real d = std::max(
+		(p0 - pp0*2.0 + pp1).mag(),
+		(pp0 - pp1*2.0 + p1).mag() );
+	int n = calc_subdivisions(d, 0.75, tolerance);
+	Vector prev = p0;
+	for(int i = 1; i < n; ++i) {
+		Real t = i/(Real)n;
+		Real tt = 1.0 - t;
+		Vector p = p0*(tt*tt*tt) + pp0*(3.0*tt*tt*t) + pp1*(3.0*tt*t*t) + p1*(t*t*t);
+		add_edge(prev, p);
+		prev = p;
+	}
+	add_edge(prev, p1);
+}
+
+int
+ContourEdges::get_bin(Real y) const
+{
+	int count = (int)bin_offsets.size() - 1;
+	int bin = (int)std::floor((y - bin_miny)/bin_height);
+	return bin < 0 ? 0 : bin >= count ? count - 1 : bin;
+}
+
+void
+ContourEdges::build_bins()
+{
+	bin_offsets.clear();
+	bin_edges.clear();
+	if (edges.empty())
+		return;
+
+	Real miny = edges.front().y0;
+	Real maxy = edges.front().y1;
+	for(EdgeList::const_iterator i = edges.begin(); i != edges.end(); ++i)
+		{ miny = std::min(miny, i->y0); maxy = std::max(maxy, i->y1); }
+	bin_miny = std::max(window.miny, (int)std::floor(miny));
+	int range = std::max(1, std::min(window.maxy, (int)std::ceil(maxy)) - bin_miny);
+
+	// long edges are placed into the each bin which they cross,
+	// so make bins higher when edges are too long
+	int count;
+	std::vector<int> counts;
+	while(true) {
+		count = (range + bin_height - 1)/bin_height;
+		bin_offsets.assign(count + 1, 0);
+		long long total = 0;
+		for(EdgeList::const_iterator i = edges.begin(); i != edges.end(); ++i)
+			total += get_bin(i->y1) - get_bin(i->y0) + 1;
+		if (count <= 1 || total <= 8*(long long)edges.size() + count)
+			break;
+		bin_height *= 2;
+	}
+
+	// counting sort of edges by bins
+	counts.assign(count, 0);
+	for(EdgeList::const_iterator i = edges.begin(); i != edges.end(); ++i)
+		for(int j = get_bin(i->y0), end = get_bin(i->y1); j <= end; ++j)
+			++counts[j];
+	for(int j = 0; j < count; ++j)
+		bin_offsets[j + 1] = bin_offsets[j] + counts[j];
+	bin_edges.resize(bin_offsets.back());
+	for(int j = 0; j < count; ++j)
+		counts[j] = bin_offsets[j];
+	for(EdgeList::const_iterator i = edges.begin(); i != edges.end(); ++i)
+		for(int j = get_bin(i->y0), end = get_bin(i->y1); j <= end; ++j)
+			bin_edges[counts[j]++] = i - edges.begin();
+}
+
+bool
+ContourEdges::is_compatible(const Matrix &matrix, Real detail, const RectInt &window) const
+{
+	return this->matrix == matrix
+	    && approximate_equal(this->detail, detail)
+	    && this->window == window;
+}
+
+void
+ContourEdges::get_edges(int miny, int maxy, EdgePtrList &out_edges) const
+{
+	if (bin_offsets.empty() || miny >= maxy)
+		return;
+	int first_bin = get_bin(miny);
+	int last_bin = get_bin(maxy - 1);
+	for(int bin = first_bin; bin <= last_bin; ++bin)
+	{
+		for(int j = bin_offsets[bin]; j < bin_offsets[bin + 1]; ++j)
+		{
+			const Edge &edge = edges[ bin_edges[j] ];
+			// take the edge only from the first bin of the range which contains it
+			if (std::max(get_bin(edge.y0), first_bin) != bin)
+				continue;
+			if (edge.y1 <= miny || edge.y0 >= maxy)
+				continue;
+			out_edges.push_back(&edge);
+		}
+	}
+}
+
+/* === E N T R Y P O I N T ================================================= */
@@ -0,0 +1,124 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file synfig/rendering/primitive/contouredges.h
+**	\brief ContourEdges Header
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === S T A R T =========================================================== */
+
+#ifndef __SYNFIG_RENDERING_CONTOUREDGES_H
+#define __SYNFIG_RENDERING_CONTOUREDGES_H
+
+/* === H E A D E R S ======================================================= */
+
+#include <vector>
+
+#include <ETL/handle>
+
+#include <synfig/matrix.h>
+#include <synfig/rect.h>
+
+#include "contour.h"
+
+/* === M A C R O S ========================================================= */
+
+/* === T Y P E D E F S ===================================================== */
+
+/* === C L A S S E S & S T R U C T S ======================================= */
+
+namespace synfig
+{
+namespace rendering
+{
+
+//! Contour flattened to the straight edges in pixel coordinates.
+//! Edges are binned by rows, so each tile of the target surface
+//! may take only the edges which crosses it.
+//! Object is constant after build, so it may be shared between threads.
+class ContourEdges: public etl::shared_object
+{
+public:
+	typedef etl::handle<ContourEdges> Handle;
+
+	//! Edge is oriented from top to bottom, original direction stored in 'dir'
+	struct Edge
+	{
+		Real x0, y0, x1, y1;
+		Real dxdy;
+		int dir;
+
+		Edge(): x0(), y0(), x1(), y1(), dxdy(), dir() { }
+		Edge(Real x0, Real y0, Real x1, Real y1);
+
+		Real get_x(Real y) const
+			{ return x0 + (y - y0)*dxdy; }
+	};
+
+	typedef std::vector<Edge> EdgeList;
+	typedef std::vector<const Edge*> EdgePtrList;
+
+	enum {
+		MIN_BIN_HEIGHT = 16,
+		MAX_SUBDIVISIONS = 1024
+	};
+
+private:
+	Matrix matrix;
+	Real detail;
+	RectInt window;
+
+	EdgeList edges;
+	int bin_miny;
+	int bin_height;
+	std::vector<int> bin_offsets; //!< bin 'i' contains bin_edges[bin_offsets[i] .. bin_offsets[i+1]]
+	std::vector<int> bin_edges;
+
+	void add_edge(const Vector &p0, const Vector &p1);
+	void add_conic(const Vector &p0, const Vector &p1, const Vector &pp0, Real tolerance);
+	void add_cubic(const Vector &p0, const Vector &p1, const Vector &pp0, const Vector &pp1, Real tolerance);
+	void build_bins();
+
+	int get_bin(Real y) const;
+
+public:
+	//! Flattens chunks transformed by the matrix.
+	//! Curves which are outside of window will be replaced by lines
+	//! (lines gives the same winding for all visible pixels).
+	ContourEdges(
+		const Contour::ChunkList &chunks,
+		const Matrix &matrix,
+		Real detail,
+		const RectInt &window );
+
+	bool is_compatible(const Matrix &matrix, Real detail, const RectInt &window) const;
+
+	const EdgeList& get_edges() const { return edges; }
+
+	//! Collects edges which affects rows from miny to maxy (not inclusive),
+	//! each edge will be added once
+	void get_edges(int miny, int maxy, EdgePtrList &out_edges) const;
+};
+
+} /* end namespace rendering */
+} /* end namespace synfig */
+
+/* -- E N D ----------------------------------------------------------------- */
+
+#endif
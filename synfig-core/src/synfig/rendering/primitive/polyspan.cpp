@@ -929,7 +929,7 @@ Polyspan::draw_line(Real x1, Real y1, Real x2, Real y2)
 }
 
 Real
-Polyspan::extract_alpha(Real area, Contour::WindingStyle winding_style) const
+Polyspan::extract_alpha(Real area, Contour::WindingStyle winding_style)
 {
 	if (area < 0)
 		area = -area;
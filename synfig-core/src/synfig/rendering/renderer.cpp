@@ -128,7 +128,7 @@ Renderer::deinitialize_renderers()
 Renderer::~Renderer() { }
 
 int
-Renderer::get_max_simultaneous_threads() const
+Renderer::get_max_simultaneous_threads()
 {
 	assert(queue);
 	return queue->get_threads_count() - 1;
@@ -989,6 +989,8 @@ Renderer::initialize()
 		debug_options.task_list_optimized_log = s;
 	if (const char *s = getenv("SYNFIG_RENDERING_DEBUG_RESULT_IMAGE"))
 		debug_options.result_image = s;
+	if (const char *s = getenv("SYNFIG_RENDERING_DEBUG_OPTIMIZER_LOG"))
+		debug_options.optimizer_log = s;
 
 	renderers = new std::map<String, Handle>();
 	queue = new RenderQueue();
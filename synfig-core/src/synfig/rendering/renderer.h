@@ -60,6 +60,8 @@ public:
 		String task_list_log;
 		String task_list_optimized_log;
 		String result_image;
+		//! statistics of optimizers (split parts balance, culled tasks, etc)
+		String optimizer_log;
 	};
 
 private:
@@ -142,7 +144,7 @@ private:
 	void find_deps(const Task::List &list, long long batch_index) const;
 
 public:
-	int get_max_simultaneous_threads() const;
+	static int get_max_simultaneous_threads();
 	void optimize(Task::List &list) const;
 
 	bool run(
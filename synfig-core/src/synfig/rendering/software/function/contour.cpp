@@ -32,6 +32,10 @@
 #	include <config.h>
 #endif
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "contour.h"
 
 #include <synfig/debug/debugsurface.h>
@@ -47,6 +51,95 @@ using namespace rendering;
 
 /* === P R O C E D U R E S ================================================= */
 
+namespace {
+
+//! Covers of cells of one row, in the same format as Polyspan::PenMark
+class RowAccumulator
+{
+public:
+	const int minx, maxx;
+	std::vector<Real> covers;
+	std::vector<Real> areas;
+	int touched_min, touched_max;
+
+	RowAccumulator(int minx, int maxx):
+		minx(minx),
+		maxx(maxx),
+		covers(maxx - minx, 0.0),
+		areas(maxx - minx, 0.0),
+		touched_min(maxx - minx),
+		touched_max(-1)
+	{ }
+
+	void clear() {
+		if (touched_max >= touched_min) {
+			std::fill(covers.begin() + touched_min, covers.begin() + touched_max + 1, 0.0);
+			std::fill(areas.begin() + touched_min, areas.begin() + touched_max + 1, 0.0);
+		}
+		touched_min = maxx - minx;
+		touched_max = -1;
+	}
+
+	int cell(Real x) const
+		{ return std::min((int)std::floor(x), maxx - 1) - minx; }
+
+	void add_cover(int i, Real cover, Real fx) {
+		covers[i] += cover;
+		areas[i] += cover*fx;
+		touched_min = std::min(touched_min, i);
+		touched_max = std::max(touched_max, i);
+	}
+
+	//! x0 and x1 must be inside [minx, maxx]
+	void add_cells(Real x0, Real y0, Real x1, Real y1) {
+		int i0 = cell(x0);
+		int i1 = cell(x1);
+		if (i0 == i1)
+			{ add_cover(i0, y1 - y0, (x0 + x1)*0.5 - (i0 + minx)); return; }
+
+		Real dydx = (y1 - y0)/(x1 - x0);
+		int step = i1 > i0 ? 1 : -1;
+		Real x = x0;
+		for(int i = i0; i != i1; i += step) {
+			Real next_x = minx + (step > 0 ? i + 1 : i);
+			add_cover(i, (next_x - x)*dydx, (x + next_x)*0.5 - (i + minx));
+			x = next_x;
+		}
+		add_cover(i1, (x1 - x)*dydx, (x + x1)*0.5 - (i1 + minx));
+	}
+
+	//! adds part of edge inside of the row, y0 < y1, coordinates of y are relative to the row
+	void add_segment(Real x0, Real y0, Real x1, Real y1, int dir) {
+		// split by the borders, parts at the left side gives the full cover to the first cell,
+		// parts at the right side don't affect the row
+		Real ys[4] = { y0, y1 };
+		int count = 2;
+		if ((x0 < minx) != (x1 < minx))
+			ys[count++] = y0 + (minx - x0)*(y1 - y0)/(x1 - x0);
+		if ((x0 < maxx) != (x1 < maxx))
+			ys[count++] = y0 + (maxx - x0)*(y1 - y0)/(x1 - x0);
+		std::sort(ys, ys + count);
+
+		Real dxdy = (x1 - x0)/(y1 - y0);
+		for(int i = 1; i < count; ++i) {
+			Real ya = ys[i-1], yb = ys[i];
+			if (yb <= ya) continue;
+			Real xa = x0 + (ya - y0)*dxdy;
+			Real xb = x0 + (yb - y0)*dxdy;
+			if ((xa + xb)*0.5 >= maxx) continue;
+			xa = std::max((Real)minx, std::min((Real)maxx, xa));
+			xb = std::max((Real)minx, std::min((Real)maxx, xb));
+			// keep the original direction of edge, it defines the sign of cover
+			if (dir < 0)
+				add_cells(xb, yb, xa, ya);
+			else
+				add_cells(xa, ya, xb, yb);
+		}
+	}
+};
+
+} // end of anonimous namespace
+
 /* === M E T H O D S ======================================================= */
 
 void
@@ -278,6 +371,134 @@ software::Contour::render_polyspan(
 	}
 }
 
+void
+software::Contour::render_edges(
+	synfig::Surface &target_surface,
+	const RectInt &target_rect,
+	const ContourEdges &edges,
+	bool invert,
+	bool antialias,
+	rendering::Contour::WindingStyle winding_style,
+	const Color &color,
+	Color::value_type opacity,
+	Color::BlendMethod blend_method )
+{
+	RectInt window;
+	rect_set_intersect(window, target_rect, RectInt(0, 0, target_surface.get_w(), target_surface.get_h()));
+	if (!window.is_valid())
+		return;
+
+	bool simple_fill = (Color::BLEND_METHODS_OVERWRITE_ON_ALPHA_ONE & (1 << blend_method))
+			        && fabsf(1.f - opacity*color.get_a()) <= 1e-6;
+
+	synfig::Surface::alpha_pen p(target_surface.begin(), opacity, blend_method);
+	synfig::Surface::pen sp(target_surface.begin());
+	p.set_value(color);
+	sp.set_value(color);
+
+	const int width = window.maxx - window.minx;
+	const int height = window.maxy - window.miny;
+
+	// take edges from bins and sort them by the first row (counting sort)
+	ContourEdges::EdgePtrList list;
+	edges.get_edges(window.miny, window.maxy, list);
+
+	std::vector<int> row_offsets(height + 1, 0);
+	for(ContourEdges::EdgePtrList::const_iterator i = list.begin(); i != list.end(); ++i)
+		++row_offsets[ std::max(0, (int)std::floor((*i)->y0) - window.miny) + 1 ];
+	for(int row = 0; row < height; ++row)
+		row_offsets[row + 1] += row_offsets[row];
+	ContourEdges::EdgePtrList sorted(list.size());
+	{
+		std::vector<int> positions(row_offsets.begin(), row_offsets.end() - 1);
+		for(ContourEdges::EdgePtrList::const_iterator i = list.begin(); i != list.end(); ++i)
+			sorted[ positions[ std::max(0, (int)std::floor((*i)->y0) - window.miny) ]++ ] = *i;
+	}
+
+	RowAccumulator row_acc(window.minx, window.maxx);
+	ContourEdges::EdgePtrList active;
+	active.reserve(list.size());
+
+	for(int row = 0; row < height; ++row)
+	{
+		const int y = window.miny + row;
+		active.insert(active.end(), sorted.begin() + row_offsets[row], sorted.begin() + row_offsets[row + 1]);
+
+		// accumulate covers of active edges
+		ContourEdges::EdgePtrList::iterator last = active.begin();
+		for(ContourEdges::EdgePtrList::iterator i = active.begin(); i != active.end(); ++i)
+		{
+			const ContourEdges::Edge &e = **i;
+			Real ya = std::max(e.y0, (Real)y);
+			Real yb = std::min(e.y1, (Real)(y + 1));
+			if (ya < yb)
+				row_acc.add_segment(e.get_x(ya), ya - y, e.get_x(yb), yb - y, e.dir);
+			if (e.y1 > y + 1) *last++ = *i;
+		}
+		active.erase(last, active.end());
+
+		// draw row
+		Real cover = 0.0;
+		Real run_cover = 0.0;
+		int run_begin = 0;
+		for(int i = row_acc.touched_min; i <= row_acc.touched_max + 1; ++i)
+		{
+			bool end = i > row_acc.touched_max;
+			Real c = end ? 0.0 : row_acc.covers[i];
+			Real a = end ? 0.0 : row_acc.areas[i];
+			if (!end && !c && !a) continue;
+
+			// draw span with the constant cover
+			int run_end = end ? width : i;
+			if (run_begin < run_end)
+			{
+				Real alpha = Polyspan::extract_alpha(run_cover, winding_style);
+				if (invert) alpha = 1 - alpha;
+				if (alpha >= .5)
+				{
+					if (simple_fill)
+					{
+						sp.move_to(window.minx + run_begin, y);
+						sp.put_hline(run_end - run_begin);
+					}
+					else
+					{
+						p.move_to(window.minx + run_begin, y);
+						p.put_hline(run_end - run_begin);
+					}
+				}
+			}
+			if (end) break;
+
+			cover += c;
+			run_cover = cover;
+			run_begin = i;
+			if (a)
+			{
+				// draw pixel - based on covered area
+				Real alpha = Polyspan::extract_alpha(cover - a, winding_style);
+				if (invert) alpha = 1 - alpha;
+				p.move_to(window.minx + i, y);
+				if (antialias)
+					{ if (alpha) p.put_value_alpha(alpha); }
+				else
+					{ if (alpha >= .5) p.put_value(); }
+				++run_begin;
+			}
+		}
+		if (row_acc.touched_max < 0 && invert)
+		{
+			// empty row
+			if (simple_fill)
+				{ sp.move_to(window.minx, y); sp.put_hline(width); }
+			else
+				{ p.move_to(window.minx, y); p.put_hline(width); }
+		}
+
+		row_acc.clear();
+	}
+}
+
 void
 software::Contour::build_polyspan(
 	const rendering::Contour::ChunkList &chunks,
@@ -33,6 +33,7 @@
 #include <synfig/surface.h>
 
 #include "../../primitive/contour.h"
+#include "../../primitive/contouredges.h"
 #include "../../primitive/polyspan.h"
 
 /* === M A C R O S ========================================================= */
@@ -61,6 +62,19 @@ public:
 		Color::value_type opacity,
 		Color::BlendMethod blend_method );
 
+	//! Renders part of flattened contour inside of target_rect.
+	//! Accumulates covers row by row, so marks needs no sorting.
+	static void render_edges(
+		synfig::Surface &target_surface,
+		const RectInt &target_rect,
+		const ContourEdges &edges,
+		bool invert,
+		bool antialias,
+		rendering::Contour::WindingStyle winding_style,
+		const Color &color,
+		Color::value_type opacity,
+		Color::BlendMethod blend_method );
+
 	static void build_polyspan(
 		const rendering::Contour::ChunkList &chunks,
 		const Matrix &transform_matrix,
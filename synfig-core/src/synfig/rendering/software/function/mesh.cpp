@@ -32,6 +32,9 @@
 #	include <config.h>
 #endif
 
+#include <algorithm>
+#include <vector>
+
 #include "mesh.h"
 
 #endif
@@ -86,6 +89,149 @@ namespace {
 			if (coords[1] < 0.0 || coords[1] > size[1])
 				coords[1] -= floor(coords[1]/size[1])*size[1];
 		}
+
+		// Texture samplers.
+		// Pixels are read directly from the rows of texture when all of the taps
+		// are inside of the texture, otherwise Surface samplers with clamping are used.
+		// Results are the same as Surface::xxx_sample().
+
+		typedef synfig::Surface::sampler_cook::float_type Float;
+
+		inline static ColorAccumulator cook(const synfig::Surface &texture, int x, int y)
+			{ return ColorPrep::cook_static(texture[y][x]); }
+
+		inline static bool is_inside(const synfig::Surface &texture, int x0, int y0, int x1, int y1)
+			{ return x0 >= 0 && y0 >= 0 && x1 < texture.get_w() && y1 < texture.get_h(); }
+
+		struct SampleNearest {
+			inline static Color sample(const synfig::Surface &texture, Float x, Float y) {
+				int u = etl::round_to_int(x), v = etl::round_to_int(y);
+				if (!is_inside(texture, u, v, u, v))
+					return texture.nearest_sample(x, y);
+				return ColorPrep::uncook_static(cook(texture, u, v));
+			}
+		};
+
+		template<bool cosine>
+		struct SampleLinear {
+			inline static Color sample(const synfig::Surface &texture, Float x, Float y) {
+				int u, v; Float a, b;
+				synfig::Surface::sampler_cook::prepare_coords(x, y, u, v, a, b);
+				if (!is_inside(texture, u, v, u + 1, v + 1))
+					return cosine ? texture.cosine_sample(x, y) : texture.linear_sample(x, y);
+				if (cosine) {
+					a = (Float(1) - cos(a*Float(3.1415927)))*Float(0.5);
+					b = (Float(1) - cos(b*Float(3.1415927)))*Float(0.5);
+				}
+				const Float c(Float(1) - a), d(Float(1) - b);
+				const Color *row0 = &texture[v][u];
+				const Color *row1 = &texture[v + 1][u];
+				return ColorPrep::uncook_static(
+					  ColorPrep::cook_static(row0[0])*c*d
+					+ ColorPrep::cook_static(row0[1])*a*d
+					+ ColorPrep::cook_static(row1[0])*c*b
+					+ ColorPrep::cook_static(row1[1])*a*b );
+			}
+		};
+
+		struct SampleCubic {
+			inline static Color sample(const synfig::Surface &texture, Float x, Float y) {
+				const int xi = (int)floor(x);
+				const int yi = (int)floor(y);
+				if (!is_inside(texture, xi - 1, yi - 1, xi + 2, yi + 2))
+					return texture.cubic_sample(x, y);
+
+				Float txf[4], tyf[4];
+				synfig::Surface::sampler_cook::fill_cubic_polinomial(Float(x) - Float(xi), txf);
+				synfig::Surface::sampler_cook::fill_cubic_polinomial(Float(y) - Float(yi), tyf);
+
+				ColorAccumulator rows[4];
+				for(int j = 0; j < 4; ++j) {
+					const Color *row = &texture[yi - 1 + j][xi - 1];
+					rows[j] = ( ColorPrep::cook_static(row[0])*txf[0]
+					          + ColorPrep::cook_static(row[1])*txf[1]
+					          + ColorPrep::cook_static(row[2])*txf[2]
+					          + ColorPrep::cook_static(row[3])*txf[3] )*tyf[j];
+				}
+				return ColorPrep::uncook_static(rows[0] + rows[1] + rows[2] + rows[3]);
+			}
+		};
+
+		typedef etl::generic_pen<Color, ColorAccumulator> Pen;
+
+		//! fills horizontal line of textured triangle,
+		//! texture coordinates are stepped incrementally.
+		//! When 'replace' is set then opaque colors are written without blending
+		//! (composite blending with amount 1 gives the same result)
+		template<typename Sampler>
+		static void fill_span(
+			synfig::Surface::alpha_pen &apen,
+			int count,
+			Vector tex_point,
+			const Vector &tdx,
+			const synfig::Surface &texture,
+			const Rect &tex_bounds,
+			Color::value_type opacity,
+			bool replace )
+		{
+			for(int i = 0; i < count; ++i)
+			{
+				if (tex_point[0] < tex_bounds.minx || tex_point[0] > tex_bounds.maxx
+				 || tex_point[1] < tex_bounds.miny || tex_point[1] > tex_bounds.maxy)
+				{
+					apen.set_alpha(0.0);
+					apen.put_value(Color());
+				}
+				else
+				{
+					Color color = Sampler::sample(texture, (Float)tex_point[0], (Float)tex_point[1]);
+					if (replace && color.get_a() == Color::value_type(1)) {
+						apen.Pen::put_value(color);
+					} else {
+						apen.set_alpha(opacity);
+						apen.put_value(color);
+					}
+				}
+				// uncomment following line to debug
+				//apen.put_value(Color(0,0,1,0.5));
+				apen.inc_x();
+				tex_point += tdx;
+			}
+		}
+
+		static void fill_span(
+			Color::Interpolation interpolation,
+			synfig::Surface::alpha_pen &apen,
+			int count,
+			const Vector &tex_point,
+			const Vector &tdx,
+			const synfig::Surface &texture,
+			const Rect &tex_bounds,
+			Color::value_type opacity,
+			bool replace )
+		{
+			switch(interpolation) {
+			case Color::INTERPOLATION_NEAREST:
+				fill_span<SampleNearest>(apen, count, tex_point, tdx, texture, tex_bounds, opacity, replace); break;
+			case Color::INTERPOLATION_LINEAR:
+				fill_span< SampleLinear<false> >(apen, count, tex_point, tdx, texture, tex_bounds, opacity, replace); break;
+			case Color::INTERPOLATION_COSINE:
+				fill_span< SampleLinear<true> >(apen, count, tex_point, tdx, texture, tex_bounds, opacity, replace); break;
+			default:
+				fill_span<SampleCubic>(apen, count, tex_point, tdx, texture, tex_bounds, opacity, replace); break;
+			}
+		}
+
+		//! bounds of triangle in pixels, same rounding as in render_triangle()
+		static RectInt triangle_bounds(const Vector &p0, const Vector &p1, const Vector &p2)
+		{
+			IntVector ip0(p0), ip1(p1), ip2(p2);
+			return RectInt(
+				std::min(ip0.x, std::min(ip1.x, ip2.x)),
+				std::min(ip0.y, std::min(ip1.y, ip2.y)),
+				std::max(ip0.x, std::max(ip1.x, ip2.x)) + 1,
+				std::max(ip0.y, std::max(ip1.y, ip2.y)) + 1 );
+		}
 	};
 }
 
@@ -213,11 +359,13 @@ software::Mesh::render_triangle(
 	const synfig::Surface &texture,
 	const Rect &texture_rect,
 	Color::value_type opacity,
-	Color::BlendMethod blend_method )
+	Color::BlendMethod blend_method,
+	Color::Interpolation interpolation )
 {
 	if (approximate_equal(opacity, Color::value_type(0))) return;
 	
 	bool straight = Color::is_straight(blend_method);
+	bool replace = blend_method == Color::BLEND_COMPOSITE && opacity == Color::value_type(1);
 	Rect tex_bounds = texture_rect & Rect(0.0, 0.0, texture.get_w(), texture.get_h());
 	if ( !texture.is_valid() || !tex_bounds.is_valid()
 	  || (t0[0] < tex_bounds.minx && t1[0] < tex_bounds.minx && t2[0] < tex_bounds.minx)
@@ -298,25 +446,10 @@ software::Mesh::render_triangle(
 			if (x1 >= x0)
 			{
 				apen.move_to(x0, y);
-				Vector tex_point = matrix.get_transformed(Vector(Real(x0), Real(y)));
-				for(int x = x0; x <= x1; ++x)
-				{
-					if (tex_point[0] < tex_bounds.minx || tex_point[0] > tex_bounds.maxx
-					 || tex_point[1] < tex_bounds.miny || tex_point[1] > tex_bounds.maxy)
-					{
-						apen.set_alpha(0.0);
-						apen.put_value(Color());
-					}
-					else
-					{
-						apen.set_alpha(opacity);
-						apen.put_value(texture.cubic_sample(tex_point[0], tex_point[1]));
-					}
-					// uncomment following line to debug
-					//apen.put_value(Color(0,0,1,0.5));
-					apen.inc_x();
-					tex_point += tdx;
-				}
+				Internal::fill_span(
+					interpolation, apen, x1 - x0 + 1,
+					matrix.get_transformed(Vector(Real(x0), Real(y))), tdx,
+					texture, tex_bounds, opacity, replace );
 			}
     	}
 
@@ -347,25 +480,10 @@ software::Mesh::render_triangle(
 			if (x1 >= x0)
 			{
 				apen.move_to(x0, y);
-				Vector tex_point = matrix.get_transformed(Vector(Real(x0), Real(y)));
-				for(int x = x0; x <= x1; ++x)
-				{
-					if (tex_point[0] < tex_bounds.minx || tex_point[0] > tex_bounds.maxx
-					 || tex_point[1] < tex_bounds.miny || tex_point[1] > tex_bounds.maxy)
-					{
-						apen.set_alpha(0.0);
-						apen.put_value(Color());
-					}
-					else
-					{
-						apen.set_alpha(opacity);
-						apen.put_value(texture.cubic_sample(tex_point[0], tex_point[1]));
-					}
-					// uncomment following line to debug
-					//apen.put_value(Color(1,0,0,0.5));
-					apen.inc_x();
-					tex_point += tdx;
-				}
+				Internal::fill_span(
+					interpolation, apen, x1 - x0 + 1,
+					matrix.get_transformed(Vector(Real(x0), Real(y))), tdx,
+					texture, tex_bounds, opacity, replace );
 			}
     	}
 
@@ -451,7 +569,8 @@ software::Mesh::render_mesh(
 	const Matrix &transform_matrix,
 	const Matrix &texture_matrix,
 	Color::value_type opacity,
-	Color::BlendMethod blend_method )
+	Color::BlendMethod blend_method,
+	Color::Interpolation interpolation )
 {
 	if ( !texture.is_valid()
 	  || !(texture_rect & Rect(0.0, 0.0, texture.get_w(), texture.get_h())).is_valid() )
@@ -474,22 +593,40 @@ software::Mesh::render_mesh(
 	if (tex_coords_strip <= 0) tex_coords_strip = sizeof(Vector);
 	if (triangles_strip <= 0) triangles_strip = sizeof(int[3]);
 
+	// transform each vertex only once
+	int vertices_count = 0;
 	for(int i = 0; i < triangles_count; ++i)
 	{
-		int *triangle = (int*)((char*)triangles + i*triangles_strip);
+		const int *triangle = (const int*)((const char*)triangles + i*triangles_strip);
+		vertices_count = std::max(vertices_count, std::max(triangle[0], std::max(triangle[1], triangle[2])) + 1);
+	}
+	std::vector<Vector> positions(vertices_count);
+	std::vector<Vector> coords(vertices_count);
+	for(int i = 0; i < vertices_count; ++i)
+	{
+		positions[i] = transform_matrix.get_transformed(*(const Vector*)((const char*)vertices + i*vertices_strip));
+		coords[i] = texture_matrix.get_transformed(*(const Vector*)((const char*)tex_coords + i*tex_coords_strip));
+	}
+
+	for(int i = 0; i < triangles_count; ++i)
+	{
+		const int *triangle = (const int*)((const char*)triangles + i*triangles_strip);
+		const Vector &p0 = positions[triangle[0]];
+		const Vector &p1 = positions[triangle[1]];
+		const Vector &p2 = positions[triangle[2]];
+		if (!(Internal::triangle_bounds(p0, p1, p2) & bounds).is_valid())
+			continue;
 		render_triangle(
 			target_surface,
 			target_rect,
-			transform_matrix.get_transformed(*(Vector*)((char*)vertices + triangle[0]*vertices_strip)),
-			texture_matrix.get_transformed(*(Vector*)((char*)tex_coords + triangle[0]*tex_coords_strip)),
-			transform_matrix.get_transformed(*(Vector*)((char*)vertices + triangle[1]*vertices_strip)),
-			texture_matrix.get_transformed(*(Vector*)((char*)tex_coords + triangle[1]*tex_coords_strip)),
-			transform_matrix.get_transformed(*(Vector*)((char*)vertices + triangle[2]*vertices_strip)),
-			texture_matrix.get_transformed(*(Vector*)((char*)tex_coords + triangle[2]*tex_coords_strip)),
+			p0, coords[triangle[0]],
+			p1, coords[triangle[1]],
+			p2, coords[triangle[2]],
 			texture,
 			texture_rect,
 			opacity,
-			blend_method );
+			blend_method,
+			interpolation );
 	}
 }
 
@@ -503,7 +640,8 @@ software::Mesh::render_mesh(
 	const Matrix &transform_matrix,
 	const Matrix &texture_matrix,
 	Color::value_type opacity,
-	Color::BlendMethod blend_method )
+	Color::BlendMethod blend_method,
+	Color::Interpolation interpolation )
 {
 	render_mesh(
 		target_surface,
@@ -520,7 +658,8 @@ software::Mesh::render_mesh(
 		transform_matrix,
 		texture_matrix,
 		opacity,
-		blend_method );
+		blend_method,
+		interpolation );
 }
 
 /* === E N T R Y P O I N T ================================================= */
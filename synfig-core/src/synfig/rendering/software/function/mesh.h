@@ -73,7 +73,8 @@ public:
 		const synfig::Surface &texture,
 		const Rect &texture_rect,
 		Color::value_type opacity,
-		Color::BlendMethod blend_method );
+		Color::BlendMethod blend_method,
+		Color::Interpolation interpolation = Color::INTERPOLATION_CUBIC );
 
 	static void render_polygon(
 		synfig::Surface &target_surface,
@@ -97,6 +98,8 @@ public:
 		Color::value_type opacity,
 		Color::BlendMethod blend_method );
 
+	//! Vertices are transformed once, triangles which are outside of target_rect
+	//! are skipped, so mesh may be rendered by tiles in separate threads
 	static void render_mesh(
 		synfig::Surface &target_surface,
 		const RectInt &target_rect,
@@ -112,7 +115,8 @@ public:
 		const Matrix &transform_matrix,
 		const Matrix &texture_matrix,
 		Color::value_type opacity,
-		Color::BlendMethod blend_method );
+		Color::BlendMethod blend_method,
+		Color::Interpolation interpolation = Color::INTERPOLATION_CUBIC );
 
 	static void render_mesh(
 		synfig::Surface &target_surface,
@@ -123,7 +127,8 @@ public:
 		const Matrix &transform_matrix,
 		const Matrix &texture_matrix,
 		Color::value_type opacity,
-		Color::BlendMethod blend_method );
+		Color::BlendMethod blend_method,
+		Color::Interpolation interpolation = Color::INTERPOLATION_CUBIC );
 };
 
 } /* end namespace software */
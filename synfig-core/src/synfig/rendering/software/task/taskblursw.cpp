@@ -52,7 +52,9 @@ using namespace rendering;
 
 namespace {
 
-class TaskBlurSW: public TaskBlur, public TaskSW, public TaskInterfaceBlendToTarget
+class TaskBlurSW: public TaskBlur, public TaskSW,
+	public TaskInterfaceBlendToTarget,
+	public TaskInterfaceSplit
 {
 public:
 	typedef etl::handle<TaskBlurSW> Handle;
@@ -64,6 +66,15 @@ public:
 	virtual Color::BlendMethodFlags get_supported_blend_methods() const
 		{ return Color::BLEND_METHODS_ALL & ~Color::BLEND_METHODS_STRAIGHT; }
 
+	virtual Real get_split_cost(const VectorInt &size) const {
+		// each part reads (and blurs) the source with margins
+		VectorInt extra = software::Blur::get_extra_size(
+			blur.type, blur.size.multiply_coords(get_pixels_per_unit()) );
+		Real w = size[0] + 2*extra[0];
+		Real h = size[1] + 2*extra[1];
+		return 4.0*w*h;
+	}
+
 	virtual bool run(RunParams&) const {
 		if (!is_valid() || !sub_task() || !sub_task()->is_valid())
 			return true;
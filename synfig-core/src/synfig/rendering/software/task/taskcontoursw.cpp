@@ -64,6 +64,11 @@ public:
 	static Token token;
 	virtual Token::Handle get_token() const { return token.handle(); }
 
+	//! Task is a part of the split task
+	bool split;
+
+	TaskContourSW(): split() { }
+
 	virtual void on_target_set_as_source() {
 		Task::Handle &subtask = sub_task(0);
 		if ( subtask
@@ -79,6 +84,26 @@ public:
 	virtual Color::BlendMethodFlags get_supported_blend_methods() const
 		{ return Color::BLEND_METHODS_ALL & ~Color::BLEND_METHODS_STRAIGHT; }
 
+	virtual Rect calc_opaque_bounds() const {
+		if ( blend
+		  && ( blend_method != Color::BLEND_COMPOSITE
+		    || !approximate_equal_lp(amount, ColorReal(1.0)) ))
+			return Rect::zero();
+		return TaskContour::calc_opaque_bounds();
+	}
+
+	virtual Real get_split_cost(const VectorInt &size) const {
+		// contour flattened once for all parts,
+		// each part processes edges which crosses rows of the part
+		Real edges = contour ? (Real)contour->get_chunks().size() : 0.0;
+		int h = target_rect.get_height();
+		Real rows = h > 0 ? std::min(1.0, size[1]/(Real)h) : 1.0;
+		return 16.0*edges*rows + (Real)size[0]*(Real)size[1];
+	}
+
+	virtual void on_split()
+		{ split = true; }
+
 	virtual bool run(RunParams&) const {
 		if (!is_valid())
 			return true;
@@ -95,19 +120,44 @@ public:
 
 		Matrix matrix = bounds_transfromation * transformation->matrix;
 
-		Polyspan polyspan;
-		polyspan.init(target_rect);
-		software::Contour::build_polyspan(contour->get_chunks(), matrix, polyspan, detail);
-		polyspan.close();
-		polyspan.sort_marks();
+		if (!split) {
+			Polyspan polyspan;
+			polyspan.init(target_rect);
+			software::Contour::build_polyspan(contour->get_chunks(), matrix, polyspan, detail);
+			polyspan.close();
+			polyspan.sort_marks();
+
+			LockWrite la(this);
+			if (!la)
+				return false;
+
+			software::Contour::render_polyspan(
+				la->get_surface(),
+				polyspan,
+				contour->invert,
+				allow_antialias && contour->antialias,
+				contour->winding_style,
+				contour->color,
+				blend ? amount : 1.0,
+				blend ? blend_method : Color::BLEND_COMPOSITE );
+
+			return true;
+		}
 
 		LockWrite la(this);
 		if (!la)
 			return false;
 
-		software::Contour::render_polyspan(
-			la->get_surface(),
-			polyspan,
+		// parts of the split task share flattened edges of the contour,
+		// so curves are flattened once, but coarser than by Polyspan
+		synfig::Surface &surface = la->get_surface();
+		ContourEdges::Handle edges = contour->get_edges(
+			matrix, detail, RectInt(0, 0, surface.get_w(), surface.get_h()) );
+
+		software::Contour::render_edges(
+			surface,
+			target_rect,
+			*edges,
 			contour->invert,
 			allow_antialias && contour->antialias,
 			contour->winding_style,
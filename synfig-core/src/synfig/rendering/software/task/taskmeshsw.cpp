@@ -51,12 +51,22 @@ using namespace rendering;
 
 namespace {
 
-class TaskMeshSW: public TaskMesh, public TaskSW
+class TaskMeshSW: public TaskMesh, public TaskSW,
+	public TaskInterfaceSplit
 {
 	typedef etl::handle<TaskMeshSW> Handle;
 	static Token token;
 	virtual Token::Handle get_token() const { return token.handle(); }
 
+	virtual Real get_split_cost(const VectorInt &size) const {
+		// each part transforms all vertices and tests bounds of all triangles,
+		// but rasterizes only triangles which crosses the part
+		Real triangles = mesh ? (Real)mesh->triangles.size() : 0.0;
+		Real vertices = mesh ? (Real)mesh->vertices.size() : 0.0;
+		// textured pixel costs several simple operations
+		return 2.0*vertices + triangles + 8.0*(Real)size[0]*(Real)size[1];
+	}
+
 	virtual bool run(RunParams&) const {
 		if (!is_valid() || !sub_task() || !sub_task()->is_valid())
 			return true;
@@ -102,7 +112,8 @@ class TaskMeshSW: public TaskMesh, public TaskSW
 			transfromation_matrix,
 			texture_transfromation_matrix,
 			1.0,
-			Color::BLEND_COMPOSITE );
+			Color::BLEND_COMPOSITE,
+			interpolation );
 
 		return true;
 	}
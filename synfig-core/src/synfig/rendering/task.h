@@ -432,6 +432,11 @@ public:
 		return bounds;
 	}
 
+	//! Conservative region (in source units) where result of task is fully opaque.
+	//! Tasks placed below this region by BLEND_COMPOSITE are invisible (see OptimizerOcclusion)
+	virtual Rect calc_opaque_bounds() const
+		{ return Rect::zero(); }
+
 	Vector get_pixels_per_unit() const;
 	Vector get_units_per_pixel() const;
 
@@ -492,6 +497,14 @@ class TaskInterfaceSplit
 public:
 	virtual bool is_splittable() const
 		{ return true; }
+	//! Estimated cost of rendering of the part of target_rect with given size,
+	//! measured in simple per-pixel operations. Should include the work which
+	//! will be repeated for each part (margins of sources, preparing of geometry, etc)
+	virtual Real get_split_cost(const VectorInt &size) const
+		{ return (Real)size[0]*(Real)size[1]; }
+	//! Called for each part of the split task after its target_rect is truncated
+	virtual void on_split()
+		{ }
 	virtual ~TaskInterfaceSplit() { }
 };
 
@@ -529,6 +542,14 @@ public:
 	typedef etl::handle<TaskSurface> Handle;
 	SYNFIG_EXPORT static Token token;
 	virtual Token::Handle get_token() const { return token.handle(); }
+
+	//! set it when surface has no transparent pixels
+	bool opaque;
+
+	TaskSurface(): opaque() { }
+
+	virtual Rect calc_opaque_bounds() const
+		{ return opaque ? source_rect : Rect::zero(); }
 };
 
 
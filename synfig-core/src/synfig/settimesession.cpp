@@ -0,0 +1,249 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file settimesession.cpp
+**	\brief SetTimeSession
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#ifdef USING_PCH
+#	include "pch.h"
+#else
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+#include <sigc++/bind.h>
+#include <sigc++/functors/mem_fun.h>
+#include <sigc++/functors/ptr_fun.h>
+
+#include "settimesession.h"
+#include "valuenode.h"
+
+#endif
+
+/* === U S I N G =========================================================== */
+
+using namespace synfig;
+
+/* === M A C R O S ========================================================= */
+
+/* === G L O B A L S ======================================================= */
+
+namespace {
+	std::atomic<bool> parallel(false);
+	std::atomic<bool> timing(false);
+
+	thread_local SetTimeSession *current_session = nullptr;
+	//! count of SharedCanvasLock in the current thread
+	thread_local int serial_depth = 0;
+
+	std::recursive_mutex shared_canvas_mutex;
+
+	std::mutex canvas_times_mutex;
+	std::map<const void*, CanvasSetTime> canvas_times;
+	//! to keep order of canvases with the same times
+	std::vector<const void*> canvas_times_order;
+}
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+	Real get_seconds()
+	{
+		return std::chrono::duration<Real>(
+			std::chrono::steady_clock::now().time_since_epoch() ).count();
+	}
+
+	bool compare_canvas_times(const CanvasSetTime &a, const CanvasSetTime &b)
+		{ return a.seconds > b.seconds; }
+}
+
+/* === M E T H O D S ======================================================= */
+
+SetTimeSession::Scope::Scope(SetTimeSession *session):
+	previous(current_session)
+	{ current_session = session; }
+
+SetTimeSession::Scope::~Scope()
+	{ current_session = previous; }
+
+
+SetTimeSession::SharedCanvasLock::SharedCanvasLock():
+	locked(current_session != nullptr)
+	{ if (locked) { shared_canvas_mutex.lock(); ++serial_depth; } }
+
+SetTimeSession::SharedCanvasLock::~SharedCanvasLock()
+	{ if (locked) { --serial_depth; shared_canvas_mutex.unlock(); } }
+
+
+SetTimeSession::Timer::Timer(const void *key, const String &name):
+	key(timing ? key : nullptr),
+	begin()
+{
+	if (this->key)
+	{
+		this->name = name;
+		begin = get_seconds();
+	}
+}
+
+SetTimeSession::Timer::~Timer()
+{
+	if (!key) return;
+	Real seconds = get_seconds() - begin;
+	std::lock_guard<std::mutex> lock(canvas_times_mutex);
+	CanvasSetTime &t = canvas_times[key];
+	if (!t.calls)
+	{
+		t.name = name;
+		canvas_times_order.push_back(key);
+	}
+	++t.calls;
+	t.seconds += seconds;
+}
+
+
+SetTimeSession::SetTimeSession() { }
+
+SetTimeSession::~SetTimeSession() { }
+
+SetTimeSession*
+SetTimeSession::current()
+	{ return current_session; }
+
+ValueBase
+SetTimeSession::calculate_once(ValueMap &map, const ValueNode &value_node, Time time, const CalculateSlot &calculate)
+{
+	// the first thread calculates the value, others wait for it
+	std::promise<ValueBase> promise;
+	std::shared_future<ValueBase> future;
+	bool owner = false;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		std::shared_future<ValueBase> &f = map[Key(&value_node, (Real)time)];
+		if (!f.valid())
+		{
+			f = promise.get_future().share();
+			owner = true;
+		}
+		future = f;
+	}
+
+	if (owner)
+	{
+		try
+			{ promise.set_value(calculate(time)); }
+		catch(...)
+			{ promise.set_exception(std::current_exception()); }
+	}
+	return future.get();
+}
+
+ValueBase
+SetTimeSession::evaluate(const ValueNode &value_node, Time time)
+{
+	SetTimeSession *session = current_session;
+	if (!session || (!value_node.is_exported() && value_node.rcount() < 2))
+		return value_node(time);
+	return session->calculate_once(
+		session->values, value_node, time,
+		sigc::mem_fun(value_node, &ValueNode::operator()) );
+}
+
+ValueBase
+SetTimeSession::evaluate_stateful(const ValueNode &value_node, Time time, const CalculateSlot &calculate)
+{
+	SetTimeSession *session = current_session;
+	if (!session)
+		return calculate(time);
+	// separate map, because node may be evaluated by evaluate() too
+	return session->calculate_once(session->stateful_values, value_node, time, calculate);
+}
+
+void
+SetTimeSession::run_task(SetTimeSession *session, ThreadPool::Slot slot)
+{
+	Scope scope(session);
+	slot();
+}
+
+void
+SetTimeSession::run(const ThreadPool::Slot &first, const ThreadPool::Slot &second)
+{
+	// don't split the work when all threads are busy already
+	if ( !parallel
+	  || !current_session
+	  || serial_depth > 0
+	  || ThreadPool::instance().get_queue_size() >= ThreadPool::instance().get_max_threads() )
+	{
+		first();
+		second();
+		return;
+	}
+
+	ThreadPool::Group group;
+	group.enqueue(sigc::bind(sigc::ptr_fun(&SetTimeSession::run_task), current_session, first));
+	group.enqueue(sigc::bind(sigc::ptr_fun(&SetTimeSession::run_task), current_session, second));
+	group.run();
+}
+
+void
+SetTimeSession::set_parallel(bool x)
+	{ parallel = x; }
+
+bool
+SetTimeSession::get_parallel()
+	{ return parallel; }
+
+void
+SetTimeSession::set_timing(bool x)
+	{ timing = x; }
+
+bool
+SetTimeSession::get_timing()
+	{ return timing; }
+
+std::vector<CanvasSetTime>
+SetTimeSession::get_canvas_times()
+{
+	std::vector<CanvasSetTime> times;
+	{
+		std::lock_guard<std::mutex> lock(canvas_times_mutex);
+		for(std::vector<const void*>::const_iterator i = canvas_times_order.begin(); i != canvas_times_order.end(); ++i)
+			times.push_back(canvas_times[*i]);
+	}
+	std::stable_sort(times.begin(), times.end(), compare_canvas_times);
+	return times;
+}
+
+void
+SetTimeSession::reset_canvas_times()
+{
+	std::lock_guard<std::mutex> lock(canvas_times_mutex);
+	canvas_times.clear();
+	canvas_times_order.clear();
+}
+
+/* === E N T R Y P O I N T ================================================= */
@@ -0,0 +1,167 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file settimesession.h
+**	\brief SetTimeSession
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === S T A R T =========================================================== */
+
+#ifndef __SYNFIG_SETTIMESESSION_H
+#define __SYNFIG_SETTIMESESSION_H
+
+/* === H E A D E R S ======================================================= */
+
+#include <future>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "real.h"
+#include "string.h"
+#include "threadpool.h"
+#include "time.h"
+#include "value.h"
+
+/* === M A C R O S ========================================================= */
+
+/* === T Y P E D E F S ===================================================== */
+
+/* === C L A S S E S & S T R U C T S ======================================= */
+
+namespace synfig {
+
+class ValueNode;
+
+//! Time spent on set_time() of one canvas, see SetTimeSession::get_canvas_times()
+struct CanvasSetTime
+{
+	String name;
+	int calls;
+	Real seconds; //!< including nested canvases
+
+	CanvasSetTime(): calls(), seconds() { }
+};
+
+/*!	\class SetTimeSession
+**	\brief Shared state of one Canvas::set_time() call
+**
+**	Canvas::set_time() of the root canvas creates the session.
+**	When parallel mode is enabled, groups set time of their inline canvases
+**	in the ThreadPool simultaneously with the rest of the context (see run()),
+**	and value nodes shared by several parameters (exported or linked)
+**	are evaluated only once for each time while session is alive (see evaluate()).
+**	Value nodes which keep mutable state (caches, simulation) are evaluated
+**	once for each time at any level of the tree (see evaluate_stateful()).
+**	Session is created only in parallel mode.
+*/
+class SetTimeSession
+{
+public:
+	typedef sigc::slot<ValueBase, Time> CalculateSlot;
+
+	//! Makes session current for the calling thread
+	class Scope
+	{
+	private:
+		SetTimeSession *previous;
+	public:
+		explicit Scope(SetTimeSession *session);
+		~Scope();
+	};
+
+	//! Canvases which are not inline may be used by several groups,
+	//! so the lock serializes setting of time for them,
+	//! and nested canvases are processed in the current thread while it is held.
+	//! Does nothing outside of session.
+	class SharedCanvasLock
+	{
+	private:
+		bool locked;
+	public:
+		SharedCanvasLock();
+		~SharedCanvasLock();
+	};
+
+	//! Collects time spent by the scope into get_canvas_times()
+	class Timer
+	{
+	private:
+		const void *key;
+		String name;
+		Real begin;
+	public:
+		//! \param key identifies the canvas, \param name is used in the first record only
+		Timer(const void *key, const String &name);
+		~Timer();
+	};
+
+private:
+	typedef std::pair<const ValueNode*, Real> Key;
+	typedef std::map<Key, std::shared_future<ValueBase> > ValueMap;
+
+	std::mutex mutex;
+	ValueMap values;          //!< shared parameters of layers, see evaluate()
+	ValueMap stateful_values; //!< nodes with mutable state, see evaluate_stateful()
+
+	//! The first thread calculates the value, others wait for it
+	ValueBase calculate_once(ValueMap &map, const ValueNode &value_node, Time time, const CalculateSlot &calculate);
+
+	static void run_task(SetTimeSession *session, ThreadPool::Slot slot);
+
+public:
+	SetTimeSession();
+	~SetTimeSession();
+
+	//! Session of the calling thread or null
+	static SetTimeSession* current();
+
+	//! Calculates the value of node, shared nodes are calculated once per session
+	static ValueBase evaluate(const ValueNode &value_node, Time time);
+
+	//! Value nodes which change their mutable members while calculation should call this
+	//! from operator()(), so they are never calculated simultaneously by several threads
+	//! and the result doesn't depend on the order of threads.
+	//! Calls \a calculate once per time for the session, or every time without session
+	static ValueBase evaluate_stateful(const ValueNode &value_node, Time time, const CalculateSlot &calculate);
+
+	//! Calls both slots, simultaneously if parallel mode is enabled and there are free threads,
+	//! slot processed in other thread gets the session of the calling thread
+	static void run(const ThreadPool::Slot &first, const ThreadPool::Slot &second);
+
+	//! Enables setting of time for independent canvases in several threads (disabled by default).
+	//! Handlers of layer signals will be called from the ThreadPool threads in this mode.
+	static void set_parallel(bool x);
+	static bool get_parallel();
+
+	//! Enables collecting of get_canvas_times() (disabled by default)
+	static void set_timing(bool x);
+	static bool get_timing();
+
+	//! Returns times of canvases collected since the last reset_canvas_times() call,
+	//! sorted by spent time
+	static std::vector<CanvasSetTime> get_canvas_times();
+	static void reset_canvas_times();
+};
+
+}; // END of namespace synfig
+
+/* === E N D =============================================================== */
+
+#endif
@@ -0,0 +1,284 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file skinning.cpp
+**	\brief SkinningGrid
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#ifdef USING_PCH
+#	include "pch.h"
+#else
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+#include <sigc++/bind.h>
+#include <sigc++/functors/mem_fun.h>
+
+#include "skinning.h"
+#include "threadpool.h"
+
+#endif
+
+/* === U S I N G =========================================================== */
+
+using namespace synfig;
+
+/* === M A C R O S ========================================================= */
+
+/* === G L O B A L S ======================================================= */
+
+namespace {
+	//! minimal weight of bone, and minimal distance to bone
+	const Real precision = 1e-10;
+	//! see Bone::distance_to_shape_center_percent()
+	const Real shape_precision = 1e-9;
+	//! grids with less count of (point, bone) pairs are processed in the current thread
+	const long long min_parallel_work = 64*64;
+	//! count of row blocks per thread
+	const int blocks_per_thread = 4;
+}
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+	//! range of grid indices (including max) for coordinates from min to max
+	void calc_range(Real min, Real max, Real origin, Real step, int count, int &out_min, int &out_max)
+	{
+		out_min = 0;
+		out_max = count - 1;
+		if (std::fabs(step) <= precision)
+			return;
+		Real a = (min - origin)/step;
+		Real b = (max - origin)/step;
+		if (a > b) std::swap(a, b);
+		a = std::max(a, -1.0);
+		b = std::min(b, (Real)count);
+		out_min = std::max(out_min, (int)std::floor(a));
+		out_max = std::min(out_max, (int)std::ceil(b));
+	}
+}
+
+/* === M E T H O D S ======================================================= */
+
+SkinningGrid::SkinningGrid(const Vector &p0, const Vector &p1, int count_x, int count_y):
+	p0(p0),
+	count_x(std::max(1, count_x)),
+	count_y(std::max(1, count_y))
+{
+	step[0] = this->count_x > 1 ? (p1[0] - p0[0])/(Real)(this->count_x - 1) : 0.0;
+	step[1] = this->count_y > 1 ? (p1[1] - p0[1])/(Real)(this->count_y - 1) : 0.0;
+
+	xs.resize(this->count_x);
+	for(int i = 0; i < this->count_x; ++i)
+		xs[i] = p0[0] + i*step[0];
+	ys.resize(this->count_y);
+	for(int j = 0; j < this->count_y; ++j)
+		ys[j] = p0[1] + j*step[1];
+
+	int count = get_count();
+	sum_x.assign(count, 0.0);
+	sum_y.assign(count, 0.0);
+	sum_depth.assign(count, 0.0);
+	sum_weight.assign(count, 0.0);
+	used.assign(count, 0);
+}
+
+void
+SkinningGrid::add_bone(const Bone::Shape &rest_shape, const Bone::Shape &pose_shape, Real depth)
+{
+	const Bone::Shape &shape0 = rest_shape;
+	const Bone::Shape &shape1 = pose_shape;
+	Real expand = 2.0*step.mag();
+
+	BoneInfo bone;
+
+	Matrix into_bone(
+		shape0.p1[0] - shape0.p0[0], shape0.p1[1] - shape0.p0[1], 0.0,
+		shape0.p0[1] - shape0.p1[1], shape0.p1[0] - shape0.p0[0], 0.0,
+		shape0.p0[0], shape0.p0[1], 1.0
+	);
+	into_bone.invert();
+	Matrix from_bone(
+		shape1.p1[0] - shape1.p0[0], shape1.p1[1] - shape1.p0[1], 0.0,
+		shape1.p0[1] - shape1.p1[1], shape1.p1[0] - shape1.p0[0], 0.0,
+		shape1.p0[0], shape1.p0[1], 1.0
+	);
+	bone.matrix = from_bone * into_bone;
+	bone.depth = depth;
+
+	bone.p0 = shape0.p0;
+	bone.p1 = shape0.p1;
+	bone.r0 = std::fabs(shape0.r0 + expand);
+	bone.r1 = std::fabs(shape0.r1 + expand);
+	bone.k0 = bone.r0 > shape_precision ? 1.0/bone.r0 : 0.0;
+	bone.k1 = bone.r1 > shape_precision ? 1.0/bone.r1 : 0.0;
+
+	Vector line = bone.p1 - bone.p0;
+	bone.line_length = line.mag();
+	bone.line_dir = bone.line_length > 0.0 ? line/bone.line_length : Vector();
+
+	// constants of Bone::distance_to_shape_center_percent()
+	Real length = bone.line_length;
+	bone.shape_line = length > 0.0 && length + shape_precision > std::fabs(bone.r1 - bone.r0);
+	bone.shape_k = 0.0;
+	bone.shape_rr0 = bone.shape_rr1 = 0.0;
+	if (bone.shape_line) {
+		Real cos0 = (bone.r0 - bone.r1)/length;
+		Real sin0 = sqrt(1 + shape_precision - cos0*cos0);
+		Real ll = length - bone.r0*cos0 + bone.r1*cos0;
+		bone.shape_line = ll != 0.0;
+		bone.shape_k = bone.shape_line ? 1.0/ll : 0.0;
+		bone.shape_origin = bone.p0 + line/length*(bone.r0*cos0);
+		bone.shape_rr0 = bone.r0*sin0;
+		bone.shape_rr1 = bone.r1*sin0;
+	}
+
+	// influence area lies inside of bounds of both circles
+	// (with a small margin for rounding errors)
+	Real r0 = bone.r0*(1.0 + 1e-6) + precision;
+	Real r1 = bone.r1*(1.0 + 1e-6) + precision;
+	Real minx = std::min(bone.p0[0] - r0, bone.p1[0] - r1);
+	Real maxx = std::max(bone.p0[0] + r0, bone.p1[0] + r1);
+	Real miny = std::min(bone.p0[1] - r0, bone.p1[1] - r1);
+	Real maxy = std::max(bone.p0[1] + r0, bone.p1[1] + r1);
+	calc_range(minx, maxx, p0[0], step[0], count_x, bone.minx, bone.maxx);
+	calc_range(miny, maxy, p0[1], step[1], count_y, bone.miny, bone.maxy);
+	if (bone.minx > bone.maxx || bone.miny > bone.maxy)
+		return;
+
+	bones.push_back(bone);
+}
+
+void
+SkinningGrid::process_rows(int begin, int end)
+{
+	// each point sums bones in the order of adding,
+	// so result doesn't depend on the count of threads
+	for(int y = begin; y < end; ++y)
+	{
+		const Real py = ys[y];
+		const int row = y*count_x;
+		Real *row_sum_x      = &sum_x[row];
+		Real *row_sum_y      = &sum_y[row];
+		Real *row_sum_depth  = &sum_depth[row];
+		Real *row_sum_weight = &sum_weight[row];
+		unsigned char *row_used = &used[row];
+
+		for(std::vector<BoneInfo>::const_iterator b = bones.begin(); b != bones.end(); ++b)
+		{
+			if (y < b->miny || y > b->maxy)
+				continue;
+
+			const Real dy0 = py - b->p0[1];
+			const Real dy1 = py - b->p1[1];
+			const Real sy = py - b->shape_origin[1];
+			const Real m00 = b->matrix.m00, m01 = b->matrix.m01;
+			const Real ty0 = py*b->matrix.m10 + b->matrix.m20;
+			const Real ty1 = py*b->matrix.m11 + b->matrix.m21;
+
+			for(int x = b->minx; x <= b->maxx; ++x)
+			{
+				const Real px = xs[x];
+				const Real dx0 = px - b->p0[0];
+				const Real dx1 = px - b->p1[0];
+				const Real d0 = std::sqrt(dx0*dx0 + dy0*dy0);
+				const Real d1 = std::sqrt(dx1*dx1 + dy1*dy1);
+
+				// distance to shape center in percents
+				Real percent = 0.0;
+				if (b->k0 != 0.0) percent = std::max(percent, 1.0 - d0*b->k0);
+				if (b->k1 != 0.0) percent = std::max(percent, 1.0 - d1*b->k1);
+				if (b->shape_line) {
+					const Real sx = px - b->shape_origin[0];
+					const Real pos = (sx*b->line_dir[0] + sy*b->line_dir[1])*b->shape_k;
+					if (pos > 0.0 && pos < 1.0) {
+						Real distance = std::fabs(sx*b->line_dir[1] - sy*b->line_dir[0]);
+						Real max_distance = b->shape_rr0*(1.0 - pos) + b->shape_rr1*pos;
+						if (max_distance > 0.0)
+							percent = std::max(percent, 1.0 - distance/max_distance);
+					}
+				}
+				if (percent <= precision)
+					continue;
+
+				// distance to bone
+				Real distance = std::min(d0, d1);
+				if (b->line_length > precision) {
+					const Real pos = dx0*b->line_dir[0] + dy0*b->line_dir[1];
+					if (pos > 0.0 && pos < b->line_length)
+						distance = std::min(distance, std::fabs(dx0*b->line_dir[1] - dy0*b->line_dir[0]));
+				}
+				if (distance < precision) distance = precision;
+
+				const Real weight = percent/(distance*distance);
+				row_sum_x[x]      += (px*m00 + ty0)*weight;
+				row_sum_y[x]      += (px*m01 + ty1)*weight;
+				row_sum_depth[x]  += b->depth*weight;
+				row_sum_weight[x] += weight;
+				row_used[x] = 1;
+			}
+		}
+	}
+}
+
+void
+SkinningGrid::process()
+{
+	long long work = 0;
+	for(std::vector<BoneInfo>::const_iterator b = bones.begin(); b != bones.end(); ++b)
+		work += (long long)(b->maxx - b->minx + 1)*(b->maxy - b->miny + 1);
+
+	int threads = ThreadPool::instance().get_max_threads();
+	int blocks = std::min(count_y, std::max(1, threads*blocks_per_thread));
+	if (work < min_parallel_work || blocks < 2)
+		{ process_rows(0, count_y); return; }
+
+	ThreadPool::Group group;
+	for(int i = 0; i < blocks; ++i) {
+		int begin = (int)((long long)count_y*i/blocks);
+		int end = (int)((long long)count_y*(i + 1)/blocks);
+		if (begin < end)
+			group.enqueue( sigc::bind(sigc::mem_fun(*this, &SkinningGrid::process_rows), begin, end), end - begin );
+	}
+	group.run();
+}
+
+Vector
+SkinningGrid::get_position(int index) const
+{
+	return sum_weight[index] > precision
+	     ? Vector(sum_x[index], sum_y[index])/sum_weight[index]
+	     : get_initial_position(index);
+}
+
+Real
+SkinningGrid::get_depth(int index) const
+{
+	return sum_weight[index] > precision
+	     ? sum_depth[index]/sum_weight[index]
+	     : 0.0;
+}
+
+/* === E N T R Y P O I N T ================================================= */
@@ -0,0 +1,113 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file skinning.h
+**	\brief SkinningGrid Header
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === S T A R T =========================================================== */
+
+#ifndef __SYNFIG_SKINNING_H
+#define __SYNFIG_SKINNING_H
+
+/* === H E A D E R S ======================================================= */
+
+#include <vector>
+
+#include "bone.h"
+#include "matrix.h"
+#include "vector.h"
+
+/* === M A C R O S ========================================================= */
+
+/* === T Y P E D E F S ===================================================== */
+
+/* === C L A S S E S & S T R U C T S ======================================= */
+
+namespace synfig {
+
+//! Deforms regular grid of points by bones.
+//! Each point moves by the weighted sum of bone transformations,
+//! weight depends on distance from the point to the bone in rest position.
+//! Grid is stored as separate arrays of coordinates and sums,
+//! rows of grid are processed simultaneously by ThreadPool.
+class SkinningGrid
+{
+private:
+	//! bone constants which doesn't depend on grid point
+	struct BoneInfo
+	{
+		Matrix matrix;      //!< from rest position to pose
+		Real depth;
+
+		Vector p0, p1;      //!< rest position of bone
+		Real r0, r1;        //!< radii of influence area (expanded)
+		Real k0, k1;        //!< 1/r0 and 1/r1 or zero
+		Real line_length;
+		Vector line_dir;    //!< normalized (p1 - p0) or zero
+
+		bool shape_line;    //!< influence area has tangent lines between circles
+		Vector shape_origin;
+		Real shape_k;       //!< 1/(length of tangent line)
+		Real shape_rr0, shape_rr1;
+
+		int minx, maxx, miny, maxy; //!< affected range of grid points, including max
+	};
+
+	Vector p0, step;
+	int count_x, count_y;
+	std::vector<Real> xs, ys;
+
+	std::vector<BoneInfo> bones;
+
+	std::vector<Real> sum_x, sum_y, sum_depth, sum_weight;
+	std::vector<unsigned char> used;
+
+	void process_rows(int begin, int end);
+
+public:
+	//! Grid from p0 to p1 (inclusive) with count_x*count_y points
+	SkinningGrid(const Vector &p0, const Vector &p1, int count_x, int count_y);
+
+	int get_count_x() const { return count_x; }
+	int get_count_y() const { return count_y; }
+	int get_count() const { return count_x*count_y; }
+	int get_index(int x, int y) const { return y*count_x + x; }
+
+	//! Influence area of bone is expanded by two grid cells
+	void add_bone(const Bone::Shape &rest_shape, const Bone::Shape &pose_shape, Real depth);
+
+	//! Calculate sums for all added bones
+	void process();
+
+	Vector get_initial_position(int index) const
+		{ return Vector(xs[index % count_x], ys[index / count_x]); }
+	bool is_used(int index) const
+		{ return used[index]; }
+	//! Position after deformation (valid after process())
+	Vector get_position(int index) const;
+	//! Average depth of bones which affects the point (valid after process())
+	Real get_depth(int index) const;
+};
+
+}; // END of namespace synfig
+
+/* === E N D =============================================================== */
+
+#endif
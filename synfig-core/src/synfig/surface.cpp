@@ -101,8 +101,8 @@ public:
 		return true;
 	}
 
-	virtual void end_frame()
-		{ }
+	virtual bool end_frame()
+		{ return true; }
 
 	virtual Color * start_scanline(int scanline)
 		{ return (*surface)[scanline]; }
@@ -30,12 +30,16 @@
 # include <config.h>
 #endif
 
+#include <algorithm>
+
 #include "target.h"
 #include "string.h"
 #include "canvas.h"
+#include "module.h"
 #include "target_null.h"
 #include "target_null_tile.h"
 #include "targetparam.h"
+#include "rendering/renderer.h"
 
 using namespace synfig;
 using namespace etl;
@@ -94,7 +98,8 @@ Target::Target():
 	quality_(4),
 	alpha_mode(TARGET_ALPHA_MODE_KEEP),
 	avoid_time_sync_(false),
-	curr_frame_(0)
+	curr_frame_(0),
+	render_cancelled(false)
 {
 }
 
@@ -111,6 +116,7 @@ Target::Handle
 Target::create(const String &name, const String &filename,
 			   const synfig::TargetParam& params)
 {
+	Module::require(Module::BOOK_TARGET, name);
 	if(!book().count(name))
 		return handle<Target>();
 
@@ -163,3 +169,44 @@ Target::next_frame(Time& time)
 	return total_frames- curr_frame_;
 }
 
+bool
+Target::run_renderer(const rendering::Renderer &renderer, const rendering::Task::List &list)
+{
+	rendering::TaskEvent::Handle task_event = new rendering::TaskEvent();
+	{
+		std::lock_guard<std::mutex> lock(render_events_mutex);
+		if (render_cancelled) return false;
+		render_events.push_back(task_event);
+	}
+
+	renderer.enqueue(list, task_event);
+	task_event->wait();
+
+	{
+		std::lock_guard<std::mutex> lock(render_events_mutex);
+		std::vector<rendering::TaskEvent::Handle>::iterator i =
+			std::find(render_events.begin(), render_events.end(), task_event);
+		if (i != render_events.end()) render_events.erase(i);
+	}
+	return task_event->is_done();
+}
+
+void
+Target::cancel_render()
+{
+	std::vector<rendering::TaskEvent::Handle> events;
+	{
+		std::lock_guard<std::mutex> lock(render_events_mutex);
+		render_cancelled = true;
+		events.swap(render_events);
+	}
+	for(std::vector<rendering::TaskEvent::Handle>::const_iterator i = events.begin(); i != events.end(); ++i)
+		rendering::Renderer::cancel(*i);
+}
+
+bool
+Target::is_render_cancelled()
+{
+	std::lock_guard<std::mutex> lock(render_events_mutex);
+	return render_cancelled;
+}
@@ -33,7 +33,9 @@
 /* === H E A D E R S ======================================================= */
 
 #include <map>
+#include <mutex>
 #include <utility>
+#include <vector>
 
 #include <sigc++/signal.h>
 
@@ -82,6 +84,7 @@ class RendDesc;
 class Canvas;
 class ProgressCallback;
 struct TargetParam;
+namespace rendering { class Renderer; }
 
 enum TargetAlphaMode
 {
@@ -184,10 +187,22 @@ public:
 	//! The current frame being rendered
 	int curr_frame_;
 
+private:
+	//! Guards render_events and render_cancelled
+	std::mutex render_events_mutex;
+	//! Events of rendering tasks in progress, see run_renderer()
+	std::vector<rendering::TaskEvent::Handle> render_events;
+	bool render_cancelled;
+
 protected:
 	//! Default constructor
 	Target();
 
+	//! Enqueues tasks into \a renderer and waits for them.
+	//! Unlike Renderer::run() the tasks may be interrupted by cancel_render()
+	//! \return false if tasks are failed or cancelled
+	bool run_renderer(const rendering::Renderer &renderer, const rendering::Task::List &list);
+
 public:
 	virtual ~Target() { }
 	//! Gets the target quality
@@ -240,6 +255,13 @@ public:
 	 **	\sa curr_frame_
 	*/
 	virtual int	next_frame(Time& time);
+
+	//! Cancels rendering tasks in progress and all further ones, may be called from any thread.
+	//! Tasks already processed by the rendering threads are not interrupted,
+	//! the rest are removed from the queue.
+	void cancel_render();
+	//! Returns true if cancel_render() was called
+	bool is_render_cancelled();
 }; // END of class Target
 
 }; // END of namespace synfig
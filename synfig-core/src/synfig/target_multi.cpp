@@ -99,11 +99,12 @@ Target_Multi::start_frame(ProgressCallback *cb)
 	return a->start_frame(cb) && b->start_frame(cb);
 }
 
-void
+bool
 Target_Multi::end_frame()
 {
-	a->end_frame();
-	b->end_frame();
+	bool a_success = a->end_frame();
+	bool b_success = b->end_frame();
+	return a_success && b_success;
 }
 
 Color *
@@ -55,7 +55,7 @@ public:
 	virtual ~Target_Multi();
 	virtual bool add_frame(const synfig::Surface *surface, ProgressCallback *cb);
 	bool start_frame(ProgressCallback *cb = nullptr) override;
-	void end_frame() override;
+	bool end_frame() override;
 	Color * start_scanline(int scanline) override;
 	bool end_scanline() override;
 
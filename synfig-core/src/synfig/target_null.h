@@ -60,10 +60,10 @@ public:
 	    return true;
 	}
 
-	void end_frame() override {
+	bool end_frame() override {
 	    if (buffer) delete[] buffer;
 		buffer = nullptr;
-	    return;
+	    return true;
 	}
 
 	Color* start_scanline(int /*scanline*/) override { return buffer; }
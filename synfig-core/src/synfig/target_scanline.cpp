@@ -116,7 +116,8 @@ synfig::Target_Scanline::call_renderer(
 
 		rendering::Task::List list;
 		list.push_back(task);
-		renderer->run(list);
+		if (!run_renderer(*renderer, list) && is_render_cancelled())
+			return false;
 	}
 	return true;
 }
@@ -219,7 +220,7 @@ synfig::Target_Scanline::render(ProgressCallback *cb)
 
 						if (!call_renderer(surface, *canvas, context_params, blockrd))
 						{
-							if(cb)cb->error(_("Accelerated Renderer Failure"));
+							if(cb && !is_render_cancelled())cb->error(_("Accelerated Renderer Failure"));
 							return false;
 						} else {
 							SurfaceResource::LockRead<SurfaceSW> lock(surface);
@@ -281,7 +282,12 @@ synfig::Target_Scanline::render(ProgressCallback *cb)
 					}
 					surface->reset();
 
-					end_frame();
+					if(!end_frame())
+					{
+						if(cb)
+							cb->error(_("render(): target panic on end_frame()"));
+						return false;
+					}
 
 				}else //use normal rendering...
 				{
@@ -291,7 +297,7 @@ synfig::Target_Scanline::render(ProgressCallback *cb)
 					if (!call_renderer(surface, *canvas, context_params, desc))
 					{
 						// For some reason, the accelerated renderer failed.
-						if(cb)cb->error(_("Accelerated Renderer Failure"));
+						if(cb && !is_render_cancelled())cb->error(_("Accelerated Renderer Failure"));
 						return false;
 					}
 
@@ -372,7 +378,7 @@ synfig::Target_Scanline::render(ProgressCallback *cb)
 
 					if (!call_renderer(surface, *canvas, context_params, blockrd))
 					{
-						if(cb)cb->error(_("Accelerated Renderer Failure"));
+						if(cb && !is_render_cancelled())cb->error(_("Accelerated Renderer Failure"));
 						return false;
 					}
 
@@ -439,7 +445,12 @@ synfig::Target_Scanline::render(ProgressCallback *cb)
 				}
 				surface->reset();
 
-				end_frame();
+				if(!end_frame())
+				{
+					if(cb)
+						cb->error(_("render(): target panic on end_frame()"));
+					return false;
+				}
 
 			}else
 			{
@@ -448,7 +459,7 @@ synfig::Target_Scanline::render(ProgressCallback *cb)
 
 				if (!call_renderer(surface, *canvas, context_params, desc))
 				{
-					if(cb)cb->error(_("Accelerated Renderer Failure"));
+					if(cb && !is_render_cancelled())cb->error(_("Accelerated Renderer Failure"));
 					return false;
 				}
 
@@ -552,7 +563,12 @@ Target_Scanline::add_frame(const synfig::Surface *surface, ProgressCallback *cb)
 		}
 	}
 
-	end_frame();
+	if(!end_frame())
+	{
+		if (cb)
+			cb->error(_("add_frame(): target panic on end_frame()"));
+		return false;
+	}
 
 	return true;
 }
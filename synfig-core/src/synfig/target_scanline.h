@@ -81,8 +81,10 @@ public:
 	virtual int next_frame(Time& time);
 
 	//! Marks the end of a frame
-	/*! \see start_frame() */
-	virtual void end_frame()=0;
+	/*! \return \c true on success, \c false if the frame was not written.
+	**	\see start_frame()
+	*/
+	virtual bool end_frame()=0;
 
 	//! Marks the start of a scanline
 	/*!	\param scanline Which scanline is going to be rendered.
@@ -166,7 +166,8 @@ synfig::Target_Tile::call_renderer(
 			#ifdef DEBUG_MEASURE
 			debug::Measure t("run renderer");
 			#endif
-			renderer->run(list);
+			if (!run_renderer(*renderer, list) && is_render_cancelled())
+				return false;
 		}
 	}
 	return true;
@@ -238,7 +239,7 @@ synfig::Target_Tile::async_render_tile(
 	if (!call_renderer(surface, *canvas, context_params, tile_desc))
 	{
 		// For some reason, the accelerated renderer failed.
-		if(cb)cb->error(_("Accelerated Renderer Failure"));
+		if(cb && !is_render_cancelled())cb->error(_("Accelerated Renderer Failure"));
 		return false;
 	}
 
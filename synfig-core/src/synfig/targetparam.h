@@ -48,7 +48,8 @@ struct TargetParam
 	 *  its own valid default settings.
 	 */
 	TargetParam (const std::string& Video_codec = "none", int Bitrate = -1):
-		video_codec(Video_codec), bitrate(Bitrate), sequence_separator("."), offset_x(0), offset_y(0),rows(0),columns(0),append(true),dir(HR)
+		video_codec(Video_codec), bitrate(Bitrate), sequence_separator("."), offset_x(0), offset_y(0),rows(0),columns(0),append(true),dir(HR),
+		ordered_dithering(false), float_channels(false), tile_size(0), compression()
 	{ }
 
 	std::string video_codec;
@@ -61,6 +62,14 @@ struct TargetParam
 	int columns;
 	bool append;
 	Direction dir;
+	//! Use ordered dithering in GIF files instead of error diffusion
+	bool ordered_dithering;
+	//! Write 32-bit float channels instead of 16-bit half ones (OpenEXR)
+	bool float_channels;
+	//! Width and height of tiles for tiled files, 0 for scanline files (OpenEXR)
+	int tile_size;
+	//! Name of the compression method, empty for the default one of the target (OpenEXR)
+	std::string compression;
 };
 
 }; // END of namespace synfig
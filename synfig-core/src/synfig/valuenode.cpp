@@ -42,6 +42,7 @@
 #include "canvas.h"
 #include "layer.h"
 #include <algorithm>
+#include <atomic>
 
 #endif
 
@@ -56,6 +57,9 @@ using namespace synfig;
 
 static int value_node_count(0);
 
+//! Counts renamings of exported value nodes, see ValueNodeList::find_iterator()
+static std::atomic<unsigned int> exported_id_changes(0);
+
 /* === P R O C E D U R E S ================================================= */
 
 ValueNode::LooseHandle
@@ -177,6 +181,9 @@ ValueNode::set_id(const String &x)
 {
 	if(name!=x)
 	{
+		// node with non-empty id may be in ValueNodeList, so its index becomes outdated
+		if(!name.empty())
+			exported_id_changes++;
 		name=x;
 		signal_id_changed_();
 	}
@@ -355,37 +362,66 @@ ValueNode::get_values_vfunc(std::map<Time, ValueBase> &x) const
 
 
 ValueNodeList::ValueNodeList():
-	placeholder_count_(0)
+	placeholder_count_(0),
+	index_id_changes_(exported_id_changes)
 {
 }
 
-bool
-ValueNodeList::count(const String &id)const
+ValueNodeList::iterator
+ValueNodeList::find_iterator(const String &id)const
 {
-	const_iterator iter;
+	ValueNodeList &list = const_cast<ValueNodeList&>(*this);
+	std::lock_guard<std::mutex> lock(index_mutex_);
 
-	if(id.empty())
-		return false;
+	unsigned int id_changes = exported_id_changes;
+	if(index_id_changes_ != id_changes)
+	{
+		// keep the first node for duplicated ids, like the linear search did
+		index_.clear();
+		for(iterator iter = list.begin(); iter != list.end(); ++iter)
+			index_.insert(std::make_pair((*iter)->get_id(), iter));
+		index_id_changes_ = id_changes;
+	}
 
-	for(iter=begin();iter!=end() && id!=(*iter)->get_id();++iter)
-		;
+	std::unordered_map<String, iterator>::const_iterator i = index_.find(id);
+	// the node may be replaced by other one (see ValueNode::replace()) which has no id yet
+	if(i == index_.end() || (*i->second)->get_id() != id)
+		return list.end();
+	return i->second;
+}
 
-	if(iter==end())
+void
+ValueNodeList::index_insert(iterator iter)
+{
+	std::lock_guard<std::mutex> lock(index_mutex_);
+	index_.insert(std::make_pair((*iter)->get_id(), iter));
+}
+
+void
+ValueNodeList::index_erase(iterator iter)
+{
+	std::lock_guard<std::mutex> lock(index_mutex_);
+	std::unordered_map<String, iterator>::iterator i = index_.find((*iter)->get_id());
+	if(i != index_.end() && i->second == iter)
+		index_.erase(i);
+}
+
+bool
+ValueNodeList::count(const String &id)const
+{
+	if(id.empty())
 		return false;
 
-	return true;
+	return find_iterator(id)!=end();
 }
 
 ValueNode::Handle
 ValueNodeList::find(const String &id, bool might_fail)
 {
-	iterator iter;
-
 	if(id.empty())
 		throw Exception::IDNotFound("Empty ID");
 
-	for(iter=begin();iter!=end() && id!=(*iter)->get_id();++iter)
-		;
+	iterator iter=find_iterator(id);
 
 	if(iter==end())
 	{
@@ -399,13 +435,10 @@ ValueNodeList::find(const String &id, bool might_fail)
 ValueNode::ConstHandle
 ValueNodeList::find(const String &id, bool might_fail)const
 {
-	const_iterator iter;
-
 	if(id.empty())
 		throw Exception::IDNotFound("Empty ID");
 
-	for(iter=begin();iter!=end() && id!=(*iter)->get_id();++iter)
-		;
+	const_iterator iter=find_iterator(id);
 
 	if(iter==end())
 	{
@@ -433,6 +466,7 @@ ValueNodeList::surefind(const String &id)
 		value_node=PlaceholderValueNode::create();
 		value_node->set_id(id);
 		push_back(value_node);
+		index_insert(--end());
 		placeholder_count_++;
 	}
 
@@ -444,17 +478,21 @@ ValueNodeList::erase(ValueNode::Handle value_node)
 {
 	assert(value_node);
 
-	iterator iter;
+	iterator iter=find_iterator(value_node->get_id());
 
-	for(iter=begin();iter!=end();++iter)
-		if(value_node.get()==iter->get())
-		{
-			std::list<ValueNode::RHandle>::erase(iter);
-			if(PlaceholderValueNode::Handle::cast_dynamic(value_node))
-				placeholder_count_--;
-			return true;
-		}
-	return false;
+	// the node may be renamed before, so search it through the whole list
+	if(iter==end() || value_node.get()!=iter->get())
+		for(iter=begin();iter!=end() && value_node.get()!=iter->get();++iter)
+			;
+
+	if(iter==end())
+		return false;
+
+	index_erase(iter);
+	std::list<ValueNode::RHandle>::erase(iter);
+	if(PlaceholderValueNode::Handle::cast_dynamic(value_node))
+		placeholder_count_--;
+	return true;
 }
 
 bool
@@ -470,6 +508,7 @@ ValueNodeList::add(ValueNode::Handle value_node)
 		ValueNode::RHandle other_value_node=find(value_node->get_id(), true);
 		if(PlaceholderValueNode::Handle::cast_dynamic(other_value_node))
 		{
+			// the list item now refers to value_node, so the index stays valid
 			other_value_node->replace(value_node);
 			placeholder_count_--;
 			return true;
@@ -480,6 +519,7 @@ ValueNodeList::add(ValueNode::Handle value_node)
 	catch(Exception::IDNotFound&)
 	{
 		push_back(value_node);
+		index_insert(--end());
 		return true;
 	}
 
@@ -493,7 +533,10 @@ ValueNodeList::audit()
 
 	for(next=begin(),iter=next++;iter!=end();iter=next++)
 		if(iter->count()==1)
+		{
+			index_erase(iter);
 			std::list<ValueNode::RHandle>::erase(iter);
+		}
 }
 
 
@@ -48,6 +48,8 @@
 #include <map>
 #include <set>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 /* === M A C R O S ========================================================= */
 
@@ -478,6 +480,19 @@ protected:
 class ValueNodeList : public std::list<ValueNode::RHandle>
 {
 	int placeholder_count_;
+
+	//! Hash index of the list by id, so lookups don't scan the whole list.
+	//! Renaming of listed nodes is detected by the counter of id changes
+	//! (see ValueNode::set_id()), and the index is rebuilt on the next lookup.
+	mutable std::unordered_map<String, iterator> index_;
+	mutable unsigned int index_id_changes_;
+	mutable std::mutex index_mutex_;
+
+	//! Returns end() if there is no node with \a id
+	iterator find_iterator(const String &id)const;
+	void index_insert(iterator iter);
+	void index_erase(iterator iter);
+
 public:
 	ValueNodeList();
 
@@ -29,6 +29,7 @@
 
 #include "general.h"
 #include "localization.h"
+#include "module.h"
 
 /* === U S I N G =========================================================== */
 
@@ -79,6 +80,7 @@ LinkableValueNode::Handle
 ValueNodeRegistry::create(const String &name, const ValueBase& x)
 {
 	// forbid creating a node if class is not registered
+	Module::require(Module::BOOK_VALUENODE, name);
 	auto iter = ValueNodeRegistry::book().find(name);
 	if(iter == ValueNodeRegistry::book().end()) {
 		error(_("Bad name: ValueNode type name '%s' isn't registered"), name.c_str());
@@ -310,8 +310,8 @@ public:
 			is_angle_type<value_type> is_angle;
 			subtractor<value_type> subtract_func;
 
-			mutable etl::hermite<Time, Time> first;
-			mutable etl::hermite<value_type, Time> second;
+			etl::hermite<Time, Time> first;
+			etl::hermite<value_type, Time> second;
 			WaypointList::iterator start;
 			WaypointList::iterator end;
 
@@ -322,19 +322,24 @@ public:
 
 				if(!start_static || !end_static)
 				{
+					// the segment may be resolved by several threads simultaneously
+					// (see SetTimeSession), so the curve is built in a local copy
+					etl::hermite<value_type, Time> curve(second);
+
 					//if(!start_static)
-						second.p1()=start->get_value(t).get(value_type());
+						curve.p1()=start->get_value(t).get(value_type());
 					if(start->get_after()==INTERPOLATION_CONSTANT || end->get_before()==INTERPOLATION_CONSTANT)
-						return second.p1();
+						return curve.p1();
 					//if(!end_static)
-						second.p2()=end->get_value(t).get(value_type());
+						curve.p2()=end->get_value(t).get(value_type());
 
 					// At the moment, the only type of non-constant interpolation
 					// that we support is linear.
-					second.t1()=
-					second.t2()=subtract_func(second.p2(),second.p1());
+					curve.t1()=
+					curve.t2()=subtract_func(curve.p2(),curve.p1());
 
-					second.sync();
+					curve.sync();
+					return demult(curve(first(t)));
 				}
 
 				return demult(second(first(t)));
@@ -42,6 +42,7 @@
 #include <synfig/canvas.h>
 #include <synfig/general.h>
 #include <synfig/localization.h>
+#include <synfig/settimesession.h>
 #include <synfig/valuenode_registry.h>
 #include <synfig/blinepoint.h>
 
@@ -120,6 +121,14 @@ ValueNode_BoneInfluence::operator()(Time t)const
 	if (getenv("SYNFIG_DEBUG_VALUENODE_OPERATORS"))
 		printf("%s:%d operator()\n", __FILE__, __LINE__);
 
+	// transform_ is rebuilt while calculation, so threads of set_time() must not share it
+	return SetTimeSession::evaluate_stateful(*this, t,
+		sigc::mem_fun(*this, &ValueNode_BoneInfluence::calculate) );
+}
+
+ValueBase
+ValueNode_BoneInfluence::calculate(Time t)const
+{
 	Matrix transform(get_transform(true, t));
 	Type &type(link_->get_type());
 	if (type == type_vector)
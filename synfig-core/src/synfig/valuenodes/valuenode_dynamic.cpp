@@ -36,6 +36,7 @@
 #include "valuenode_const.h"
 #include <synfig/general.h>
 #include <synfig/localization.h>
+#include <synfig/settimesession.h>
 #include <synfig/valuenode_registry.h>
 #include <synfig/vector.h>
 
@@ -123,6 +124,15 @@ ValueNode_Dynamic::operator()(Time t)const
 {
 	if (getenv("SYNFIG_DEBUG_VALUENODE_OPERATORS"))
 		printf("%s:%d operator()\n", __FILE__, __LINE__);
+	// state is a simulation, so it must be advanced once for each time
+	// even if set_time() reaches this node from several threads
+	return SetTimeSession::evaluate_stateful(*this, t,
+		sigc::mem_fun(*this, &ValueNode_Dynamic::calculate) );
+}
+
+ValueBase
+ValueNode_Dynamic::calculate(Time t)const
+{
 	double t0=last_time;
 	double t1=t;
 	double step;
@@ -87,6 +87,9 @@ private:
 	mutable std::vector<double> state;
 	void reset_state(Time t)const;
 
+	//! Integrates the state from last_time, see operator()()
+	ValueBase calculate(Time t)const;
+
 public:
 	typedef etl::handle<ValueNode_Dynamic> Handle;
 	typedef etl::handle<const ValueNode_Dynamic> ConstHandle;
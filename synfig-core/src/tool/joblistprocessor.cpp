@@ -42,15 +42,20 @@
 #include <autorevision.h>
 #include <synfig/general.h>
 #include <synfig/localization.h>
+#include <synfig/module.h>
 #include <synfig/target.h>
 #include <synfig/target_scanline.h>
 #include <synfig/savecanvas.h>
+#include <synfig/settimesession.h>
 #include <synfig/filesystemnative.h>
 
 #include "definitions.h"
 #include "synfigtoolexception.h"
 #include "renderprogress.h"
 #include "joblistprocessor.h"
+#include "optionsprocessor.h"
+#include "renderfarm.h"
+#include "printing_functions.h"
 
 #include <giomm/file.h>
 #include <glib/gstdio.h>
@@ -71,11 +76,76 @@ void process_job_list(std::list<Job>& job_list, const TargetParam& target_params
 
 	for(; !job_list.empty(); job_list.pop_front())
 	{
-		if (setup_job(job_list.front(), target_params))
-			process_job(job_list.front());
+		if (!setup_job(job_list.front(), target_params))
+			throw (SynfigToolException(SYNFIGTOOL_INVALIDJOB, _("Unable to set up the job")));
+		process_job(job_list.front());
 	}
 }
 
+static std::string _appendAlphaToFilename(std::string input_filename)
+{
+
+	std::size_t found = input_filename.rfind('.');
+	if (found == std::string::npos) return input_filename + "-alpha"; // extension not found, just add to the end
+	
+	return input_filename.substr(0, found) + "-alpha" + input_filename.substr(found);
+
+    /*bfs::path filename(input_filename);
+    bfs::path alpha_filename(filename.stem().string() + "-alpha" +
+        filename.extension().string());
+    return bfs::path(filename.parent_path() / alpha_filename).string();*/
+}
+
+namespace {
+	/// Restores the render settings of the canvas,
+	/// so the loaded canvas may be reused by the next job (see RenderDaemon)
+	class RendDescGuard
+	{
+		Canvas::Handle canvas;
+		RendDesc desc;
+	public:
+		explicit RendDescGuard(const Canvas::Handle& canvas):
+			canvas(canvas), desc(canvas->rend_desc()) { }
+		~RendDescGuard() { canvas->rend_desc() = desc; }
+	};
+}
+
+void process_command_line_job(SynfigCommandLineParser& parser, const std::vector<std::string>& args)
+{
+	std::list<Job> job_list;
+
+	Job job;
+	job = parser.extract_job();
+	RendDescGuard rend_desc_guard(job.canvas);
+	job.desc = job.canvas->rend_desc() = parser.extract_renddesc(job.canvas->rend_desc());
+
+	RenderFarm::Params farm_params = parser.extract_render_farm_params();
+	if (farm_params.workers > 0)
+	{
+		Job farm_job = job;
+		if (setup_job(farm_job, parser.extract_targetparam()) && RenderFarm::is_supported(farm_job))
+		{
+			RenderFarm farm(args, farm_params);
+			if (!farm.run(farm_job))
+				throw (SynfigToolException(SYNFIGTOOL_RENDERFAILURE, _("Render Failure.")));
+			return;
+		}
+		synfig::warning(_("Target doesn't write separate file for each frame, rendering without workers"));
+	}
+
+	if (job.extract_alpha) {
+		job.alpha_mode = synfig::TARGET_ALPHA_MODE_REDUCE;
+		job_list.push_front(job);
+		job.alpha_mode = synfig::TARGET_ALPHA_MODE_EXTRACT;
+		job.outfilename = _appendAlphaToFilename(job.outfilename);
+		job_list.push_front(job);
+	} else {
+		job_list.push_front(job);
+	}
+
+	process_job_list(job_list, parser.extract_targetparam());
+}
+
 std::string get_extension(const std::string &filename)
 {
 	std::size_t found = filename.rfind('.');
@@ -112,6 +182,7 @@ bool setup_job(Job& job, const TargetParam& target_parameters)
 		if (ext.length())
 			ext = ext.substr(1);
 
+		Module::require(Module::BOOK_TARGET_EXT, ext);
 		if(Target::ext_book().count(ext))
 		{
 			job.target_name = Target::ext_book()[ext];
@@ -122,6 +193,7 @@ bool setup_job(Job& job, const TargetParam& target_parameters)
 			std::string lower_ext;
 			std::transform(ext.begin(), ext.end(), std::back_inserter(lower_ext), ::tolower);
 
+			Module::require(Module::BOOK_TARGET_EXT, lower_ext);
 			if(Target::ext_book().count(lower_ext))
 			{
 				job.target_name=Target::ext_book()[lower_ext];
@@ -146,6 +218,7 @@ bool setup_job(Job& job, const TargetParam& target_parameters)
 	if(job.outfilename.empty())
 	{
         std::string new_extension;
+		Module::require(Module::BOOK_TARGET, job.target_name);
 		if(Target::book().count(job.target_name))
 			new_extension = Target::book()[job.target_name].filename;
 		else
@@ -266,6 +339,8 @@ void process_job (Job& job)
 		VERBOSE_OUT(1) << _("Rendering...") << std::endl;
 		std::chrono::system_clock::time_point start_timepoint =
             std::chrono::system_clock::now();
+		SetTimeSession::set_timing(SynfigToolGeneralOptions::instance()->should_print_benchmarks());
+		SetTimeSession::reset_canvas_times();
 
 		// Call the render member of the target
 		if(!job.target->render(&p))
@@ -280,6 +355,7 @@ void process_job (Job& job)
                       << _(": Rendered in ")
                       << duration.count()
                       << _(" seconds.") << std::endl;
+            print_set_time_times();
         }
 	}
 
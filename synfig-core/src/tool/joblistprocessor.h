@@ -29,9 +29,13 @@
 #define __SYNFIG_JOBLISTPROCESSOR_H
 
 #include <list>
+#include <string>
+#include <vector>
 #include <synfig/targetparam.h>
 #include "job.h"
 
+class SynfigCommandLineParser;
+
 /// Process a Job list setting up and processing each job
 void process_job_list(std::list<Job>& job_list,
 						const synfig::TargetParam& target_parameters);
@@ -43,6 +47,12 @@ bool setup_job(Job& job, const synfig::TargetParam& target_parameters);
 /// Process an individual job
 void process_job(Job& job);
 
+/// Extract the job from the parsed command line and process it
+/// (by worker processes if requested)
+/// \param args command line without the program name, passed to the workers
+void process_command_line_job(SynfigCommandLineParser& parser,
+						const std::vector<std::string>& args);
+
 std::string get_absolute_path(std::string relative_path);
 
 #endif // __SYNFIG_JOBLISTPROCESSOR_H
@@ -37,6 +37,7 @@
 #include <iostream>
 #include <string>
 #include <list>
+#include <vector>
 
 
 #include <glibmm.h>
@@ -49,6 +50,7 @@
 #include <synfig/target.h>
 #include <synfig/paramdesc.h>
 #include <synfig/main.h>
+#include <synfig/settimesession.h>
 #include <autorevision.h>
 #include "definitions.h"
 #include "progress.h"
@@ -57,24 +59,11 @@
 #include "optionsprocessor.h"
 #include "joblistprocessor.h"
 #include "printing_functions.h"
+#include "renderdaemon.h"
 
 #endif
 
 
-std::string _appendAlphaToFilename(std::string input_filename)
-{
-
-	std::size_t found = input_filename.rfind('.');
-	if (found == std::string::npos) return input_filename + "-alpha"; // extension not found, just add to the end
-	
-	return input_filename.substr(0, found) + "-alpha" + input_filename.substr(found);
-
-    /*bfs::path filename(input_filename);
-    bfs::path alpha_filename(filename.stem().string() + "-alpha" +
-        filename.extension().string());
-    return bfs::path(filename.parent_path() / alpha_filename).string();*/
-}
-
 int main(int argc, char* argv[])
 {
 	setlocale(LC_ALL, "");
@@ -252,6 +241,10 @@ int main(int argc, char* argv[])
         }*/
 
         //OptionsProcessor op(vm, po_visible);
+		// parser removes known options from argv,
+		// so keep the command line for the worker processes
+		std::vector<std::string> args(argv + 1, argv + argc);
+
 		SynfigCommandLineParser parser;
 		parser.parse(argc, argv);
 
@@ -268,30 +261,29 @@ int main(int argc, char* argv[])
 
 		// Synfig Main initialization needs to be after verbose and
 		// before any other where it's used
+		synfig::Module::set_lazy_loading(!parser.should_load_all_modules());
 		Progress p(binary_path.c_str());
 		synfig::Main synfig_main(root_path, &p);
 
+		// the tool doesn't connect handlers to signals of layers,
+		// so independent groups may be processed by several threads
+		synfig::SetTimeSession::set_parallel(true);
+
 		// Info options -----------------------------------------------
 		parser.process_info_options();
 
-		std::list<Job> job_list;
+		// Daemon mode -----------------------------------------------
+		if (parser.is_daemon())
+		{
+			RenderDaemon daemon;
+			return daemon.run(std::cin, std::cout);
+		}
 
 		// Processing --------------------------------------------------
-		Job job;
-		job = parser.extract_job();
-		job.desc = job.canvas->rend_desc() = parser.extract_renddesc(job.canvas->rend_desc());
-
-		if (job.extract_alpha) {
-			job.alpha_mode = synfig::TARGET_ALPHA_MODE_REDUCE;
-			job_list.push_front(job);
-			job.alpha_mode = synfig::TARGET_ALPHA_MODE_EXTRACT;
-			job.outfilename = _appendAlphaToFilename(job.outfilename);
-			job_list.push_front(job);
-		} else {
-			job_list.push_front(job);
-		}
+		process_command_line_job(parser, args);
 
-		process_job_list(job_list, parser.extract_targetparam());
+		if (SynfigToolGeneralOptions::instance()->should_print_benchmarks())
+			print_startup_times(synfig_main);
 
 		return SYNFIGTOOL_OK;
 
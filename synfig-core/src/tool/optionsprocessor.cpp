@@ -107,17 +107,26 @@ SynfigCommandLineParser::SynfigCommandLineParser() :
 	set_dpi(),
 	set_dpi_x(),
 	set_dpi_y(),
+	set_workers(),
+	set_chunk_size(),
+	set_retries(-1),
+	set_tile_size(),
+	set_compression(),
 
 	// Switch group
 	sw_verbosity(),
 	sw_quiet(),
 	sw_print_benchmarks(),
 	sw_extract_alpha(),
+	sw_ordered_dithering(),
+	sw_float_channels(),
 
 	// Misc group
 	misc_append_filename(),
 	misc_canvas_info(),
 	misc_canvases(),
+	misc_daemon(),
+	misc_load_all_modules(),
 
 	//FFMPEG group
 	video_codec(),
@@ -165,6 +174,11 @@ SynfigCommandLineParser::SynfigCommandLineParser() :
 	add_option(og_set, "dpi",         ' ', set_dpi, 		_("Set the physical resolution (Dots-per-inch)"), "NUM");
 	add_option(og_set, "dpi-x",       ' ', set_dpi_x, 		_("Set the physical X resolution (Dots-per-inch)"), "NUM");
 	add_option(og_set, "dpi-y",       ' ', set_dpi_y, 		_("Set the physical Y resolution (Dots-per-inch)"), "NUM");
+	add_option(og_set, "workers",     ' ', set_workers, 	_("Split the frame range into chunks rendered by the specified number of worker processes"), "NUM");
+	add_option(og_set, "chunk-size",  ' ', set_chunk_size, 	_("Set the count of frames rendered by each worker process at once"), "NUM");
+	add_option(og_set, "retries",     ' ', set_retries, 	_("Set how many times the chunk will be restarted when worker fails (Default: 2)"), "NUM");
+	add_option(og_set, "tile-size",   ' ', set_tile_size, 	_("Write tiled files with the specified tile size when target supports it (OpenEXR)"), "NUM");
+	add_option(og_set, "compression", ' ', set_compression, _("Set the compression method when target supports it (OpenEXR: none, rle, zips, zip, piz, pxr24, b44, b44a, dwaa, dwab)"), "method");
 
 	// Switch options
 	//og_switch("switch", _("Switch options"), "Show switch help");
@@ -172,11 +186,15 @@ SynfigCommandLineParser::SynfigCommandLineParser() :
 	add_option(og_switch, "quiet",         'q', sw_quiet, 				_("Quiet mode (No progress/time-remaining display)"), "");
 	add_option(og_switch, "benchmarks",    'b', sw_print_benchmarks,	_("Print benchmarks"), "");
 	add_option(og_switch, "extract-alpha", 'x', sw_extract_alpha, 		_("Extract alpha"), "");
+	add_option(og_switch, "ordered-dithering", ' ', sw_ordered_dithering,	_("Use ordered dithering for GIF animations, it keeps unchanged areas stable between frames"), "");
+	add_option(og_switch, "float-channels", ' ', sw_float_channels,	_("Write 32-bit float channels instead of 16-bit half ones (OpenEXR)"), "");
 
 	//SynfigOptionGroup og_misc("misc", _("Misc options"), "Show Misc options help");
 	add_option_filename(og_misc, "append", ' ', misc_append_filename, 	_("Append layers in <filename> to composition"), _("filename"));
 	add_option(og_misc, "canvas-info",     ' ', misc_canvas_info, 			_("Print out specified details of the root canvas"), _("fields"));
 	add_option(og_misc, "canvases",		   ' ', misc_canvases,				_("Print out the list of exported canvases in the composition"), "");
+	add_option(og_misc, "daemon",		   ' ', misc_daemon,				_("Read render jobs from standard input, one command line per line, and keep loaded files between jobs"), "");
+	add_option(og_misc, "load-all-modules",' ', misc_load_all_modules,		_("Load all modules at startup instead of loading them on demand"), "");
 
 	//SynfigOptionGroup og_ffmpeg("ffmpeg", _("FFMPEG target options"), "Show FFMPEG target options help");
 	add_option(og_ffmpeg, "video-codec",   ' ', video_codec, 	_("Set the codec for the video. See --target-video-codecs"), _("codec"));
@@ -264,6 +282,20 @@ bool SynfigCommandLineParser::parse(int argc, char* argv[])
 	return true;
 }
 
+Canvas::Handle SynfigCommandLineParser::open_canvas_file(const std::string& filename, std::string& errors, std::string& warnings)
+{
+	if (FileSystem::Handle file_system = CanvasFileNaming::make_filesystem(filename))
+	{
+		FileSystem::Identifier identifier = file_system->get_identifier(CanvasFileNaming::project_file(filename));
+		Canvas::Handle canvas = open_canvas_as(identifier, filename, errors, warnings);
+		if (SynfigToolGeneralOptions::instance()->should_print_benchmarks())
+			print_canvas_load_times();
+		return canvas;
+	}
+	errors.append("Cannot open container " + filename + "\n");
+	return Canvas::Handle();
+}
+
 void SynfigCommandLineParser::extract_canvas_info(Job& job)
 {
 	job.canvas_info = true;
@@ -421,6 +453,10 @@ void SynfigCommandLineParser::process_trivial_info_options()
 
 void SynfigCommandLineParser::process_info_options()
 {
+	// lists below should contain entries of all modules
+	if (show_layers_list || show_modules || show_targets || show_value_nodes || show_importers)
+		synfig::Module::require_all();
+
 	if (show_layers_list) {
 		for(const auto& iter : synfig::Layer::book()) {
 			if (iter.second.category != CATEGORY_DO_NOT_USE)
@@ -632,6 +668,44 @@ TargetParam SynfigCommandLineParser::extract_targetparam()
 					   << std::endl;
 	}
 
+	if (sw_ordered_dithering)
+	{
+		params.ordered_dithering = true;
+		VERBOSE_OUT(1) << _("Ordered dithering enabled.") << std::endl;
+	}
+	if (sw_float_channels)
+	{
+		params.float_channels = true;
+		VERBOSE_OUT(1) << _("Float channels enabled.") << std::endl;
+	}
+	if (set_tile_size > 0)
+	{
+		params.tile_size = set_tile_size;
+		VERBOSE_OUT(1) << _("Tile size set to ") << params.tile_size << std::endl;
+	}
+	if (!set_compression.empty())
+	{
+		params.compression = set_compression;
+		VERBOSE_OUT(1) << _("Compression set to: ") << params.compression << std::endl;
+	}
+
+	return params;
+}
+
+RenderFarm::Params SynfigCommandLineParser::extract_render_farm_params() const
+{
+	RenderFarm::Params params;
+	if (set_workers > 0)
+	{
+		params.workers = set_workers;
+		VERBOSE_OUT(1) << _("Worker processes set to ") << params.workers << std::endl;
+	}
+	if (set_chunk_size > 0)
+		params.chunk_frames = set_chunk_size;
+	if (set_retries >= 0)
+		params.retries = set_retries;
+	if (set_num_threads > 0)
+		params.worker_threads = set_num_threads;
 	return params;
 }
 
@@ -644,19 +718,15 @@ Job SynfigCommandLineParser::extract_job()
 	{
 		job.filename = set_input_file;
 
-		// Open the composition
+		// Open the composition,
+		// appended layers will change it, so don't reuse it in this case
 		std::string errors, warnings;
 		try
 		{
-			if (FileSystem::Handle file_system = CanvasFileNaming::make_filesystem(job.filename))
-			{
-				FileSystem::Identifier identifier = file_system->get_identifier(CanvasFileNaming::project_file(job.filename));
-				job.root = open_canvas_as(identifier, job.filename, errors, warnings);
-			}
+			if (canvas_loader && misc_append_filename.empty())
+				job.root = canvas_loader(job.filename, errors, warnings);
 			else
-			{
-				errors.append("Cannot open container " + job.filename + "\n");
-			}
+				job.root = open_canvas_file(job.filename, errors, warnings);
 		}
 		catch(std::runtime_error& /*x*/)
 		{
@@ -744,16 +814,7 @@ Job SynfigCommandLineParser::extract_job()
 		std::string composite_file = misc_append_filename;
 
 		std::string errors, warnings;
-		Canvas::Handle composite;
-		if (FileSystem::Handle file_system = CanvasFileNaming::make_filesystem(composite_file))
-		{
-			FileSystem::Identifier identifier = file_system->get_identifier(CanvasFileNaming::project_file(composite_file));
-			composite = open_canvas_as(identifier, composite_file, errors, warnings);
-		}
-		else
-		{
-			errors.append("Cannot open container " + composite_file + "\n");
-		}
+		Canvas::Handle composite = open_canvas_file(composite_file, errors, warnings);
 
 		if(!composite)
 		{
@@ -28,10 +28,14 @@
 #ifndef __SYNFIG_OPTIONSPROCESSOR_H
 #define __SYNFIG_OPTIONSPROCESSOR_H
 
+#include <functional>
 #include <string>
 #include <vector>
+#include <synfig/canvas.h>
 #include <synfig/renddesc.h>
 
+#include "renderfarm.h"
+
 #include <glibmm/optioncontext.h>
 #include <glibmm/optiongroup.h>
 
@@ -39,9 +43,25 @@
 class SynfigCommandLineParser
 {
 public:
+	/// Function which opens the composition file
+	typedef std::function<synfig::Canvas::Handle(const std::string& filename, std::string& errors, std::string& warnings)> CanvasLoader;
+
 	SynfigCommandLineParser();
 	bool parse(int argc, char* argv[]);
 
+	/// Open the composition file (including containers)
+	static synfig::Canvas::Handle open_canvas_file(const std::string& filename, std::string& errors, std::string& warnings);
+
+	/// Use the given function instead of open_canvas_file() to open the input file,
+	/// allows to reuse already loaded compositions
+	void set_canvas_loader(const CanvasLoader& loader) { canvas_loader = loader; }
+
+	/// Whether the render daemon mode was requested
+	bool is_daemon() const { return misc_daemon; }
+
+	/// Whether modules should be loaded at startup instead of loading on demand
+	bool should_load_all_modules() const { return misc_load_all_modules; }
+
 	/// Settings options
 	/// verbose, quiet, threads, benchmarks
 	void process_settings_options() const;
@@ -67,6 +87,10 @@ public:
 	/// video-codec, bitrate, sequence-separator
 	synfig::TargetParam extract_targetparam();
 
+	/// Extract the options of rendering by several worker processes
+	/// workers, chunk-size, retries
+	RenderFarm::Params extract_render_farm_params() const;
+
 	/// Determine which parameters to show in the canvas info
 	/// canvas-info
 	void extract_canvas_info(Job& job);
@@ -116,17 +140,26 @@ private:
 	double			set_dpi;
 	double			set_dpi_x;
 	double			set_dpi_y;
+	int				set_workers;
+	int				set_chunk_size;
+	int				set_retries;
+	int				set_tile_size;
+	Glib::ustring	set_compression;
 
 	// Switch group
 	int				sw_verbosity;
 	bool			sw_quiet;
 	bool			sw_print_benchmarks;
 	bool			sw_extract_alpha;
+	bool			sw_ordered_dithering;
+	bool			sw_float_channels;
 
 	// Misc group
 	std::string		misc_append_filename;
 	Glib::ustring	misc_canvas_info;
 	bool			misc_canvases;
+	bool			misc_daemon;
+	bool			misc_load_all_modules;
 
 	//FFMPEG group
 	Glib::ustring	video_codec;
@@ -153,6 +186,8 @@ private:
 	
 	Glib::OptionGroup::vecustrings remaining_options_list;
 
+	CanvasLoader canvas_loader;
+
 	struct VideoCodec
 	{
 		VideoCodec(const std::string& name_, const std::string& description_)
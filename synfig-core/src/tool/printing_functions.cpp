@@ -35,6 +35,10 @@
 #include <iostream>
 #include <string>
 #include <synfig/canvas.h>
+#include <synfig/loadcanvas.h>
+#include <synfig/main.h>
+#include <synfig/module.h>
+#include <synfig/settimesession.h>
 #include <synfig/target.h>
 #include "definitions.h"
 #include "job.h"
@@ -260,3 +264,44 @@ void print_canvas_info(const Job& job)
 			std::cout << (*key).c_str() << "=" << canvas->get_meta_data(*key).c_str()<< std::endl;
 	}
 }
+
+void print_startup_times(const synfig::Main& main)
+{
+	typedef std::list< std::pair<std::string, double> > Times;
+
+	double total = 0.0;
+	const Times &stages = main.get_startup_times();
+	for (Times::const_iterator i = stages.begin(); i != stages.end(); ++i)
+	{
+		std::cout << _("Startup: ") << i->first << ": " << i->second << _(" seconds.") << std::endl;
+		total += i->second;
+	}
+	std::cout << _("Startup: total: ") << total << _(" seconds.") << std::endl;
+
+	// modules loaded on demand are included too
+	const Times modules = synfig::Module::get_load_times();
+	for (Times::const_iterator i = modules.begin(); i != modules.end(); ++i)
+		std::cout << _("Module ") << i->first << _(": Loaded in ") << i->second << _(" seconds.") << std::endl;
+}
+
+void print_canvas_load_times()
+{
+	const std::list<synfig::CanvasLoadTime> times = synfig::get_canvas_load_times();
+	for (std::list<synfig::CanvasLoadTime>::const_iterator i = times.begin(); i != times.end(); ++i)
+	{
+		std::cout << i->filename << _(": Loaded in ") << i->read + i->build + i->import << _(" seconds")
+				  << " (" << _("read") << " " << i->read
+				  << ", " << _("build") << " " << i->build
+				  << ", " << _("import") << " " << i->import << ")" << std::endl;
+	}
+}
+
+void print_set_time_times()
+{
+	const std::vector<synfig::CanvasSetTime> times = synfig::SetTimeSession::get_canvas_times();
+	for (std::vector<synfig::CanvasSetTime>::const_iterator i = times.begin(); i != times.end(); ++i)
+	{
+		std::cout << _("Set time: ") << i->name << ": " << i->seconds << _(" seconds")
+				  << " (" << i->calls << " " << _("calls") << ")" << std::endl;
+	}
+}
@@ -28,6 +28,8 @@
 #ifndef __SYNFIG_PRINTING_FUNCTIONS_H
 #define __SYNFIG_PRINTING_FUNCTIONS_H
 
+namespace synfig { class Main; }
+
 void print_usage();
 
 /// Print canvases' children IDs in cascade
@@ -36,4 +38,14 @@ void print_child_canvases(const std::string& prefix,
 
 void print_canvas_info(const Job& job);
 
+/// Print time spent on initialization of subsystems and on loading of modules
+void print_startup_times(const synfig::Main& main);
+
+/// Print time spent on loading of each file of the last opened composition
+void print_canvas_load_times();
+
+/// Print time spent on setting of time for each canvas during the last render,
+/// nested canvases are included into times of their parents
+void print_set_time_times();
+
 #endif // __SYNFIG_PRINTING_FUNCTIONS_H
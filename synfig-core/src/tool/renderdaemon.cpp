@@ -0,0 +1,198 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file tool/renderdaemon.cpp
+**	\brief Synfig Tool Render Daemon Class
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+#ifdef USING_PCH
+#	include "pch.h"
+#else
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <glibmm/shell.h>
+#include <glib/gstdio.h>
+
+#include <synfig/general.h>
+#include <synfig/localization.h>
+
+#include "definitions.h"
+#include "job.h"
+#include "synfigtoolexception.h"
+#include "optionsprocessor.h"
+#include "joblistprocessor.h"
+#include "renderdaemon.h"
+
+#endif
+
+using namespace synfig;
+
+namespace {
+	/// Keep each reply on a single line
+	std::string single_line(std::string message)
+	{
+		std::replace(message.begin(), message.end(), '\n', ' ');
+		std::replace(message.begin(), message.end(), '\r', ' ');
+		return message;
+	}
+}
+
+const std::size_t RenderDaemon::max_cached_canvases;
+
+RenderDaemon::RenderDaemon():
+	use_count(),
+	last_cached()
+{ }
+
+void RenderDaemon::drop_least_recently_used()
+{
+	std::map<std::string, CachedCanvas>::iterator oldest = canvases.begin();
+	for (std::map<std::string, CachedCanvas>::iterator i = canvases.begin(); i != canvases.end(); ++i)
+		if (i->second.last_use < oldest->second.last_use)
+			oldest = i;
+	if (oldest != canvases.end())
+		canvases.erase(oldest);
+}
+
+Canvas::Handle RenderDaemon::load_canvas(const std::string& filename, std::string& errors, std::string& warnings)
+{
+	const std::string path = get_absolute_path(filename);
+
+	GStatBuf info;
+	const bool has_info = g_stat(path.c_str(), &info) == 0;
+
+	std::map<std::string, CachedCanvas>::iterator i = canvases.find(path);
+	if ( i != canvases.end()
+	  && has_info
+	  && i->second.mtime == info.st_mtime
+	  && i->second.size == (long long)info.st_size )
+	{
+		last_cached = true;
+		i->second.last_use = ++use_count;
+		return i->second.root;
+	}
+
+	last_cached = false;
+	Canvas::Handle root = SynfigCommandLineParser::open_canvas_file(filename, errors, warnings);
+	if (root && has_info)
+	{
+		if (!canvases.count(path) && canvases.size() >= max_cached_canvases)
+			drop_least_recently_used();
+		CachedCanvas &cached = canvases[path];
+		cached.root = root;
+		cached.mtime = info.st_mtime;
+		cached.size = (long long)info.st_size;
+		cached.last_use = ++use_count;
+	}
+	else
+	{
+		canvases.erase(path);
+	}
+	return root;
+}
+
+void RenderDaemon::process_line(const std::string& line, int index, std::ostream& out)
+{
+	std::chrono::steady_clock::time_point start_timepoint =
+		std::chrono::steady_clock::now();
+
+	std::vector<std::string> args;
+	try
+	{
+		args = Glib::shell_parse_argv(line);
+	}
+	catch (const Glib::ShellError& e)
+	{
+		out << "ERROR " << index << " " << SYNFIGTOOL_UNKNOWNARGUMENT
+			<< " " << single_line(e.what().c_str()) << std::endl;
+		return;
+	}
+
+	// parser needs modifiable argv
+	std::vector<std::string> storage(args);
+	storage.insert(storage.begin(), "synfig");
+	std::vector<char*> argv;
+	for (std::string& arg : storage)
+		argv.push_back(&arg[0]);
+	argv.push_back(nullptr);
+
+	last_cached = false;
+	try
+	{
+		SynfigCommandLineParser parser;
+		if (!parser.parse((int)storage.size(), argv.data()))
+			throw (SynfigToolException(SYNFIGTOOL_UNKNOWNARGUMENT, _("Unable to parse the command line")));
+		parser.process_settings_options();
+		parser.set_canvas_loader(
+			[this](const std::string& filename, std::string& errors, std::string& warnings)
+				{ return load_canvas(filename, errors, warnings); } );
+
+		process_command_line_job(parser, args);
+	}
+	catch (SynfigToolException& e)
+	{
+		if (e.get_exit_code() != SYNFIGTOOL_OK)
+		{
+			out << "ERROR " << index << " " << e.get_exit_code()
+				<< " " << single_line(e.get_message()) << std::endl;
+			return;
+		}
+	}
+	catch (std::exception& e)
+	{
+		out << "ERROR " << index << " " << SYNFIGTOOL_UNKNOWNERROR
+			<< " " << single_line(e.what()) << std::endl;
+		return;
+	}
+
+	std::chrono::duration<double> duration =
+		std::chrono::steady_clock::now() - start_timepoint;
+	out << "OK " << index << " " << duration.count()
+		<< " " << (last_cached ? "cached" : "loaded") << std::endl;
+}
+
+int RenderDaemon::run(std::istream& in, std::ostream& out)
+{
+	VERBOSE_OUT(1) << _("Waiting for jobs on standard input...") << std::endl;
+
+	// jobs print messages to std::cout,
+	// send them to std::cerr to keep only replies in the output
+	std::ostream replies(out.rdbuf());
+	std::streambuf *cout_buffer = std::cout.rdbuf(std::cerr.rdbuf());
+
+	int index = 0;
+	std::string line;
+	while (std::getline(in, line))
+	{
+		if (line.find_first_not_of(" \t\r") == std::string::npos)
+			continue;
+		if (line == "quit" || line == "quit\r")
+			break;
+		process_line(line, ++index, replies);
+	}
+
+	std::cout.rdbuf(cout_buffer);
+	return SYNFIGTOOL_OK;
+}
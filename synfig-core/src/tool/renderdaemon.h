@@ -0,0 +1,80 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file tool/renderdaemon.h
+**	\brief Synfig Tool Render Daemon Class
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+#ifndef __SYNFIG_RENDERDAEMON_H
+#define __SYNFIG_RENDERDAEMON_H
+
+#include <ctime>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include <synfig/canvas.h>
+
+/// Long-lived mode of the tool which processes many render jobs
+/// in the same process, so modules, loaded compositions with imported
+/// images, font caches and rendering threads are reused between jobs.
+///
+/// Each line of input is a command line of a single job (without the program name),
+/// for example: "scene.sif -o frame.png --time 12". Line "quit" stops the daemon.
+/// For each job one line is written to output:
+///   "OK <job> <seconds> <loaded|cached>" or "ERROR <job> <exit code> <message>"
+/// Composition is loaded again when its file was modified.
+/// Only the file of the composition itself is checked, so changes of imported
+/// files and external canvases are not noticed until that file changes too.
+/// At most max_cached_canvases compositions are kept, the least recently used
+/// one is dropped first.
+class RenderDaemon
+{
+public:
+	static const std::size_t max_cached_canvases = 16;
+
+private:
+	struct CachedCanvas
+	{
+		synfig::Canvas::Handle root;
+		std::time_t mtime;
+		long long size;
+		unsigned long long last_use;
+
+		CachedCanvas(): mtime(), size(), last_use() { }
+	};
+
+	std::map<std::string, CachedCanvas> canvases;
+	unsigned long long use_count;
+	bool last_cached;
+
+	void drop_least_recently_used();
+
+	synfig::Canvas::Handle load_canvas(const std::string& filename, std::string& errors, std::string& warnings);
+	void process_line(const std::string& line, int index, std::ostream& out);
+
+public:
+	RenderDaemon();
+
+	/// Processes jobs until the end of input
+	/// \return exit code of the tool
+	int run(std::istream& in, std::ostream& out);
+};
+
+#endif // __SYNFIG_RENDERDAEMON_H
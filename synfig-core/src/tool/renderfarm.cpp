@@ -0,0 +1,223 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file tool/renderfarm.cpp
+**	\brief Synfig Tool Render Farm Class
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+#ifdef USING_PCH
+#	include "pch.h"
+#else
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+#include <glibmm/spawn.h>
+
+#include <synfig/general.h>
+#include <synfig/localization.h>
+
+#include "definitions.h"
+#include "renderfarm.h"
+
+#endif
+
+using namespace synfig;
+
+namespace {
+	/// Targets which write a separate numbered file for each frame
+	const char *sequence_targets[] = {
+		"png", "jpeg", "bmp", "ppm", "openexr", "imagemagick", "null", "null-tile"
+	};
+
+	/// Count of chunks per worker when chunk size is not specified,
+	/// a few chunks per worker keeps all workers busy till the end
+	const int chunks_per_worker = 4;
+}
+
+RenderFarm::RenderFarm(const std::vector<std::string>& args, const Params& params):
+	args(args),
+	params(params),
+	ready_chunks(),
+	failed()
+{ }
+
+bool RenderFarm::is_supported(const Job& job)
+{
+	if (job.sifout || job.outfilename.empty() || job.outfilename == "-")
+		return false;
+	if (job.desc.get_frame_end() - job.desc.get_frame_start() < 1)
+		return false;
+	for (const char *name : sequence_targets)
+		if (job.target_name == name)
+			return true;
+	return false;
+}
+
+std::vector<RenderFarm::Chunk> RenderFarm::split(int frame_begin, int frame_end, int chunk_frames)
+{
+	std::vector<Chunk> chunks;
+	chunk_frames = std::max(2, chunk_frames);
+	for (int frame = frame_begin; frame <= frame_end; frame += chunk_frames)
+		chunks.push_back(Chunk(frame, std::min(frame + chunk_frames - 1, frame_end)));
+
+	// don't leave a single frame in the last chunk
+	if (chunks.size() > 1 && chunks.back().frame_begin == chunks.back().frame_end)
+	{
+		chunks[chunks.size() - 2].frame_end = chunks.back().frame_end;
+		chunks.pop_back();
+	}
+	return chunks;
+}
+
+std::vector<std::string> RenderFarm::get_worker_args(const Chunk& chunk) const
+{
+	std::vector<std::string> worker_args;
+	worker_args.push_back(SynfigToolGeneralOptions::instance()->get_binary_path());
+	worker_args.insert(worker_args.end(), args.begin(), args.end());
+
+	// the last occurrence of option overrides the previous ones,
+	// and '--begin-time' overrides '--start-time'
+	worker_args.push_back("--begin-time");
+	worker_args.push_back(strprintf("%df", chunk.frame_begin));
+	worker_args.push_back("--end-time");
+	worker_args.push_back(strprintf("%df", chunk.frame_end));
+	worker_args.push_back("--workers");
+	worker_args.push_back("0");
+	worker_args.push_back("--quiet");
+
+	int threads = params.worker_threads;
+	if (threads <= 0)
+		threads = std::max(1, (int)std::thread::hardware_concurrency()/std::max(1, params.workers));
+	worker_args.push_back("--threads");
+	worker_args.push_back(strprintf("%d", threads));
+	return worker_args;
+}
+
+bool RenderFarm::render_chunk(const Chunk& chunk, std::string& errors) const
+{
+	int exit_status = -1;
+	try
+	{
+		Glib::spawn_sync(
+			std::string(),
+			get_worker_args(chunk),
+			Glib::SPAWN_STDOUT_TO_DEV_NULL,
+			Glib::SlotSpawnChildSetup(),
+			nullptr,
+			&errors,
+			&exit_status );
+	}
+	catch (const Glib::SpawnError& e)
+	{
+		errors = e.what().c_str();
+		return false;
+	}
+	return exit_status == 0;
+}
+
+void RenderFarm::worker()
+{
+	while (true)
+	{
+		int index;
+		Chunk chunk;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (queue.empty())
+				return;
+			index = queue.front();
+			queue.pop_front();
+			chunk = chunks[index];
+			++chunks[index].attempts;
+		}
+
+		VERBOSE_OUT(2) << strprintf(_("Rendering frames %d-%d..."), chunk.frame_begin, chunk.frame_end)
+					   << std::endl;
+
+		std::string errors;
+		bool success = render_chunk(chunk, errors);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (success)
+		{
+			chunks[index].done = true;
+
+			// report frames in order
+			int first_ready = ready_chunks;
+			while (ready_chunks < (int)chunks.size() && chunks[ready_chunks].done)
+				++ready_chunks;
+			if (ready_chunks > first_ready)
+				VERBOSE_OUT(1) << strprintf(_("Frames %d-%d are ready (%d of %d chunks)"),
+					chunks.front().frame_begin,
+					chunks[ready_chunks - 1].frame_end,
+					ready_chunks, (int)chunks.size() )
+							   << std::endl;
+		}
+		else
+		if (chunks[index].attempts <= params.retries)
+		{
+			synfig::warning(_("Worker failed to render frames %d-%d, retrying: %s"),
+				chunk.frame_begin, chunk.frame_end, errors.c_str());
+			queue.push_back(index);
+		}
+		else
+		{
+			synfig::error(_("Worker failed to render frames %d-%d: %s"),
+				chunk.frame_begin, chunk.frame_end, errors.c_str());
+			// render can't be completed, so don't start other chunks
+			failed = true;
+			queue.clear();
+		}
+	}
+}
+
+bool RenderFarm::run(const Job& job)
+{
+	int frame_begin = job.desc.get_frame_start();
+	int frame_end = job.desc.get_frame_end();
+	int workers = std::max(1, params.workers);
+
+	int chunk_frames = params.chunk_frames;
+	if (chunk_frames <= 0)
+		chunk_frames = (frame_end - frame_begin + 1)/(workers*chunks_per_worker);
+
+	chunks = split(frame_begin, frame_end, chunk_frames);
+	queue.clear();
+	for (int i = 0; i < (int)chunks.size(); ++i)
+		queue.push_back(i);
+	ready_chunks = 0;
+	failed = false;
+
+	workers = std::min(workers, (int)chunks.size());
+	VERBOSE_OUT(1) << strprintf(_("Rendering frames %d-%d by %d workers in %d chunks"),
+		frame_begin, frame_end, workers, (int)chunks.size()) << std::endl;
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < workers; ++i)
+		threads.push_back(std::thread(&RenderFarm::worker, this));
+	for (std::thread& thread : threads)
+		thread.join();
+
+	return !failed;
+}
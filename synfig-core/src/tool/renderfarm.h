@@ -0,0 +1,94 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file tool/renderfarm.h
+**	\brief Synfig Tool Render Farm Class
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+#ifndef __SYNFIG_RENDERFARM_H
+#define __SYNFIG_RENDERFARM_H
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "job.h"
+
+/// Splits the frame range of a job into chunks and renders them
+/// by the worker processes of this tool running simultaneously.
+/// Each worker gets the same command line with its own frame range,
+/// so the frames of image sequence are placed into the files
+/// with the same names as in the single process render.
+class RenderFarm
+{
+public:
+	struct Params
+	{
+		int workers;        ///< count of simultaneous worker processes, 0 - disabled
+		int chunk_frames;   ///< frames per chunk, 0 - choose automatically
+		int retries;        ///< how many times the failed chunk will be restarted
+		int worker_threads; ///< threads of each worker, 0 - choose automatically
+
+		Params(): workers(), chunk_frames(), retries(2), worker_threads() { }
+	};
+
+	struct Chunk
+	{
+		int frame_begin;
+		int frame_end;      ///< inclusive
+		int attempts;
+		bool done;
+
+		Chunk(int frame_begin = 0, int frame_end = 0):
+			frame_begin(frame_begin), frame_end(frame_end), attempts(), done() { }
+	};
+
+	/// \param args command line of this process without the program name
+	RenderFarm(const std::vector<std::string>& args, const Params& params);
+
+	/// Job may be rendered by farm only if target writes
+	/// separate file for each frame and there are several frames
+	static bool is_supported(const Job& job);
+
+	/// Splits the range from frame_begin to frame_end (inclusive),
+	/// each chunk contains at least two frames, because the targets
+	/// don't add frame number to the file name of a single frame
+	static std::vector<Chunk> split(int frame_begin, int frame_end, int chunk_frames);
+
+	/// Renders all chunks, blocks until all workers are finished
+	/// \return false if some chunk was failed after all retries
+	bool run(const Job& job);
+
+private:
+	std::vector<std::string> args;
+	Params params;
+
+	std::mutex mutex;
+	std::vector<Chunk> chunks;
+	std::deque<int> queue;
+	int ready_chunks;   ///< count of leading chunks which are done
+	bool failed;
+
+	std::vector<std::string> get_worker_args(const Chunk& chunk) const;
+	bool render_chunk(const Chunk& chunk, std::string& errors) const;
+	void worker();
+};
+
+#endif // __SYNFIG_RENDERFARM_H
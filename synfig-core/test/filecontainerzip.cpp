@@ -0,0 +1,159 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file filecontainerzip.cpp
+**	\brief Test reading of zip containers by streams and from memory mapping
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#include <thread>
+#include <vector>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <synfig/filecontainerzip.h>
+#include <synfig/general.h>
+
+#include "test_base.h"
+
+using namespace synfig;
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+	const int count = 64, size = 256*1024, threads = 4;
+
+	String dir;
+
+	String get_container_filename()
+		{ return dir + G_DIR_SEPARATOR_S + "container.zip"; }
+
+	String get_entry_name(int index)
+		{ return strprintf("image%d.png", index); }
+
+	//! Each entry has its own data
+	std::vector<char> create_data(int index)
+	{
+		std::vector<char> data(size);
+		for(int i = 0; i < size; ++i)
+			data[i] = (char)(i*7 + i/251 + index);
+		return data;
+	}
+
+	void write_container()
+	{
+		FileContainerZip::Handle container(new FileContainerZip());
+		ASSERT(container->create(get_container_filename()))
+		for(int i = 0; i < count; ++i) {
+			std::vector<char> data = create_data(i);
+			FileSystem::WriteStream::Handle stream = container->get_write_stream(get_entry_name(i));
+			ASSERT(stream)
+			ASSERT(stream->write_block(&data[0], size))
+		}
+		container->close();
+	}
+
+	//! Reads every step-th entry starting from begin,
+	//! returns count of entries with wrong data
+	int count_wrong_entries(FileContainerZip::Handle container, int begin, int step)
+	{
+		std::vector<char> buffer(size);
+		int wrong = 0;
+		for(int i = begin; i < count; i += step) {
+			FileSystem::ReadStream::Handle stream = container->get_read_stream(get_entry_name(i));
+			if (!stream || !stream->read_whole_block(&buffer[0], size) || buffer != create_data(i))
+				++wrong;
+		}
+		return wrong;
+	}
+
+	void check_read(bool memory_mapping)
+	{
+		write_container();
+
+		FileContainerZip::Handle container(new FileContainerZip());
+		container->set_memory_mapping(memory_mapping);
+		bool opened = container->open(get_container_filename());
+		bool mapped = container->is_memory_mapped();
+		int wrong = count_wrong_entries(container, 0, 1);
+		container.reset();
+		g_remove(get_container_filename().c_str());
+
+		ASSERT(opened)
+		ASSERT_EQUAL(memory_mapping, mapped)
+		ASSERT_EQUAL(0, wrong)
+	}
+}
+
+void
+test_entries_are_read_by_streams()
+	{ check_read(false); }
+
+void
+test_entries_are_read_from_memory_mapping()
+	{ check_read(true); }
+
+void
+test_entries_are_read_from_memory_mapping_by_several_threads()
+{
+	write_container();
+
+	FileContainerZip::Handle container(new FileContainerZip());
+	bool opened = container->open(get_container_filename());
+	bool mapped = container->is_memory_mapped();
+
+	std::vector<int> wrong(threads);
+	std::vector<std::thread> workers;
+	for(int i = 0; i < threads; ++i)
+		workers.push_back(std::thread([&container, &wrong, i]() {
+			wrong[i] = count_wrong_entries(container, i, threads); }));
+	for(std::vector<std::thread>::iterator i = workers.begin(); i != workers.end(); ++i)
+		i->join();
+
+	container.reset();
+	g_remove(get_container_filename().c_str());
+
+	ASSERT(opened)
+	ASSERT(mapped)
+	for(int i = 0; i < threads; ++i)
+		ASSERT_EQUAL(0, wrong[i])
+}
+
+/* === E N T R Y P O I N T ================================================= */
+
+int main()
+{
+	gchar *tmp_dir = g_dir_make_tmp("synfig-filecontainerzip-XXXXXX", nullptr);
+	if (!tmp_dir)
+		return 1;
+	dir = tmp_dir;
+	g_free(tmp_dir);
+
+	TEST_SUITE_BEGIN()
+		TEST_FUNCTION(test_entries_are_read_by_streams)
+		TEST_FUNCTION(test_entries_are_read_from_memory_mapping)
+		TEST_FUNCTION(test_entries_are_read_from_memory_mapping_by_several_threads)
+	TEST_SUITE_END()
+
+	g_rmdir(dir.c_str());
+
+	return tst_exit_status;
+}
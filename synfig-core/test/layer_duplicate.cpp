@@ -0,0 +1,181 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file layer_duplicate.cpp
+**	\brief Test rendering of the Duplicate layer
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#include <iterator>
+
+#include <synfig/canvas.h>
+#include <synfig/context.h>
+#include <synfig/layers/layer_duplicate.h>
+#include <synfig/layers/layer_group.h>
+#include <synfig/layers/layer_polygon.h>
+#include <synfig/rendering/common/task/taskblend.h>
+#include <synfig/valuenodes/valuenode_const.h>
+#include <synfig/valuenodes/valuenode_scale.h>
+
+#include "test_base.h"
+#include "test_rendering.h"
+
+using namespace synfig;
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+	const int w = 128, h = 128;
+	const Rect source_rect(-2, -2, 2, 2);
+
+	//! Duplicate layer which makes copies for indices from 1 to 5
+	etl::handle<Layer_Duplicate> create_duplicate(ColorReal amount, Color::BlendMethod blend_method)
+	{
+		etl::handle<Layer_Duplicate> duplicate(new Layer_Duplicate());
+		duplicate->set_param("amount", Real(amount));
+		duplicate->set_param("blend_method", int(blend_method));
+		duplicate->get_duplicate_param()->set_link("to", ValueNode_Const::create(Real(5)));
+		return duplicate;
+	}
+
+	//! Semi-transparent triangle, its origin doesn't depend on the index
+	Layer::Handle create_static_polygon()
+	{
+		Layer::Handle layer = Layer_Polygon::create();
+		layer->set_param("color", Color(0.2, 0.4, 0.9, 0.5));
+		layer->set_param("origin", Vector(0.1, -0.3));
+		return layer;
+	}
+
+	//! Semi-transparent triangle, its origin is moved by each copy of the duplicate layer
+	Layer::Handle create_moving_polygon(const etl::handle<Layer_Duplicate> &duplicate)
+	{
+		ValueNode_Scale::Handle origin = ValueNode_Scale::create(Vector(0.3, 0.2));
+		origin->set_link("scalar", duplicate->get_duplicate_param());
+
+		Layer::Handle layer = Layer_Polygon::create();
+		layer->set_param("color", Color(0.9, 0.3, 0.1, 0.6));
+		layer->connect_dynamic_param("origin", origin.get());
+		return layer;
+	}
+
+	//! Builds the task the way of previous versions,
+	//! all layers below the duplicate layer are re-evaluated for each copy.
+	//! The duplicate layer must be the first one of the canvas.
+	rendering::Task::Handle build_full_reevaluation_task(const Canvas::Handle &canvas, const etl::handle<Layer_Duplicate> &duplicate)
+	{
+		Time time = duplicate->get_time_mark();
+		ContextParams params;
+		params.force_set_time = true;
+		Context context(std::next(canvas->begin()), params);
+
+		ValueNode_Duplicate::Handle index = duplicate->get_duplicate_param();
+		rendering::Task::Handle task;
+		index->reset_index(time);
+		do {
+			rendering::TaskBlend::Handle blend(new rendering::TaskBlend());
+			blend->amount = duplicate->get_amount();
+			blend->blend_method = duplicate->get_blend_method();
+			blend->sub_task_a() = task;
+			blend->sub_task_b() = context.build_rendering_task();
+			task = blend;
+		} while (index->step(time));
+		return task;
+	}
+
+	//! Renders the canvas and the full re-evaluation of the duplicate layer at the same time
+	void check_matches_full_reevaluation(const Canvas::Handle &canvas, const etl::handle<Layer_Duplicate> &duplicate)
+	{
+		canvas->set_time(Time(0.5));
+
+		Surface surface, expected;
+		ASSERT(render_task(canvas->get_context(ContextParams()).build_rendering_task(), source_rect, w, h, surface))
+		ASSERT(render_task(build_full_reevaluation_task(canvas, duplicate), source_rect, w, h, expected))
+
+		// copies may be blended in the other order of float operations
+		ASSERT(max_difference(surface, expected) < 1e-5)
+
+		// and something is really rendered
+		Surface empty(w, h);
+		empty.fill(Color(0, 0, 0, 0));
+		ASSERT(max_difference(surface, empty) > 0.1)
+	}
+}
+
+void
+test_duplicate_of_index_dependent_layer()
+{
+	Canvas::Handle canvas = Canvas::create();
+	etl::handle<Layer_Duplicate> duplicate = create_duplicate(1.0, Color::BLEND_COMPOSITE);
+	canvas->push_back(duplicate);
+	canvas->push_back(create_moving_polygon(duplicate));
+	canvas->push_back(create_static_polygon());
+
+	check_matches_full_reevaluation(canvas, duplicate);
+}
+
+void
+test_duplicate_of_index_dependent_layer_in_group()
+{
+	Canvas::Handle canvas = Canvas::create();
+	etl::handle<Layer_Duplicate> duplicate = create_duplicate(0.7, Color::BLEND_COMPOSITE);
+	canvas->push_back(duplicate);
+
+	Canvas::Handle sub_canvas = Canvas::create_inline(canvas);
+	sub_canvas->push_back(create_moving_polygon(duplicate));
+	sub_canvas->push_back(create_static_polygon());
+	Layer::Handle group = Layer_Group::create();
+	group->set_param("canvas", sub_canvas);
+	canvas->push_back(group);
+
+	canvas->push_back(create_static_polygon());
+
+	check_matches_full_reevaluation(canvas, duplicate);
+}
+
+void
+test_duplicate_of_index_independent_layers()
+{
+	Canvas::Handle canvas = Canvas::create();
+	etl::handle<Layer_Duplicate> duplicate = create_duplicate(1.0, Color::BLEND_ADD);
+	canvas->push_back(duplicate);
+	canvas->push_back(create_static_polygon());
+
+	check_matches_full_reevaluation(canvas, duplicate);
+}
+
+/* === E N T R Y P O I N T ================================================= */
+
+int main()
+{
+	Type::subsys_init();
+	rendering::Renderer::subsys_init();
+
+	TEST_SUITE_BEGIN()
+		TEST_FUNCTION(test_duplicate_of_index_dependent_layer)
+		TEST_FUNCTION(test_duplicate_of_index_dependent_layer_in_group)
+		TEST_FUNCTION(test_duplicate_of_index_independent_layers)
+	TEST_SUITE_END()
+
+	rendering::Renderer::subsys_stop();
+	Type::subsys_stop();
+
+	return tst_exit_status;
+}
@@ -0,0 +1,110 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file layer_motionblur.cpp
+**	\brief Test summing of the Motion Blur layer subsamples
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#include <vector>
+
+#include <synfig/layers/layer_motionblur.h>
+#include <synfig/rendering/common/task/taskblend.h>
+
+#include "test_base.h"
+#include "test_rendering.h"
+
+using namespace synfig;
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+	const int samples = 13, w = 256, h = 256;
+	const Rect source_rect(-1, -1, 1, 1);
+
+	//! Hyperbolic weights like in Layer_MotionBlur
+	std::vector<Real> create_weights()
+	{
+		std::vector<Real> weights(samples);
+		Real sum = 0;
+		for(int i = 0; i < samples; ++i)
+			sum += (weights[i] = 1.0/(samples - i));
+		for(int i = 0; i < samples; ++i)
+			weights[i] /= sum;
+		return weights;
+	}
+
+	//! Subsample of a moving semi-transparent triangle
+	rendering::Task::Handle create_subsample(int i)
+	{
+		Real dx = 0.1*i - 0.6;
+		std::vector<Vector> points;
+		points.push_back(Vector(dx - 0.3, -0.5));
+		points.push_back(Vector(dx + 0.4, -0.2));
+		points.push_back(Vector(dx - 0.1, 0.6));
+		return create_polygon_task(points, Color(0.2 + 0.05*i, 0.8 - 0.05*i, 0.5, 0.3 + 0.05*i));
+	}
+}
+
+void
+test_subsamples_sum_matches_blend_chain()
+{
+	const std::vector<Real> weights = create_weights();
+
+	// left-deep chain of the previous versions
+	rendering::Task::Handle chain;
+	for(int i = 0; i < samples; ++i) {
+		rendering::TaskBlend::Handle blend(new rendering::TaskBlend());
+		blend->amount = weights[i];
+		blend->blend_method = Color::BLEND_ADD_COMPOSITE;
+		blend->sub_task_a() = chain;
+		blend->sub_task_b() = create_subsample(i);
+		chain = blend;
+	}
+
+	std::vector<rendering::Task::Handle> subsamples;
+	for(int i = 0; i < samples; ++i)
+		subsamples.push_back(create_subsample(i));
+	rendering::Task::Handle tree = Layer_MotionBlur::build_subsamples_sum(subsamples, weights);
+
+	Surface chain_surface, tree_surface;
+	ASSERT(render_task(chain, source_rect, w, h, chain_surface))
+	ASSERT(render_task(tree, source_rect, w, h, tree_surface))
+
+	// only the order of float additions differs
+	ASSERT(max_difference(chain_surface, tree_surface) < 1e-5)
+}
+
+/* === E N T R Y P O I N T ================================================= */
+
+int main()
+{
+	Type::subsys_init();
+	rendering::Renderer::subsys_init();
+
+	TEST_SUITE_BEGIN()
+		TEST_FUNCTION(test_subsamples_sum_matches_blend_chain)
+	TEST_SUITE_END()
+
+	rendering::Renderer::subsys_stop();
+	Type::subsys_stop();
+
+	return tst_exit_status;
+}
@@ -0,0 +1,145 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file layer_set_time.cpp
+**	\brief Test setting of animated layer parameters by Layer::set_time()
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#include <synfig/canvas.h>
+#include <synfig/context.h>
+#include <synfig/layers/layer_polygon.h>
+#include <synfig/type.h>
+#include <synfig/valuenodes/valuenode_const.h>
+#include <synfig/valuenodes/valuenode_linear.h>
+
+#include "test_base.h"
+
+using namespace synfig;
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+	const int count = 50, frames = 24;
+
+	//! Polygon with constant and animated parameters
+	Layer::Handle create_layer(int index)
+	{
+		Layer::Handle layer = Layer_Polygon::create();
+		layer->connect_dynamic_param("color", ValueNode_Const::create(Color(index%7/7.f, 0.5, 0.5, 1)));
+		layer->connect_dynamic_param("origin", ValueNode_Const::create(Vector(index, 0)));
+		layer->connect_dynamic_param("invert", ValueNode_Const::create(false));
+		layer->connect_dynamic_param("amount", ValueNode_Linear::create(Real(1.0)));
+		layer->connect_dynamic_param("feather", ValueNode_Linear::create(Real(0.1)));
+		layer->connect_dynamic_param("z_depth", ValueNode_Linear::create(Real(index)));
+		return layer;
+	}
+
+	//! The way of previous versions, parameters are collected into the list
+	void set_param_list(const Layer::Handle &layer, Time time)
+	{
+		Layer::ParamList params;
+		for(Layer::DynamicParamList::const_iterator i = layer->dynamic_param_list().begin(); i != layer->dynamic_param_list().end(); ++i)
+			params[i->first] = (*i->second)(time);
+		layer->set_param_list(params);
+	}
+
+	//! Checks that all parameters of the layers are equal
+	bool same_params(const Layer::Handle &a, const Layer::Handle &b)
+	{
+		Layer::Vocab vocab = a->get_param_vocab();
+		for(Layer::Vocab::const_iterator i = vocab.begin(); i != vocab.end(); ++i)
+			if (a->get_param(i->get_name()) != b->get_param(i->get_name()))
+				return false;
+		return true;
+	}
+
+	//! Checks that the parameter is equal to the value of its node at the time
+	bool follows_node(const Layer::Handle &layer, const String &param, Time time)
+	{
+		Layer::DynamicParamList::const_iterator i = layer->dynamic_param_list().find(param);
+		return i != layer->dynamic_param_list().end()
+		    && layer->get_param(param) == (*i->second)(time);
+	}
+}
+
+void
+test_set_time_matches_param_list()
+{
+	Canvas::Handle canvas = Canvas::create();
+	Canvas::Handle expected_canvas = Canvas::create();
+	for(int i = 0; i < count; ++i) {
+		canvas->push_back(create_layer(i));
+		expected_canvas->push_back(create_layer(i));
+	}
+	IndependentContext context_end(canvas->end());
+
+	for(int f = 0; f < frames; ++f) {
+		Time time(f/24.0);
+		for(Canvas::const_iterator i = canvas->begin(), j = expected_canvas->begin(); i != canvas->end(); ++i, ++j) {
+			(*i)->set_time(context_end, time);
+			set_param_list(*j, time);
+			ASSERT(same_params(*i, *j))
+			ASSERT(follows_node(*i, "z_depth", time))
+		}
+	}
+}
+
+void
+test_set_time_follows_connected_params()
+{
+	Canvas::Handle canvas = Canvas::create();
+	Layer::Handle layer = create_layer(3);
+	canvas->push_back(layer);
+	IndependentContext context_end(canvas->end());
+
+	layer->set_time(context_end, Time(0.5));
+	ASSERT(follows_node(layer, "amount", Time(0.5)))
+
+	// parameter connected after the first set_time()
+	layer->connect_dynamic_param("origin", ValueNode_Linear::create(Vector(1, 2)));
+	layer->set_time(context_end, Time(1.5));
+	ASSERT(follows_node(layer, "origin", Time(1.5)))
+	ASSERT(follows_node(layer, "amount", Time(1.5)))
+
+	// disconnected parameter keeps its last value
+	ValueBase feather = layer->get_param("feather");
+	layer->disconnect_dynamic_param("feather");
+	layer->set_time(context_end, Time(2.5));
+	ASSERT(feather == layer->get_param("feather"))
+	ASSERT(follows_node(layer, "origin", Time(2.5)))
+	ASSERT(follows_node(layer, "z_depth", Time(2.5)))
+}
+
+/* === E N T R Y P O I N T ================================================= */
+
+int main()
+{
+	Type::subsys_init();
+
+	TEST_SUITE_BEGIN()
+		TEST_FUNCTION(test_set_time_matches_param_list)
+		TEST_FUNCTION(test_set_time_follows_connected_params)
+	TEST_SUITE_END()
+
+	Type::subsys_stop();
+
+	return tst_exit_status;
+}
@@ -0,0 +1,129 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file loadcanvas.cpp
+**	\brief Test loading of exported values and canvases
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#include <fstream>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <synfig/canvas.h>
+#include <synfig/filesystemnative.h>
+#include <synfig/general.h>
+#include <synfig/loadcanvas.h>
+#include <synfig/type.h>
+
+#include "test_base.h"
+
+using namespace synfig;
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+	const int count = 2000, canvases = 200;
+
+	String dir;
+
+	String get_filename()
+		{ return dir + G_DIR_SEPARATOR_S + "exported_values.sif"; }
+
+	//! Scales refer to values which are defined later,
+	//! so placeholders are created for them while loading
+	void write_file()
+	{
+		std::ofstream file(get_filename().c_str());
+		file << "<canvas version=\"1.2\" width=\"480\" height=\"270\" view-box=\"-4 2.25 4 -2.25\" fps=\"24\">\n<defs>\n";
+		for(int i = 0; i < count; ++i)
+			file << strprintf("<scale id=\"s%d\" type=\"real\" link=\"v%d\" scalar=\"v%d\"/>\n", i, i, count - 1 - i);
+		for(int i = 0; i < count; ++i)
+			file << strprintf("<real id=\"v%d\" value=\"%d\"/>\n", i, i);
+		for(int i = 0; i < canvases; ++i)
+			file << strprintf("<canvas id=\"c%d\"/>\n", i);
+		file << "</defs>\n</canvas>\n";
+		ASSERT(file)
+	}
+
+	Canvas::Handle load_file()
+	{
+		write_file();
+		String errors, warnings;
+		Canvas::Handle canvas = open_canvas_as(
+			FileSystemNative::instance()->get_identifier(get_filename()), get_filename(), errors, warnings );
+		g_remove(get_filename().c_str());
+		return canvas;
+	}
+}
+
+void
+test_values_defined_later_are_linked()
+{
+	Canvas::Handle canvas = load_file();
+	ASSERT(canvas)
+	ASSERT_EQUAL(0, (int)canvas->value_node_list().placeholder_count())
+
+	for(int i = 0; i < count; ++i) {
+		ValueNode::Handle node = canvas->find_value_node(strprintf("s%d", i), false);
+		ASSERT(node)
+		Real value = (*node)(Time()).get(Real());
+		ASSERT_EQUAL(Real(i*(count - 1 - i)), value)
+	}
+}
+
+void
+test_exported_canvases_are_found()
+{
+	Canvas::Handle canvas = load_file();
+	ASSERT(canvas)
+
+	String warnings;
+	for(int i = 0; i < canvases; ++i) {
+		Canvas::Handle child = canvas->find_canvas(strprintf("c%d", i), warnings);
+		ASSERT(child)
+		ASSERT_EQUAL(strprintf("c%d", i), child->get_id())
+	}
+}
+
+/* === E N T R Y P O I N T ================================================= */
+
+int main()
+{
+	gchar *tmp_dir = g_dir_make_tmp("synfig-loadcanvas-XXXXXX", nullptr);
+	if (!tmp_dir)
+		return 1;
+	dir = tmp_dir;
+	g_free(tmp_dir);
+
+	Type::subsys_init();
+
+	TEST_SUITE_BEGIN()
+		TEST_FUNCTION(test_values_defined_later_are_linked)
+		TEST_FUNCTION(test_exported_canvases_are_found)
+	TEST_SUITE_END()
+
+	Type::subsys_stop();
+
+	g_rmdir(dir.c_str());
+
+	return tst_exit_status;
+}
@@ -0,0 +1,151 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file optimizer_occlusion.cpp
+**	\brief Test culling of blend destinations hidden by opaque sources
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#include <vector>
+
+#include <synfig/rendering/common/optimizer/optimizerocclusion.h>
+#include <synfig/rendering/common/task/taskblend.h>
+#include <synfig/type.h>
+
+#include "test_base.h"
+#include "test_rendering.h"
+
+using namespace synfig;
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+	const int w = 64, h = 64;
+	const Rect source_rect(-1, -1, 1, 1);
+
+	//! Software renderer without split, with or without the occlusion culling
+	class OcclusionRenderer: public SplitRenderer {
+	public:
+		etl::handle<rendering::OptimizerOcclusion> occlusion;
+
+		explicit OcclusionRenderer(bool enabled): SplitRenderer(0) {
+			rendering::Optimizer::List list = get_optimizers(rendering::Optimizer::CATEGORY_ID_SPECIALIZED);
+			for(rendering::Optimizer::List::const_iterator i = list.begin(); i != list.end(); ++i)
+				if (etl::handle<rendering::OptimizerOcclusion>::cast_dynamic(*i))
+					unregister_optimizer(*i);
+			if (enabled) {
+				occlusion = new rendering::OptimizerOcclusion();
+				register_optimizer(occlusion);
+			}
+		}
+	};
+
+	rendering::Task::Handle create_rectangle_task(const Rect &rect, const Color &color)
+	{
+		std::vector<Vector> points;
+		points.push_back(Vector(rect.minx, rect.miny));
+		points.push_back(Vector(rect.maxx, rect.miny));
+		points.push_back(Vector(rect.maxx, rect.maxy));
+		points.push_back(Vector(rect.minx, rect.maxy));
+		return create_polygon_task(points, color);
+	}
+
+	//! Semi-transparent triangle on the opaque background,
+	//! covered by the rectangle
+	rendering::Task::Handle create_scene(const Rect &rect, const Color &color, Color::BlendMethod blend_method)
+	{
+		std::vector<Vector> points;
+		points.push_back(Vector(-0.8, -0.9));
+		points.push_back(Vector( 0.9, -0.2));
+		points.push_back(Vector(-0.3,  0.8));
+
+		rendering::TaskBlend::Handle destination(new rendering::TaskBlend());
+		destination->blend_method = Color::BLEND_COMPOSITE;
+		destination->sub_task_a() = create_rectangle_task(Rect(-2, -2, 2, 2), Color(0.1, 0.1, 0.4, 1.0));
+		destination->sub_task_b() = create_polygon_task(points, Color(0.9, 0.3, 0.1, 0.7));
+
+		rendering::TaskBlend::Handle blend(new rendering::TaskBlend());
+		blend->blend_method = blend_method;
+		blend->sub_task_a() = destination;
+		blend->sub_task_b() = create_rectangle_task(rect, color);
+		return blend;
+	}
+
+	//! Renders the scene with and without the occlusion culling,
+	//! returns the count of culled pixels
+	long long check_same_pixels(const Rect &rect, const Color &color, Color::BlendMethod blend_method)
+	{
+		etl::handle<OcclusionRenderer> plain_renderer(new OcclusionRenderer(false));
+		etl::handle<OcclusionRenderer> culling_renderer(new OcclusionRenderer(true));
+
+		Surface plain_surface, culled_surface;
+		ASSERT(render_task(create_scene(rect, color, blend_method), source_rect, w, h, plain_surface, plain_renderer))
+		ASSERT(render_task(create_scene(rect, color, blend_method), source_rect, w, h, culled_surface, culling_renderer))
+		ASSERT(max_difference(plain_surface, culled_surface) < 1e-6)
+
+		return culling_renderer->occlusion->get_culled_pixels();
+	}
+}
+
+void
+test_destination_hidden_by_opaque_source_is_culled()
+{
+	ASSERT(check_same_pixels(Rect(-1.5, -1.5, 1.5, 1.5), Color(0.2, 0.6, 0.3, 1.0), Color::BLEND_COMPOSITE) > 0)
+}
+
+void
+test_destination_partially_hidden_by_opaque_source_is_truncated()
+{
+	ASSERT(check_same_pixels(Rect(-1.5, -1.5, 0.0, 1.5), Color(0.2, 0.6, 0.3, 1.0), Color::BLEND_COMPOSITE) > 0)
+}
+
+void
+test_destination_under_transparent_source_is_kept()
+{
+	long long culled_pixels = check_same_pixels(Rect(-1.5, -1.5, 1.5, 1.5), Color(0.2, 0.6, 0.3, 0.9), Color::BLEND_COMPOSITE);
+	ASSERT_EQUAL(0, culled_pixels)
+}
+
+void
+test_destination_under_not_composite_blend_is_kept()
+{
+	long long culled_pixels = check_same_pixels(Rect(-1.5, -1.5, 1.5, 1.5), Color(0.2, 0.6, 0.3, 1.0), Color::BLEND_ADD);
+	ASSERT_EQUAL(0, culled_pixels)
+}
+
+/* === E N T R Y P O I N T ================================================= */
+
+int main()
+{
+	Type::subsys_init();
+	rendering::Renderer::subsys_init();
+
+	TEST_SUITE_BEGIN()
+		TEST_FUNCTION(test_destination_hidden_by_opaque_source_is_culled)
+		TEST_FUNCTION(test_destination_partially_hidden_by_opaque_source_is_truncated)
+		TEST_FUNCTION(test_destination_under_transparent_source_is_kept)
+		TEST_FUNCTION(test_destination_under_not_composite_blend_is_kept)
+	TEST_SUITE_END()
+
+	rendering::Renderer::subsys_stop();
+	Type::subsys_stop();
+
+	return tst_exit_status;
+}
@@ -0,0 +1,107 @@
+/* === S Y N F I G ========================================================= */
+/*! \file palette.cpp
+**  \brief Test median-cut palette and nearest color lookup
+**
+**  \legal
+**  This file is part of Synfig.
+**
+**  Synfig is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 2 of the License, or
+**  (at your option) any later version.
+**
+**  Synfig is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**  \endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#include <vector>
+
+#include <synfig/palette.h>
+#include <synfig/surface.h>
+
+#include "test_base.h"
+
+using namespace synfig;
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+	const int w = 320, h = 240;
+
+	Surface create_gradient_surface()
+	{
+		Surface surface(w, h);
+		for(int y = 0; y < h; ++y)
+			for(int x = 0; x < w; ++x)
+				surface[y][x] = Color(x/(float)w, y/(float)h, (x^y)/1024.f, (x + y)%97 ? 1 : 0);
+		return surface;
+	}
+
+	int count_lookup_mismatches(const Surface &surface, PaletteLookup &lookup, const Palette &palette)
+	{
+		int mismatches = 0;
+		for(int y = 0; y < h; ++y)
+			for(int x = 0; x < w; ++x)
+				if (lookup.find_closest(surface[y][x]) != palette.find_closest(PaletteLookup::get_cell_color(surface[y][x]), Gamma()) - palette.begin())
+					++mismatches;
+		return mismatches;
+	}
+}
+
+void
+test_palette_fits_into_gif_color_table()
+{
+	Surface surface = create_gradient_surface();
+	ASSERT((int)Palette(surface, 255, Gamma()).size() <= 255)
+	for(int max_colors = 1; max_colors <= 16; ++max_colors)
+		ASSERT((int)Palette(surface, max_colors, Gamma()).size() <= max_colors)
+}
+
+void
+test_lookup_matches_linear_search()
+{
+	// lookup searches by the center of the cell of the color,
+	// so it must give exactly the same entries as the linear search for those colors
+	Surface surface = create_gradient_surface();
+	Palette palette(surface, 255, Gamma());
+	PaletteLookup lookup(palette, Gamma());
+	ASSERT_EQUAL(0, count_lookup_mismatches(surface, lookup, palette))
+}
+
+void
+test_reset_lookup_returns_entries_of_new_palette()
+{
+	// lookup reused for another palette must not return stale entries
+	Surface surface = create_gradient_surface();
+	Palette palette(surface, 255, Gamma());
+	PaletteLookup lookup(palette, Gamma());
+	count_lookup_mismatches(surface, lookup, palette);
+
+	Palette small(surface, 16, Gamma());
+	lookup.reset(small, Gamma());
+	ASSERT_EQUAL(0, count_lookup_mismatches(surface, lookup, small))
+}
+
+/* === E N T R Y P O I N T ================================================= */
+
+int main()
+{
+	TEST_SUITE_BEGIN()
+
+	TEST_FUNCTION(test_palette_fits_into_gif_color_table)
+	TEST_FUNCTION(test_lookup_matches_linear_search)
+	TEST_FUNCTION(test_reset_lookup_returns_entries_of_new_palette)
+
+	TEST_SUITE_END()
+
+	return tst_exit_status;
+}
@@ -0,0 +1,203 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file settimesession.cpp
+**	\brief Test parallel setting of time by SetTimeSession
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <synfig/canvas.h>
+#include <synfig/layers/layer_group.h>
+#include <synfig/layers/layer_polygon.h>
+#include <synfig/settimesession.h>
+#include <synfig/threadpool.h>
+#include <synfig/type.h>
+#include <synfig/valuenodes/valuenode_animated.h>
+#include <synfig/valuenodes/valuenode_const.h>
+#include <synfig/valuenodes/valuenode_linear.h>
+
+#include "test_base.h"
+
+using namespace synfig;
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+	const int frames = 24;
+
+	//! Counts calculations of the shared parameter
+	class CountingNode: public ValueNode {
+	public:
+		mutable std::atomic<int> calls;
+		CountingNode(): ValueNode(type_real), calls(0) { }
+		virtual ValueBase operator()(Time t) const override
+			{ ++calls; return Real(0.5 + 0.1*t); }
+		virtual String get_name() const override { return "counting"; }
+		virtual String get_local_name() const override { return "counting"; }
+		virtual ValueNode::Handle clone(etl::loose_handle<Canvas>, const GUID&) const override
+			{ return ValueNode::Handle(); }
+	protected:
+		virtual void get_times_vfunc(Node::time_set &) const override { }
+	};
+
+	//! Integrates its value from the previous time like ValueNode_Dynamic,
+	//! it is linked below unshared parameters, so evaluate() doesn't memoize it
+	class StatefulNode: public ValueNode {
+	public:
+		mutable std::atomic<int> calls;
+		mutable Real last_time, state;
+		StatefulNode(): ValueNode(type_real), calls(0), last_time(0), state(0) { }
+		ValueBase calculate(Time t) const {
+			++calls;
+			Real dt = (Real)t - last_time;
+			std::this_thread::yield();
+			state += dt;
+			last_time = t;
+			return state;
+		}
+		virtual ValueBase operator()(Time t) const override
+			{ return SetTimeSession::evaluate_stateful(*this, t, sigc::mem_fun(*this, &StatefulNode::calculate)); }
+		virtual String get_name() const override { return "stateful"; }
+		virtual String get_local_name() const override { return "stateful"; }
+		virtual ValueNode::Handle clone(etl::loose_handle<Canvas>, const GUID&) const override
+			{ return ValueNode::Handle(); }
+	protected:
+		virtual void get_times_vfunc(Node::time_set &) const override { }
+	};
+
+	//! Inline groups, which are processed simultaneously in parallel mode.
+	//! Every layer has its own (unshared) z_depth node, linked to the shared offset.
+	class Scene {
+	public:
+		Canvas::Handle canvas;
+		std::vector<Layer::Handle> layers;
+
+		Scene(int groups, int count, const ValueNode::Handle &amount, const ValueNode::Handle &offset):
+			canvas(Canvas::create())
+		{
+			for(int g = 0; g < groups; ++g) {
+				Canvas::Handle sub_canvas = Canvas::create_inline(canvas);
+				for(int i = 0; i < count; ++i) {
+					ValueNode_Linear::Handle depth = ValueNode_Linear::create(Real(0));
+					depth->set_link("slope", ValueNode_Const::create(Real(g*count + i)));
+					depth->set_link("offset", offset);
+
+					Layer::Handle layer = Layer_Polygon::create();
+					layer->connect_dynamic_param("amount", amount);
+					layer->connect_dynamic_param("z_depth", depth.get());
+					sub_canvas->push_back(layer);
+					layers.push_back(layer);
+				}
+				Layer::Handle group = Layer_Group::create();
+				group->set_param("canvas", sub_canvas);
+				canvas->push_back(group);
+			}
+		}
+
+		//! Sets time of every frame, returns parameters of all layers
+		std::vector<Real> render(bool parallel)
+		{
+			SetTimeSession::set_parallel(parallel);
+			std::vector<Real> values;
+			for(int f = 0; f < frames; ++f) {
+				canvas->set_time(Time(f/24.0));
+				for(std::vector<Layer::Handle>::const_iterator i = layers.begin(); i != layers.end(); ++i) {
+					values.push_back((*i)->get_param("amount").get(Real()));
+					values.push_back((*i)->get_param("z_depth").get(Real()));
+				}
+			}
+			SetTimeSession::set_parallel(false);
+			return values;
+		}
+	};
+}
+
+void
+test_shared_node_is_calculated_once_per_frame()
+{
+	etl::handle<CountingNode> shared(new CountingNode());
+	Scene scene(16, 64, shared, ValueNode_Const::create(Real(0)));
+
+	std::vector<Real> expected = scene.render(false);
+	shared->calls = 0;
+	std::vector<Real> values = scene.render(true);
+
+	ASSERT_EQUAL(frames, (int)shared->calls)
+	ASSERT(values == expected)
+}
+
+void
+test_stateful_node_is_calculated_once_per_frame()
+{
+	etl::handle<StatefulNode> stateful(new StatefulNode());
+	Scene scene(16, 64, ValueNode_Const::create(Real(1)), stateful);
+
+	std::vector<Real> expected = scene.render(false);
+	stateful->calls = 0;
+	stateful->last_time = stateful->state = 0;
+	std::vector<Real> values = scene.render(true);
+
+	ASSERT_EQUAL(frames, (int)stateful->calls)
+	ASSERT(values == expected)
+}
+
+void
+test_shared_animated_node_below_unshared_parents()
+{
+	// waypoints are not static, so animated node builds the curve at every calculation
+	ValueNode_Animated::Handle animated = ValueNode_Animated::create(type_real);
+	for(int i = 0; i < 4; ++i) {
+		ValueNode_Linear::Handle value = ValueNode_Linear::create(Real(0));
+		value->set_link("slope", ValueNode_Const::create(Real(i%2 ? 2 : -3)));
+		value->set_link("offset", ValueNode_Const::create(Real(i)));
+		animated->new_waypoint(Time(i/3.0), ValueNode::Handle(value));
+	}
+
+	// two groups, so parents in different threads calculate the same child
+	for(int k = 0; k < 8; ++k) {
+		Scene scene(2, 256, ValueNode_Const::create(Real(1)), animated);
+		std::vector<Real> expected = scene.render(false);
+		std::vector<Real> values = scene.render(true);
+		ASSERT(values == expected)
+	}
+}
+
+/* === E N T R Y P O I N T ================================================= */
+
+int main()
+{
+	Type::subsys_init();
+	ThreadPool::subsys_init();
+
+	TEST_SUITE_BEGIN()
+		TEST_FUNCTION(test_shared_node_is_calculated_once_per_frame)
+		TEST_FUNCTION(test_stateful_node_is_calculated_once_per_frame)
+		TEST_FUNCTION(test_shared_animated_node_below_unshared_parents)
+	TEST_SUITE_END()
+
+	ThreadPool::subsys_stop();
+	Type::subsys_stop();
+
+	return tst_exit_status;
+}
@@ -0,0 +1,218 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file skinning.cpp
+**	\brief Test SkinningGrid against the per-point weighting of previous versions
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <synfig/bone.h>
+#include <synfig/matrix.h>
+#include <synfig/skinning.h>
+#include <synfig/threadpool.h>
+
+#include "test_base.h"
+
+using namespace synfig;
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+	const Real precision = 1e-10;
+
+	struct BoneSample {
+		Bone::Shape rest, pose;
+		Real depth;
+	};
+
+	Real random(unsigned int &x, Real min, Real max)
+		{ x = x*1103515245 + 12345; return min + (max - min)*((x >> 8) & 0xffff)/65535.0; }
+
+	//! Bones with random rest shapes, moved, rotated and scaled in pose
+	std::vector<BoneSample> create_bones(int count, unsigned int seed)
+	{
+		std::vector<BoneSample> bones;
+		for(int i = 0; i < count; ++i) {
+			BoneSample b;
+			Vector p0(random(seed, -2, 2), random(seed, -2, 2));
+			Vector p1 = p0 + Vector(random(seed, -1, 1), random(seed, -1, 1));
+			b.rest = Bone::Shape(p0, random(seed, 0, 0.5), p1, random(seed, 0, 0.5));
+
+			Real angle = random(seed, -1, 1), scale = random(seed, 0.5, 1.5);
+			Vector offset(random(seed, -0.3, 0.3), random(seed, -0.3, 0.3));
+			Vector d = (p1 - p0)*scale;
+			d = Vector(d[0]*std::cos(angle) - d[1]*std::sin(angle), d[0]*std::sin(angle) + d[1]*std::cos(angle));
+			b.pose = Bone::Shape(p0 + offset, b.rest.r0, p0 + offset + d, b.rest.r1);
+
+			b.depth = random(seed, -1, 1);
+			bones.push_back(b);
+		}
+		// zero-length bone
+		BoneSample b = bones.front();
+		b.rest.p1 = b.rest.p0;
+		bones.push_back(b);
+		return bones;
+	}
+
+	Real distance_to_line(const Vector &p0, const Vector &p1, const Vector &x)
+	{
+		const Real epsilon = 1e-10;
+
+		Real distance_to_p0 = (x - p0).mag();
+		Real distance_to_p1 = (x - p1).mag();
+		Real distance_to_line = INFINITY;
+
+		Vector line = p1 - p0;
+		Real line_length = line.mag();
+		if (line_length > epsilon)
+		{
+			Real dist = std::fabs((x - p0) * line.perp() / line_length);
+			Real pos = (x - p0) * line / line_length;
+			if (pos > 0.0 && pos < line_length)
+				distance_to_line = dist;
+		}
+
+		return std::min(distance_to_line, std::min(distance_to_p0, distance_to_p1) );
+	}
+
+	//! Grid point of Layer_SkeletonDeformation of previous versions
+	struct GridPoint {
+		Vector initial_position;
+		Vector summary_position;
+		Real summary_depth;
+		Real summary_weight;
+		bool used;
+
+		explicit GridPoint(const Vector &initial_position):
+			initial_position(initial_position), summary_depth(0.0), summary_weight(0.0), used(false) { }
+	};
+
+	//! Per-point weighting of Layer_SkeletonDeformation of previous versions
+	std::vector<GridPoint> deform_grid(const Vector &grid_p0, const Vector &grid_p1, int count_x, int count_y, const std::vector<BoneSample> &bones)
+	{
+		const Real grid_step_x = (grid_p1[0] - grid_p0[0]) / (Real)(count_x - 1);
+		const Real grid_step_y = (grid_p1[1] - grid_p0[1]) / (Real)(count_y - 1);
+		const Real grid_step_diagonal = std::sqrt(grid_step_x*grid_step_x + grid_step_y*grid_step_y);
+
+		std::vector<GridPoint> grid;
+		for(int j = 0; j < count_y; ++j)
+			for(int i = 0; i < count_x; ++i)
+				grid.push_back(GridPoint(Vector(
+					grid_p0[0] + i*grid_step_x,
+					grid_p0[1] + j*grid_step_y )));
+
+		for(std::vector<BoneSample>::const_iterator i = bones.begin(); i != bones.end(); ++i) {
+			const Bone::Shape &shape0 = i->rest;
+			const Bone::Shape &shape1 = i->pose;
+			Bone::Shape expandedShape0 = shape0;
+			expandedShape0.r0 += 2.0*grid_step_diagonal;
+			expandedShape0.r1 += 2.0*grid_step_diagonal;
+
+			Matrix into_bone(
+				shape0.p1[0] - shape0.p0[0], shape0.p1[1] - shape0.p0[1], 0.0,
+				shape0.p0[1] - shape0.p1[1], shape0.p1[0] - shape0.p0[0], 0.0,
+				shape0.p0[0], shape0.p0[1], 1.0
+			);
+			into_bone.invert();
+			Matrix from_bone(
+				shape1.p1[0] - shape1.p0[0], shape1.p1[1] - shape1.p0[1], 0.0,
+				shape1.p0[1] - shape1.p1[1], shape1.p1[0] - shape1.p0[0], 0.0,
+				shape1.p0[0], shape1.p0[1], 1.0
+			);
+			Matrix matrix = from_bone * into_bone;
+
+			for(std::vector<GridPoint>::iterator j = grid.begin(); j != grid.end(); ++j) {
+				Real percent = Bone::distance_to_shape_center_percent(expandedShape0, j->initial_position);
+				if (percent > precision) {
+					Real distance = distance_to_line(shape0.p0, shape0.p1, j->initial_position);
+					if (distance < precision) distance = precision;
+					Real weight = percent/(distance*distance);
+					j->summary_position += matrix.get_transformed(j->initial_position) * weight;
+					j->summary_depth += i->depth * weight;
+					j->summary_weight += weight;
+					j->used = true;
+				}
+			}
+		}
+		return grid;
+	}
+
+	void check_grid_matches_per_point_weighting(int count_x, int count_y, int bone_count, unsigned int seed)
+	{
+		const Vector grid_p0(-2.5, -2.0), grid_p1(2.5, 2.0);
+		std::vector<BoneSample> bones = create_bones(bone_count, seed);
+
+		std::vector<GridPoint> expected = deform_grid(grid_p0, grid_p1, count_x, count_y, bones);
+
+		SkinningGrid grid(grid_p0, grid_p1, count_x, count_y);
+		for(std::vector<BoneSample>::const_iterator i = bones.begin(); i != bones.end(); ++i)
+			grid.add_bone(i->rest, i->pose, i->depth);
+		grid.process();
+
+		ASSERT_EQUAL((int)expected.size(), grid.get_count())
+		int used = 0;
+		for(int i = 0; i < grid.get_count(); ++i) {
+			const GridPoint &p = expected[i];
+			Vector position = p.summary_weight > precision ? p.summary_position/p.summary_weight : p.initial_position;
+			Real depth = p.summary_weight > precision ? p.summary_depth/p.summary_weight : 0.0;
+
+			ASSERT_EQUAL(p.used, grid.is_used(i))
+			ASSERT_APPROX_EQUAL_MICRO(p.initial_position[0], grid.get_initial_position(i)[0])
+			ASSERT_APPROX_EQUAL_MICRO(p.initial_position[1], grid.get_initial_position(i)[1])
+			ASSERT((position - grid.get_position(i)).mag() < 1e-9)
+			ASSERT(std::fabs(depth - grid.get_depth(i)) < 1e-9)
+			if (p.used) ++used;
+		}
+		// bones really affect the grid
+		ASSERT(used > grid.get_count()/4)
+	}
+}
+
+void
+test_skinning_grid_matches_per_point_weighting()
+{
+	check_grid_matches_per_point_weighting(101, 101, 64, 1);
+}
+
+void
+test_skinning_grid_matches_per_point_weighting_on_non_square_grid()
+{
+	check_grid_matches_per_point_weighting(37, 15, 7, 2);
+}
+
+/* === E N T R Y P O I N T ================================================= */
+
+int main()
+{
+	ThreadPool::subsys_init();
+
+	TEST_SUITE_BEGIN()
+		TEST_FUNCTION(test_skinning_grid_matches_per_point_weighting)
+		TEST_FUNCTION(test_skinning_grid_matches_per_point_weighting_on_non_square_grid)
+	TEST_SUITE_END()
+
+	ThreadPool::subsys_stop();
+
+	return tst_exit_status;
+}
@@ -0,0 +1,125 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file task_blur.cpp
+**	\brief Test rendering of blur tasks split into parts
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#include <vector>
+
+#include <synfig/rendering/common/task/taskblur.h>
+#include <synfig/type.h>
+
+#include "test_base.h"
+#include "test_rendering.h"
+
+using namespace synfig;
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+	const int w = 256, h = 256;
+	const Rect source_rect(-1, -1, 1, 1);
+
+	//! Blurred polygon which crosses the borders of the frame,
+	//! so parts at the borders read the source from the margins outside of the frame
+	rendering::Task::Handle create_blurred_polygon(rendering::Blur::Type type)
+	{
+		std::vector<Vector> points;
+		points.push_back(Vector(-1.3, -0.2));
+		points.push_back(Vector( 0.4, -1.2));
+		points.push_back(Vector( 1.2,  0.9));
+		points.push_back(Vector(-0.2,  0.5));
+		points.push_back(Vector(-0.6,  1.4));
+		rendering::TaskBlur::Handle blur(new rendering::TaskBlur());
+		blur->blur = rendering::Blur(type, Vector(0.15, 0.1));
+		blur->sub_task() = create_polygon_task(points, Color(0.9, 0.3, 0.1, 0.8));
+		return blur;
+	}
+
+	void check_split_blur(rendering::Blur::Type type)
+	{
+		rendering::Renderer::Handle whole_renderer(new SplitRenderer(0));
+		rendering::Renderer::Handle split_renderer(new SplitRenderer(4));
+
+		// check that the task is really split
+		rendering::Task::Handle task = create_blurred_polygon(type);
+		task->target_surface = new rendering::SurfaceResource();
+		task->target_surface->create(w, h);
+		task->target_rect = RectInt(0, 0, w, h);
+		task->source_rect = source_rect;
+		rendering::Task::List list(1, task);
+		split_renderer->optimize(list);
+		int parts = 0;
+		for(rendering::Task::List::const_iterator i = list.begin(); i != list.end(); ++i)
+			if (rendering::TaskBlur::Handle::cast_dynamic(*i))
+				++parts;
+		ASSERT(parts >= 2)
+
+		Surface whole_surface, split_surface;
+		ASSERT(render_task(create_blurred_polygon(type), source_rect, w, h, whole_surface, whole_renderer))
+		ASSERT(render_task(create_blurred_polygon(type), source_rect, w, h, split_surface, split_renderer))
+
+		// parts blur the same source, but accumulate sums from different origins
+		ASSERT(max_difference(whole_surface, split_surface) < 1e-4)
+	}
+}
+
+void
+test_split_box_blur_matches_whole()
+	{ check_split_blur(rendering::Blur::BOX); }
+
+void
+test_split_fast_gaussian_blur_matches_whole()
+	{ check_split_blur(rendering::Blur::FASTGAUSSIAN); }
+
+void
+test_split_cross_blur_matches_whole()
+	{ check_split_blur(rendering::Blur::CROSS); }
+
+void
+test_split_gaussian_blur_matches_whole()
+	{ check_split_blur(rendering::Blur::GAUSSIAN); }
+
+void
+test_split_disc_blur_matches_whole()
+	{ check_split_blur(rendering::Blur::DISC); }
+
+/* === E N T R Y P O I N T ================================================= */
+
+int main()
+{
+	Type::subsys_init();
+	rendering::Renderer::subsys_init();
+
+	TEST_SUITE_BEGIN()
+		TEST_FUNCTION(test_split_box_blur_matches_whole)
+		TEST_FUNCTION(test_split_fast_gaussian_blur_matches_whole)
+		TEST_FUNCTION(test_split_cross_blur_matches_whole)
+		TEST_FUNCTION(test_split_gaussian_blur_matches_whole)
+		TEST_FUNCTION(test_split_disc_blur_matches_whole)
+	TEST_SUITE_END()
+
+	rendering::Renderer::subsys_stop();
+	Type::subsys_stop();
+
+	return tst_exit_status;
+}
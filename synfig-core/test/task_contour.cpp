@@ -0,0 +1,193 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file task_contour.cpp
+**	\brief Test rendering of contours by Polyspan and by shared edges of split tasks
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#include <cmath>
+
+#include <synfig/rendering/primitive/contouredges.h>
+#include <synfig/rendering/primitive/polyspan.h>
+#include <synfig/rendering/software/function/contour.h>
+#include <synfig/type.h>
+
+#include "test_base.h"
+#include "test_rendering.h"
+
+using namespace synfig;
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+	const int w = 203, h = 157, tiles = 3;
+	const Real detail = 0.25;
+
+	//! Contour crossing the frame, with self-intersections and holes,
+	//! type 0 is built from lines, type 1 from conics and type 2 from cubics
+	rendering::Contour::Handle create_contour(int type, int seed)
+	{
+		struct Random {
+			static Real next(unsigned int &x, Real min, Real max)
+				{ x = x*1103515245 + 12345; return min + (max - min)*((x >> 8) & 0xffff)/65535.0; }
+		};
+
+		rendering::Contour::Handle contour(new rendering::Contour());
+		unsigned int x = 12345 + 977*seed;
+		contour->move_to(Vector(Random::next(x, -30, 230), Random::next(x, -30, 180)));
+		for(int i = 0; i < 9; ++i) {
+			Vector p(Random::next(x, -30, 230), Random::next(x, -30, 180));
+			Vector pp0(Random::next(x, -30, 230), Random::next(x, -30, 180));
+			Vector pp1(Random::next(x, -30, 230), Random::next(x, -30, 180));
+			if (type == 0) contour->line_to(p);
+			else if (type == 1) contour->conic_to(p, pp0);
+			else contour->cubic_to(p, pp0, pp1);
+		}
+		contour->close();
+
+		contour->invert = seed % 4 == 3;
+		contour->antialias = seed % 4 != 2;
+		contour->winding_style = seed % 2
+		                       ? rendering::Contour::WINDING_EVEN_ODD
+		                       : rendering::Contour::WINDING_NON_ZERO;
+		contour->color = Color::white();
+		return contour;
+	}
+
+	Surface render_by_polyspan(const rendering::Contour &contour)
+	{
+		Surface surface(w, h);
+		surface.fill(Color(0, 0, 0, 0));
+
+		rendering::Polyspan polyspan;
+		polyspan.init(0, 0, w, h);
+		rendering::software::Contour::build_polyspan(contour.get_chunks(), Matrix(), polyspan, detail);
+		polyspan.close();
+		polyspan.sort_marks();
+		rendering::software::Contour::render_polyspan(
+			surface, polyspan, contour.invert, contour.antialias, contour.winding_style,
+			contour.color, 1.0, Color::BLEND_COMPOSITE );
+		return surface;
+	}
+
+	//! Parts of the split task render shared edges
+	Surface render_by_edges(const rendering::Contour &contour)
+	{
+		Surface surface(w, h);
+		surface.fill(Color(0, 0, 0, 0));
+
+		rendering::ContourEdges::Handle edges = contour.get_edges(Matrix(), detail, RectInt(0, 0, w, h));
+		for(int ty = 0; ty < tiles; ++ty)
+			for(int tx = 0; tx < tiles; ++tx)
+				rendering::software::Contour::render_edges(
+					surface,
+					RectInt(w*tx/tiles, h*ty/tiles, w*(tx + 1)/tiles, h*(ty + 1)/tiles),
+					*edges, contour.invert, contour.antialias, contour.winding_style,
+					contour.color, 1.0, Color::BLEND_COMPOSITE );
+		return surface;
+	}
+
+	Surface render_by_renderer(const rendering::Contour::Handle &contour, int threads)
+	{
+		rendering::TaskContour::Handle task(new rendering::TaskContour());
+		task->contour = contour;
+		task->detail = detail;
+
+		Surface surface;
+		ASSERT(render_task(task, Rect(0, 0, w, h), w, h, surface, new SplitRenderer(threads)))
+		return surface;
+	}
+
+	void check_edges_close_to_polyspan(int type)
+	{
+		for(int seed = 0; seed < 8; ++seed) {
+			rendering::Contour::Handle contour = create_contour(type, seed);
+			Surface polyspan_surface = render_by_polyspan(*contour);
+			Surface edges_surface = render_by_edges(*contour);
+
+			// straight edges are rasterized identically,
+			// curves are flattened coarser than by Polyspan, so cover of the border pixels
+			// may differ by 0.005, and without antialiasing a few of them may flip
+			const ColorReal tolerance = type == 0 ? 1e-5 : 0.005;
+			const int max_flipped = type == 0 || contour->antialias ? 0 : w*h/1000;
+			int flipped = 0;
+			for(int y = 0; y < h; ++y)
+				for(int x = 0; x < w; ++x)
+					if (std::fabs(polyspan_surface[y][x].get_a() - edges_surface[y][x].get_a()) > tolerance)
+						++flipped;
+			ASSERT(flipped <= max_flipped)
+		}
+	}
+}
+
+void
+test_edges_of_lines_match_polyspan()
+	{ check_edges_close_to_polyspan(0); }
+
+void
+test_edges_of_conics_are_close_to_polyspan()
+	{ check_edges_close_to_polyspan(1); }
+
+void
+test_edges_of_cubics_are_close_to_polyspan()
+	{ check_edges_close_to_polyspan(2); }
+
+void
+test_unsplit_task_matches_polyspan()
+{
+	// task which is not split is rendered by Polyspan itself
+	for(int type = 0; type < 3; ++type)
+		for(int seed = 0; seed < 8; ++seed) {
+			rendering::Contour::Handle contour = create_contour(type, seed);
+			ASSERT(max_difference(render_by_polyspan(*contour), render_by_renderer(contour, 0)) < 1e-6)
+		}
+}
+
+void
+test_split_task_matches_edges()
+{
+	for(int type = 0; type < 3; ++type)
+		for(int seed = 0; seed < 8; ++seed) {
+			rendering::Contour::Handle contour = create_contour(type, seed);
+			ASSERT(max_difference(render_by_edges(*contour), render_by_renderer(contour, 4)) < 1e-6)
+		}
+}
+
+/* === E N T R Y P O I N T ================================================= */
+
+int main()
+{
+	Type::subsys_init();
+	rendering::Renderer::subsys_init();
+
+	TEST_SUITE_BEGIN()
+		TEST_FUNCTION(test_edges_of_lines_match_polyspan)
+		TEST_FUNCTION(test_edges_of_conics_are_close_to_polyspan)
+		TEST_FUNCTION(test_edges_of_cubics_are_close_to_polyspan)
+		TEST_FUNCTION(test_unsplit_task_matches_polyspan)
+		TEST_FUNCTION(test_split_task_matches_edges)
+	TEST_SUITE_END()
+
+	rendering::Renderer::subsys_stop();
+	Type::subsys_stop();
+
+	return tst_exit_status;
+}
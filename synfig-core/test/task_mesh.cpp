@@ -0,0 +1,130 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file task_mesh.cpp
+**	\brief Test rendering of mesh textures by tiles
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#include <cmath>
+
+#include <synfig/matrix.h>
+#include <synfig/rendering/primitive/mesh.h>
+#include <synfig/rendering/software/function/mesh.h>
+
+#include "test_base.h"
+#include "test_rendering.h"
+
+using namespace synfig;
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+	const int w = 512, h = 512, tw = 256, th = 256, cells = 128;
+
+	//! Dense grid of small triangles, slightly distorted,
+	//! the last row and column of cells are out of the frame
+	void create_mesh(rendering::Mesh &mesh)
+	{
+		for(int j = 0; j <= cells; ++j)
+			for(int i = 0; i <= cells; ++i) {
+				Real u = i/(Real)(cells - 1), v = j/(Real)(cells - 1);
+				mesh.vertices.push_back(rendering::Mesh::Vertex(
+					Vector(u + 0.01*std::sin(v*20.0), v + 0.01*std::cos(u*20.0)),
+					Vector(u, v) ));
+			}
+		for(int j = 0; j < cells; ++j)
+			for(int i = 0; i < cells; ++i) {
+				int v = j*(cells + 1) + i;
+				mesh.triangles.push_back(rendering::Mesh::Triangle(v, v + 1, v + cells + 1));
+				mesh.triangles.push_back(rendering::Mesh::Triangle(v + 1, v + cells + 2, v + cells + 1));
+			}
+	}
+
+	//! Texture with gradients in all channels and semi-transparent squares
+	Surface create_texture()
+	{
+		Surface texture(tw, th);
+		for(int y = 0; y < th; ++y)
+			for(int x = 0; x < tw; ++x)
+				texture[y][x] = Color(
+					x/(float)tw,
+					y/(float)th,
+					((x^y)&15)/15.f,
+					((x/16 + y/16)%3 ? 1.f : 0.5f) );
+		return texture;
+	}
+
+	void check_tiles_match_whole(Color::Interpolation interpolation)
+	{
+		rendering::Mesh mesh;
+		create_mesh(mesh);
+		Surface texture = create_texture();
+
+		Matrix matrix = Matrix().set_scale(w, h);
+		Matrix texture_matrix = Matrix().set_scale(tw, th);
+		Rect texture_rect(0, 0, tw, th);
+
+		Surface whole(w, h);
+		rendering::software::Mesh::render_mesh(
+			whole, RectInt(0, 0, w, h), mesh, texture, texture_rect,
+			matrix, texture_matrix, 1.0, Color::BLEND_COMPOSITE, interpolation );
+
+		// parts of split task render tiles of the same surface
+		Surface tiles(w, h);
+		for(int y = 0; y < h; y += 64)
+			for(int x = 0; x < w; x += 128)
+				rendering::software::Mesh::render_mesh(
+					tiles, RectInt(x, y, x + 128, y + 64), mesh, texture, texture_rect,
+					matrix, texture_matrix, 1.0, Color::BLEND_COMPOSITE, interpolation );
+
+		ASSERT(max_difference(whole, tiles) < 1e-4)
+	}
+}
+
+void
+test_nearest_mesh_tiles_match_whole()
+	{ check_tiles_match_whole(Color::INTERPOLATION_NEAREST); }
+
+void
+test_linear_mesh_tiles_match_whole()
+	{ check_tiles_match_whole(Color::INTERPOLATION_LINEAR); }
+
+void
+test_cosine_mesh_tiles_match_whole()
+	{ check_tiles_match_whole(Color::INTERPOLATION_COSINE); }
+
+void
+test_cubic_mesh_tiles_match_whole()
+	{ check_tiles_match_whole(Color::INTERPOLATION_CUBIC); }
+
+/* === E N T R Y P O I N T ================================================= */
+
+int main()
+{
+	TEST_SUITE_BEGIN()
+		TEST_FUNCTION(test_nearest_mesh_tiles_match_whole)
+		TEST_FUNCTION(test_linear_mesh_tiles_match_whole)
+		TEST_FUNCTION(test_cosine_mesh_tiles_match_whole)
+		TEST_FUNCTION(test_cubic_mesh_tiles_match_whole)
+	TEST_SUITE_END()
+
+	return tst_exit_status;
+}
@@ -0,0 +1,118 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file test_rendering.h
+**	\brief Helpers for tests which render tasks and compare the results
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+#ifndef SYNFIG_TESTRENDERING_H
+#define SYNFIG_TESTRENDERING_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <synfig/color.h>
+#include <synfig/rect.h>
+#include <synfig/surface.h>
+#include <synfig/vector.h>
+#include <synfig/rendering/renderer.h>
+#include <synfig/rendering/common/optimizer/optimizersplit.h>
+#include <synfig/rendering/common/task/taskcontour.h>
+#include <synfig/rendering/software/renderersw.h>
+#include <synfig/rendering/software/surfacesw.h>
+
+//! Software renderer with fixed split (or without it),
+//! so result doesn't depend on count of threads of this machine
+class SplitRenderer: public synfig::rendering::RendererSW {
+public:
+	explicit SplitRenderer(int threads) {
+		using namespace synfig;
+		rendering::Optimizer::List list = get_optimizers(rendering::Optimizer::CATEGORY_ID_LIST);
+		for(rendering::Optimizer::List::const_iterator i = list.begin(); i != list.end(); ++i)
+			if (etl::handle<rendering::OptimizerSplit>::cast_dynamic(*i))
+				unregister_optimizer(*i);
+		if (threads > 0)
+			register_optimizer(new rendering::OptimizerSplit(threads));
+	}
+};
+
+//! Renders the task into a new surface of w x h pixels,
+//! the software renderer is used when renderer is not specified
+inline bool
+render_task(
+	const synfig::rendering::Task::Handle &task,
+	const synfig::Rect &source_rect,
+	int w, int h,
+	synfig::Surface &result,
+	synfig::rendering::Renderer::Handle renderer = synfig::rendering::Renderer::Handle() )
+{
+	using namespace synfig;
+	if (!renderer)
+		renderer = rendering::Renderer::get_renderer("software");
+	rendering::SurfaceResource::Handle surface = new rendering::SurfaceResource();
+	surface->create(w, h);
+	task->target_surface = surface;
+	task->target_rect = RectInt(0, 0, w, h);
+	task->source_rect = source_rect;
+	if (!renderer->run(task))
+		return false;
+	rendering::SurfaceResource::LockRead<rendering::SurfaceSW> lock(surface);
+	if (!lock)
+		return false;
+	result = lock->get_surface();
+	return true;
+}
+
+//! Task which fills a polygon by the color
+inline synfig::rendering::Task::Handle
+create_polygon_task(const std::vector<synfig::Vector> &points, const synfig::Color &color)
+{
+	using namespace synfig;
+	rendering::Contour::Handle contour = new rendering::Contour();
+	contour->color = color;
+	contour->move_to(points.front());
+	for(std::vector<Vector>::const_iterator i = points.begin() + 1; i != points.end(); ++i)
+		contour->line_to(*i);
+	contour->close();
+	rendering::TaskContour::Handle task = new rendering::TaskContour();
+	task->contour = contour;
+	return task;
+}
+
+//! Largest difference of premultiplied color channels of two surfaces of the same size,
+//! premultiplied colors are compared, because colors of almost transparent pixels are unstable
+inline synfig::ColorReal
+max_difference(const synfig::Surface &a, const synfig::Surface &b)
+{
+	using namespace synfig;
+	if (a.get_w() != b.get_w() || a.get_h() != b.get_h())
+		return 1e10;
+	ColorReal diff = 0;
+	for(int y = 0; y < a.get_h(); ++y)
+		for(int x = 0; x < a.get_w(); ++x) {
+			const Color ca = a[y][x].premult_alpha(), cb = b[y][x].premult_alpha();
+			diff = std::max(diff, std::fabs(ca.get_r() - cb.get_r()));
+			diff = std::max(diff, std::fabs(ca.get_g() - cb.get_g()));
+			diff = std::max(diff, std::fabs(ca.get_b() - cb.get_b()));
+			diff = std::max(diff, std::fabs(ca.get_a() - cb.get_a()));
+		}
+	return diff;
+}
+
+#endif
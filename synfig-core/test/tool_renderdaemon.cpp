@@ -0,0 +1,223 @@
+/* === S Y N F I G ========================================================= */
+/*! \file tool_renderdaemon.cpp
+**  \brief Test protocol of the render daemon of the synfig tool
+**
+**  \legal
+**  This file is part of Synfig.
+**
+**  Synfig is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 2 of the License, or
+**  (at your option) any later version.
+**
+**  Synfig is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**  \endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <synfig/general.h>
+#include <synfig/main.h>
+
+#include "../src/tool/definitions.h"
+#include "../src/tool/joblistprocessor.h"
+#include "../src/tool/renderdaemon.h"
+
+#include "test_base.h"
+
+using namespace synfig;
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+	std::string dir;
+
+	std::string get_canvas_filename(int index)
+		{ return dir + G_DIR_SEPARATOR_S + strprintf("scene%d.sif", index); }
+
+	/// Writes empty composition, its file size depends on the width
+	void write_canvas(int index, int width)
+	{
+		FILE *f = g_fopen(get_canvas_filename(index).c_str(), "w");
+		ASSERT(f)
+		fprintf(f,
+			"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+			"<canvas version=\"1.2\" width=\"%d\" height=\"8\" xres=\"2834.645669\" yres=\"2834.645669\""
+			" view-box=\"-1 1 1 -1\" antialias=\"1\" fps=\"24\" begin-time=\"0f\" end-time=\"0f\" bgcolor=\"0 0 0 0\">\n"
+			"</canvas>\n",
+			width );
+		fclose(f);
+	}
+
+	/// Command line of the job which renders the composition by null target
+	std::string render_line(int index)
+	{
+		return "\"" + get_canvas_filename(index) + "\" -t null -o \""
+		     + dir + G_DIR_SEPARATOR_S + "frame.null\"\n";
+	}
+
+	struct Reply {
+		std::string status;
+		int index;
+		std::string value;
+		std::string source;
+		Reply(): index() { }
+	};
+
+	std::vector<Reply> run(RenderDaemon &daemon, const std::string &input)
+	{
+		std::istringstream in(input);
+		std::ostringstream out;
+		int exit_code = daemon.run(in, out);
+		ASSERT_EQUAL((int)SYNFIGTOOL_OK, exit_code)
+
+		std::vector<Reply> replies;
+		std::istringstream lines(out.str());
+		std::string line;
+		while (std::getline(lines, line))
+		{
+			std::istringstream words(line);
+			Reply reply;
+			words >> reply.status >> reply.index >> reply.value >> reply.source;
+			replies.push_back(reply);
+		}
+		return replies;
+	}
+}
+
+void
+test_replies_are_written_for_each_job_until_quit()
+{
+	write_canvas(0, 8);
+	RenderDaemon daemon;
+	std::vector<Reply> replies = run(daemon,
+		"\n"
+		+ render_line(0)
+		+ "  \t\n"
+		+ render_line(0)
+		+ "quit\n"
+		+ render_line(0) );
+
+	ASSERT_EQUAL(2, (int)replies.size())
+	ASSERT_EQUAL(std::string("OK"), replies[0].status)
+	ASSERT_EQUAL(1, replies[0].index)
+	ASSERT_EQUAL(std::string("loaded"), replies[0].source)
+	ASSERT_EQUAL(std::string("OK"), replies[1].status)
+	ASSERT_EQUAL(2, replies[1].index)
+	ASSERT_EQUAL(std::string("cached"), replies[1].source)
+}
+
+void
+test_failed_jobs_reply_error()
+{
+	write_canvas(0, 8);
+	RenderDaemon daemon;
+	std::vector<Reply> replies = run(daemon,
+		"\"unterminated -t null\n"
+		"\"" + dir + G_DIR_SEPARATOR_S + "missing.sif\" -t null\n"
+		"\"" + get_canvas_filename(0) + "\" -t null -o \"" + dir + G_DIR_SEPARATOR_S + "missing" + G_DIR_SEPARATOR_S + "frame.null\"\n"
+		+ render_line(0) );
+
+	ASSERT_EQUAL(4, (int)replies.size())
+	ASSERT_EQUAL(std::string("ERROR"), replies[0].status)
+	ASSERT_EQUAL(1, replies[0].index)
+	ASSERT_EQUAL(strprintf("%d", SYNFIGTOOL_UNKNOWNARGUMENT), replies[0].value)
+	ASSERT_EQUAL(std::string("ERROR"), replies[1].status)
+	ASSERT_EQUAL(2, replies[1].index)
+	// output directory doesn't exist, so the job can't be set up
+	ASSERT_EQUAL(std::string("ERROR"), replies[2].status)
+	ASSERT_EQUAL(3, replies[2].index)
+	ASSERT_EQUAL(strprintf("%d", SYNFIGTOOL_INVALIDJOB), replies[2].value)
+	// daemon continues after errors
+	ASSERT_EQUAL(std::string("OK"), replies[3].status)
+	ASSERT_EQUAL(4, replies[3].index)
+}
+
+void
+test_modified_canvas_is_loaded_again()
+{
+	write_canvas(0, 8);
+	RenderDaemon daemon;
+	std::vector<Reply> replies = run(daemon, render_line(0) + render_line(0));
+	ASSERT_EQUAL(2, (int)replies.size())
+	ASSERT_EQUAL(std::string("loaded"), replies[0].source)
+	ASSERT_EQUAL(std::string("cached"), replies[1].source)
+
+	write_canvas(0, 128);
+	replies = run(daemon, render_line(0) + render_line(0));
+	ASSERT_EQUAL(2, (int)replies.size())
+	ASSERT_EQUAL(std::string("loaded"), replies[0].source)
+	ASSERT_EQUAL(std::string("cached"), replies[1].source)
+}
+
+void
+test_least_recently_used_canvas_is_dropped()
+{
+	const int count = (int)RenderDaemon::max_cached_canvases;
+	for (int i = 0; i <= count; ++i)
+		write_canvas(i, 8);
+
+	RenderDaemon daemon;
+	std::string input;
+	for (int i = 0; i < count; ++i)
+		input += render_line(i);
+	input += render_line(0);     // canvas 1 is the least recently used now
+	input += render_line(count); // drops canvas 1
+	input += render_line(0);
+	input += render_line(1);
+	std::vector<Reply> replies = run(daemon, input);
+
+	ASSERT_EQUAL(count + 4, (int)replies.size())
+	for (int i = 0; i < count; ++i)
+		ASSERT_EQUAL(std::string("loaded"), replies[i].source)
+	ASSERT_EQUAL(std::string("cached"), replies[count].source)
+	ASSERT_EQUAL(std::string("loaded"), replies[count + 1].source)
+	ASSERT_EQUAL(std::string("cached"), replies[count + 2].source)
+	ASSERT_EQUAL(std::string("loaded"), replies[count + 3].source)
+}
+
+/* === E N T R Y P O I N T ================================================= */
+
+int main(int argc, char **argv)
+{
+	SynfigToolGeneralOptions::instance()->set_binary_path(argv[0]);
+	const std::string root_path = get_absolute_path(
+		SynfigToolGeneralOptions::instance()->get_binary_path() + "/../../" );
+	synfig::Main synfig_main(root_path);
+
+	gchar *tmp_dir = g_dir_make_tmp("synfig-renderdaemon-XXXXXX", nullptr);
+	if (!tmp_dir)
+		return 1;
+	dir = tmp_dir;
+	g_free(tmp_dir);
+
+	TEST_SUITE_BEGIN()
+
+	TEST_FUNCTION(test_replies_are_written_for_each_job_until_quit)
+	TEST_FUNCTION(test_failed_jobs_reply_error)
+	TEST_FUNCTION(test_modified_canvas_is_loaded_again)
+	TEST_FUNCTION(test_least_recently_used_canvas_is_dropped)
+
+	TEST_SUITE_END()
+
+	for (int i = 0; i <= (int)RenderDaemon::max_cached_canvases; ++i)
+		g_remove(get_canvas_filename(i).c_str());
+	g_rmdir(dir.c_str());
+
+	return tst_exit_status;
+}
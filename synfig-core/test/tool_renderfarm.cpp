@@ -0,0 +1,202 @@
+/* === S Y N F I G ========================================================= */
+/*! \file tool_renderfarm.cpp
+**  \brief Test render farm of the synfig tool
+**
+**  \legal
+**  This file is part of Synfig.
+**
+**  Synfig is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU General Public License as published by
+**  the Free Software Foundation, either version 2 of the License, or
+**  (at your option) any later version.
+**
+**  Synfig is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**  \endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <thread>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <synfig/general.h>
+
+#include "../src/tool/definitions.h"
+#include "../src/tool/renderfarm.h"
+
+#include "test_base.h"
+
+using namespace synfig;
+
+/* === M A C R O S ========================================================= */
+
+// This test runs its own executable as the worker processes of the farm,
+// the worker "renders" the frames of its chunk by writing their numbers to the log
+#define WORKER_DIR_OPTION "--renderfarm-test-dir"
+
+/* === G L O B A L S ======================================================= */
+
+namespace {
+	const char log_name[] = "frames.log";
+
+	/// Chunk which starts from this frame fails at the first attempt
+	const int failing_frame = 6;
+}
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+	std::string get_marker_filename(const std::string &dir, int frame)
+		{ return dir + G_DIR_SEPARATOR_S + strprintf("failed-%d", frame); }
+
+	std::string get_log_filename(const std::string &dir)
+		{ return dir + G_DIR_SEPARATOR_S + log_name; }
+
+	/// Entry point of the worker process
+	int run_worker(int argc, char **argv)
+	{
+		std::string dir;
+		int frame_begin = -1, frame_end = -1;
+		for (int i = 1; i + 1 < argc; ++i)
+		{
+			if (!strcmp(argv[i], WORKER_DIR_OPTION))
+				dir = argv[++i];
+			else if (!strcmp(argv[i], "--begin-time"))
+				frame_begin = atoi(argv[++i]);
+			else if (!strcmp(argv[i], "--end-time"))
+				frame_end = atoi(argv[++i]);
+		}
+		if (dir.empty() || frame_begin < 0 || frame_end < frame_begin)
+			return SYNFIGTOOL_MISSINGARGUMENT;
+
+		if (frame_begin == failing_frame)
+		{
+			std::string marker = get_marker_filename(dir, frame_begin);
+			if (!g_file_test(marker.c_str(), G_FILE_TEST_EXISTS))
+			{
+				if (FILE *f = g_fopen(marker.c_str(), "w"))
+					fclose(f);
+				return SYNFIGTOOL_RENDERFAILURE;
+			}
+		}
+
+		for (int frame = frame_begin; frame <= frame_end; ++frame)
+		{
+			// let the other workers run simultaneously
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			FILE *f = g_fopen(get_log_filename(dir).c_str(), "a");
+			if (!f)
+				return SYNFIGTOOL_RENDERFAILURE;
+			fprintf(f, "%d\n", frame);
+			fclose(f);
+		}
+		return SYNFIGTOOL_OK;
+	}
+
+	bool is_worker(int argc, char **argv)
+	{
+		for (int i = 1; i < argc; ++i)
+			if (!strcmp(argv[i], WORKER_DIR_OPTION))
+				return true;
+		return false;
+	}
+}
+
+void
+test_split_covers_every_frame_once()
+{
+	for (int frames = 2; frames <= 20; ++frames)
+	{
+		for (int chunk_frames = 0; chunk_frames <= 7; ++chunk_frames)
+		{
+			std::vector<RenderFarm::Chunk> chunks = RenderFarm::split(10, 10 + frames - 1, chunk_frames);
+			int next = 10;
+			for (const RenderFarm::Chunk &chunk : chunks)
+			{
+				ASSERT_EQUAL(next, chunk.frame_begin)
+				ASSERT(chunk.frame_end > chunk.frame_begin)
+				next = chunk.frame_end + 1;
+			}
+			ASSERT_EQUAL(10 + frames, next)
+		}
+	}
+}
+
+void
+test_workers_render_every_frame_once()
+{
+	const int frame_begin = 0, frame_end = 20;
+
+	gchar *tmp_dir = g_dir_make_tmp("synfig-renderfarm-XXXXXX", nullptr);
+	ASSERT(tmp_dir)
+	std::string dir = tmp_dir;
+	g_free(tmp_dir);
+
+	Job job;
+	job.desc.set_frame_rate(24);
+	job.desc.set_frame_start(frame_begin);
+	job.desc.set_frame_end(frame_end);
+
+	RenderFarm::Params params;
+	params.workers = 3;
+	params.chunk_frames = 2;
+	params.retries = 1;
+
+	std::vector<std::string> args;
+	args.push_back(WORKER_DIR_OPTION);
+	args.push_back(dir);
+	bool success = RenderFarm(args, params).run(job);
+
+	std::map<int, int> counts;
+	if (FILE *f = g_fopen(get_log_filename(dir).c_str(), "r"))
+	{
+		int frame;
+		while (fscanf(f, "%d", &frame) == 1)
+			++counts[frame];
+		fclose(f);
+	}
+	bool retried = g_file_test(get_marker_filename(dir, failing_frame).c_str(), G_FILE_TEST_EXISTS);
+
+	g_remove(get_log_filename(dir).c_str());
+	g_remove(get_marker_filename(dir, failing_frame).c_str());
+	g_rmdir(dir.c_str());
+
+	ASSERT(success)
+	ASSERT(retried)
+	ASSERT_EQUAL(frame_end - frame_begin + 1, (int)counts.size())
+	for (int frame = frame_begin; frame <= frame_end; ++frame)
+		ASSERT_EQUAL(1, counts[frame])
+}
+
+/* === E N T R Y P O I N T ================================================= */
+
+int main(int argc, char **argv)
+{
+	if (is_worker(argc, argv))
+		return run_worker(argc, argv);
+
+	SynfigToolGeneralOptions::instance()->set_binary_path(argv[0]);
+
+	TEST_SUITE_BEGIN()
+
+	TEST_FUNCTION(test_split_covers_every_frame_once)
+	TEST_FUNCTION(test_workers_render_every_frame_once)
+
+	TEST_SUITE_END()
+
+	return tst_exit_status;
+}
@@ -309,6 +309,7 @@ synfig::Color studio::App::default_background_layer_color =
 String        studio::App::default_background_layer_image = "undefined";
 synfig::Color studio::App::preview_background_color =
 	synfig::Color(0.742187, 0.742187, 0.742187, 1.000000);  //X11 Gray
+int           studio::App::preview_memory_limit = 1024;
 
 bool   studio::App::enable_mainwin_menubar = true;
 bool   studio::App::enable_mainwin_toolbar = true;
@@ -614,6 +615,11 @@ public:
 					);
 				return true;
 			}
+			if (key == "preview_memory_limit")
+			{
+				value = strprintf("%i", App::preview_memory_limit);
+				return true;
+			}
 			if(key=="use_render_done_sound")
 			{
 				value=strprintf("%i",(int)App::use_render_done_sound);
@@ -801,6 +807,11 @@ public:
 				App::preview_background_color = synfig::Color(r,g,b,a);
 				return true;
 			}
+			if (key == "preview_memory_limit")
+			{
+				App::preview_memory_limit = atoi(value.c_str());
+				return true;
+			}
 			if(key=="use_render_done_sound")
 			{
 				int i(atoi(value.c_str()));
@@ -829,6 +840,12 @@ public:
 				for (auto instance : App::instance_list)
 					instance->set_clear_redo_stack_on_new_action(value != "0");
 			}
+			if(key=="undo_memory_limit")
+			{
+				int limit = atoi(value.c_str());
+				for (auto instance : App::instance_list)
+					instance->set_max_memory(limit > 0 ? (size_t)limit << 20 : 0);
+			}
 		}
 		catch(...)
 		{
@@ -868,6 +885,7 @@ public:
 		ret.push_back("default_background_layer_color");
 		ret.push_back("default_background_layer_image");
 		ret.push_back("preview_background_color");
+		ret.push_back("preview_memory_limit");
 		ret.push_back("use_render_done_sound");
 		ret.push_back("enable_mainwin_menubar");
 		ret.push_back("ui_handle_tooltip_flag");
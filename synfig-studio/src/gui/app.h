@@ -243,6 +243,7 @@ public:
 	static synfig::Color  default_background_layer_color;
 	static synfig::String default_background_layer_image;
 	static synfig::Color  preview_background_color;
+	static int            preview_memory_limit; //!< in megabytes
 
 	//The sound effects that will be used
 	static synfig::SoundProcessor* sound_render_done;
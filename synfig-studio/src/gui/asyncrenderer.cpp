@@ -35,11 +35,16 @@
 
 #include "asyncrenderer.h"
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 #include <synfig/clock.h>
 #include <synfig/context.h>
 #include <synfig/general.h>
 #include <synfig/target_scanline.h>
 #include <synfig/target_tile.h>
+#include <synfig/threadpool.h>
 
 #include <gui/app.h>
 #include <gui/docks/dock_info.h>
@@ -53,7 +58,10 @@
 using namespace synfig;
 using namespace studio;
 
-#define BOREDOM_TIMEOUT		1
+//! Count of rendered tiles which may wait for the render thread
+#define TILE_QUEUE_SIZE		64
+//! Delay of the render thread when there are no rendered tiles
+#define TILE_QUEUE_POLL_MS	1
 
 #define REJOIN_ON_STOP	1
 
@@ -63,6 +71,86 @@ using namespace studio;
 
 /* === C L A S S E S ======================================================= */
 
+namespace {
+
+//! Bounded lock-free queue for several producers and consumers.
+//! \param Size must be a power of two
+template<typename T, size_t Size>
+class BoundedQueue
+{
+private:
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		T data;
+	};
+
+	Cell cells[Size];
+	std::atomic<size_t> push_pos;
+	std::atomic<size_t> pop_pos;
+
+public:
+	BoundedQueue(): push_pos(0), pop_pos(0)
+	{
+		for(size_t i = 0; i < Size; ++i)
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	//! Returns false if queue is full
+	bool push(const T &data)
+	{
+		size_t pos = push_pos.load(std::memory_order_relaxed);
+		Cell *cell;
+		while(true)
+		{
+			cell = &cells[pos & (Size - 1)];
+			size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			if (sequence == pos)
+			{
+				if (push_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else
+			if ((long long)(sequence - pos) < 0)
+				return false;
+			else
+				pos = push_pos.load(std::memory_order_relaxed);
+		}
+		cell->data = data;
+		cell->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	//! Returns false if queue is empty
+	bool pop(T &data)
+	{
+		size_t pos = pop_pos.load(std::memory_order_relaxed);
+		Cell *cell;
+		while(true)
+		{
+			cell = &cells[pos & (Size - 1)];
+			size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			if (sequence == pos + 1)
+			{
+				if (pop_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else
+			if ((long long)(sequence - (pos + 1)) < 0)
+				return false;
+			else
+				pos = pop_pos.load(std::memory_order_relaxed);
+		}
+		data = cell->data;
+		cell->sequence.store(pos + Size, std::memory_order_release);
+		return true;
+	}
+};
+
+}
+
+//! Renders tiles in the ThreadPool and passes them to the warm target
+//! in the render thread through the bounded lock-free queue
 class AsyncTarget_Tile : public synfig::Target_Tile
 {
 public:
@@ -78,22 +166,26 @@ public:
 		{
 		}
 	};
-	std::list<tile_t> tile_queue;
-	std::list<Glib::Thread*> threads;
-	bool err;
-	Glib::Mutex mutex;
-
-#ifndef GLIB_DISPATCHER_BROKEN
-	Glib::Dispatcher tile_ready_signal;
-#endif
-	Glib::Cond cond_tile_queue_empty;
-	bool alive_flag;
-
-	sigc::connection ready_connection;
+	//! Rendered tiles waiting for the render thread, see process_tiles()
+	BoundedQueue<tile_t*, TILE_QUEUE_SIZE> tile_queue;
+	//! Count of tiles enqueued into the ThreadPool and not finished yet
+	std::atomic<int> pending_tiles;
+	std::atomic<bool> err;
+	std::atomic<bool> alive_flag;
+	bool show_tile_outlines;
+	bool first_pixel;
+
+	//! Emitted in the render thread when the first tile is passed to the warm target
+	sigc::signal<void> signal_first_pixel;
 
 public:
 	AsyncTarget_Tile(etl::handle<synfig::Target_Tile> warm_target):
-		warm_target(warm_target), err(false)
+		warm_target(warm_target),
+		pending_tiles(0),
+		err(false),
+		alive_flag(true),
+		show_tile_outlines(getenv("SYNFIG_SHOW_TILE_OUTLINES")),
+		first_pixel(false)
 	{
 		set_avoid_time_sync(warm_target->get_avoid_time_sync());
 		set_tile_w(warm_target->get_tile_w());
@@ -105,20 +197,19 @@ public:
 		set_clipping(warm_target->get_clipping());
 		set_rend_desc(&warm_target->rend_desc());
 		set_engine(warm_target->get_engine());
-		alive_flag=true;
-#ifndef GLIB_DISPATCHER_BROKEN
-		ready_connection=tile_ready_signal.connect(sigc::mem_fun(*this,&AsyncTarget_Tile::tile_ready));
-#endif
 	}
 
 	~AsyncTarget_Tile()
 	{
-		ready_connection.disconnect();
+		// tasks in the ThreadPool refer to this target
+		set_dead();
+		process_tiles();
 	}
+
 	void set_dead()
 	{
-		Glib::Mutex::Lock lock(mutex);
 		alive_flag=false;
+		cancel_render();
 	}
 
 	virtual bool async_render_tile(
@@ -131,56 +222,77 @@ public:
 		if(!alive_flag)
 			return false;
 
-		Glib::Thread *thread = Glib::Thread::create(
-			sigc::hide_return(
-				sigc::bind(
-					sigc::mem_fun(*this, &AsyncTarget_Tile::sync_render_tile),
-					canvas, context_params, rect, tile_desc, (synfig::ProgressCallback*)nullptr )),
-				true
-			);
-		assert(thread);
-
-		{
-			Glib::Mutex::Lock lock(mutex);
-			threads.push_back(thread);
-		}
-
+		++pending_tiles;
+		ThreadPool::instance().enqueue(
+			sigc::bind(
+				sigc::mem_fun(*this, &AsyncTarget_Tile::render_tile),
+				canvas, context_params, rect, tile_desc ));
 		return true;
 	}
 
-	bool sync_render_tile(
+	void render_tile(
 		etl::handle<Canvas> canvas,
 		ContextParams context_params,
 		RectInt rect,
-		RendDesc tile_desc,
-		ProgressCallback *cb )
+		RendDesc tile_desc )
 	{
-		if(!alive_flag)
-			return false;
-		bool r = warm_target->async_render_tile(canvas, context_params, rect, tile_desc, cb);
-		if (!r) { Glib::Mutex::Lock lock(mutex); err = true; }
-		return r;
+		try
+		{
+			// calls call_renderer() and add_tile() of this target
+			if (alive_flag && !Target_Tile::async_render_tile(canvas, context_params, rect, tile_desc, nullptr))
+				err = true;
+		}
+		catch(...)
+		{
+			err = true;
+		}
+		--pending_tiles;
 	}
 
-	virtual bool wait_render_tiles(ProgressCallback* cb = nullptr)
+	//! Passes rendered tiles to the warm target until all enqueued tiles are finished
+	void process_tiles()
 	{
-		if(!alive_flag)
-			return false;
-
 		while(true)
 		{
-			Glib::Thread *thread;
-			{
-				Glib::Mutex::Lock lock(mutex);
-				if (threads.empty()) break;
-				thread = threads.front();
-				threads.pop_front();
+			// tiles are pushed before the counter is decreased
+			bool finished = !pending_tiles;
+			bool idle = true;
 
+			tile_t *tile;
+			while(tile_queue.pop(tile))
+			{
+				idle = false;
+				if (alive_flag)
+				{
+					if (show_tile_outlines)
+					{
+						Color red(1,0,0);
+						tile->surface.fill(red, 0, 0, 1, tile->surface.get_h());
+						tile->surface.fill(red, 0, 0, tile->surface.get_w(), 1);
+					}
+					if (!first_pixel)
+					{
+						first_pixel = true;
+						signal_first_pixel();
+					}
+					if (!warm_target->add_tile(tile->surface, tile->x, tile->y))
+						alive_flag = false;
+				}
+				delete tile;
 			}
-			thread->join();
+
+			if (finished)
+				break;
+			if (idle)
+				std::this_thread::sleep_for(std::chrono::milliseconds(TILE_QUEUE_POLL_MS));
 		}
+	}
 
-		{ Glib::Mutex::Lock lock(mutex); if (err) return false; }
+	virtual bool wait_render_tiles(ProgressCallback* cb = nullptr)
+	{
+		process_tiles();
+		if(!alive_flag || err)
+			return false;
 		return warm_target->wait_render_tiles(cb);
 	}
 
@@ -203,115 +315,65 @@ public:
 	{
 		if(!alive_flag)
 			return false;
-		{ Glib::Mutex::Lock lock(mutex); err = false; }
+		err = false;
 		return warm_target->start_frame(cb);
 	}
 
+	//! Called from the ThreadPool
 	virtual bool add_tile(const synfig::Surface &surface, int gx, int gy)
 	{
 		assert(surface);
 		if(!alive_flag)
 			return false;
-		Glib::Mutex::Lock lock(mutex);
-		tile_queue.push_back(tile_t(surface,gx,gy));
-		if(tile_queue.size()==1)
-		{
-#ifdef GLIB_DISPATCHER_BROKEN
-		ready_connection=Glib::signal_timeout().connect(
-			sigc::bind_return(
-				sigc::mem_fun(*this,&AsyncTarget_Tile::tile_ready),
-				false
-			)
-			,0
-		);
-#else
-		tile_ready_signal();
-#endif
-		}
 
-		return alive_flag;
-	}
-
-	void tile_ready()
-	{
-		Glib::Mutex::Lock lock(mutex);
-		if(!alive_flag)
-		{
-			tile_queue.clear();
-			cond_tile_queue_empty.signal();
-			return;
-		}
-		while(!tile_queue.empty() && alive_flag)
+		tile_t *tile = new tile_t(surface, gx, gy);
+		while(!tile_queue.push(tile))
 		{
-			tile_t& tile(tile_queue.front());
-
-			if (getenv("SYNFIG_SHOW_TILE_OUTLINES"))
+			if (!alive_flag)
 			{
-				Color red(1,0,0);
-				tile.surface.fill(red, 0, 0, 1, tile.surface.get_h());
-				tile.surface.fill(red, 0, 0, tile.surface.get_w(), 1);
+				delete tile;
+				return false;
 			}
-
-			alive_flag=warm_target->add_tile(tile.surface,tile.x,tile.y);
-
-			tile_queue.pop_front();
+			std::this_thread::yield();
 		}
-		cond_tile_queue_empty.signal();
+		return true;
 	}
 
 	virtual void end_frame()
 	{
-		while(alive_flag)
-		{
-			Glib::Mutex::Lock lock(mutex);
-			Glib::TimeVal end_time;
-
-			end_time.assign_current_time();
-			end_time.add_microseconds(BOREDOM_TIMEOUT);
-
-			if(!tile_queue.empty() && alive_flag)
-			{
-				if(cond_tile_queue_empty.timed_wait(mutex,end_time))
-					break;
-			}
-			else
-				break;
-		}
-		Glib::Mutex::Lock lock(mutex);
 		if(!alive_flag)
 			return;
-		return warm_target->end_frame();
+		warm_target->end_frame();
 	}
 };
 
 
 
+//! Passes frames to the warm target directly from the render thread,
+//! GUI thread receives the progress only
 class AsyncTarget_Scanline : public synfig::Target_Scanline
 {
 public:
 	etl::handle<synfig::Target_Scanline> warm_target;
 
-	int scanline_;
 	Surface surface;
 
-	Glib::Mutex mutex;
-
-#ifndef GLIB_DISPATCHER_BROKEN
-	Glib::Dispatcher frame_ready_signal;
-#endif
-	Glib::Cond cond_frame_queue_empty;
-	bool alive_flag;
-	bool ready_next;
-	sigc::connection ready_connection;
+	std::atomic<bool> alive_flag;
+	std::atomic<bool> progress_pending;
+	bool first_pixel;
+	sigc::connection progress_connection;
 
 	ProgressCallback *cb;
 
+	//! Emitted in the render thread when the first scanline is finished
+	sigc::signal<void> signal_first_pixel;
+
 public:
 	AsyncTarget_Scanline(etl::handle<synfig::Target_Scanline> warm_target):
 		warm_target(warm_target),
-		scanline_(),
-		alive_flag(),
-		ready_next(),
+		alive_flag(true),
+		progress_pending(false),
+		first_pixel(false),
 		cb(nullptr)
 	{
 		set_avoid_time_sync(warm_target->get_avoid_time_sync());
@@ -320,16 +382,12 @@ public:
 		set_alpha_mode(warm_target->get_alpha_mode());
 		set_threads(warm_target->get_threads());
 		set_rend_desc(&warm_target->rend_desc());
-		alive_flag=true;
-#ifndef GLIB_DISPATCHER_BROKEN
-		ready_connection=frame_ready_signal.connect(sigc::mem_fun(*this,&AsyncTarget_Scanline::frame_ready));
-#endif
 		surface.set_wh(warm_target->rend_desc().get_w(),warm_target->rend_desc().get_h());
 	}
 
 	~AsyncTarget_Scanline()
 	{
-		ready_connection.disconnect();
+		progress_connection.disconnect();
 	}
 
 	virtual int next_frame(Time& time)
@@ -342,8 +400,8 @@ public:
 
 	void set_dead()
 	{
-		Glib::Mutex::Lock lock(mutex);
 		alive_flag=false;
+		cancel_render();
 	}
 
 	virtual bool start_frame(synfig::ProgressCallback *cb)
@@ -352,62 +410,46 @@ public:
 		return alive_flag;
 	}
 
-	virtual void end_frame()
+	virtual bool end_frame()
 	{
-		{
-			Glib::Mutex::Lock lock(mutex);
-
-			if(!alive_flag)
-				return;
-			ready_next=false;
-
-#ifdef GLIB_DISPATCHER_BROKEN
-		ready_connection=Glib::signal_timeout().connect(
-			sigc::bind_return(
-				sigc::mem_fun(*this,&AsyncTarget_Scanline::frame_ready),
-				false
-			)
-			,0
-		);
-#else
-			frame_ready_signal();
-#endif
-		}
-
-		Glib::TimeVal end_time;
+		if(!alive_flag)
+			return false;
 
-		end_time.assign_current_time();
-		end_time.add_microseconds(BOREDOM_TIMEOUT);
+		// the surface is not reused by the next frame until it is written
+		if (!warm_target->add_frame(&surface, cb))
+			alive_flag = false;
+
+		if (!progress_pending.exchange(true))
+			progress_connection=Glib::signal_timeout().connect(
+				sigc::bind_return(
+					sigc::mem_fun(*this,&AsyncTarget_Scanline::progress_ready),
+					false
+				)
+				,0
+			);
 
-		while(alive_flag && !ready_next)
-		{
-			Glib::Mutex::Lock lock(mutex);
-			if(cond_frame_queue_empty.timed_wait(mutex, end_time))
-				break;
-		}
+		return alive_flag;
 	}
 
-
 	virtual Color * start_scanline(int scanline)
 	{
-		Glib::Mutex::Lock lock(mutex);
-
 		return surface[scanline];
 	}
 
 	virtual bool end_scanline()
 	{
+		if (!first_pixel)
+		{
+			first_pixel = true;
+			signal_first_pixel();
+		}
 		return alive_flag;
 	}
 
-	void frame_ready()
+	void progress_ready()
 	{
-		Glib::Mutex::Lock lock(mutex);
-		if(alive_flag)
-			alive_flag=warm_target->add_frame(&surface, cb);
-		cond_frame_queue_empty.signal();
-		ready_next=true;
-		
+		progress_pending = false;
+
 		int n_total_frames_to_render = warm_target->desc.get_frame_end()        //120
 		                             - warm_target->desc.get_frame_start()      //0
 		                             + 1;                                       //->121
@@ -432,7 +474,8 @@ AsyncRenderer::AsyncRenderer(etl::handle<synfig::Target> target_,synfig::Progres
 	start_clock(0),
 	finish_clock(0),
 	start_time(0, 0),
-	finish_time(0, 0)
+	finish_time(0, 0),
+	first_pixel_latency(-1.0)
 {
 	render_thread=0;
 	if(auto cast_target = synfig::Target_Tile::Handle::cast_dynamic(target_))
@@ -442,6 +485,7 @@ AsyncRenderer::AsyncRenderer(etl::handle<synfig::Target> target_,synfig::Progres
 		);
 
 		signal_stop_.connect(sigc::mem_fun(*wrap_target,&AsyncTarget_Tile::set_dead));
+		wrap_target->signal_first_pixel.connect(sigc::mem_fun(*this,&AsyncRenderer::on_first_pixel));
 
 		target=wrap_target;
 	}
@@ -452,6 +496,7 @@ AsyncRenderer::AsyncRenderer(etl::handle<synfig::Target> target_,synfig::Progres
 		);
 
 		signal_stop_.connect(sigc::mem_fun(*wrap_target,&AsyncTarget_Scanline::set_dead));
+		wrap_target->signal_first_pixel.connect(sigc::mem_fun(*this,&AsyncRenderer::on_first_pixel));
 
 		target=wrap_target;
 	}
@@ -480,6 +525,10 @@ AsyncRenderer::stop(AsyncRenderer::Interaction interaction)
 			finish_time.assign_current_time();
 			finish_clock = ::clock();
 
+			if (get_first_pixel_latency() >= 0.0)
+				synfig::info("AsyncRenderer: first pixel in %f s, finished in %f s",
+					get_first_pixel_latency(), get_execution_time() );
+
 
 			// Make sure all the dispatch crap is cleared out
 			//Glib::MainContext::get_default()->iteration(false);
@@ -529,6 +578,8 @@ void
 AsyncRenderer::start()
 {
 	App::dock_info_->set_render_progress(0.0);
+	request_time = std::chrono::steady_clock::now();
+	first_pixel_latency = -1.0;
 	start_time.assign_current_time();
 	finish_time = start_time;
 	start_clock = ::clock();
@@ -567,6 +618,13 @@ AsyncRenderer::start_()
 	}
 }
 
+void
+AsyncRenderer::on_first_pixel()
+{
+	first_pixel_latency = std::chrono::duration<Real>(
+		std::chrono::steady_clock::now() - request_time ).count();
+}
+
 void
 AsyncRenderer::render_target()
 {
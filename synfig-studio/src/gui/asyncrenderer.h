@@ -31,6 +31,8 @@
 
 /* === H E A D E R S ======================================================= */
 
+#include <atomic>
+#include <chrono>
 #include <ctime>
 
 #include <ETL/handle>
@@ -93,6 +95,11 @@ private:
 	Glib::TimeVal start_time;
 	Glib::TimeVal finish_time;
 
+	//! Time of the start() call, see get_first_pixel_latency()
+	std::chrono::steady_clock::time_point request_time;
+	//! Negative until the first pixel is rendered
+	std::atomic<synfig::Real> first_pixel_latency;
+
 	/*
  --	** -- P A R E N T   M E M B E R S -----------------------------------------
 	*/
@@ -109,6 +116,9 @@ public:
 	Status get_status() const { return status; }
 	synfig::Real get_execution_time() const { return (finish_time - start_time).as_double(); }
 	synfig::Real get_execution_clock() const { return (synfig::Real)(finish_clock - start_clock)/(synfig::Real)CLOCKS_PER_SEC; }
+	//! Seconds from the start() call to the first pixel passed to the target,
+	//! negative if nothing is rendered yet
+	synfig::Real get_first_pixel_latency() const { return first_pixel_latency; }
 
 	sigc::signal<void, std::string>& signal_finished() { return signal_finished_; }
 	sigc::signal<void>& signal_success() { return signal_success_; }
@@ -117,6 +127,8 @@ private:
 
 	void render_target();
 	void start_();
+	//! Called from the render thread
+	void on_first_pixel();
 
 	/*
  --	** -- C H I L D   M E M B E R S -------------------------------------------
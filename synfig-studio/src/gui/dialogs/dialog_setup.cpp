@@ -88,11 +88,13 @@ Dialog_Setup::Dialog_Setup(Gtk::Window& parent):
 	adj_recent_files(Gtk::Adjustment::create(15,1,50,1,1,0)),
 	adj_undo_depth(Gtk::Adjustment::create(100,10,5000,1,1,1)),
 	time_format(Time::FORMAT_NORMAL),
+	adj_undo_memory_limit(Gtk::Adjustment::create(512,0,65536,16,256,0)),
 	listviewtext_brushes_path(manage (new Gtk::ListViewText(1, true, Gtk::SELECTION_BROWSE))),
 	adj_pref_x_size(Gtk::Adjustment::create(480,1,10000,1,10,0)),
 	adj_pref_y_size(Gtk::Adjustment::create(270,1,10000,1,10,0)),
 	adj_pref_fps(Gtk::Adjustment::create(24.0,1.0,100,0.1,1,0)),
 	adj_number_of_threads(Gtk::Adjustment::create(App::number_of_threads,2,std::thread::hardware_concurrency(),1,10,0)),
+	adj_preview_memory_limit(Gtk::Adjustment::create(App::preview_memory_limit,16,65536,16,256,0)),
 	pref_modification_flag(false),
 	refreshing(false)
 {
@@ -243,6 +245,13 @@ Dialog_Setup::create_system_page(PageInfo pi)
 	toggle_clear_redo_stack_on_new_action.set_halign(Gtk::ALIGN_START);
 	toggle_clear_redo_stack_on_new_action.set_hexpand(false);
 
+	// System - undo_memory_limit
+	attach_label(pi.grid, _("History memory limit (MB)"), ++row);
+	Gtk::SpinButton *undo_memory_limit_select = Gtk::manage(new Gtk::SpinButton(adj_undo_memory_limit,0,0));
+	pi.grid->attach(*undo_memory_limit_select, 1, row, 1, 1);
+	undo_memory_limit_select->set_hexpand(true);
+	undo_memory_limit_select->set_tooltip_text(_("The oldest actions are removed from history when it takes more memory. Zero means unlimited."));
+
 	// signal for change resume
 	auto_backup_interval.signal_changed().connect(
 			sigc::bind<int>(sigc::mem_fun(*this, &Dialog_Setup::on_value_change), CHANGE_AUTOBACKUP));
@@ -732,6 +741,12 @@ Dialog_Setup::create_render_page(PageInfo pi)
 	preview_background_color_button.signal_color_set().connect(
 		sigc::mem_fun(*this, &studio::Dialog_Setup::on_preview_background_color_changed) );
 
+	// Render - Preview memory limit
+	attach_label(pi.grid, _("Preview Memory Limit (MB)"), ++row);
+	Gtk::SpinButton *preview_memory_limit_select = Gtk::manage(new Gtk::SpinButton(adj_preview_memory_limit,0,0));
+	pi.grid->attach(*preview_memory_limit_select, 1, row, 1, 1);
+	preview_memory_limit_select->set_hexpand(true);
+	preview_memory_limit_select->set_tooltip_text(_("Preview stops rendering when its compressed frames reach this size."));
 }
 
 void
@@ -872,6 +887,7 @@ Dialog_Setup::on_restore_pressed()
 		toggle_animation_thumbnail_preview.set_active(true);
 		toggle_enable_experimental_features.set_active(false);
 		toggle_clear_redo_stack_on_new_action.set_active(true);
+		adj_undo_memory_limit->set_value(512);
 		toggle_use_dark_theme.set_active(false);
 		toggle_show_file_toolbar.set_active(true);
 		listviewtext_brushes_path->clear_items();
@@ -893,6 +909,7 @@ Dialog_Setup::on_restore_pressed()
 		def_background_color_button.set_rgba(m_color);
 		m_color.set_rgba(0.742187, 0.742187, 0.742187, 1.000000);
 		preview_background_color_button.set_rgba(m_color);
+		adj_preview_memory_limit->set_value(1024);
 		fcbutton_image.unselect_all();
 		
 		toggle_play_sound_on_render_done.set_active(true);
@@ -963,6 +980,9 @@ Dialog_Setup::on_apply_pressed()
 	// Set the advanced and risky flag that keeps the Redo stack on new action, instead of clear it
 	synfigapp::Main::settings().set_value("pref.clear_redo_stack_on_new_action", toggle_clear_redo_stack_on_new_action.get_active());
 
+	// Set the limit of memory used by history
+	synfigapp::Main::settings().set_value("pref.undo_memory_limit", int(adj_undo_memory_limit->get_value()));
+
 	// Set the dark theme flag
 	App::use_dark_theme               = toggle_use_dark_theme.get_active();
 	// Set the icon theme
@@ -1053,6 +1073,9 @@ Dialog_Setup::on_apply_pressed()
 												  m_color.get_blue(),
 												  m_color.get_alpha());
 
+	// Set the memory limit of preview
+	App::preview_memory_limit = int(adj_preview_memory_limit->get_value());
+
 	// Set ui language
 	if (pref_modification_flag & CHANGE_UI_LANGUAGE)
 		App::ui_language = ui_language_combo.get_active_id().c_str();
@@ -1251,6 +1274,9 @@ Dialog_Setup::refresh()
 		toggle_clear_redo_stack_on_new_action.set_active(active);
 	}
 
+	// Refresh the limit of memory used by history
+	adj_undo_memory_limit->set_value(synfigapp::Main::settings().get_value("pref.undo_memory_limit", 512));
+
 	// Refresh the status of the theme flag
 	toggle_use_dark_theme.set_active(App::use_dark_theme);
 	// Refresh the choice of the icon theme
@@ -1282,6 +1308,7 @@ Dialog_Setup::refresh()
 					  App::preview_background_color.get_b(),
 					  App::preview_background_color.get_a());
 	preview_background_color_button.set_rgba(m_color);
+	adj_preview_memory_limit->set_value(App::preview_memory_limit);
 
 	// Refresh the status of file toolbar flag
 	toggle_show_file_toolbar.set_active(App::show_file_toolbar);
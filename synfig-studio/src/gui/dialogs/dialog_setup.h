@@ -135,6 +135,7 @@ class Dialog_Setup : public Dialog_Template
 	Gtk::Switch toggle_animation_thumbnail_preview;
 	Gtk::Switch toggle_enable_experimental_features;
 	Gtk::Switch toggle_clear_redo_stack_on_new_action;
+	Glib::RefPtr<Gtk::Adjustment> adj_undo_memory_limit;
 	Gtk::Switch toggle_use_dark_theme;
 	Gtk::Switch toggle_show_file_toolbar;
 
@@ -172,6 +173,7 @@ class Dialog_Setup : public Dialog_Template
 	Gtk::Switch       toggle_play_sound_on_render_done;
 	Glib::RefPtr<Gtk::Adjustment> adj_number_of_threads;
 	Gtk::SpinButton*  number_of_threads_select;	
+	Glib::RefPtr<Gtk::Adjustment> adj_preview_memory_limit;
 
 	Gtk::Switch toggle_handle_tooltip_widthpoint;
 	Gtk::Switch toggle_handle_tooltip_radius;
@@ -222,6 +222,20 @@ Dock_History::create_action_tree()
 
 		action_tree->append_column(*column);
 	}
+	{
+		Gtk::TreeView::Column* column = Gtk::manage( new Gtk::TreeView::Column(_("Memory")) );
+
+		Gtk::CellRendererText *text_cr=Gtk::manage(new Gtk::CellRendererText());
+		text_cr->property_foreground()=Glib::ustring("#7f7f7f");
+		text_cr->property_xalign()=1.0;
+
+		column->pack_start(*text_cr);
+		column->add_attribute(text_cr->property_text(),history_tree_model.memory);
+		column->add_attribute(text_cr->property_foreground_set(),history_tree_model.is_redo);
+		column->set_resizable();
+
+		action_tree->append_column(*column);
+	}
 
 	action_tree->set_enable_search(true);
 	action_tree->set_search_column(history_tree_model.name);
@@ -184,6 +184,12 @@ Instance::create(synfig::Canvas::Handle canvas, synfig::FileSystem::Handle conta
 		instance->set_clear_redo_stack_on_new_action(active);
 	}
 
+	// Set the user preference regarding memory used by history
+	{
+		int limit = synfigapp::Main::settings().get_value("pref.undo_memory_limit", 512);
+		instance->set_max_memory(limit > 0 ? (size_t)limit << 20 : 0);
+	}
+
 	// Add the new instance to the application's instance list
 	App::instance_list.push_back(instance);
 
@@ -33,6 +33,8 @@
 #	include <config.h>
 #endif
 
+#include <cstdlib>
+
 #include <glibmm/convert.h>
 
 #include <ETL/stringf>
@@ -41,6 +43,10 @@
 #include <gui/exception_guard.h>
 #include <gui/localization.h>
 
+#include <synfig/clock.h>
+#include <synfigapp/main.h>
+#include <synfigapp/vectorizer/vectorizerbatch.h>
+
 #include <iostream>
 
 #endif
@@ -56,6 +62,60 @@ using namespace studio;
 
 /* === P R O C E D U R E S ================================================= */
 
+// Centerline vectorization of image files without the GUI:
+//   synfigstudio --vectorize [--threshold N] [--accuracy N] [--despeckling N] [--maxthickness N] image...
+// options have the same units and defaults as the vectorizer dialog,
+// each image is saved as a composition with the same name and .sif extension
+static int vectorize_images(const String &rootpath, int argc, char **argv)
+{
+	int threshold = 8, accuracy = 9, despeckling = 5, maxthickness = 200;
+	std::vector<studio::VectorizerBatch::Frame> frames;
+	for (int i = 0; i < argc; ++i) {
+		const String arg(argv[i]);
+		if      (arg == "--threshold"    && i + 1 < argc) threshold    = atoi(argv[++i]);
+		else if (arg == "--accuracy"     && i + 1 < argc) accuracy     = atoi(argv[++i]);
+		else if (arg == "--despeckling"  && i + 1 < argc) despeckling  = atoi(argv[++i]);
+		else if (arg == "--maxthickness" && i + 1 < argc) maxthickness = atoi(argv[++i]);
+		else frames.push_back(studio::VectorizerBatch::Frame(arg, etl::filename_sans_extension(arg) + ".sif"));
+	}
+	if (frames.empty()) {
+		std::cerr << _("Usage: synfigstudio --vectorize [--threshold N] [--accuracy N] [--despeckling N] [--maxthickness N] image...") << std::endl;
+		return 1;
+	}
+
+	// the same conversion as in VectorizerSettings::on_convert_pressed()
+	studio::CenterlineConfiguration configuration;
+	configuration.m_threshold      = threshold * 25;
+	configuration.m_penalty        = 10 - accuracy;
+	configuration.m_despeckling    = despeckling * 2;
+	configuration.m_maxThickness   = maxthickness / 2;
+	configuration.m_thicknessRatio = 1.0;
+
+	synfigapp::Main synfigapp_main(rootpath);
+
+	synfig::clock timer;
+	int failed = studio::VectorizerBatch::vectorizeSequence(frames, configuration);
+	float seconds = timer();
+
+	studio::VectorizerTimes times;
+	for (const auto& frame : frames) {
+		if (frame.success)
+			std::cout << frame.input << " -> " << frame.output
+					  << strprintf(_(" (%f s: polygonize %f s, skeletonize %f s, organize %f s, strokes %f s)"),
+							frame.times.total(), frame.times.polygonize, frame.times.skeletonize,
+							frame.times.organize, frame.times.strokes)
+					  << std::endl;
+		else
+			std::cerr << frame.input << ": " << frame.errors << std::endl;
+		times += frame.times;
+	}
+	std::cout << strprintf(_("Vectorized %d of %d images in %f s (polygonize %f s, skeletonize %f s, organize %f s, strokes %f s in total)"),
+		(int)frames.size() - failed, (int)frames.size(), seconds,
+		times.polygonize, times.skeletonize, times.organize, times.strokes) << std::endl;
+
+	return failed ? 1 : 0;
+}
+
 /* === M E T H O D S ======================================================= */
 
 /* === E N T R Y P O I N T ================================================= */
@@ -75,10 +135,13 @@ int main(int argc, char **argv)
 	textdomain(GETTEXT_PACKAGE);
 #endif
 	
+	SYNFIG_EXCEPTION_GUARD_BEGIN()
+
+	if (argc > 1 && String(argv[1]) == "--vectorize")
+		return vectorize_images(rootpath, argc - 2, argv + 2);
+
 	std::cout << std::endl;
 	std::cout << "   " << _("synfig studio -- starting up application...") << std::endl << std::endl;
-
-	SYNFIG_EXCEPTION_GUARD_BEGIN()
 	
 	Glib::RefPtr<studio::App> app = studio::App::instance();
 
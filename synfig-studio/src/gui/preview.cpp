@@ -37,6 +37,13 @@
 
 #include <gui/preview.h>
 
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+
 #include <gdkmm/general.h>
 
 #include <gtkmm/alignment.h>
@@ -51,7 +58,9 @@
 
 #include <synfig/string.h>
 #include <synfig/surface.h>
-#include <synfig/target_scanline.h>
+#include <synfig/target_tile.h>
+#include <synfig/threadpool.h>
+#include <synfig/zstreambuf.h>
 
 #endif
 
@@ -66,42 +75,130 @@ using namespace studio;
 
 /* === P R O C E D U R E S ================================================= */
 
+namespace {
+	//! Count of frames decoded in background ahead of the shown one
+	const int decode_ahead = 4;
+
+	void free_guint8(const guint8 *mem)
+	{
+		free((void*)mem);
+	}
+
+	//! Converts the surface to RGB and compresses it.
+	//! Each row is stored as difference from the previous one,
+	//! so flat and smoothly shaded areas are packed much better.
+	bool encode_frame(Preview::FlipbookElem &fe, const Surface &surface)
+	{
+		const int w = surface.get_w(), h = surface.get_h();
+		const size_t stride = w*3;
+		std::vector<unsigned char> buffer(stride*h);
+		if (buffer.empty())
+			return false;
+		color_to_pixelformat(&buffer.front(), surface[0], PF_RGB, 0, w, h);
+
+		for(int y = h - 1; y > 0; --y)
+		{
+			unsigned char *row = &buffer[y*stride];
+			const unsigned char *prev = row - stride;
+			for(size_t i = 0; i < stride; ++i)
+				row[i] -= prev[i];
+		}
+
+		// fixed Huffman codes may expand the noisy data a little
+		std::shared_ptr<std::vector<char> > data(new std::vector<char>(buffer.size() + buffer.size()/4 + 64));
+		size_t size = zstreambuf::pack(&data->front(), data->size(), &buffer.front(), buffer.size(), true);
+		if (!size || size >= data->size())
+			return false;
+		data->resize(size);
+		data->shrink_to_fit();
+
+		fe.w = w;
+		fe.h = h;
+		fe.data = data;
+		return true;
+	}
+
+	//! Returns RGB buffer allocated by malloc() or null
+	guint8* decode_frame(const Preview::FlipbookElem &fe)
+	{
+		const size_t stride = fe.w*3;
+		const size_t size = stride*fe.h;
+		if (!fe.data || !size)
+			return nullptr;
+
+		guint8 *buffer = (guint8*)malloc(size);
+		if (!buffer)
+			return nullptr;
+		if (zstreambuf::unpack(buffer, size, &fe.data->front(), fe.data->size()) != size)
+		{
+			free(buffer);
+			return nullptr;
+		}
+
+		for(int y = 1; y < fe.h; ++y)
+		{
+			guint8 *row = buffer + y*stride;
+			const guint8 *prev = row - stride;
+			for(size_t i = 0; i < stride; ++i)
+				row[i] += prev[i];
+		}
+		return buffer;
+	}
+}
+
 /* === M E T H O D S ======================================================= */
 
 /* === E N T R Y P O I N T ================================================= */
 
-class studio::Preview::Preview_Target : public Target_Scanline
+//! Tiles are rendered simultaneously by the AsyncRenderer,
+//! complete frames are compressed in the render thread
+//! and passed to the GUI thread through the dispatcher
+class studio::Preview::Preview_Target : public Target_Tile
 {
 	Surface	surface;
 
-	sigc::signal<void, const Preview_Target *>		signal_frame_done_;
-
-	int scanline;
+	sigc::signal<void, const FlipbookElem &>		signal_frame_done_;
 
 	double	tbegin,tend;
 
 	int		nframes,curframe;
 
+	size_t	memory_limit;
+	size_t	memory_used;
+
+	std::mutex mutex;
+	std::deque<FlipbookElem> ready_frames;
+	Glib::Dispatcher frame_ready;
+
+	void on_frame_ready()
+	{
+		std::deque<FlipbookElem> frames;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			frames.swap(ready_frames);
+		}
+		for(std::deque<FlipbookElem>::const_iterator i = frames.begin(); i != frames.end(); ++i)
+			signal_frame_done_(*i);
+	}
+
 public:
 
-	Preview_Target()
+	explicit Preview_Target(size_t memory_limit):
+		memory_limit(memory_limit),
+		memory_used()
 	{
 		set_alpha_mode(TARGET_ALPHA_MODE_FILL);
 		tbegin   = tend     = 0;
-		scanline            = 0;
 		nframes  = curframe = 0;
+		frame_ready.connect(sigc::mem_fun(*this, &Preview_Target::on_frame_ready));
 	}
 
 	const RendDesc &get_rend_desc() const { return desc; }
 
 	virtual bool set_rend_desc(RendDesc *r)
 	{
-		if(Target_Scanline::set_rend_desc(r))
+		if(Target_Tile::set_rend_desc(r))
 		{
-			/*synfig::warning("Succeeded in setting the desc to new one: %d x %d, %.2f fps [%.2f,%.2f]",
-							desc.get_w(),desc.get_h(),desc.get_frame_rate(),
-					(float)desc.get_time_start(),(float)desc.get_time_end());*/
-
 			surface.set_wh(desc.get_w(), desc.get_h());
 
 			curframe = 0;
@@ -117,27 +214,39 @@ public:
 
 	virtual bool start_frame(ProgressCallback* /*cb*/=nullptr)
 	{
+		if (memory_used > memory_limit)
+		{
+			synfig::warning("Preview: memory limit of %d MB is reached, rendering stopped at %.3f s",
+				(int)(memory_limit >> 20), get_time());
+			return false;
+		}
 		return true;
 	}
 
-	virtual void end_frame()
+	virtual bool add_tile(const synfig::Surface &tile, int x, int y)
 	{
-		//ok... notify our subscribers...
-		signal_frame_done_(this);
-		curframe += 1;
-		//synfig::warning("Finished the frame stuff, and changed time to %.3f",t);
+		int w = std::min(tile.get_w(), surface.get_w() - x);
+		int h = std::min(tile.get_h(), surface.get_h() - y);
+		for(int j = 0; j < h; ++j)
+			memcpy(surface[y + j] + x, tile[j], w*sizeof(Color));
+		return true;
 	}
 
-	virtual Color * start_scanline(int scanline)
+	virtual void end_frame()
 	{
-		return surface[scanline];
+		FlipbookElem fe;
+		fe.t = get_time();
+		if (encode_frame(fe, surface))
+		{
+			memory_used += fe.get_size();
+			std::lock_guard<std::mutex> lock(mutex);
+			ready_frames.push_back(fe);
+		}
+		frame_ready.emit();
+		curframe += 1;
 	}
 
-	virtual bool end_scanline() {return true;}
-
-	sigc::signal<void, const Preview_Target *>	&signal_frame_done() {return signal_frame_done_;}
-
-	const Surface &get_surface() const {return surface;}
+	sigc::signal<void, const FlipbookElem &>	&signal_frame_done() {return signal_frame_done_;}
 
 	float get_time() const
 	{
@@ -147,6 +256,35 @@ public:
 	}
 };
 
+struct studio::Preview::DecodeCache
+{
+	std::mutex mutex;
+	int position;
+	std::map<int, guint8*> frames;
+	std::set<int> pending;
+
+	DecodeCache(): position() { }
+	~DecodeCache()
+	{
+		for(std::map<int, guint8*>::iterator i = frames.begin(); i != frames.end(); ++i)
+			free(i->second);
+	}
+
+	bool wanted(int index) const
+		{ return index >= position && index <= position + decode_ahead; }
+
+	static void decode_task(std::shared_ptr<DecodeCache> cache, int index, FlipbookElem fe)
+	{
+		guint8 *buffer = decode_frame(fe);
+		std::lock_guard<std::mutex> lock(cache->mutex);
+		cache->pending.erase(index);
+		if (buffer && cache->wanted(index) && !cache->frames.count(index))
+			cache->frames[index] = buffer;
+		else
+			free(buffer);
+	}
+};
+
 studio::Preview::Preview(const etl::loose_handle<CanvasView> &h, float zoom, float f):
 	canvasview(h),
 	zoom(zoom),
@@ -157,7 +295,11 @@ studio::Preview::Preview(const etl::loose_handle<CanvasView> &h, float zoom, flo
 	overbegin(false),
 	overend(false),
 	quality(),
-	global_fps()
+	global_fps(),
+	memory_limit((size_t)App::preview_memory_limit << 20),
+	memory_used(),
+	decode_cache(new DecodeCache()),
+	current_index(-1)
 { }
 
 void studio::Preview::set_canvasview(const etl::loose_handle<CanvasView> &h)
@@ -227,8 +369,9 @@ void studio::Preview::render()
 		desc.set_time_end(desc.get_time_end() + 1.000001/fps);
 
 		// Render using a Preview target
-		etl::handle<Preview_Target> target = new Preview_Target;
-		target->signal_frame_done().connect(sigc::mem_fun(*this, &Preview::frame_finish));
+		etl::handle<Preview_Target> target = new Preview_Target(memory_limit);
+		frame_done_connection.disconnect();
+		frame_done_connection = target->signal_frame_done().connect(sigc::mem_fun(*this, &Preview::frame_finish));
 
 		//set the options
 		target->set_canvas(get_canvas());
@@ -237,7 +380,7 @@ void studio::Preview::render()
 		target->set_rend_desc(&desc);
 
 		//... first we must clear our current selves of space
-		frames.resize(0);
+		clear();
 
 		//now tell it to go... with inherited prog. reporting...
 		if(renderer) renderer->stop();
@@ -249,65 +392,85 @@ void studio::Preview::render()
 void studio::Preview::clear()
 {
 	frames.clear();
+	memory_used = 0;
+	// background tasks keep the old cache until they finish
+	decode_cache.reset(new DecodeCache());
+	current_frame.reset();
+	current_index = -1;
 }
 
-const etl::handle<synfig::Canvas>&
-studio::Preview::get_canvas() const
-	{return canvasview->get_canvas();}
-
-const etl::loose_handle<CanvasView>&
-studio::Preview::get_canvasview() const
-	{return canvasview;}
-
-static void free_guint8(const guint8 *mem)
-{
-	free((void*)mem);
-}
-
-void studio::Preview::frame_finish(const Preview_Target *targ)
+Glib::RefPtr<Gdk::Pixbuf>
+studio::Preview::get_frame(int index)
 {
-	//copy image with time to next frame (can just push back)
-	FlipbookElem	fe;
-	float           time = targ->get_time();
-	const Surface&  surf = targ->get_surface();
-	const RendDesc& r    = targ->get_rend_desc();
+	if (index < 0 || index >= (int)frames.size())
+		return Glib::RefPtr<Gdk::Pixbuf>();
+	if (index == current_index && current_frame)
+		return current_frame;
 
-	//synfig::warning("Finished a frame at %f s",time);
+	guint8 *buffer = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(decode_cache->mutex);
+		decode_cache->position = index;
+		for(std::map<int, guint8*>::iterator i = decode_cache->frames.begin(); i != decode_cache->frames.end();)
+		{
+			if (i->first == index)
+				buffer = i->second;
+			else
+			if (!decode_cache->wanted(i->first))
+				free(i->second);
+			else
+				{ ++i; continue; }
+			decode_cache->frames.erase(i++);
+		}
+	}
 
-	//copy EVERYTHING!
-	PixelFormat pf(PF_RGB);
+	const FlipbookElem &fe = frames[index];
+	if (!buffer)
+		buffer = decode_frame(fe);
+	if (!buffer)
+		return Glib::RefPtr<Gdk::Pixbuf>();
 
-	const int total_bytes(r.get_w() * r.get_h() * synfig::pixel_size(pf));
+	//uses and manages the memory for the buffer...
+	current_frame = Gdk::Pixbuf::create_from_data(
+		buffer,                 // pointer to the data
+		Gdk::COLORSPACE_RGB,    // the colorspace
+		false,                  // has alpha?
+		8,                      // bits per sample
+		fe.w,                   // width
+		fe.h,                   // height
+		fe.w * 3,               // stride (pitch)
+		sigc::ptr_fun(free_guint8)
+	);
+	current_index = index;
 
-	//synfig::warning("Creating a buffer");
-	unsigned char *buffer((unsigned char*)malloc(total_bytes));
+	//decode the following frames while this one is shown
+	for(int i = index + 1; i <= index + decode_ahead && i < (int)frames.size(); ++i)
+	{
+		{
+			std::lock_guard<std::mutex> lock(decode_cache->mutex);
+			if (decode_cache->frames.count(i) || decode_cache->pending.count(i))
+				continue;
+			decode_cache->pending.insert(i);
+		}
+		ThreadPool::instance().enqueue(sigc::bind(
+			sigc::ptr_fun(&DecodeCache::decode_task), decode_cache, i, frames[i] ));
+	}
 
-	if(!buffer)
-		return;
+	return current_frame;
+}
 
-	//convert all the pixels to the pixbuf... buffer... thing...
-	//synfig::warning("Converting...");
-	color_to_pixelformat(buffer, surf[0], pf, 0, surf.get_w(), surf.get_h());
+const etl::handle<synfig::Canvas>&
+studio::Preview::get_canvas() const
+	{return canvasview->get_canvas();}
 
-	//load time
-	fe.t = time;
-	//uses and manages the memory for the buffer...
-	//synfig::warning("Create a pixmap...");
-	fe.buf =
-	Gdk::Pixbuf::create_from_data(
-		buffer,	                               // pointer to the data
-		Gdk::COLORSPACE_RGB,                   // the colorspace
-		((pf & PF_A) == PF_A),                 // has alpha?
-		8,                                     // bits per sample
-		surf.get_w(),                          // width
-		surf.get_h(),                          // height
-		surf.get_w() * synfig::pixel_size(pf), // stride (pitch)
-		sigc::ptr_fun(free_guint8)
-	);
+const etl::loose_handle<CanvasView>&
+studio::Preview::get_canvasview() const
+	{return canvasview;}
 
+void studio::Preview::frame_finish(const FlipbookElem &fe)
+{
 	//add the flipbook element to the list (assume time is correct)
-	//synfig::info("Prev: Adding %f s to the list", time);
-	frames.push_back(fe);
+	push_back(fe);
 
 	signal_changed()();
 }
@@ -612,8 +775,8 @@ void studio::Widget_Preview::update()
 				timedisp = -1;
 			}else
 			{
-				currentbuf = i->buf;
 				currentindex = i-beg;
+				currentbuf = preview->get_frame(currentindex);
 				if(timedisp != i->t)
 				{
 					timedisp = i->t;
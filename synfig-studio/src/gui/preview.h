@@ -55,6 +55,7 @@
 #include <synfig/soundprocessor.h>
 #include <synfig/time.h>
 
+#include <memory>
 #include <vector>
 
 /* === M A C R O S ========================================================= */
@@ -70,22 +71,16 @@ class CanvasView;
 class Preview : public sigc::trackable, public etl::shared_object
 {
 public:
+	//! Rendered frame, pixels are kept compressed, see get_frame()
 	class FlipbookElem
 	{
 	public:
 		float t;
-		Glib::RefPtr<Gdk::Pixbuf> buf; //at whatever resolution they are rendered at (resized at run time)
-		cairo_surface_t* surface;
-		FlipbookElem(): t(), surface(nullptr) { }
-		//Copy constructor
-		FlipbookElem(const FlipbookElem& other): t(other.t) ,buf(other.buf), surface(cairo_surface_reference(other.surface))
-		{
-		}
-		~FlipbookElem()
-		{
-			if(surface)
-				cairo_surface_destroy(surface);
-		}
+		int w, h;
+		//! RGB rows stored as difference from the previous row and packed by zlib
+		std::shared_ptr<const std::vector<char> > data;
+		FlipbookElem(): t(), w(), h() { }
+		size_t get_size() const { return data ? data->size() : 0; }
 	};
 
 	etl::handle<studio::AsyncRenderer>	renderer;
@@ -108,9 +103,19 @@ private:
 
 	float	global_fps;
 
+	size_t	memory_limit;
+	size_t	memory_used;
+
+	//frames decoded ahead in background for playback
+	struct DecodeCache;
+	std::shared_ptr<DecodeCache> decode_cache;
+	Glib::RefPtr<Gdk::Pixbuf> current_frame;
+	int		current_index;
+
 	//expose the frame information etc.
 	class Preview_Target;
-	void frame_finish(const Preview_Target *);
+	sigc::connection frame_done_connection;
+	void frame_finish(const FlipbookElem &fe);
 
 	sigc::signal0<void>	sig_changed;
 
@@ -162,6 +167,11 @@ public:
 	int		get_quality() const {return quality;}
 	void	set_quality(int i)	{quality = i;}
 
+	//! Rendering stops when compressed frames take more bytes than the limit
+	size_t	get_memory_limit() const {return memory_limit;}
+	void	set_memory_limit(size_t x) {memory_limit = x;}
+	size_t	get_memory_used() const {return memory_used;}
+
 	const etl::handle<synfig::Canvas>& get_canvas() const;
 	const etl::loose_handle<CanvasView>& get_canvasview() const;
 
@@ -177,13 +187,16 @@ public:
 
 	FlipBook::const_iterator	begin() const {return frames.begin();}
 	FlipBook::const_iterator	end() const	  {return frames.end();}
-	void push_back(FlipbookElem fe) { frames.push_back(fe); }
+	void push_back(const FlipbookElem &fe) { frames.push_back(fe); memory_used += fe.get_size(); }
 	// Used to clear the FlipBook. Do not use directly the std::vector<>::clear member
-	// because the cairo_surface_t* wouldn't be destroyed.
+	// because the decoded frames and the memory counter wouldn't be reset.
 	void clear();
 	
 	unsigned int				numframes() const  {return frames.size();}
 
+	//! Decodes the frame and starts decoding of the following frames in background
+	Glib::RefPtr<Gdk::Pixbuf> get_frame(int index);
+
 	void render();
 
 	sigc::signal0<void>	&signal_changed() { return sig_changed; }
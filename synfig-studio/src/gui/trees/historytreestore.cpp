@@ -54,6 +54,16 @@ using namespace studio;
 
 /* === P R O C E D U R E S ================================================= */
 
+static Glib::ustring
+format_memory(size_t size)
+{
+	if (size < 1024)
+		return strprintf(_("%d B"), (int)size);
+	if (size < 1024*1024)
+		return strprintf(_("%.1f KB"), size/1024.0);
+	return strprintf(_("%.1f MB"), size/(1024.0*1024.0));
+}
+
 /* === M E T H O D S ======================================================= */
 
 static HistoryTreeStore::Model& ModelHack()
@@ -72,6 +82,7 @@ HistoryTreeStore::HistoryTreeStore(etl::loose_handle<studio::Instance> instance_
 	instance_->signal_redo().connect(sigc::mem_fun(*this,&studio::HistoryTreeStore::on_redo));
 	instance_->signal_undo_stack_cleared().connect(sigc::mem_fun(*this,&studio::HistoryTreeStore::on_undo_stack_cleared));
 	instance_->signal_redo_stack_cleared().connect(sigc::mem_fun(*this,&studio::HistoryTreeStore::on_redo_stack_cleared));
+	instance_->signal_undo_stack_trimmed().connect(sigc::mem_fun(*this,&studio::HistoryTreeStore::on_undo_stack_trimmed));
 	instance_->signal_new_action().connect(sigc::mem_fun(*this,&studio::HistoryTreeStore::on_new_action));
 	instance_->signal_action_status_changed().connect(sigc::mem_fun(*this,&studio::HistoryTreeStore::on_action_status_changed));
 }
@@ -120,6 +131,7 @@ HistoryTreeStore::insert_action(Gtk::TreeRow row,etl::handle<synfigapp::Action::
 	row[model.is_active] = action->is_active();
 	row[model.is_undo] = is_undo;
 	row[model.is_redo] = is_redo;
+	row[model.memory] = format_memory(action->get_memory_usage());
 
 	synfigapp::Action::CanvasSpecific *specific_action;
 	specific_action=dynamic_cast<synfigapp::Action::CanvasSpecific*>(action.get());
@@ -206,6 +218,19 @@ HistoryTreeStore::on_redo_stack_cleared()
 	next_action_iter = children_.end();
 }
 
+void
+HistoryTreeStore::on_undo_stack_trimmed(int count)
+{
+	// the oldest actions are at the top
+	Gtk::TreeModel::Children children_(children());
+	Gtk::TreeModel::Children::iterator iter = children_.begin();
+
+	for(int i = 0; i < count && iter != children_.end() && iter != next_action_iter; ++i)
+		iter = erase(iter);
+
+	signal_undo_tree_changed()();
+}
+
 void
 HistoryTreeStore::on_new_action(etl::handle<synfigapp::Action::Undoable> action)
 {
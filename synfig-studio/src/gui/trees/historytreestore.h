@@ -62,6 +62,7 @@ public:
 		Gtk::TreeModelColumn<bool> is_active;
 		Gtk::TreeModelColumn<bool> is_undo;
 		Gtk::TreeModelColumn<bool> is_redo;
+		Gtk::TreeModelColumn<Glib::ustring> memory;
 
 		Gtk::TreeModelColumn<Glib::ustring> canvas_id;
 		Gtk::TreeModelColumn<synfig::Canvas::Handle> canvas;
@@ -74,6 +75,7 @@ public:
 			add(is_active);
 			add(is_undo);
 			add(is_redo);
+			add(memory);
 			add(canvas_id);
 			add(canvas);
 		}
@@ -135,6 +137,8 @@ private:
 
 	void on_redo_stack_cleared();
 
+	void on_undo_stack_trimmed(int count);
+
 	void on_new_action(etl::handle<synfigapp::Action::Undoable> action);
 
 	void on_action_status_changed(etl::handle<synfigapp::Action::Undoable> action);
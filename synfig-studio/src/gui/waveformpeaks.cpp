@@ -0,0 +1,288 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file waveformpeaks.cpp
+**	\brief Multi-level min/max peaks of an audio track
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#ifdef USING_PCH
+#	include "pch.h"
+#else
+# ifdef HAVE_CONFIG_H
+#  include <config.h>
+# endif
+
+# include <algorithm>
+# include <cmath>
+# include <cstdint>
+# include <cstdio>
+# include <cstring>
+
+# include <glib.h>
+# include <glib/gstdio.h>
+
+# include "waveformpeaks.h"
+
+#endif
+
+/* === U S I N G =========================================================== */
+
+using namespace studio;
+
+/* === M A C R O S ========================================================= */
+
+/* === G L O B A L S ======================================================= */
+
+namespace {
+	const char cache_magic[8] = { 'S', 'Y', 'N', 'F', 'I', 'G', 'W', 'P' };
+	const std::int32_t cache_version = 1;
+	const char cache_extension[] = ".peaks";
+}
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+	bool get_file_info(const std::string &filename, std::int64_t &mtime, std::int64_t &size)
+	{
+		GStatBuf info;
+		if (filename.empty() || g_stat(filename.c_str(), &info) != 0)
+			return false;
+		mtime = (std::int64_t)info.st_mtime;
+		size = (std::int64_t)info.st_size;
+		return true;
+	}
+
+	template<typename T>
+	bool write_value(FILE *file, const T &x)
+		{ return fwrite(&x, sizeof(x), 1, file) == 1; }
+
+	template<typename T>
+	bool read_value(FILE *file, T &x)
+		{ return fread(&x, sizeof(x), 1, file) == 1; }
+}
+
+/* === M E T H O D S ======================================================= */
+
+WaveformPeaks::WaveformPeaks():
+	frequency(),
+	channels(),
+	samples(),
+	block_samples()
+{ }
+
+void
+WaveformPeaks::reset(int frequency, int channels)
+{
+	this->frequency = std::max(0, frequency);
+	this->channels = std::max(0, channels);
+	samples = 0;
+	levels.clear();
+	block.assign(this->channels, Peak());
+	block_samples = 0;
+}
+
+void
+WaveformPeaks::add_samples(const unsigned char *data, int count)
+{
+	if (!data || count <= 0 || channels <= 0)
+		return;
+	if (levels.empty())
+		levels.resize(1);
+
+	std::vector<Peak> &level = levels.front();
+	for(int i = 0; i < count; ++i, data += channels)
+	{
+		for(int c = 0; c < channels; ++c)
+			block[c].add(data[c]);
+		if (++block_samples == BLOCK_SIZE)
+		{
+			level.insert(level.end(), block.begin(), block.end());
+			block.assign(channels, Peak());
+			block_samples = 0;
+		}
+	}
+	samples += count;
+}
+
+void
+WaveformPeaks::finish()
+{
+	if (block_samples > 0)
+	{
+		if (levels.empty())
+			levels.resize(1);
+		levels.front().insert(levels.front().end(), block.begin(), block.end());
+		block.assign(channels, Peak());
+		block_samples = 0;
+	}
+	build_levels();
+}
+
+void
+WaveformPeaks::build_levels()
+{
+	if (levels.empty() || channels <= 0)
+		return;
+	levels.resize(1);
+
+	while(levels.back().size() > (size_t)channels)
+	{
+		const std::vector<Peak> &src = levels.back();
+		size_t src_blocks = src.size()/channels;
+		std::vector<Peak> dst(((src_blocks + 1)/2)*channels);
+		for(size_t i = 0; i < src_blocks; ++i)
+			for(int c = 0; c < channels; ++c)
+				dst[(i/2)*channels + c].merge(src[i*channels + c]);
+		levels.push_back(std::vector<Peak>());
+		levels.back().swap(dst);
+	}
+}
+
+void
+WaveformPeaks::swap(WaveformPeaks &other)
+{
+	std::swap(frequency, other.frequency);
+	std::swap(channels, other.channels);
+	std::swap(samples, other.samples);
+	levels.swap(other.levels);
+	block.swap(other.block);
+	std::swap(block_samples, other.block_samples);
+}
+
+WaveformPeaks::Peak
+WaveformPeaks::get_peak(int channel, double begin, double end) const
+{
+	if (empty() || channel < 0 || channel >= channels)
+		return Peak();
+
+	begin = std::max(begin, 0.0);
+	end = std::min(end, (double)samples);
+	if (!(begin < end))
+		return Peak();
+
+	// the coarsest level with blocks not longer than the range,
+	// so the range covers two or three blocks at most
+	double count = end - begin;
+	size_t level = 0;
+	while(level + 1 < levels.size() && (double)((long long)BLOCK_SIZE << (level + 1)) <= count)
+		++level;
+
+	const std::vector<Peak> &peaks = levels[level];
+	double block_size = (double)((long long)BLOCK_SIZE << level);
+	long long blocks = (long long)(peaks.size()/channels);
+	long long first = std::min(blocks, (long long)std::floor(begin/block_size));
+	long long last = std::min(blocks, (long long)std::ceil(end/block_size));
+
+	Peak peak;
+	for(long long i = first; i < last; ++i)
+		peak.merge(peaks[i*channels + channel]);
+	return peak;
+}
+
+std::string
+WaveformPeaks::get_cache_filename(const std::string &audio_filename)
+	{ return audio_filename + cache_extension; }
+
+bool
+WaveformPeaks::save(const std::string &filename, const std::string &audio_filename) const
+{
+	static_assert(sizeof(Peak) == 2, "Peak must be stored as two bytes");
+
+	if (empty())
+		return false;
+	std::int64_t mtime, size;
+	if (!get_file_info(audio_filename, mtime, size))
+		return false;
+
+	// g_fopen() accepts UTF-8 names on Windows too
+	FILE *file = g_fopen(filename.c_str(), "wb");
+	if (!file)
+		return false;
+
+	// upper levels are cheap to rebuild, so only the first one is stored
+	const std::vector<Peak> &peaks = levels.front();
+	bool success =
+	     fwrite(cache_magic, sizeof(cache_magic), 1, file) == 1
+	  && write_value(file, cache_version)
+	  && write_value(file, size)
+	  && write_value(file, mtime)
+	  && write_value(file, (std::int32_t)frequency)
+	  && write_value(file, (std::int32_t)channels)
+	  && write_value(file, (std::int64_t)samples)
+	  && write_value(file, (std::int64_t)peaks.size())
+	  && fwrite(peaks.data(), sizeof(Peak), peaks.size(), file) == peaks.size();
+	if (fclose(file) != 0)
+		success = false;
+
+	if (!success)
+	{
+		g_remove(filename.c_str());
+		return false;
+	}
+	return true;
+}
+
+bool
+WaveformPeaks::load(const std::string &filename, const std::string &audio_filename)
+{
+	clear();
+
+	std::int64_t mtime, size;
+	if (!get_file_info(audio_filename, mtime, size))
+		return false;
+
+	FILE *file = g_fopen(filename.c_str(), "rb");
+	if (!file)
+		return false;
+
+	char magic[sizeof(cache_magic)];
+	std::int32_t version, file_frequency, file_channels;
+	std::int64_t file_size, file_mtime, file_samples, count;
+	std::vector<Peak> peaks;
+	bool success =
+	     fread(magic, sizeof(magic), 1, file) == 1
+	  && memcmp(magic, cache_magic, sizeof(magic)) == 0
+	  && read_value(file, version) && version == cache_version
+	  && read_value(file, file_size) && file_size == size
+	  && read_value(file, file_mtime) && file_mtime == mtime
+	  && read_value(file, file_frequency) && file_frequency > 0
+	  && read_value(file, file_channels) && file_channels > 0
+	  && read_value(file, file_samples) && file_samples > 0
+	  && read_value(file, count)
+	  && count == (file_samples + BLOCK_SIZE - 1)/BLOCK_SIZE*file_channels;
+	if (success)
+	{
+		peaks.resize(count);
+		success = fread(peaks.data(), sizeof(Peak), peaks.size(), file) == peaks.size();
+	}
+	fclose(file);
+	if (!success)
+		return false;
+
+	reset(file_frequency, file_channels);
+	samples = file_samples;
+	levels.resize(1);
+	levels.front().swap(peaks);
+	build_levels();
+	return true;
+}
+
+/* === E N T R Y P O I N T ================================================= */
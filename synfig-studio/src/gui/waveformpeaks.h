@@ -0,0 +1,117 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file waveformpeaks.h
+**	\brief Multi-level min/max peaks of an audio track
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === S T A R T =========================================================== */
+
+#ifndef __SYNFIG_STUDIO_WAVEFORMPEAKS_H
+#define __SYNFIG_STUDIO_WAVEFORMPEAKS_H
+
+/* === H E A D E R S ======================================================= */
+
+#include <string>
+#include <vector>
+
+/* === M A C R O S ========================================================= */
+
+/* === T Y P E D E F S ===================================================== */
+
+/* === C L A S S E S & S T R U C T S ======================================= */
+
+namespace studio {
+
+//! Pyramid of min/max values of unsigned 8-bit audio samples.
+/*! The first level keeps one peak per BLOCK_SIZE samples of each channel,
+**  every next level merges pairs of peaks of the previous one.
+**  So get_peak() reads only a few peaks for any length of the range,
+**  and drawing of the whole track at any zoom is proportional to its width in pixels.
+*/
+class WaveformPeaks
+{
+public:
+	enum { BLOCK_SIZE = 64 };
+
+	struct Peak
+	{
+		unsigned char min, max;
+
+		Peak(): min(255), max(0) { }
+		Peak(unsigned char min, unsigned char max): min(min), max(max) { }
+
+		bool empty() const { return min > max; }
+		void add(unsigned char x)
+			{ if (x < min) min = x; if (x > max) max = x; }
+		void merge(const Peak &other)
+			{ if (other.min < min) min = other.min; if (other.max > max) max = other.max; }
+	};
+
+private:
+	int frequency;
+	int channels;
+	long long samples;
+
+	//! levels[i] keeps peaks of (BLOCK_SIZE << i) samples, interleaved by channel
+	std::vector< std::vector<Peak> > levels;
+
+	//! unfinished block of the first level, see add_samples()
+	std::vector<Peak> block;
+	int block_samples;
+
+	void build_levels();
+
+public:
+	WaveformPeaks();
+
+	//! Removes all peaks and prepares to receive samples of the new format
+	void reset(int frequency, int channels);
+	void clear() { reset(0, 0); }
+
+	//! Appends interleaved samples, \a count is a number of samples per channel
+	void add_samples(const unsigned char *data, int count);
+	//! Flushes the last incomplete block and builds the upper levels
+	void finish();
+
+	void swap(WaveformPeaks &other);
+
+	bool empty() const { return levels.empty() || levels.front().empty(); }
+	int get_frequency() const { return frequency; }
+	int get_channels() const { return channels; }
+	long long get_samples() const { return samples; }
+
+	//! Returns min/max of the channel between two sample positions,
+	//! the result is empty if the range is out of the track
+	Peak get_peak(int channel, double begin, double end) const;
+
+	//! File name of the peaks cache stored next to the audio file
+	static std::string get_cache_filename(const std::string &audio_filename);
+
+	//! Writes the cache, it remembers size and modification time of the audio file
+	bool save(const std::string &filename, const std::string &audio_filename) const;
+	//! Reads the cache, fails if the audio file was changed after saving
+	bool load(const std::string &filename, const std::string &audio_filename);
+};
+
+}; // END of namespace studio
+
+/* === E N D =============================================================== */
+
+#endif
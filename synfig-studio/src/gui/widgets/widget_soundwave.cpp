@@ -32,9 +32,16 @@
 
 #include <gui/widgets/widget_soundwave.h>
 
+#include <algorithm>
+#include <atomic>
+
 #include <cairomm/cairomm.h>
 #include <gdkmm.h>
 #include <glibmm/convert.h>
+#include <glibmm/main.h>
+
+#include <sigc++/bind.h>
+#include <sigc++/functors/ptr_fun.h>
 
 #include <gui/exception_guard.h>
 #include <gui/helpers.h>
@@ -46,6 +53,7 @@
 #endif
 
 #include <synfig/general.h>
+#include <synfig/threadpool.h>
 
 #endif
 
@@ -54,13 +62,59 @@ using namespace studio;
 const int default_frequency = 48000;
 const int default_n_channels = 2;
 
+//! interval of checking if the peaks are decoded, in milliseconds
+const int load_check_interval = 100;
+
+//! count of track frames decoded by one task of the ThreadPool
+const int load_chunk_frames = 250;
+
+//! Decoding of peaks in the ThreadPool.
+//! Each task decodes a chunk of the track and enqueues the next one,
+//! so a long track doesn't occupy a thread of the pool.
+//! Job is shared with the widget, so it stays valid when the widget drops it,
+//! widget just marks the job as cancelled
+struct Widget_SoundWave::LoadJob
+{
+	std::string filename;
+	std::string cache_filename;
+#ifndef WITHOUT_MLT
+	Mlt::Profile profile;
+	Mlt::Producer *track;
+#endif
+	int frequency;
+	int n_channels;
+	int next_frame;
+	WaveformPeaks peaks;
+	std::atomic<bool> cancelled;
+	std::atomic<bool> finished;
+
+	LoadJob(const std::string &filename):
+		filename(filename),
+		cache_filename(WaveformPeaks::get_cache_filename(filename)),
+#ifndef WITHOUT_MLT
+		track(),
+#endif
+		frequency(default_frequency),
+		n_channels(default_n_channels),
+		next_frame(),
+		cancelled(false),
+		finished(false)
+	{ }
+
+	~LoadJob()
+	{
+#ifndef WITHOUT_MLT
+		delete track;
+#endif
+	}
+};
+
 Widget_SoundWave::MouseHandler::~MouseHandler() {}
 
 Widget_SoundWave::Widget_SoundWave()
     : Widget_TimeGraphBase(),
 	  frequency(default_frequency),
 	  n_channels(default_n_channels),
-	  n_samples(0),
 	  channel_idx(0),
 	  loading_error(false)
 {
@@ -92,11 +146,18 @@ bool Widget_SoundWave::load(const std::string& filename)
 	clear();
 
 	std::lock_guard<std::mutex> lock(mutex);
-	if (!do_load(filename)) {
+	std::string real_filename = Glib::filename_from_utf8(filename);
+	if (peaks.load(WaveformPeaks::get_cache_filename(real_filename), real_filename)) {
+		frequency = peaks.get_frequency();
+		n_channels = peaks.get_channels();
+	} else
+	if (!start_load(real_filename)) {
 		loading_error = true;
 		queue_draw();
 		return false;
 	}
+	if (channel_idx >= n_channels)
+		channel_idx = 0;
 	loading_error = false;
 	this->filename = filename;
 	signal_file_loaded().emit(filename);
@@ -107,12 +168,16 @@ bool Widget_SoundWave::load(const std::string& filename)
 void Widget_SoundWave::clear()
 {
 	std::lock_guard<std::mutex> lock(mutex);
-	buffer.clear();
+	load_connection.disconnect();
+	if (load_job) {
+		load_job->cancelled = true;
+		load_job.reset();
+	}
+	peaks.clear();
 	this->filename.clear();
 	loading_error = false;
 	sound_delay = 0.0;
 	channel_idx = 0;
-	n_samples = 0;
 	queue_draw();
 }
 
@@ -179,39 +244,47 @@ bool Widget_SoundWave::on_draw(const Cairo::RefPtr<Cairo::Context>& cr)
 	if (filename.empty())
 		return true;
 
-	if (buffer.empty())
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (load_job) {
+		Glib::RefPtr<Pango::Layout> layout(Pango::Layout::create(get_pango_context()));
+		layout->set_text(_("Loading audio..."));
+
+		cr->save();
+		Gdk::RGBA color = get_style_context()->get_color();
+		cr->set_source_rgba(color.get_red(), color.get_green(), color.get_blue(), 0.5);
+		cr->move_to(5, get_height()/2);
+		layout->show_in_cairo_context(cr);
+		cr->restore();
 		return true;
+	}
 
-	if (!frequency || !n_channels)
+	if (peaks.empty() || !frequency)
 		return true;
 
 	cr->save();
 
-	std::lock_guard<std::mutex> lock(mutex);
-
-	const int bytes_per_sample = 1;
-
 	Gdk::RGBA color = get_style_context()->get_color();
 	cr->set_source_rgb(color.get_red(), color.get_green(), color.get_blue());
 
-	const int middle_y = 127;
-	cr->move_to(0, middle_y);
-
-	const int stride = frequency * bytes_per_sample * n_channels;
-
-	for (double x = 0; x < get_width(); x+=.1) {
-		synfig::Time t = time_plot_data->get_t_from_pixel_coord(x);
-		int value = middle_y;
-		if (t >= sound_delay) {
-			synfig::Time dt = t - sound_delay;
-			unsigned long index = int(dt * stride) + channel_idx;
-			if (index < buffer.size())
-				std::copy(buffer.begin() + index, buffer.begin() + index + bytes_per_sample, &value);
-		}
-		int y = time_plot_data->get_pixel_y_coord(value);
-		cr->line_to(x, y);
+	// one vertical line from min to max per pixel column,
+	// WaveformPeaks reads only a few peaks for each of them at any zoom
+	const int width = get_width();
+	double begin = (double)(time_plot_data->get_t_from_pixel_coord(0) - sound_delay)*frequency;
+	for (int x = 0; x < width; ++x) {
+		double end = (double)(time_plot_data->get_t_from_pixel_coord(x + 1) - sound_delay)*frequency;
+		WaveformPeaks::Peak peak = peaks.get_peak(channel_idx, begin, end);
+		begin = end;
+		if (peak.empty())
+			continue;
+		int y0 = time_plot_data->get_pixel_y_coord(peak.max);
+		int y1 = time_plot_data->get_pixel_y_coord(peak.min);
+		if (y0 > y1)
+			std::swap(y0, y1);
+		cr->move_to(x + 0.5, y0);
+		cr->line_to(x + 0.5, y1 + 1);
 	}
-	cr->set_line_width(0.3);
+	cr->set_line_width(1.0);
 	cr->stroke();
 
 	draw_current_time(cr);
@@ -226,33 +299,6 @@ bool Widget_SoundWave::on_draw(const Cairo::RefPtr<Cairo::Context>& cr)
 	return true;
 }
 
-void Widget_SoundWave::set_time_model(const etl::handle<TimeModel>& x)
-{
-	if (x) {
-		previous_lower_time = x->get_lower();
-		previous_upper_time = x->get_upper();
-	}
-	Widget_TimeGraphBase::set_time_model(x);
-}
-
-void Widget_SoundWave::on_time_model_changed()
-{
-	if (filename.empty())
-		return;
-	if (previous_lower_time == time_plot_data->time_model->get_lower()
-		&& previous_upper_time == time_plot_data->time_model->get_upper())
-		return;
-
-	previous_lower_time = time_plot_data->time_model->get_lower();
-	previous_upper_time = time_plot_data->time_model->get_upper();
-
-	std::lock_guard<std::mutex> lock(mutex);
-	buffer.clear();
-	n_samples = 0;
-	do_load(filename);
-	queue_draw();
-}
-
 void Widget_SoundWave::setup_mouse_handler()
 {
 	mouse_handler.set_pan_enabled(true);
@@ -272,78 +318,104 @@ void Widget_SoundWave::setup_mouse_handler()
 	mouse_handler.signal_panning_requested().connect(sigc::mem_fun(*this, &Widget_SoundWave::pan));
 }
 
-bool Widget_SoundWave::do_load(const std::string& filename)
+bool Widget_SoundWave::start_load(const std::string& real_filename)
 {
-#ifndef WITHOUT_MLT	
-	std::string real_filename = Glib::filename_from_utf8(filename);
-	Mlt::Profile profile;
-	Mlt::Producer *track = new Mlt::Producer(profile, (std::string("avformat:") + real_filename).c_str());
-	if (!track->get_producer() || track->get_length() <= 0) {
-		delete track;
-		track = new Mlt::Producer(profile, (std::string("vorbis:") + real_filename).c_str());
-		if (!track->get_producer() || track->get_length() <= 0) {
-			delete track;
+	std::shared_ptr<LoadJob> job(new LoadJob(real_filename));
+#ifndef WITHOUT_MLT
+	job->track = new Mlt::Producer(job->profile, (std::string("avformat:") + real_filename).c_str());
+	if (!job->track->get_producer() || job->track->get_length() <= 0) {
+		delete job->track;
+		job->track = new Mlt::Producer(job->profile, (std::string("vorbis:") + real_filename).c_str());
+		if (!job->track->get_producer() || job->track->get_length() <= 0)
 			return false;
-		}
 	}
 
-	const int length = track->get_length();
-	double fps = track->get_fps();
-	int start_frame = 0;
-	int end_frame = length;
-	start_frame = synfig::clamp(start_frame, 0, length);
-	end_frame = synfig::clamp(end_frame, 0, length);
-	track->seek(start_frame);
-	// check if audio is seekable
-	if (track->position() != start_frame) {
-		// Not seekable!
-		synfig::error("Audio file not seekable, but a delay (%s) was set: %s", sound_delay.get_string(time_plot_data->time_model->get_frame_rate()).c_str(), filename.c_str());
-	}
-	unsigned char *outbuffer = nullptr;
-	int bytes_written = 0;
+	// format is needed right now to fill the channel list of the dock
+	Mlt::Frame *frame = job->track->get_frame(0);
+	if (!frame)
+		return false;
+	if (int x = frame->get_int("audio_frequency"))
+		job->frequency = x;
+	if (int x = frame->get_int("audio_channels"))
+		job->n_channels = x;
+	delete frame;
+	job->track->seek(0);
+#endif
 
-	frequency = 0;
-	n_channels = 0;
+	frequency = job->frequency;
+	n_channels = job->n_channels;
 
-	for (int i = start_frame; i < end_frame; ++i) {
-		Mlt::Frame *frame = track->get_frame(0);
-		if (!frame)
-			break;
+	job->peaks.reset(job->frequency, job->n_channels);
+	load_job = job;
+	synfig::ThreadPool::instance().enqueue(
+		sigc::bind(sigc::ptr_fun(&Widget_SoundWave::run_load_job), job) );
+	load_connection = Glib::signal_timeout().connect(
+		sigc::mem_fun(*this, &Widget_SoundWave::on_load_timeout), load_check_interval );
+	return true;
+}
+
+bool Widget_SoundWave::on_load_timeout()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!load_job)
+		return false;
+	if (!load_job->finished)
+		return true;
+
+	peaks.swap(load_job->peaks);
+	load_job.reset();
+	queue_draw();
+	return false;
+}
 
-		if (!frequency)
-			frequency = std::stoi(frame->get("audio_frequency"));
-		if (!n_channels)
-			n_channels = std::stoi(frame->get("audio_channels"));
+void Widget_SoundWave::run_load_job(std::shared_ptr<LoadJob> job)
+{
+#ifndef WITHOUT_MLT
+	const int length = job->track->get_length();
+	const int end = std::min(length, job->next_frame + load_chunk_frames);
+	for (; job->next_frame < end && !job->cancelled; ++job->next_frame) {
+		const int i = job->next_frame;
+		Mlt::Frame *frame = job->track->get_frame(0);
+		if (!frame) {
+			job->next_frame = length;
+			break;
+		}
 
 		mlt_audio_format format = mlt_audio_u8;
-		int bytes_per_sample = 1;
-		int _frequency = frequency? frequency : default_frequency;
-		int _channels = n_channels ? n_channels : default_n_channels;
-		int _n_samples = 0;
-		void * _buffer = frame->get_audio(format, _frequency, _channels, _n_samples);
-		if (_buffer == nullptr) {
+		int frequency = job->frequency;
+		int n_channels = job->n_channels;
+		int n_samples = 0;
+		void *buffer = frame->get_audio(format, frequency, n_channels, n_samples);
+		if (buffer == nullptr) {
 			synfig::warning("couldn't get sound frame #%i", i);
 			delete frame;
+			job->next_frame = length;
 			break;
 		}
-		if (buffer.empty()) {
-			synfig::warning("sound frame #%i got empty buffer", i);
-			int buffer_length = (end_frame - start_frame + 1) * _channels * bytes_per_sample * std::round(_frequency/fps);
-			buffer.resize(buffer_length);
-		}
-		int _n_bytes = _n_samples * _channels * bytes_per_sample;
-		std::copy(static_cast<unsigned char*>(_buffer), static_cast<unsigned char*>(_buffer) + _n_bytes, buffer.begin()+bytes_written);
-		bytes_written += _n_bytes;
-		outbuffer += _n_bytes;
-		frequency = _frequency;
-		n_channels = _channels;
-		n_samples += _n_samples;
+		if (n_channels == job->n_channels)
+			job->peaks.add_samples(static_cast<unsigned char*>(buffer), n_samples);
+		else
+			synfig::warning("sound frame #%i has unexpected count of channels: %i", i, n_channels);
 		delete frame;
 	}
-	if (channel_idx > n_channels)
-		channel_idx = 0;
-	queue_draw();
-	delete track;
+
+	// the rest of the track is decoded by the next task,
+	// chunks of the job never run simultaneously
+	if (job->next_frame < length && !job->cancelled) {
+		synfig::ThreadPool::instance().enqueue(
+			sigc::bind(sigc::ptr_fun(&Widget_SoundWave::run_load_job), job) );
+		return;
+	}
+
+	// the track is not needed anymore, release the file
+	delete job->track;
+	job->track = nullptr;
 #endif
-	return true;
+
+	job->peaks.finish();
+	if (!job->cancelled && !job->peaks.empty())
+		if (!job->peaks.save(job->cache_filename, job->filename))
+			synfig::warning("unable to write audio peaks cache: %s", job->cache_filename.c_str());
+
+	job->finished = true;
 }
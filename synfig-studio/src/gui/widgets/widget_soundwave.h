@@ -26,11 +26,17 @@
 #ifndef SYNFIG_STUDIO_WIDGET_SOUNDWAVE_H
 #define SYNFIG_STUDIO_WIDGET_SOUNDWAVE_H
 
+#include <memory>
+
 #include <gui/selectdraghelper.h>
+#include <gui/waveformpeaks.h>
 #include <gui/widgets/widget_timegraphbase.h>
 
 namespace studio {
 
+//! Draws min/max peaks of an audio track.
+//! Peaks are decoded in the ThreadPool and cached next to the audio file,
+//! see WaveformPeaks.
 class Widget_SoundWave : public Widget_TimeGraphBase
 {
 public:
@@ -52,8 +58,6 @@ public:
 	void set_delay(synfig::Time delay);
 	const synfig::Time& get_delay() const;
 
-	virtual void set_time_model(const etl::handle<TimeModel> &x) override;
-
 	sigc::signal<void, const std::string&> & signal_file_loaded() { return signal_file_loaded_; }
 	sigc::signal<void> & signal_delay_changed() { return signal_delay_changed_; }
 	sigc::signal<void> & signal_specs_changed() { return signal_specs_changed_; }
@@ -62,19 +66,18 @@ protected:
 	bool on_event(GdkEvent *event) override;
 	bool on_draw(const Cairo::RefPtr<Cairo::Context> &cr) override;
 
-	void on_time_model_changed() override;
-
 private:
+	struct LoadJob;
+
 	std::mutex mutex;
 	std::string filename;
 
 	// sound data
-	std::vector<unsigned char> buffer;
+	WaveformPeaks peaks;
 
 	// sound format
 	int frequency;
 	int n_channels;
-	int n_samples;
 
 	// user settings
 	synfig::Time sound_delay;
@@ -82,8 +85,8 @@ private:
 
 	// status
 	bool loading_error;
-	synfig::Time previous_lower_time;
-	synfig::Time previous_upper_time;
+	std::shared_ptr<LoadJob> load_job;
+	sigc::connection load_connection;
 
 	sigc::signal<void, const std::string&> signal_file_loaded_;
 	sigc::signal<void> signal_delay_changed_;
@@ -91,7 +94,12 @@ private:
 
 	void setup_mouse_handler();
 
-	bool do_load(const std::string& filename);
+	//! Opens the audio file and starts decoding of peaks in the ThreadPool
+	bool start_load(const std::string &real_filename);
+	//! Takes peaks of the finished job
+	bool on_load_timeout();
+	//! Decodes a chunk of the track and enqueues the rest
+	static void run_load_job(std::shared_ptr<LoadJob> job);
 
 	// I'm too lazy to code/copy again mouse actions for panning/zooming/scrolling
 	struct MouseHandler : SelectDragHelper<int>
@@ -41,8 +41,10 @@
 #include <synfig/general.h>
 #include <synfig/context.h>
 #include <synfig/threadpool.h>
+#include <synfig/color/pixelformat.h>
 #include <synfig/rendering/renderer.h>
 #include <synfig/rendering/common/task/tasktransformation.h>
+#include <synfig/rendering/software/surfacesw.h>
 
 #include <gui/canvasview.h>
 #include <gui/localization.h>
@@ -50,6 +52,7 @@
 #include <gui/workarea.h>
 
 #include "renderer_canvas.h"
+#include "tiledownscale.h"
 
 #endif
 
@@ -92,7 +95,13 @@ Renderer_Canvas::Renderer_Canvas():
 	weight_zoom_in     (1024.0), // very very low priority
 	weight_zoom_out    (1024.0),
 	max_enqueued_tasks (6),
+	max_downscale      (4.0),
+	downscale_cell     (256),
+	prefetch_frames    (4),
+	prefetch_timeout   (0.5),
 	enqueued_tasks(),
+	motion_step(),
+	motion_playing(),
 	tiles_size(),
 	pixel_format()
 {
@@ -141,6 +150,29 @@ Renderer_Canvas::on_post_tile_finished_callback(etl::handle<Renderer_Canvas> obj
 		obj->on_post_tile_finished(tile);
 }
 
+void
+Renderer_Canvas::downscale_tile_func(
+	rendering::SurfaceResource::Handle surface,
+	std::shared_ptr<std::vector<unsigned char> > pixels,
+	int width,
+	int height,
+	PixelFormat pixel_format,
+	rendering::TaskEvent::Handle event )
+{
+	// this function is called from the ThreadPool
+	if (event->is_finished()) return; // tile is removed already
+
+	bool success = false;
+	{
+		rendering::SurfaceResource::LockWrite<rendering::SurfaceSW> lock(surface);
+		if (lock) {
+			TileDownscale::downscale(lock->get_surface(), pixels->data(), width, height, pixel_format);
+			success = true;
+		}
+	}
+	event->finish(success);
+}
+
 Cairo::RefPtr<Cairo::ImageSurface>
 Renderer_Canvas::convert(
 	const rendering::SurfaceResource::Handle &surface,
@@ -456,6 +488,148 @@ Renderer_Canvas::build_onion_frames()
 		visible_frames.insert(i->id);
 }
 
+void
+Renderer_Canvas::update_motion(bool is_playing, const RectInt &window_rect)
+{
+	// mutex must be already locked
+
+	if (motion_playing && !is_playing && prefetch_stats.frames) {
+		info( "Renderer_Canvas: prefetch hits %d of %d frames (%.0f%%), %d frames prefetched",
+			  prefetch_stats.hits, prefetch_stats.frames,
+			  100.0*prefetch_stats.hit_rate(), prefetch_stats.prefetched );
+		prefetch_stats = PrefetchStats();
+	}
+	motion_playing = is_playing;
+
+	if (!frame_duration) {
+		motion_step = 0;
+		return;
+	}
+
+	if (current_frame.time == motion_time) {
+		// scrubbing is finished
+		if (!is_playing && motion_timer() > prefetch_timeout)
+			motion_step = 0;
+		return;
+	}
+
+	// check that the frame was ready when it became visible
+	if (motion_step || is_playing) {
+		++prefetch_stats.frames;
+		if (calc_frame_status(current_frame, window_rect) == FS_Done)
+			++prefetch_stats.hits;
+	}
+
+	// playback skips frames when rendering is slower than fps,
+	// and scrubbing may move time by several frames at once
+	Real seconds = motion_timer.pop_time();
+	int frames = (int)round((Real)(current_frame.time - motion_time)/(Real)frame_duration);
+	motion_time = current_frame.time;
+	if (frames && (is_playing || seconds < prefetch_timeout))
+		motion_step = is_playing ? std::max(1, frames) : frames;
+	else
+		motion_step = is_playing ? 1 : 0;
+}
+
+void
+Renderer_Canvas::cancel_frame(const FrameId &id, rendering::Task::List &events)
+{
+	// mutex must be already locked
+	TileMap::iterator i = tiles.find(id);
+	if (i == tiles.end()) return;
+	for(TileList::iterator j = i->second.begin(); j != i->second.end(); )
+		if (*j && (*j)->event)
+			j = erase_tile(i->second, j, events);
+		else
+			++j;
+	if (i->second.empty()) tiles.erase(i);
+}
+
+bool
+Renderer_Canvas::enqueue_downscale_tiles(
+	TileList &frame_tiles,
+	const FrameId &id,
+	std::vector<RectInt> &rects )
+{
+	// mutex must be already locked
+
+	// find the nearest level of pyramid with higher resolution
+	TileMap::const_iterator source = tiles.end();
+	for(TileMap::const_iterator i = tiles.lower_bound(FrameId(id.time)); i != tiles.end() && i->first.time == id.time; ++i)
+		if ( i->first.width > id.width
+		  && i->first.height > id.height
+		  && i->first.width <= id.width*max_downscale
+		  && std::abs(i->first.width*id.height - i->first.height*id.width) <= i->first.width + i->first.height
+		  && (source == tiles.end() || i->first.width < source->first.width) )
+			source = i;
+	if (source == tiles.end()) return false;
+
+	const TileList &source_tiles = source->second;
+	Real kx = (Real)source->first.width/(Real)id.width;
+	Real ky = (Real)source->first.height/(Real)id.height;
+
+	// split regions to cells to reuse partially rendered levels
+	std::vector<RectInt> cells;
+	for(std::vector<RectInt>::const_iterator i = rects.begin(); i != rects.end(); ++i)
+		for(int y = i->miny; y < i->maxy; y += downscale_cell)
+			for(int x = i->minx; x < i->maxx; x += downscale_cell)
+				cells.push_back( RectInt(x, y, std::min(x + downscale_cell, i->maxx), std::min(y + downscale_cell, i->maxy)) );
+
+	std::vector<RectInt> remaining;
+	for(std::vector<RectInt>::const_iterator i = cells.begin(); i != cells.end(); ++i) {
+		RectInt src_rect = TileDownscale::get_source_rect(*i, kx, ky);
+		src_rect &= source->first.rect();
+
+		// check that region is completely rendered
+		std::vector<RectInt> src_rects(1, src_rect);
+		for(TileList::const_iterator j = source_tiles.begin(); j != source_tiles.end(); ++j)
+			if (*j && !(*j)->event && (*j)->cairo_surface)
+				rects_subtract(src_rects, (*j)->rect);
+		if (!src_rect.is_valid() || !src_rects.empty())
+			{ remaining.push_back(*i); continue; }
+
+		// copy pixels here, because tiles may be removed while downscaling
+		int sw = src_rect.get_width();
+		int sh = src_rect.get_height();
+		std::shared_ptr<std::vector<unsigned char> > pixels(
+			new std::vector<unsigned char>(4*(size_t)sw*(size_t)sh) );
+		for(TileList::const_iterator j = source_tiles.begin(); j != source_tiles.end(); ++j) {
+			if (!*j || (*j)->event || !(*j)->cairo_surface) continue;
+			RectInt r = (*j)->rect;
+			r &= src_rect;
+			if (!r.is_valid()) continue;
+			const unsigned char *data = (*j)->cairo_surface->get_data();
+			int stride = (*j)->cairo_surface->get_stride();
+			for(int y = r.miny; y < r.maxy; ++y)
+				memcpy( &(*pixels)[4*((size_t)(y - src_rect.miny)*sw + (r.minx - src_rect.minx))],
+				        data + (y - (*j)->rect.miny)*stride + 4*(r.minx - (*j)->rect.minx),
+				        4*r.get_width() );
+		}
+
+		RectInt rect = *i;
+		Tile::Handle tile = new Tile(id, rect);
+		tile->surface = new rendering::SurfaceResource();
+		tile->surface->create(rect.get_width(), rect.get_height());
+
+		tile->event = new rendering::TaskEvent();
+		tile->event->signal_finished.connect( sigc::bind(
+			sigc::ptr_fun(&on_tile_finished_callback), this, tile ));
+
+		insert_tile(frame_tiles, tile);
+
+		++enqueued_tasks;
+
+		ThreadPool::instance().enqueue( sigc::bind(
+			sigc::ptr_fun(&downscale_tile_func),
+			tile->surface, pixels, sw, sh, pixel_format, tile->event ));
+	}
+
+	if (remaining.size() == cells.size()) return false;
+	rects_merge(remaining);
+	rects.swap(remaining);
+	return true;
+}
+
 bool
 Renderer_Canvas::enqueue_render_frame(
 	const rendering::Renderer::Handle &renderer,
@@ -499,6 +673,20 @@ Renderer_Canvas::enqueue_render_frame(
 
 	if (rects.empty()) return false;
 
+	// snap rect corners to tile grid
+	for(std::vector<RectInt>::iterator j = rects.begin(); j != rects.end(); ++j) {
+		RectInt &rect = *j;
+		rect.minx = int_floor(rect.minx, tile_grid_step);
+		rect.miny = int_floor(rect.miny, tile_grid_step);
+		rect.maxx = int_ceil (rect.maxx, tile_grid_step);
+		rect.maxy = int_ceil (rect.maxy, tile_grid_step);
+		rect &= id.rect();
+	}
+
+	// reuse tiles rendered with higher resolution when zooming out
+	bool downscaled = enqueue_downscale_tiles(frame_tiles, id, rects);
+	if (rects.empty()) return downscaled;
+
 	// build rendering task
 	canvas->set_time(id.time);
 
@@ -518,7 +706,7 @@ Renderer_Canvas::enqueue_render_frame(
 		std::string full_error_msg = synfig::strprintf(_("Error loading canvas resources at %s (%s):\n\t%s"), id.time.get_string().c_str(), canvas->get_name().c_str(), loading_error_msg.c_str());
 		rendering_error_msg_map[id.time].insert(full_error_msg);
 		synfig::error(full_error_msg);
-		return false;
+		return downscaled;
 	}
 
 	canvas->set_outline_grow(rend_desc.get_outline_grow());
@@ -538,13 +726,7 @@ Renderer_Canvas::enqueue_render_frame(
 	if (!task) task = new rendering::TaskSurface();
 
 	for(std::vector<RectInt>::iterator j = rects.begin(); j != rects.end(); ++j) {
-		// snap rect corners to tile grid
 		RectInt &rect = *j;
-		rect.minx = int_floor(rect.minx, tile_grid_step);
-		rect.miny = int_floor(rect.miny, tile_grid_step);
-		rect.maxx = int_ceil (rect.maxx, tile_grid_step);
-		rect.maxy = int_ceil (rect.maxy, tile_grid_step);
-		rect &= id.rect();
 
 		RendDesc tile_desc=rend_desc;
 		tile_desc.set_subwindow(rect.minx, rect.miny, rect.get_width(), rect.get_height());
@@ -595,6 +777,7 @@ Renderer_Canvas::enqueue_render()
 		bool			is_bounded = time_model->get_play_bounds_enabled();
 
 		build_onion_frames();
+		update_motion(is_playing, window_rect);
 
 		rendering::Renderer::Handle renderer = rendering::Renderer::get_renderer(renderer_name);
 		
@@ -619,14 +802,38 @@ Renderer_Canvas::enqueue_render()
 
 				remove_extra_tiles(events);
 
+				long long frame_size = image_rect_size(window_rect);
+
+				// prefetch ring of upcoming frames in direction of playback or scrubbing,
+				// it is enqueued after visible frames, so it has lower priority
+				FrameSet ring;
+				for(int i = 1; motion_step && i <= prefetch_frames; ++i) {
+					Time time = current_frame.time + frame_duration*(motion_step*i);
+					if (time < time_model->get_lower() || time > time_model->get_upper())
+						break;
+					FrameId id = current_frame.with_time(time);
+					if (visible_frames.count(id))
+						continue;
+					ring.insert(id);
+					if (enqueued_tasks < max_tasks && tiles_size + frame_size < max_tiles_size_soft)
+						if (enqueue_render_frame(renderer, canvas, window_rect, id))
+							{ ++enqueued; ++prefetch_stats.prefetched; }
+				}
+
+				// frames left behind will not be shown, don't waste time for them
+				for(FrameSet::const_iterator i = prefetched_frames.begin(); i != prefetched_frames.end(); ++i)
+					if (!ring.count(*i) && !visible_frames.count(*i))
+						cancel_frame(*i, events);
+				prefetched_frames.swap(ring);
+
 				// generate rendering tasks for future or past frames
 				// render only one frame in background
+				// skip it while scrubbing, the ring is already enqueued
 				int future = 0, past = 0;
-				long long frame_size = image_rect_size(window_rect);
 				bool time_in_repeat_range = time_model->get_time() >= time_model->get_play_bounds_lower()
 						                 && time_model->get_time() <= time_model->get_play_bounds_upper();
 				
-				while(bg_rendering && enqueued_tasks < max_tasks && tiles_size + frame_size < max_tiles_size_soft)
+				while(bg_rendering && (is_playing || !motion_step) && enqueued_tasks < max_tasks && tiles_size + frame_size < max_tiles_size_soft)
 				{
 					Time future_time = current_frame.time + frame_duration*future;
 					bool future_exists = future_time >= time_model->get_lower()
@@ -730,6 +937,7 @@ Renderer_Canvas::clear_render()
 				erase_tile(i->second, j, events);
 			}
 		tiles.clear();
+		prefetched_frames.clear();
 		rendering_error_msg_map.clear();
 	}
 	rendering::Renderer::cancel(events);
@@ -803,6 +1011,20 @@ Renderer_Canvas::get_render_status(StatusMap &out_map)
 	}
 }
 
+Renderer_Canvas::PrefetchStats
+Renderer_Canvas::get_prefetch_stats()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return prefetch_stats;
+}
+
+void
+Renderer_Canvas::reset_prefetch_stats()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	prefetch_stats = PrefetchStats();
+}
+
 void Renderer_Canvas::get_rendering_error_messages(std::vector<std::string>& messages)
 {
 	std::lock_guard<std::mutex> lock(mutex);
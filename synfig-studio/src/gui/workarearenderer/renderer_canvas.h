@@ -33,8 +33,10 @@
 
 #include <vector>
 #include <map>
+#include <memory>
 
 #include <synfig/canvas.h>
+#include <synfig/clock.h>
 #include <synfig/rendering/task.h>
 #include <synfig/rendering/renderer.h>
 #include <synfig/time.h>
@@ -129,6 +131,17 @@ public:
 			frame_id(frame_id), rect(rect) { }
 	};
 
+	//! Statistics of frames shown while the time is moving (playback or scrubbing)
+	class PrefetchStats {
+	public:
+		int frames;     //!< count of shown frames
+		int hits;       //!< count of shown frames which was completely rendered in advance
+		int prefetched; //!< count of frames enqueued by prefetch
+		PrefetchStats(): frames(), hits(), prefetched() { }
+		synfig::Real hit_rate() const
+			{ return frames ? (synfig::Real)hits/(synfig::Real)frames : 0.0; }
+	};
+
 	typedef std::map<synfig::Time, FrameStatus> StatusMap;
 	typedef std::set<FrameId> FrameSet;
 	typedef std::vector<FrameDesc> FrameList;
@@ -146,8 +159,13 @@ private:
 	const synfig::Real weight_zoom_in;   //!< will multiply to log(zoom)
 	const synfig::Real weight_zoom_out;
 	const int max_enqueued_tasks;
+	const synfig::Real max_downscale;    //!< max ratio of resolutions to reuse tiles of other zoom level
+	const int downscale_cell;            //!< size of regions to search finished tiles of other zoom level
+	const int prefetch_frames;           //!< size of ring of upcoming frames
+	const synfig::Real prefetch_timeout; //!< seconds after the last time change while scrubbing is assumed
 
-	//! controls access to fields: enqueued_tasks, tiles, onion_frames, visible_frames, current_frame, frame_duration, tiles_size
+	//! controls access to fields: enqueued_tasks, tiles, onion_frames, visible_frames, current_frame, frame_duration, tiles_size,
+	//! and the prefetch state
 	std::mutex mutex;
 
 	int enqueued_tasks;
@@ -162,6 +180,16 @@ private:
 	FrameId current_frame;
 	synfig::Time frame_duration;
 
+	//! time of the current frame when it was seen last time by update_motion()
+	synfig::Time motion_time;
+	synfig::clock motion_timer;
+	//! predicted change of the current frame, negative when time moves backward, zero if time stays
+	int motion_step;
+	bool motion_playing;
+	//! frames of the prefetch ring
+	FrameSet prefetched_frames;
+	PrefetchStats prefetch_stats;
+
 	//! increment of this field makes all tiles outdated
 	long long tiles_size;
 
@@ -180,6 +208,13 @@ private:
 	// Renderer_Canvas is non-thread-safe sigc::trackable, so use static callback methods in signals
 	static void on_tile_finished_callback(bool success, Renderer_Canvas *obj, Tile::Handle tile);
 	static void on_post_tile_finished_callback(etl::handle<Renderer_Canvas> obj, Tile::Handle tile);
+	static void downscale_tile_func(
+		synfig::rendering::SurfaceResource::Handle surface,
+		std::shared_ptr<std::vector<unsigned char> > pixels,
+		int width,
+		int height,
+		synfig::PixelFormat pixel_format,
+		synfig::rendering::TaskEvent::Handle event );
 
 	//! this method may be called from the other threads
 	void on_tile_finished(bool success, const Tile::Handle &tile);
@@ -204,9 +239,25 @@ private:
 	//! mutex must be locked before call
 	void build_onion_frames();
 
+	//! mutex must be locked before call
+	//! updates motion_step by the changes of the current frame and collects prefetch_stats
+	void update_motion(bool is_playing, const synfig::RectInt &window_rect);
+
+	//! mutex must be locked before call
+	//! removes tiles of frame which are not rendered yet
+	void cancel_frame(const FrameId &id, synfig::rendering::Task::List &events);
+
 	//! mutex must be locked before call
 	FrameStatus calc_frame_status(const FrameId &id, const synfig::RectInt &window_rect);
 
+	//! mutex must be locked before call
+	//! enqueues downscaling of finished tiles of the same frame with higher resolution (mipmap pyramid),
+	//! removes covered regions from rects, returns true if something enqueued
+	bool enqueue_downscale_tiles(
+		TileList &frame_tiles,
+		const FrameId &id,
+		std::vector<synfig::RectInt> &rects );
+
 	//! mutex must be locked before call
 	//! returns true if rendering task actually enqueued
 	//! function can change the canvas time
@@ -230,6 +281,9 @@ public:
 
 	void get_render_status(StatusMap &out_map);
 
+	PrefetchStats get_prefetch_stats();
+	void reset_prefetch_stats();
+
 	void get_rendering_error_messages(std::vector<std::string>& messages);
 	void get_rendering_error_messages_for_time(const synfig::Time& time, std::set<std::string>& message_set);
 
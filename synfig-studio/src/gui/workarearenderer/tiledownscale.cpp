@@ -0,0 +1,78 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file tiledownscale.cpp
+**	\brief Downscaling of finished tiles of the work area to lower zoom levels
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#ifdef USING_PCH
+#	include "pch.h"
+#else
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include <cmath>
+
+#include <synfig/rendering/software/function/resample.h>
+
+#include "tiledownscale.h"
+
+#endif
+
+/* === U S I N G =========================================================== */
+
+using namespace synfig;
+using namespace studio;
+
+/* === M A C R O S ========================================================= */
+
+/* === G L O B A L S ======================================================= */
+
+/* === P R O C E D U R E S ================================================= */
+
+/* === M E T H O D S ======================================================= */
+
+RectInt
+TileDownscale::get_source_rect(const RectInt &rect, Real kx, Real ky)
+{
+	return RectInt( (int)std::floor(rect.minx*kx), (int)std::floor(rect.miny*ky),
+	                (int)std::ceil (rect.maxx*kx), (int)std::ceil (rect.maxy*ky) );
+}
+
+void
+TileDownscale::downscale(
+	Surface &dest,
+	const unsigned char *pixels,
+	int width,
+	int height,
+	PixelFormat pixel_format )
+{
+	Surface src(width, height);
+	pixelformat_to_color(src[0], pixels, pixel_format, width, height, src.get_pitch());
+
+	dest.clear();
+	rendering::software::Resample::downscale(
+		dest, RectInt(0, 0, dest.get_w(), dest.get_h()),
+		src, RectInt(0, 0, width, height) );
+}
+
+/* === E N T R Y P O I N T ================================================= */
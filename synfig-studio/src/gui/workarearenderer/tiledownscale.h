@@ -0,0 +1,67 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file tiledownscale.h
+**	\brief Downscaling of finished tiles of the work area to lower zoom levels
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === S T A R T =========================================================== */
+
+#ifndef __SYNFIG_STUDIO_TILEDOWNSCALE_H
+#define __SYNFIG_STUDIO_TILEDOWNSCALE_H
+
+/* === H E A D E R S ======================================================= */
+
+#include <synfig/color/pixelformat.h>
+#include <synfig/rect.h>
+#include <synfig/real.h>
+#include <synfig/surface.h>
+
+/* === M A C R O S ========================================================= */
+
+/* === T Y P E D E F S ===================================================== */
+
+/* === C L A S S E S & S T R U C T S ======================================= */
+
+namespace studio {
+
+//! Builds tiles of the frame from finished tiles of the same frame
+//! with higher resolution (see Renderer_Canvas), doesn't depend on GUI
+class TileDownscale
+{
+public:
+	//! Region of the level with higher resolution which covers the rect,
+	//! \a kx and \a ky are ratios of resolutions of that level and of the rect
+	static synfig::RectInt get_source_rect(const synfig::RectInt &rect, synfig::Real kx, synfig::Real ky);
+
+	//! Converts pixels of the region of higher resolution level
+	//! and downscales them into the whole \a dest
+	static void downscale(
+		synfig::Surface &dest,
+		const unsigned char *pixels,
+		int width,
+		int height,
+		synfig::PixelFormat pixel_format );
+};
+
+}; // END of namespace studio
+
+/* === E N D =============================================================== */
+
+#endif
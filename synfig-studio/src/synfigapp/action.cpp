@@ -549,6 +549,15 @@ Super::add_action_front(etl::handle<Undoable> action)
 		set_canvas(specific_action->get_canvas());
 }
 
+size_t
+Super::get_memory_usage()const
+{
+	size_t size = Undoable::get_memory_usage();
+	for(ActionList::const_iterator i = action_list_.begin(); i != action_list_.end(); ++i)
+		size += (*i)->get_memory_usage();
+	return size;
+}
+
 
 Group::Group(const synfig::String &str):
 	name_(str),
@@ -642,6 +651,13 @@ Undoable::Undoable():
 	//DOO printf("%s:%d Undoable::Undoable() (we have %d)\n", __FILE__, __LINE__, ++undoable_count);
 }
 
+size_t
+Undoable::get_memory_usage()const
+{
+	// actions which keep big copies of values should add them
+	return 256;
+}
+
 #ifdef _DEBUG
 Undoable::~Undoable() {
 	//DOO printf("%s:%d Undoable::~Undoable() (we now have %d)\n", __FILE__, __LINE__, --undoable_count);
@@ -228,6 +228,9 @@ public:
 	//! This function will throw an Action::Error() on failure
 	virtual void undo()=0;
 
+	//! Approximate count of bytes kept by the action for undo and redo
+	virtual size_t get_memory_usage()const;
+
 	bool is_active()const { return active_; }
 
 #ifdef _DEBUG
@@ -318,6 +321,8 @@ public:
 	virtual void perform();
 	virtual void undo();
 
+	virtual size_t get_memory_usage()const;
+
 }; // END of class Action::Super
 
 
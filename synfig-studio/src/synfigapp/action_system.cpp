@@ -32,6 +32,8 @@
 #	include <config.h>
 #endif
 
+#include <algorithm>
+
 #include <synfig/general.h>
 
 #include "action_system.h"
@@ -67,7 +69,8 @@ namespace {
 
 
 Action::System::System():
-	action_count_(0)
+	action_count_(0),
+	max_memory_(0)
 {
 	unset_ui_interface();
 	clear_redo_stack_on_new_action_=false;
@@ -173,8 +176,10 @@ Action::System::perform_action(etl::handle<Action::Base> action)
 		undo_action_stack_.push_front(undoable_action);
 
 		// Signal that a new action has been added
-		if(group_stack_.empty())
+		if(group_stack_.empty()) {
 			signal_new_action()(undoable_action);
+			trim_undo_stack_();
+		}
 	}
 
 	uim->task(action->get_local_name()+' '+_("Successful"));
@@ -371,6 +376,46 @@ Action::System::clear_redo_stack()
 	signal_redo_stack_cleared_();
 }
 
+void
+Action::System::set_max_memory(size_t x)
+{
+	max_memory_ = x;
+	if (group_stack_.empty())
+		trim_undo_stack_();
+}
+
+size_t
+Action::System::get_memory_usage()const
+{
+	size_t size = 0;
+	for(Stack::const_iterator i = undo_action_stack_.begin(); i != undo_action_stack_.end(); ++i)
+		size += (*i)->get_memory_usage();
+	for(Stack::const_iterator i = redo_action_stack_.begin(); i != redo_action_stack_.end(); ++i)
+		size += (*i)->get_memory_usage();
+	return size;
+}
+
+void
+Action::System::trim_undo_stack_()
+{
+	if (!max_memory_ || undo_action_stack_.size() < 2)
+		return;
+
+	size_t size = get_memory_usage();
+	int count = 0;
+	while(size > max_memory_ && undo_action_stack_.size() > 1) {
+		size_t action_size = undo_action_stack_.back()->get_memory_usage();
+		size -= std::min(size, action_size);
+		undo_action_stack_.pop_back();
+		++count;
+	}
+
+	if (count) {
+		synfig::info("Action history: %d oldest action(s) removed to fit into %zu bytes", count, max_memory_);
+		signal_undo_stack_trimmed_(count);
+	}
+}
+
 bool
 Action::System::set_action_status(etl::handle<Action::Undoable> action, bool x)
 {
@@ -465,6 +510,7 @@ Action::PassiveGrouper::finish()
 		if (instance_->group_stack_.empty()) {
 			instance_->inc_action_count();
 			instance_->signal_new_action()(instance_->undo_action_stack_.front());
+			instance_->trim_undo_stack_();
 		} else
 			instance_->group_stack_.front()->inc_depth();
 	} else
@@ -497,6 +543,7 @@ Action::PassiveGrouper::finish()
 		if(instance_->group_stack_.empty()) {
 			instance_->inc_action_count();
 			instance_->signal_new_action()(instance_->undo_action_stack_.front());
+			instance_->trim_undo_stack_();
 		} else
 			instance_->group_stack_.front()->inc_depth();
 	}
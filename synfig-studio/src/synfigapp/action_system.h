@@ -130,6 +130,7 @@ private:
 	sigc::signal<void,etl::handle<Action::Undoable> > signal_new_action_;
 	sigc::signal<void> signal_undo_stack_cleared_;
 	sigc::signal<void> signal_redo_stack_cleared_;
+	sigc::signal<void,int> signal_undo_stack_trimmed_;
 	sigc::signal<void> signal_undo_;
 	sigc::signal<void> signal_redo_;
 	sigc::signal<void,etl::handle<Action::Undoable> > signal_action_status_changed_;
@@ -143,6 +144,9 @@ private:
 
 	bool clear_redo_stack_on_new_action_;
 
+	//! Limit of memory used by the history, zero if unlimited
+	size_t max_memory_;
+
 	/*
  -- ** -- P R I V A T E   M E T H O D S ---------------------------------------
 	*/
@@ -152,6 +156,9 @@ private:
 	bool undo_(etl::handle<UIInterface> uim);
 	bool redo_(etl::handle<UIInterface> uim);
 
+	//! Removes the oldest undoable actions while the history doesn't fit into max_memory_
+	void trim_undo_stack_();
+
 	/*
  -- ** -- S I G N A L   T E R M I N A L S -------------------------------------
 	*/
@@ -204,6 +211,15 @@ public:
 	//! Clears the redo stack.
 	void clear_redo_stack();
 
+	//! Sets limit of memory used by undo and redo history in bytes, zero means unlimited.
+	/*! The oldest actions are removed from the undo stack when the limit is exceeded,
+	**	the most recent action is always kept. */
+	void set_max_memory(size_t x);
+	size_t get_max_memory()const { return max_memory_; }
+
+	//! Returns approximate count of bytes used by undo and redo history
+	size_t get_memory_usage()const;
+
 	//! Increments the action counter
 	/*! \note You should not have to call this under normal circumstances.
 	**	\see dec_action_count(), reset_action_count(), get_action_count() */
@@ -243,6 +259,9 @@ public:
 
 	sigc::signal<void>& signal_redo_stack_cleared() { return signal_redo_stack_cleared_; }
 
+	//! Called with count of the oldest actions removed from the undo stack, see set_max_memory()
+	sigc::signal<void,int>& signal_undo_stack_trimmed() { return signal_undo_stack_trimmed_; }
+
 	sigc::signal<void>& signal_undo() { return signal_undo_; }
 
 	sigc::signal<void>& signal_redo() { return signal_redo_; }
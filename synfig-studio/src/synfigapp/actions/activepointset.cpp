@@ -293,3 +293,10 @@ Action::ActivepointSet::undo()
 	// Signal that a valuenode has been changed
 	value_node->changed();
 }
+
+size_t
+Action::ActivepointSet::get_memory_usage()const
+{
+	return Undoable::get_memory_usage()
+	     + (activepoints.size() + old_activepoints.size() + overwritten_activepoints.size())*sizeof(synfig::Activepoint);
+}
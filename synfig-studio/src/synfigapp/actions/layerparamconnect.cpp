@@ -144,7 +144,7 @@ Action::LayerParamConnect::perform()
 		old_value_node=0;
 	}
 
-	old_value=layer->get_param(param_name);
+	old_value=ValueSnapshot(layer->get_param(param_name));
 	if(!old_value.is_valid())
 		throw Error(_("Layer did not recognize parameter name"));
 
@@ -190,3 +190,9 @@ Action::LayerParamConnect::undo()
 		//if(old_value_node)get_canvas_interface()->signal_value_node_changed()(old_value_node);
 	}
 }
+
+size_t
+Action::LayerParamConnect::get_memory_usage()const
+{
+	return Undoable::get_memory_usage() + old_value.get_memory_usage();
+}
@@ -32,6 +32,7 @@
 
 #include <synfig/layer.h>
 #include <synfigapp/action.h>
+#include <synfigapp/value_snapshot.h>
 
 /* === M A C R O S ========================================================= */
 
@@ -55,7 +56,7 @@ private:
 	synfig::String	param_name;
 	synfig::ValueNode::Handle	value_node;
 	synfig::ValueNode::Handle	old_value_node;
-	synfig::ValueBase old_value;
+	ValueSnapshot old_value;
 
 
 public:
@@ -71,6 +72,8 @@ public:
 	virtual void perform();
 	virtual void undo();
 
+	virtual size_t get_memory_usage()const;
+
 	ACTION_MODULE_EXT
 };
 
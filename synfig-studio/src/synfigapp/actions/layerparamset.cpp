@@ -103,7 +103,7 @@ Action::LayerParamSet::set_param(const synfig::String& name, const Action::Param
 
 	if(name=="new_value" && param.get_type()==Param::TYPE_VALUE)
 	{
-		new_value=param.get_value();
+		new_value=ValueSnapshot(param.get_value());
 
 		return true;
 	}
@@ -133,7 +133,7 @@ Action::LayerParamSet::perform()
 	if(layer->dynamic_param_list().count(param_name))
 		throw Error(_("ValueNode attached to Parameter."));
 
-	old_value=layer->get_param(param_name);
+	old_value=ValueSnapshot(layer->get_param(param_name));
 
 	// We shouldn't change the parameters properties when change its value
 	new_value.copy_properties_of(old_value);
@@ -176,3 +176,11 @@ Action::LayerParamSet::undo()
 		get_canvas_interface()->signal_layer_param_changed()(layer,param_name);
 	}
 }
+
+size_t
+Action::LayerParamSet::get_memory_usage()const
+{
+	return Undoable::get_memory_usage()
+	     + new_value.get_memory_usage()
+	     + old_value.get_memory_usage();
+}
@@ -32,6 +32,7 @@
 
 #include <synfig/layer.h>
 #include <synfigapp/action.h>
+#include <synfigapp/value_snapshot.h>
 
 /* === M A C R O S ========================================================= */
 
@@ -53,8 +54,8 @@ private:
 
 	synfig::Layer::Handle layer;
 	synfig::String	param_name;
-	synfig::ValueBase	new_value;
-	synfig::ValueBase	old_value;
+	ValueSnapshot	new_value;
+	ValueSnapshot	old_value;
 
 
 public:
@@ -70,6 +71,8 @@ public:
 	virtual void perform();
 	virtual void undo();
 
+	virtual size_t get_memory_usage()const;
+
 	ACTION_MODULE_EXT
 };
 
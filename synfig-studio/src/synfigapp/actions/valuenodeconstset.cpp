@@ -105,7 +105,7 @@ Action::ValueNodeConstSet::set_param(const synfig::String& name, const Action::P
 
 	if(name=="new_value" && param.get_type()==Param::TYPE_VALUE)
 	{
-		new_value=param.get_value();
+		new_value=ValueSnapshot(param.get_value());
 
 		return true;
 	}
@@ -126,7 +126,7 @@ Action::ValueNodeConstSet::perform()
 {
 	//set_dirty(true);
 
-	old_value=value_node->get_value();
+	old_value=ValueSnapshot(value_node->get_value());
 
 	// We shouldn't change the parameters properties when change its value
 	new_value.copy_properties_of(old_value);
@@ -153,3 +153,11 @@ Action::ValueNodeConstSet::undo()
 		get_canvas_interface()->signal_value_node_changed()(value_node);
 	}*/
 }
+
+size_t
+Action::ValueNodeConstSet::get_memory_usage()const
+{
+	return Undoable::get_memory_usage()
+	     + new_value.get_memory_usage()
+	     + old_value.get_memory_usage();
+}
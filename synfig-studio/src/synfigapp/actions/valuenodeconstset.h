@@ -32,6 +32,7 @@
 
 #include <synfig/valuenodes/valuenode_const.h>
 #include <synfigapp/action.h>
+#include <synfigapp/value_snapshot.h>
 
 /* === M A C R O S ========================================================= */
 
@@ -52,8 +53,8 @@ class ValueNodeConstSet :
 private:
 
 	synfig::ValueNode_Const::Handle value_node;
-	synfig::ValueBase	new_value;
-	synfig::ValueBase	old_value;
+	ValueSnapshot	new_value;
+	ValueSnapshot	old_value;
 
 
 public:
@@ -69,6 +70,8 @@ public:
 	virtual void perform();
 	virtual void undo();
 
+	virtual size_t get_memory_usage()const;
+
 	ACTION_MODULE_EXT
 };
 
@@ -272,3 +272,10 @@ Action::WaypointSet::undo()
 	// Signal that a valuenode has been changed
 	value_node->changed();
 }
+
+size_t
+Action::WaypointSet::get_memory_usage()const
+{
+	return Undoable::get_memory_usage()
+	     + (waypoints.size() + old_waypoints.size() + overwritten_waypoints.size())*sizeof(synfig::Waypoint);
+}
@@ -0,0 +1,217 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file value_snapshot.cpp
+**	\brief Immutable copy of a value stored by undoable actions
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#ifdef USING_PCH
+#	include "pch.h"
+#else
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include <list>
+#include <mutex>
+
+#include <synfig/blinepoint.h>
+#include <synfig/dashitem.h>
+#include <synfig/gradient.h>
+#include <synfig/matrix.h>
+#include <synfig/segment.h>
+#include <synfig/transformation.h>
+#include <synfig/widthpoint.h>
+
+#include "value_snapshot.h"
+
+#endif
+
+/* === U S I N G =========================================================== */
+
+using namespace synfig;
+using namespace synfigapp;
+
+/* === M A C R O S ========================================================= */
+
+/* === G L O B A L S ======================================================= */
+
+namespace {
+	//! Count of recent snapshots checked for equal values
+	const size_t recent_count = 8;
+}
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+	bool same_properties(const ValueBase &a, const ValueBase &b)
+	{
+		return a.get_loop() == b.get_loop()
+			&& a.get_static() == b.get_static()
+			&& a.get_interpolation() == b.get_interpolation();
+	}
+
+	bool same_vector(const Vector &a, const Vector &b)
+		{ return a[0] == b[0] && a[1] == b[1]; }
+
+	//! Exact comparison, also for types without registered equality operation
+	bool same_value(const ValueBase &a, const ValueBase &b)
+	{
+		if (a.get_type() != b.get_type() || !same_properties(a, b))
+			return false;
+
+		Type &type = a.get_type();
+		if (type == type_list)
+		{
+			const ValueBase::List &la = a.get_list(), &lb = b.get_list();
+			if (la.size() != lb.size())
+				return false;
+			for(ValueBase::List::const_iterator i = la.begin(), j = lb.begin(); i != la.end(); ++i, ++j)
+				if (!same_value(*i, *j))
+					return false;
+			return true;
+		}
+		if (type == type_bline_point)
+		{
+			const BLinePoint &x = a.get(BLinePoint()), &y = b.get(BLinePoint());
+			return same_vector(x.get_vertex(), y.get_vertex())
+				&& same_vector(x.get_tangent1(), y.get_tangent1())
+				&& same_vector(x.get_tangent2(), y.get_tangent2())
+				&& same_vector(x.get_vertex_setup(), y.get_vertex_setup())
+				&& x.get_width() == y.get_width()
+				&& x.get_origin() == y.get_origin()
+				&& x.get_split_tangent_radius() == y.get_split_tangent_radius()
+				&& x.get_split_tangent_angle() == y.get_split_tangent_angle()
+				&& x.get_boned_vertex_flag() == y.get_boned_vertex_flag();
+		}
+		if (type == type_width_point)
+		{
+			const WidthPoint &x = a.get(WidthPoint()), &y = b.get(WidthPoint());
+			return x.get_position() == y.get_position()
+				&& x.get_width() == y.get_width()
+				&& x.get_side_type_before() == y.get_side_type_before()
+				&& x.get_side_type_after() == y.get_side_type_after()
+				&& x.get_dash() == y.get_dash()
+				&& x.get_lower_bound() == y.get_lower_bound()
+				&& x.get_upper_bound() == y.get_upper_bound();
+		}
+		if (type == type_vector)
+			return same_vector(a.get(Vector()), b.get(Vector()));
+		return a == b;
+	}
+}
+
+/* === M E T H O D S ======================================================= */
+
+ValueSnapshot::ValueSnapshot(const ValueBase &x)
+{
+	static std::mutex mutex;
+	static std::list<std::weak_ptr<const Data> > recent;
+
+	size_t size = estimate_memory(x);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	for(std::list<std::weak_ptr<const Data> >::iterator i = recent.begin(); i != recent.end();)
+	{
+		std::shared_ptr<const Data> data = i->lock();
+		if (!data)
+			{ i = recent.erase(i); continue; }
+		if (data->size == size && same_value(data->value, x))
+		{
+			data_ = data;
+			recent.splice(recent.begin(), recent, i);
+			return;
+		}
+		++i;
+	}
+
+	std::shared_ptr<Data> data(new Data());
+	data->value = x;
+	data->size = size;
+	data_ = data;
+
+	recent.push_front(data_);
+	if (recent.size() > recent_count)
+		recent.pop_back();
+}
+
+const ValueBase&
+ValueSnapshot::get()const
+{
+	static const ValueBase empty;
+	return data_ ? data_->value : empty;
+}
+
+void
+ValueSnapshot::copy_properties_of(const ValueBase &x)
+{
+	if (!data_ || same_properties(data_->value, x))
+		return;
+	ValueBase value(data_->value);
+	value.copy_properties_of(x);
+	*this = ValueSnapshot(value);
+}
+
+size_t
+ValueSnapshot::get_memory_usage()const
+{
+	return data_ ? data_->size/data_.use_count() : 0;
+}
+
+size_t
+ValueSnapshot::estimate_memory(const ValueBase &x)
+{
+	size_t size = sizeof(ValueBase);
+	Type &type = x.get_type();
+	if (type == type_list)
+	{
+		const ValueBase::List &list = x.get_list();
+		for(ValueBase::List::const_iterator i = list.begin(); i != list.end(); ++i)
+			size += estimate_memory(*i);
+	}
+	else
+	if (type == type_string)
+		size += sizeof(String) + x.get(String()).size();
+	else
+	if (type == type_gradient)
+		size += sizeof(Gradient) + x.get(Gradient()).size()*sizeof(Gradient::CPoint);
+	else
+	if (type == type_bline_point)
+		size += sizeof(BLinePoint);
+	else
+	if (type == type_width_point)
+		size += sizeof(WidthPoint);
+	else
+	if (type == type_dash_item)
+		size += sizeof(DashItem);
+	else
+	if (type == type_segment)
+		size += sizeof(Segment);
+	else
+	if (type == type_matrix)
+		size += sizeof(Matrix);
+	else
+	if (type == type_transformation)
+		size += sizeof(Transformation);
+	else
+		size += 4*sizeof(Real); // scalars, vectors, colors and handles
+	return size;
+}
@@ -0,0 +1,82 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file value_snapshot.h
+**	\brief Immutable copy of a value stored by undoable actions
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === S T A R T =========================================================== */
+
+#ifndef __SYNFIG_APP_VALUE_SNAPSHOT_H
+#define __SYNFIG_APP_VALUE_SNAPSHOT_H
+
+/* === H E A D E R S ======================================================= */
+
+#include <memory>
+
+#include <synfig/value.h>
+
+/* === M A C R O S ========================================================= */
+
+/* === T Y P E D E F S ===================================================== */
+
+/* === C L A S S E S & S T R U C T S ======================================= */
+
+namespace synfigapp {
+
+//! Immutable value shared by the actions of the undo history.
+/*!	Successive edits of the same parameter store the same value twice:
+**	as the new value of one action and as the old value of the next one.
+**	Snapshots equal to one of the recently created ones reuse its data,
+**	so a long history of edits of a big list keeps one copy of each state.
+**	Modification makes a private copy (see copy_properties_of()). */
+class ValueSnapshot
+{
+	struct Data
+	{
+		synfig::ValueBase value;
+		size_t size;
+	};
+
+	std::shared_ptr<const Data> data_;
+
+public:
+	ValueSnapshot() { }
+	explicit ValueSnapshot(const synfig::ValueBase &x);
+
+	const synfig::ValueBase& get()const;
+	operator const synfig::ValueBase&()const { return get(); }
+
+	bool is_valid()const { return data_ && data_->value.is_valid(); }
+
+	//! Copies loop, static and interpolation flags, the data is copied only when they differ
+	void copy_properties_of(const synfig::ValueBase &x);
+
+	//! Bytes of the value divided by count of snapshots which share it
+	size_t get_memory_usage()const;
+
+	//! Approximate count of bytes used by the value
+	static size_t estimate_memory(const synfig::ValueBase &x);
+};
+
+}; // END of namespace synfigapp
+
+/* === E N D =============================================================== */
+
+#endif
@@ -33,7 +33,11 @@
 /* === H E A D E R S ======================================================= */
 
 #include "polygonizerclasses.h"
+#include <algorithm>
 #include <queue>
+#include <sigc++/bind.h>
+#include <sigc++/functors/ptr_fun.h>
+#include <synfig/threadpool.h>
 #include <synfig/vector.h>
 
 
@@ -1694,28 +1698,51 @@ static SkeletonGraph *skeletonize(ContourFamily &regionContours,
 
 //--------------------------------------------------------------------------
 
-SkeletonList* studio::skeletonize(Contours &contours, const etl::handle<synfigapp::UIInterface> &ui_interface, VectorizerCoreGlobals &g) {
-  VectorizationContext context(&g);
+// Contour families don't share any data, so each one is skeletonized
+// with its own context
+static void skeletonizeFamily(ContourFamily *family, SkeletonGraph **output,
+                              VectorizerCoreGlobals *globals) {
+  VectorizationContext context(globals);
+  *output = skeletonize(*family, context);
+}
 
-  SkeletonList *res = new SkeletonList;
-  unsigned int i, j,contours_size = contours.size();
+//--------------------------------------------------------------------------
+
+SkeletonList* studio::skeletonize(Contours &contours, const etl::handle<synfigapp::UIInterface> &ui_interface, VectorizerCoreGlobals &g) {
+  unsigned int i, j, k, contours_size = contours.size();
+  SkeletonList *res = new SkeletonList(contours_size);
 
   // Find overall number of nodes
   unsigned int overallNodes = 0;
-  for (i = 0; i < contours.size(); ++i)
+  std::vector<unsigned int> familyNodes(contours_size, 0);
+  for (i = 0; i < contours_size; ++i) {
     for (j = 0; j < contours[i].size(); ++j)
-      overallNodes += contours[i][j].size();
-
+      familyNodes[i] += contours[i][j].size();
+    overallNodes += familyNodes[i];
+  }
 
-  for (i = 0; i <contours_size ; ++i) {
+  // Families are skeletonized in the ThreadPool by batches,
+  // progress is reported from the calling thread between them
+  unsigned int batchNodes = overallNodes / 10 + 1;
+  unsigned int doneNodes = 0;
+  for (i = 0; i < contours_size; i = k) {
     /* To be enabled in case on isCancenled is implemnted
         if (thisVectorizer->isCanceled()) break;
     */
-    res->push_back(skeletonize(contours[i], context));
-    float partial = 30.0 + ((i/(float)contours_size)*30.0);
+    synfig::ThreadPool::Group group;
+    unsigned int nodes = 0;
+    for (k = i; k < contours_size && (k == i || nodes < batchNodes); ++k) {
+      group.enqueue(sigc::bind(sigc::ptr_fun(&skeletonizeFamily), &contours[k],
+                               &(*res)[k], &g),
+                    familyNodes[k] + 1);
+      nodes += familyNodes[k];
+    }
+    group.run();
+
+    doneNodes += nodes;
+    float partial = 30.0 + ((doneNodes/(float)std::max(overallNodes, 1u))*30.0);
     ui_interface->amount_complete(partial,100);
   }
 
   return res;
 }
-
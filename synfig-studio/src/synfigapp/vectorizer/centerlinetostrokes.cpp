@@ -54,12 +54,13 @@ using namespace studio;
 const double Polyg_eps_max = 1;     // Sequence simplification max error
 const double Polyg_eps_mul = 0.75;  // Sequence simple thickness-multiplier error
 const double Quad_eps_max =  infinity;  // As above, for sequence conversion into strokes
-synfig::Point bottomleft(0,0);
-bool max_thickness_zero = false;
-synfig::Canvas::Handle canvas;
-float unit_size;
-float h_factor = 1;
-float w_factor = 1;
+// Per thread, as images of a sequence may be vectorized simultaneously
+thread_local synfig::Point bottomleft(0,0);
+thread_local bool max_thickness_zero = false;
+thread_local synfig::Canvas::Handle canvas;
+thread_local float unit_size;
+thread_local float h_factor = 1;
+thread_local float w_factor = 1;
 /* === P R O C E D U R E S ================================================= */
 
 // this function will be responsible for unit conversion and height, width transformation
@@ -950,6 +951,8 @@ void studio::conversionToStrokes(std::vector< etl::handle<synfig::Layer> > &stro
   bottomleft[1] = bottomright[1];
 
   canvas = image->get_canvas();
+  // pool threads must not keep the canvas of the finished frame alive
+  struct CanvasReset { ~CanvasReset() { canvas.reset(); } } canvas_reset;
   synfig::rendering::SurfaceResource::LockRead<synfig::rendering::SurfaceSW> lock( image->rendering_surface );
 	const synfig::Surface &surface = lock->get_surface(); 
   
@@ -42,6 +42,7 @@
 
 #include "centerlinevectorizer.h"
 #include "polygonizerclasses.h"
+#include <synfig/clock.h>
 #include <synfig/layer.h>
 #include <synfig/debug/log.h>
 #endif
@@ -82,17 +83,21 @@ const CenterlineConfiguration &configuration,const Gamma &gamma)
   synfig::debug::Log::info("","Inside CenterlineVectorize");
   VectorizerCoreGlobals globals;
   globals.currConfig = &configuration;
+  m_times = VectorizerTimes();
+  synfig::clock timer;
 
   // step 2 
   // Extracts a polygonal, minimal yet faithful representation of image contours
   Contours polygons;
   studio::polygonize(image, polygons, globals);
+  m_times.polygonize = timer.pop_time();
   ui_interface->amount_complete(3,10);
   
   // step 3
   // The process of skeletonization reduces all objects in an image to lines, 
   //  without changing the essential structure of the image.
   SkeletonList *skeletons = studio::skeletonize(polygons,ui_interface, globals);
+  m_times.skeletonize = timer.pop_time();
   ui_interface->amount_complete(6,10);
   /* To be uncommented if isCanceled is needed in future
   if (isCanceled()) 
@@ -106,6 +111,7 @@ const CenterlineConfiguration &configuration,const Gamma &gamma)
   // The raw skeleton data obtained from StraightSkeletonizer
   // class need to be grouped in joints and sequences before proceeding further
   studio::organizeGraphs(skeletons, globals);
+  m_times.organize = timer.pop_time();
   ui_interface->amount_complete(8,10);
 
 
@@ -119,8 +125,12 @@ const CenterlineConfiguration &configuration,const Gamma &gamma)
   // step 6
   // Converts each forward or single Sequence of the image in its corresponding Stroke.
   studio::conversionToStrokes(sortibleResult, globals, image);
+  m_times.strokes = timer.pop_time();
   ui_interface->amount_complete(9,10);
 
+  synfig::debug::Log::info("", "Vectorized in %f s: polygonize %f s, skeletonize %f s (%d families), organize %f s, strokes %f s",
+    m_times.total(), m_times.polygonize, m_times.skeletonize, (int)polygons.size(), m_times.organize, m_times.strokes);
+
   deleteSkeletonList(skeletons);
   return sortibleResult;
 }
@@ -51,6 +51,27 @@ typedef etl::handle<synfig::Layer_Bitmap> Handle;
 
 namespace studio {
 
+//! Seconds spent by the stages of vectorization of a single image
+struct VectorizerTimes
+{
+  double polygonize;   //!< Extraction of image contours
+  double skeletonize;  //!< Straight skeletons of contour families
+  double organize;     //!< Grouping of skeletons into joints and sequences
+  double strokes;      //!< Conversion of sequences into outline layers
+
+  VectorizerTimes() : polygonize(), skeletonize(), organize(), strokes() {}
+
+  double total() const { return polygonize + skeletonize + organize + strokes; }
+
+  VectorizerTimes &operator+=(const VectorizerTimes &x) {
+    polygonize += x.polygonize;
+    skeletonize += x.skeletonize;
+    organize += x.organize;
+    strokes += x.strokes;
+    return *this;
+  }
+};
+
 //==============================
 //    Core vectorizer class
 //==============================
@@ -72,6 +93,8 @@ class VectorizerCore
 
   bool m_isCanceled;
 
+  VectorizerTimes m_times;
+
 public:
   VectorizerCore() : /*m_currPartial(0), m_totalPartials(0),*/ m_isCanceled(false) {}
   ~VectorizerCore() {}
@@ -79,6 +102,9 @@ public:
   //! Returns true if vectorization was aborted at user's request
   bool isCanceled() { return m_isCanceled; }
 
+  //! Returns time spent by the stages of the last vectorize() call
+  const VectorizerTimes &getTimes() const { return m_times; }
+
   /*!Calls the appropriate technique to convert \b image to vectors depending on c.*/
  
   std::vector< etl::handle<synfig::Layer> > vectorize(const etl::handle<synfig::Layer_Bitmap> &image, const etl::handle<synfigapp::UIInterface> &ui_interface,const VectorizerConfiguration &c,const synfig::Gamma &gamma);
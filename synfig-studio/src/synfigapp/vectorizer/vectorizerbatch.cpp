@@ -0,0 +1,140 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file vectorizerbatch.cpp
+**	\brief Vectorization of image sequences
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === H E A D E R S ======================================================= */
+
+#ifdef USING_PCH
+#	include "pch.h"
+#else
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#include <mutex>
+
+#include <sigc++/bind.h>
+#include <sigc++/functors/ptr_fun.h>
+
+#include <ETL/stringf>
+
+#include <synfig/canvas.h>
+#include <synfig/filesystemnative.h>
+#include <synfig/general.h>
+#include <synfig/layer.h>
+#include <synfig/savecanvas.h>
+#include <synfig/threadpool.h>
+
+#include "vectorizerbatch.h"
+#endif
+
+/* === U S I N G =========================================================== */
+
+using namespace synfig;
+using namespace studio;
+
+/* === M A C R O S ========================================================= */
+
+/* === G L O B A L S ======================================================= */
+
+namespace {
+  // Saving is fast compared to vectorization, so it is simply serialized
+  std::mutex save_mutex;
+}
+
+/* === P R O C E D U R E S ================================================= */
+
+namespace {
+  void vectorizeTask(VectorizerBatch::Frame *frame,
+                     const CenterlineConfiguration *configuration) {
+    VectorizerBatch::vectorizeFrame(*frame, *configuration);
+  }
+}
+
+/* === M E T H O D S ======================================================= */
+
+bool VectorizerBatch::vectorizeFrame(Frame &frame,
+                                     const CenterlineConfiguration &configuration) {
+  frame.success = false;
+  frame.errors.clear();
+  frame.times = VectorizerTimes();
+
+  // Import resolves the file name relative to the canvas through its file system
+  String output = etl::absolute_path(frame.output);
+  Canvas::Handle canvas = Canvas::create();
+  canvas->set_identifier(FileSystemNative::instance()->get_identifier(output));
+  canvas->set_file_name(output);
+
+  Layer_Bitmap::Handle image =
+      Layer_Bitmap::Handle::cast_dynamic(Layer::create("import"));
+  if (!image) {
+    frame.errors = "Import layer is not available";
+    return false;
+  }
+  image->set_canvas(canvas);
+  image->set_param("filename", ValueBase(etl::absolute_path(frame.input)));
+  if (!image->rendering_surface || !image->rendering_surface->is_exists()) {
+    frame.errors = strprintf("Unable to import \"%s\"", frame.input.c_str());
+    return false;
+  }
+
+  Gamma gamma = canvas->rend_desc().get_gamma();
+  gamma.invert();
+
+  etl::handle<synfigapp::UIInterface> ui_interface(new synfigapp::ConsoleUIInterface());
+  VectorizerCore core;
+  std::vector<etl::handle<Layer> > layers;
+  try {
+    layers = core.vectorize(image, ui_interface, configuration, gamma);
+  } catch (const std::exception &e) {
+    frame.errors = e.what();
+    return false;
+  }
+  frame.times = core.getTimes();
+
+  for (std::vector<etl::handle<Layer> >::const_iterator i = layers.begin(); i != layers.end(); ++i) {
+    (*i)->set_canvas(canvas);
+    canvas->push_front(*i);
+  }
+
+  std::lock_guard<std::mutex> lock(save_mutex);
+  if (!save_canvas(FileSystemNative::instance()->get_identifier(output), canvas)) {
+    frame.errors = strprintf("Unable to save \"%s\"", frame.output.c_str());
+    return false;
+  }
+
+  frame.success = true;
+  return true;
+}
+
+int VectorizerBatch::vectorizeSequence(std::vector<Frame> &frames,
+                                       const CenterlineConfiguration &configuration) {
+  ThreadPool::Group group;
+  for (std::vector<Frame>::iterator i = frames.begin(); i != frames.end(); ++i)
+    group.enqueue(sigc::bind(sigc::ptr_fun(&vectorizeTask), &*i, &configuration));
+  group.run();
+
+  int failed = 0;
+  for (std::vector<Frame>::const_iterator i = frames.begin(); i != frames.end(); ++i)
+    if (!i->success) ++failed;
+  return failed;
+}
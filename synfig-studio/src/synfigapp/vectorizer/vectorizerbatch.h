@@ -0,0 +1,77 @@
+/* === S Y N F I G ========================================================= */
+/*!	\file vectorizerbatch.h
+**	\brief Vectorization of image sequences
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+/* ========================================================================= */
+
+/* === S T A R T =========================================================== */
+
+#ifndef __SYNFIG_STUDIO_VECTORIZERBATCH_H
+#define __SYNFIG_STUDIO_VECTORIZERBATCH_H
+
+/* === H E A D E R S ======================================================= */
+
+#include <string>
+#include <vector>
+
+#include "centerlinevectorizer.h"
+
+/* === M A C R O S ========================================================= */
+
+/* === T Y P E D E F S ===================================================== */
+
+/* === C L A S S E S & S T R U C T S ======================================= */
+
+namespace studio {
+
+//! Centerline vectorization of image files without the GUI.
+/*!Each image is imported into a new composition, vectorized, and the
+resulting outline layers are saved as a separate composition.
+Frames of a sequence are independent, so they are processed simultaneously
+in the ThreadPool.*/
+class VectorizerBatch
+{
+public:
+  struct Frame {
+    std::string input;   //!< Image file
+    std::string output;  //!< Composition to write
+    bool success;
+    std::string errors;
+    VectorizerTimes times;
+
+    Frame() : success() {}
+    Frame(const std::string &input, const std::string &output)
+        : input(input), output(output), success() {}
+  };
+
+  //! Vectorizes a single image, returns false on failure
+  static bool vectorizeFrame(Frame &frame,
+                             const CenterlineConfiguration &configuration);
+
+  //! Vectorizes all frames, returns count of failed ones
+  static int vectorizeSequence(std::vector<Frame> &frames,
+                               const CenterlineConfiguration &configuration);
+};
+
+}; // END of namespace studio
+
+/* === E N D =============================================================== */
+
+#endif
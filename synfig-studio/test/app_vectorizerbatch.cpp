@@ -0,0 +1,99 @@
+/*!	\file test/app_vectorizerbatch.cpp
+**	\brief Tests for studio::VectorizerBatch
+**
+**	\legal
+**	Copyright (c) 2021 Synfig authors
+**
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+
+#include "test_base.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+#include <synfig/canvas.h>
+#include <synfig/filesystemnative.h>
+#include <synfig/general.h>
+#include <synfig/loadcanvas.h>
+
+#include <synfigapp/main.h>
+#include <synfigapp/vectorizer/vectorizerbatch.h>
+
+// Writes white image with a black cross, lines are thick enough to survive despeckling
+static bool write_cross_image(const std::string &filename, int size)
+{
+	std::ofstream file(filename.c_str(), std::ios::binary);
+	file << "P6\n" << size << " " << size << "\n255\n";
+	for (int y = 0; y < size; ++y) {
+		for (int x = 0; x < size; ++x) {
+			bool ink = (x >= size/8 && x < size - size/8 && std::abs(y - size/2) < 3)
+					|| (y >= size/8 && y < size - size/8 && std::abs(x - size/2) < 3);
+			char c = ink ? 0 : (char)255;
+			file.put(c).put(c).put(c);
+		}
+	}
+	return (bool)file;
+}
+
+// Check that frame without canvas of the GUI is imported, vectorized and saved
+static void test_vectorizerbatch_vectorize_frame()
+{
+	const std::string input = "vectorizerbatch_frame.ppm";
+	const std::string output = "vectorizerbatch_frame.sif";
+	ASSERT(write_cross_image(input, 64))
+
+	// the same settings as the defaults of synfigstudio --vectorize
+	studio::CenterlineConfiguration configuration;
+	configuration.m_threshold      = 8 * 25;
+	configuration.m_penalty        = 10 - 9;
+	configuration.m_despeckling    = 5 * 2;
+	configuration.m_maxThickness   = 200 / 2;
+	configuration.m_thicknessRatio = 1.0;
+
+	studio::VectorizerBatch::Frame frame(input, output);
+	bool success = studio::VectorizerBatch::vectorizeFrame(frame, configuration);
+	if (!success)
+		synfig::error("vectorizeFrame: %s", frame.errors.c_str());
+
+	synfig::String errors, warnings;
+	synfig::Canvas::Handle canvas;
+	if (success)
+		canvas = synfig::open_canvas_as(synfig::FileSystemNative::instance()->get_identifier(output), output, errors, warnings);
+
+	remove(input.c_str());
+	remove(output.c_str());
+
+	ASSERT(success)
+	ASSERT(frame.success)
+	ASSERT(canvas)
+	ASSERT(!canvas->empty())
+	for (synfig::Canvas::const_iterator i = canvas->begin(); i != canvas->end(); ++i)
+		ASSERT_EQUAL("outline", (*i)->get_name())
+}
+
+int main()
+{
+	synfigapp::Main Main("");
+
+	TEST_SUITE_BEGIN()
+		TEST_FUNCTION(test_vectorizerbatch_vectorize_frame)
+	TEST_SUITE_END();
+
+	return tst_exit_status;
+}
@@ -0,0 +1,177 @@
+/*!	\file test/gui_tiledownscale.cpp
+**	\brief Tests for downscaling of work area tiles to lower zoom levels
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+
+#include "test_base.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <synfig/color/pixelformat.h>
+#include <synfig/rendering/renderer.h>
+#include <synfig/rendering/common/task/taskblur.h>
+#include <synfig/rendering/common/task/taskcontour.h>
+#include <synfig/rendering/software/surfacesw.h>
+#include <synfig/type.h>
+
+#include <gui/workarearenderer/tiledownscale.h>
+
+using namespace synfig;
+
+static const int width = 192, height = 128, cell = 50;
+static const Rect source_rect(-1.5, -1, 1.5, 1);
+
+// Blurred polygon, smooth enough to be downscaled without visible difference
+static rendering::Task::Handle create_scene()
+{
+	rendering::Contour::Handle contour = new rendering::Contour();
+	contour->color = Color(0.9, 0.3, 0.1, 0.8);
+	contour->move_to(Vector(-1.3, -0.2));
+	contour->line_to(Vector( 0.4, -0.9));
+	contour->line_to(Vector( 1.2,  0.7));
+	contour->line_to(Vector(-0.6,  0.8));
+	contour->close();
+	rendering::TaskContour::Handle polygon = new rendering::TaskContour();
+	polygon->contour = contour;
+
+	rendering::TaskBlur::Handle blur = new rendering::TaskBlur();
+	blur->blur = rendering::Blur(rendering::Blur::GAUSSIAN, Vector(0.4, 0.4));
+	blur->sub_task() = polygon;
+	return blur;
+}
+
+static Surface render(int w, int h)
+{
+	rendering::Task::Handle task = create_scene();
+	rendering::SurfaceResource::Handle surface = new rendering::SurfaceResource();
+	surface->create(w, h);
+	task->target_surface = surface;
+	task->target_rect = RectInt(0, 0, w, h);
+	task->source_rect = source_rect;
+	rendering::Renderer::get_renderer("software")->run(task);
+
+	rendering::SurfaceResource::LockRead<rendering::SurfaceSW> lock(surface);
+	ASSERT(lock)
+	return lock->get_surface();
+}
+
+// Pixel format of the tiles of Renderer_Canvas
+static PixelFormat get_pixel_format()
+{
+	union { int i; char c[4]; } checker = {0x01020304};
+	bool big_endian = checker.c[0] == 1;
+	return big_endian
+	     ? (PF_A_START | PF_RGB | PF_A_PREMULT)
+	     : (PF_BGR | PF_A | PF_A_PREMULT);
+}
+
+// Builds every cell of the frame from the frame rendered with k times higher resolution,
+// the same way as Renderer_Canvas::enqueue_downscale_tiles() does,
+// and compares them with the frame rendered directly
+static void check_downscaled_tiles_match_rendered(Real k)
+{
+	const PixelFormat pixel_format = get_pixel_format();
+	const int source_width = (int)std::round(width*k);
+	const int source_height = (int)std::round(height*k);
+	const Real kx = (Real)source_width/(Real)width;
+	const Real ky = (Real)source_height/(Real)height;
+
+	Surface rendered = render(width, height);
+	Surface source = render(source_width, source_height);
+	std::vector<unsigned char> source_pixels(4*(size_t)source_width*(size_t)source_height);
+	color_to_pixelformat(&source_pixels.front(), source[0], pixel_format, 0, source_width, source_height);
+
+	ColorReal max_diff = 0, sum_diff = 0;
+	for(int y = 0; y < height; y += cell) {
+		for(int x = 0; x < width; x += cell) {
+			RectInt rect(x, y, std::min(x + cell, width), std::min(y + cell, height));
+			RectInt src_rect = studio::TileDownscale::get_source_rect(rect, kx, ky);
+			src_rect &= RectInt(0, 0, source_width, source_height);
+			ASSERT(src_rect.is_valid())
+
+			int sw = src_rect.get_width();
+			int sh = src_rect.get_height();
+			std::vector<unsigned char> pixels(4*(size_t)sw*(size_t)sh);
+			for(int j = 0; j < sh; ++j)
+				memcpy( &pixels[4*(size_t)j*sw],
+				        &source_pixels[4*((size_t)(src_rect.miny + j)*source_width + src_rect.minx)],
+				        4*sw );
+
+			Surface tile(rect.get_width(), rect.get_height());
+			studio::TileDownscale::downscale(tile, &pixels.front(), sw, sh, pixel_format);
+
+			for(int j = 0; j < tile.get_h(); ++j) {
+				for(int i = 0; i < tile.get_w(); ++i) {
+					Color a = tile[j][i].premult_alpha();
+					Color b = rendered[y + j][x + i].premult_alpha();
+					ColorReal diff = std::max(
+						std::max(std::fabs(a.get_r() - b.get_r()), std::fabs(a.get_g() - b.get_g())),
+						std::max(std::fabs(a.get_b() - b.get_b()), std::fabs(a.get_a() - b.get_a())) );
+					max_diff = std::max(max_diff, diff);
+					sum_diff += diff;
+				}
+			}
+		}
+	}
+
+	// tiles are stored with 8 bits per channel,
+	// and bounds of cells are rounded to pixels of the source level
+	ASSERT(max_diff < 0.04)
+	ASSERT(sum_diff/(width*height) < 0.01)
+}
+
+static void test_studio_tiledownscale_twice_larger_level()
+{
+	check_downscaled_tiles_match_rendered(2.0);
+}
+
+static void test_studio_tiledownscale_not_multiple_level()
+{
+	check_downscaled_tiles_match_rendered(1.37);
+}
+
+static void test_studio_tiledownscale_source_rect_covers_cell()
+{
+	const RectInt rect(50, 100, 97, 150);
+	RectInt src_rect = studio::TileDownscale::get_source_rect(rect, 1.37, 1.5);
+	ASSERT_EQUAL(68, src_rect.minx)
+	ASSERT_EQUAL(150, src_rect.miny)
+	ASSERT_EQUAL(133, src_rect.maxx)
+	ASSERT_EQUAL(225, src_rect.maxy)
+}
+
+int main()
+{
+	Type::subsys_init();
+	rendering::Renderer::subsys_init();
+
+	TEST_SUITE_BEGIN()
+		TEST_FUNCTION(test_studio_tiledownscale_twice_larger_level)
+		TEST_FUNCTION(test_studio_tiledownscale_not_multiple_level)
+		TEST_FUNCTION(test_studio_tiledownscale_source_rect_covers_cell)
+	TEST_SUITE_END();
+
+	rendering::Renderer::subsys_stop();
+	Type::subsys_stop();
+
+	return tst_exit_status;
+}
@@ -0,0 +1,309 @@
+/*!	\file test/gui_waveformpeaks.cpp
+**	\brief Tests for the min/max peaks of audio tracks and their cache files
+**
+**	\legal
+**	This file is part of Synfig.
+**
+**	Synfig is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 2 of the License, or
+**	(at your option) any later version.
+**
+**	Synfig is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with Synfig.  If not, see <https://www.gnu.org/licenses/>.
+**	\endlegal
+*/
+
+#include "test_base.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <utime.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <gui/waveformpeaks.h>
+
+using studio::WaveformPeaks;
+
+static const int channels = 2;
+// whole track is 21 blocks of the first level and a partial last block
+static const int samples = 21*WaveformPeaks::BLOCK_SIZE + 17;
+
+static std::string dir;
+
+static std::string get_audio_filename()
+{
+	return dir + G_DIR_SEPARATOR_S + "track.wav";
+}
+
+// Noise with rare spikes, so neighbouring blocks have different peaks,
+// values 0 and 255 are left for the tests
+static std::vector<unsigned char> create_samples()
+{
+	std::vector<unsigned char> data(samples*channels);
+	unsigned int seed = 12345;
+	for(size_t i = 0; i < data.size(); ++i) {
+		seed = seed*1103515245 + 12345;
+		data[i] = (unsigned char)(96 + (seed >> 16)%64);
+	}
+	for(int i = 0; i < samples; i += 37) {
+		data[i*channels] = (unsigned char)(28 + i%200);
+		data[i*channels + 1] = (unsigned char)(227 - i%200);
+	}
+	return data;
+}
+
+static void build_peaks(WaveformPeaks &peaks, const std::vector<unsigned char> &data)
+{
+	// odd count of samples per call, so blocks are filled by several calls
+	peaks.reset(44100, channels);
+	for(int i = 0; i < samples; i += 100)
+		peaks.add_samples(&data[i*channels], std::min(100, samples - i));
+	peaks.finish();
+}
+
+static WaveformPeaks::Peak get_exact_peak(const std::vector<unsigned char> &data, int channel, int begin, int end)
+{
+	WaveformPeaks::Peak peak;
+	for(int i = std::max(0, begin); i < std::min(samples, end); ++i)
+		peak.add(data[i*channels + channel]);
+	return peak;
+}
+
+static void write_file(const std::string &filename, const std::string &content)
+{
+	FILE *file = g_fopen(filename.c_str(), "wb");
+	ASSERT(file)
+	size_t written = fwrite(content.data(), 1, content.size(), file);
+	int result = fclose(file);
+	ASSERT_EQUAL(content.size(), written)
+	ASSERT_EQUAL(0, result)
+}
+
+static std::string read_file(const std::string &filename)
+{
+	std::string content;
+	FILE *file = g_fopen(filename.c_str(), "rb");
+	ASSERT(file)
+	char buffer[4096];
+	for(size_t size; (size = fread(buffer, 1, sizeof(buffer), file)) > 0; )
+		content.append(buffer, size);
+	fclose(file);
+	return content;
+}
+
+static void assert_same_peaks(const WaveformPeaks &a, const WaveformPeaks &b)
+{
+	ASSERT_EQUAL(a.get_frequency(), b.get_frequency())
+	ASSERT_EQUAL(a.get_channels(), b.get_channels())
+	ASSERT_EQUAL(a.get_samples(), b.get_samples())
+	for(int c = 0; c < channels; ++c) {
+		for(int begin = 0; begin < samples; begin += 53) {
+			for(int length = 1; begin + length <= samples + 64; length = length*3 + 1) {
+				WaveformPeaks::Peak pa = a.get_peak(c, begin, begin + length);
+				WaveformPeaks::Peak pb = b.get_peak(c, begin, begin + length);
+				ASSERT_EQUAL((int)pa.min, (int)pb.min)
+				ASSERT_EQUAL((int)pa.max, (int)pb.max)
+			}
+		}
+	}
+}
+
+// The peak of the range may include neighbouring blocks of the chosen level,
+// but those blocks are not longer than the range itself
+static void test_studio_waveformpeaks_range_peaks()
+{
+	std::vector<unsigned char> data = create_samples();
+	WaveformPeaks peaks;
+	build_peaks(peaks, data);
+	ASSERT_EQUAL((long long)samples, peaks.get_samples())
+
+	for(int c = 0; c < channels; ++c) {
+		for(int begin = 0; begin < samples; begin += 29) {
+			for(int length = 1; length <= 2*samples; length = length*2 + 1) {
+				int end = begin + length;
+				int margin = std::max(length, (int)WaveformPeaks::BLOCK_SIZE);
+				WaveformPeaks::Peak peak = peaks.get_peak(c, begin, end);
+				WaveformPeaks::Peak inner = get_exact_peak(data, c, begin, end);
+				WaveformPeaks::Peak outer = get_exact_peak(data, c, begin - margin, end + margin);
+				ASSERT(!peak.empty())
+				ASSERT(peak.min <= inner.min && peak.max >= inner.max)
+				ASSERT(peak.min >= outer.min && peak.max <= outer.max)
+			}
+		}
+	}
+}
+
+static void test_studio_waveformpeaks_block_aligned_ranges_are_exact()
+{
+	const int block = WaveformPeaks::BLOCK_SIZE;
+	std::vector<unsigned char> data = create_samples();
+	WaveformPeaks peaks;
+	build_peaks(peaks, data);
+
+	// ranges of whole blocks of the level, which is chosen for their length
+	for(int c = 0; c < channels; ++c) {
+		for(int size = block; size < samples; size *= 2) {
+			for(int begin = 0; begin < samples; begin += size) {
+				WaveformPeaks::Peak peak = peaks.get_peak(c, begin, begin + size);
+				WaveformPeaks::Peak exact = get_exact_peak(data, c, begin, begin + size);
+				ASSERT_EQUAL((int)exact.min, (int)peak.min)
+				ASSERT_EQUAL((int)exact.max, (int)peak.max)
+			}
+		}
+	}
+}
+
+static void test_studio_waveformpeaks_partial_last_block()
+{
+	const int last_block = samples/WaveformPeaks::BLOCK_SIZE*WaveformPeaks::BLOCK_SIZE;
+	std::vector<unsigned char> data = create_samples();
+	data[(samples - 1)*channels] = 0;
+	data[(samples - 1)*channels + 1] = 255;
+	WaveformPeaks peaks;
+	build_peaks(peaks, data);
+
+	for(int c = 0; c < channels; ++c) {
+		// only existing samples of the last block, ranges out of the track are clamped
+		WaveformPeaks::Peak exact = get_exact_peak(data, c, last_block, samples);
+		WaveformPeaks::Peak peak = peaks.get_peak(c, last_block, samples + 1000);
+		ASSERT_EQUAL((int)exact.min, (int)peak.min)
+		ASSERT_EQUAL((int)exact.max, (int)peak.max)
+	}
+
+	// the last sample reaches every level
+	for(int length = 1; length <= samples; length *= 2) {
+		WaveformPeaks::Peak first = peaks.get_peak(0, samples - length, samples);
+		WaveformPeaks::Peak second = peaks.get_peak(1, samples - length, samples);
+		ASSERT_EQUAL(0, (int)first.min)
+		ASSERT_EQUAL(255, (int)second.max)
+	}
+
+	ASSERT(peaks.get_peak(0, samples, samples + 100).empty())
+	ASSERT(peaks.get_peak(0, -100, 0).empty())
+	ASSERT(peaks.get_peak(channels, 0, samples).empty())
+}
+
+static void test_studio_waveformpeaks_save_load()
+{
+	std::vector<unsigned char> data = create_samples();
+	std::string audio_filename = get_audio_filename();
+	std::string cache_filename = WaveformPeaks::get_cache_filename(audio_filename);
+	write_file(audio_filename, std::string(data.begin(), data.end()));
+
+	WaveformPeaks peaks;
+	build_peaks(peaks, data);
+	ASSERT(peaks.save(cache_filename, audio_filename))
+
+	WaveformPeaks loaded;
+	ASSERT(loaded.load(cache_filename, audio_filename))
+	assert_same_peaks(peaks, loaded);
+
+	g_remove(cache_filename.c_str());
+	g_remove(audio_filename.c_str());
+}
+
+static void test_studio_waveformpeaks_changed_audio_file()
+{
+	std::vector<unsigned char> data = create_samples();
+	std::string audio_filename = get_audio_filename();
+	std::string cache_filename = WaveformPeaks::get_cache_filename(audio_filename);
+	std::string content(data.begin(), data.end());
+	write_file(audio_filename, content);
+
+	WaveformPeaks peaks;
+	build_peaks(peaks, data);
+	ASSERT(peaks.save(cache_filename, audio_filename))
+
+	GStatBuf info;
+	ASSERT_EQUAL(0, g_stat(audio_filename.c_str(), &info))
+	struct utimbuf times;
+	times.actime = info.st_atime;
+	times.modtime = info.st_mtime;
+
+	// the same size, but another modification time
+	times.modtime = info.st_mtime + 10;
+	ASSERT_EQUAL(0, g_utime(audio_filename.c_str(), &times))
+	ASSERT(!peaks.load(cache_filename, audio_filename))
+	ASSERT(peaks.empty())
+
+	// the same modification time, but another size
+	write_file(audio_filename, content + "x");
+	times.modtime = info.st_mtime;
+	ASSERT_EQUAL(0, g_utime(audio_filename.c_str(), &times))
+	ASSERT(!peaks.load(cache_filename, audio_filename))
+
+	// the original file is accepted again
+	write_file(audio_filename, content);
+	ASSERT_EQUAL(0, g_utime(audio_filename.c_str(), &times))
+	ASSERT(peaks.load(cache_filename, audio_filename))
+
+	// missing audio file
+	g_remove(audio_filename.c_str());
+	ASSERT(!peaks.load(cache_filename, audio_filename))
+
+	g_remove(cache_filename.c_str());
+}
+
+static void test_studio_waveformpeaks_truncated_cache()
+{
+	std::vector<unsigned char> data = create_samples();
+	std::string audio_filename = get_audio_filename();
+	std::string cache_filename = WaveformPeaks::get_cache_filename(audio_filename);
+	write_file(audio_filename, std::string(data.begin(), data.end()));
+
+	WaveformPeaks peaks;
+	build_peaks(peaks, data);
+	ASSERT(peaks.save(cache_filename, audio_filename))
+	std::string content = read_file(cache_filename);
+
+	// cut inside the header, at the start of peaks and inside the peaks
+	const size_t peaks_size = (samples + WaveformPeaks::BLOCK_SIZE - 1)/WaveformPeaks::BLOCK_SIZE*channels*2;
+	ASSERT(content.size() > peaks_size)
+	const size_t sizes[] = { 0, 5, 20, content.size() - peaks_size, content.size() - peaks_size/2, content.size() - 1 };
+	for(size_t i = 0; i < sizeof(sizes)/sizeof(sizes[0]); ++i) {
+		write_file(cache_filename, content.substr(0, sizes[i]));
+		WaveformPeaks loaded;
+		build_peaks(loaded, data);
+		ASSERT(!loaded.load(cache_filename, audio_filename))
+		ASSERT(loaded.empty())
+	}
+
+	write_file(cache_filename, content);
+	ASSERT(peaks.load(cache_filename, audio_filename))
+
+	g_remove(cache_filename.c_str());
+	g_remove(audio_filename.c_str());
+}
+
+int main()
+{
+	gchar *tmp_dir = g_dir_make_tmp("synfig-waveformpeaks-XXXXXX", nullptr);
+	if (!tmp_dir)
+		return 1;
+	dir = tmp_dir;
+	g_free(tmp_dir);
+
+	TEST_SUITE_BEGIN()
+		TEST_FUNCTION(test_studio_waveformpeaks_range_peaks)
+		TEST_FUNCTION(test_studio_waveformpeaks_block_aligned_ranges_are_exact)
+		TEST_FUNCTION(test_studio_waveformpeaks_partial_last_block)
+		TEST_FUNCTION(test_studio_waveformpeaks_save_load)
+		TEST_FUNCTION(test_studio_waveformpeaks_changed_audio_file)
+		TEST_FUNCTION(test_studio_waveformpeaks_truncated_cache)
+	TEST_SUITE_END();
+
+	g_rmdir(dir.c_str());
+
+	return tst_exit_status;
+}